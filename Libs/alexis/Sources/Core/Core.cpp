@@ -11,7 +11,10 @@
 #include "CoreHelpers.h"
 #include "SystemsHolder.h"
 #include "FrameUpdateGraph.h"
+#include "JobSystem.h"
 
+#include <ECS/Systems/CameraSystem.h>
+#include <ECS/Systems/TransformSystem.h>
 #include <ECS/Systems/ImguiSystem.h>
 
 // TODO: rework it! Needed to get app's icon
@@ -40,6 +43,26 @@ namespace alexis
 
 	static LRESULT CALLBACK WindowProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam);
 
+	// "-workers N" sets the JobSystem worker count, to measure frame times against the number of cores.
+	// 0 (the default) spawns one per hardware thread minus the main one
+	static std::uint32_t GetWorkerCountArgument()
+	{
+		std::uint32_t workerCount = 0;
+
+		int argc = 0;
+		LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+		for (int i = 1; argv && i + 1 < argc; ++i)
+		{
+			if (wcscmp(argv[i], L"-workers") == 0)
+			{
+				workerCount = static_cast<std::uint32_t>(std::max(_wtoi(argv[i + 1]), 0));
+			}
+		}
+		LocalFree(argv);
+
+		return workerCount;
+	}
+
 	void Core::CreateRenderWindow()
 	{
 		WNDCLASSEX windowClass = { 0 };
@@ -216,6 +239,8 @@ namespace alexis
 		Render::GetInstance()->Initialize(g_clientWidth, g_clientHeight);
 		s_frameCount = 0;
 
+		m_jobSystem = std::make_unique<JobSystem>(GetWorkerCountArgument());
+
 		m_resourceManager = std::make_unique<ResourceManager>();
 
 		m_ecs = std::make_unique<ecs::World>();
@@ -224,7 +249,12 @@ namespace alexis
 		m_systemsHolder = std::make_unique<SystemsHolder>();
 		m_systemsHolder->Init();
 
+		// Conflicting systems update in this order
 		m_frameUpdateGraph = std::make_unique<FrameUpdateGraph>();
+		m_frameUpdateGraph->AddSystem<ecs::CameraSystem>(*m_ecs);
+		m_frameUpdateGraph->AddSystem<ecs::TransformSystem>(*m_ecs);
+		m_frameUpdateGraph->AddSystem<ecs::ImguiSystem>(*m_ecs);
+		m_frameUpdateGraph->Build();
 
 		ShowWindow(s_hwnd, SW_SHOWDEFAULT);
 		UpdateWindow(s_hwnd);
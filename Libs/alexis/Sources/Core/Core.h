@@ -44,6 +44,7 @@ namespace alexis
 	class ResourceManager;
 	class SystemsHolder;
 	class FrameUpdateGraph;
+	class JobSystem;
 
 	class Core
 	{
@@ -79,6 +80,11 @@ namespace alexis
 			return *m_ecs;
 		}
 
+		inline JobSystem& GetJobSystem() const
+		{
+			return *m_jobSystem;
+		}
+
 		inline ResourceManager* GetResourceManager()
 		{
 			return m_resourceManager.get();
@@ -103,6 +109,8 @@ namespace alexis
 
 		void CreateRenderWindow();
 
+		// Declared first to outlive everything that may schedule jobs
+		std::unique_ptr<JobSystem> m_jobSystem;
 		std::unique_ptr<ecs::World> m_ecs;
 		std::unique_ptr<ResourceManager> m_resourceManager;
 		std::unique_ptr<SystemsHolder> m_systemsHolder;
@@ -1,19 +1,111 @@
-#include "Precompiled.h"
+#include <Precompiled.h>
 
 #include "FrameUpdateGraph.h"
 
 #include <Core/Core.h>
 
-#include <ECS/Systems/ModelSystem.h>
-#include <ECS/Systems/ImguiSystem.h>
-
 namespace alexis
 {
 	void FrameUpdateGraph::Update(float dt)
 	{
-		auto& ecsWorld = Core::Get().GetECSWorld();
+		if (m_nodes.empty())
+		{
+			return;
+		}
+
+		auto& jobSystem = Core::Get().GetJobSystem();
+
+		for (std::size_t i = 0; i < m_nodes.size(); ++i)
+		{
+			m_pendingDependencies[i].store(m_nodes[i].DependencyCount, std::memory_order_relaxed);
+		}
+
+		for (std::size_t i = 0; i < m_nodes.size(); ++i)
+		{
+			if (m_nodes[i].DependencyCount == 0)
+			{
+				Dispatch(i, dt);
+			}
+		}
+
+		// Main thread executes its own nodes and otherwise helps the workers. A node job dispatches its dependents
+		// before it is counted as done, so once m_nodeJobs drops to zero every node left is waiting in m_mainThreadNodes
+		for (;;)
+		{
+			std::size_t node = m_nodes.size();
+			{
+				std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+				if (!m_mainThreadNodes.empty())
+				{
+					node = m_mainThreadNodes.front();
+					m_mainThreadNodes.erase(m_mainThreadNodes.begin());
+				}
+			}
+
+			if (node < m_nodes.size())
+			{
+				Execute(node, dt);
+			}
+			else if (m_nodeJobs.load(std::memory_order_acquire) > 0)
+			{
+				jobSystem.Wait(m_nodeJobs);
+			}
+			else
+			{
+				break;
+			}
+		}
+	}
+
+	void FrameUpdateGraph::Build()
+	{
+		// Later system depends on every earlier one it conflicts with.
+		// Keeps results identical to serial execution in registration order
+		for (std::size_t i = 0; i < m_nodes.size(); ++i)
+		{
+			auto& node = m_nodes[i];
+			for (std::size_t j = 0; j < i; ++j)
+			{
+				auto& prevNode = m_nodes[j];
+
+				bool bothOnMainThread = node.Access.MainThreadOnly && prevNode.Access.MainThreadOnly;
+				if (bothOnMainThread || node.Access.ConflictsWith(prevNode.Access))
+				{
+					prevNode.Dependents.push_back(i);
+					++node.DependencyCount;
+				}
+			}
+		}
+
+		m_pendingDependencies = std::make_unique<std::atomic<std::uint32_t>[]>(m_nodes.size());
+		m_mainThreadNodes.reserve(m_nodes.size());
+	}
+
+	void FrameUpdateGraph::Dispatch(std::size_t node, float dt)
+	{
+		if (m_nodes[node].Access.MainThreadOnly)
+		{
+			std::lock_guard<std::mutex> lock(m_mainThreadMutex);
+			m_mainThreadNodes.push_back(node);
+			return;
+		}
+
+		Core::Get().GetJobSystem().Run([this, node, dt]()
+		{
+			Execute(node, dt);
+		}, &m_nodeJobs);
+	}
+
+	void FrameUpdateGraph::Execute(std::size_t node, float dt)
+	{
+		m_nodes[node].Update(dt);
 
-		ecsWorld.GetSystem<ecs::ModelSystem>()->Update(dt);
-		ecsWorld.GetSystem<ecs::ImguiSystem>()->Update(dt);
+		for (auto dependent : m_nodes[node].Dependents)
+		{
+			if (m_pendingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				Dispatch(dependent, dt);
+			}
+		}
 	}
-}
\ No newline at end of file
+}
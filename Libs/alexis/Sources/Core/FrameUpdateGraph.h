@@ -1,10 +1,64 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <ECS/ECS.h>
+#include <Core/JobSystem.h>
+
 namespace alexis
 {
+	// Runs systems' Update in parallel where their declared component access allows.
+	// Systems conflicting by access are ordered as added
 	class FrameUpdateGraph
 	{
 	public:
+		template<class T>
+		void AddSystem(ecs::World& world)
+		{
+			Node node;
+			node.Access = world.GetSystemAccess<T>();
+			node.Update = [system = world.GetSystem<T>(), &world](float dt)
+			{
+				// Writes made from now on are seen by the next Update via Changed<T>
+				std::uint32_t version = world.AdvanceChangeVersion();
+				system->Update(dt);
+				system->LastSystemVersion = version;
+			};
+
+			m_nodes.push_back(std::move(node));
+		}
+
+		// Call once all systems are added
+		void Build();
+
 		void Update(float dt);
+
+	private:
+		struct Node
+		{
+			std::function<void(float)> Update;
+			ecs::SystemAccess Access;
+
+			// Nodes that have to wait for this one
+			std::vector<std::size_t> Dependents;
+			std::uint32_t DependencyCount{ 0 };
+		};
+
+		void Dispatch(std::size_t node, float dt);
+		void Execute(std::size_t node, float dt);
+
+		std::vector<Node> m_nodes;
+
+		// Per-frame state
+		std::unique_ptr<std::atomic<std::uint32_t>[]> m_pendingDependencies;
+		JobCounter m_nodeJobs{ 0 };
+
+		std::mutex m_mainThreadMutex;
+		std::vector<std::size_t> m_mainThreadNodes;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,371 @@
+#include <Precompiled.h>
+
+#include "JobSystem.h"
+
+namespace alexis
+{
+	namespace
+	{
+		// Failed attempts to find a job before an idle worker goes to sleep
+		static constexpr std::uint32_t k_idleSpinCount = 64;
+
+		// Free jobs moved at once between a thread cache and the shared free list
+		static constexpr std::uint32_t k_jobCacheBatch = 32;
+
+		// Deque of the calling thread, set for the creating thread and the workers
+		thread_local const JobSystem* t_jobSystem = nullptr;
+		thread_local std::uint32_t t_queueIndex = 0;
+	}
+
+	JobSystem::JobSystem(std::uint32_t workerCount)
+	{
+		if (workerCount == 0)
+		{
+			std::uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+		}
+
+		m_queues.reserve(workerCount + 1);
+		for (std::uint32_t i = 0; i < workerCount + 1; ++i)
+		{
+			m_queues.push_back(std::make_unique<JobQueue>());
+		}
+		m_jobCaches.resize(workerCount + 1);
+
+		t_jobSystem = this;
+		t_queueIndex = 0;
+
+		m_workers.reserve(workerCount);
+		for (std::uint32_t i = 0; i < workerCount; ++i)
+		{
+			m_workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+		}
+	}
+
+	JobSystem::~JobSystem()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_running.store(false);
+		}
+
+		m_condition.notify_all();
+
+		for (auto& worker : m_workers)
+		{
+			worker.join();
+		}
+
+		// Jobs nobody got to
+		auto discard = [](PendingJob* job)
+		{
+			job->Destroy(job->Storage);
+			delete job;
+		};
+
+		for (auto& queue : m_queues)
+		{
+			while (auto* job = queue->Pop())
+			{
+				discard(job);
+			}
+		}
+
+		for (auto* job : m_sharedJobs)
+		{
+			discard(job);
+		}
+
+		for (auto& [dependency, job] : m_parkedJobs)
+		{
+			while (job)
+			{
+				discard(std::exchange(job, job->Next));
+			}
+		}
+
+		auto deleteList = [](PendingJob* job)
+		{
+			while (job)
+			{
+				delete std::exchange(job, job->Next);
+			}
+		};
+
+		for (auto& cache : m_jobCaches)
+		{
+			deleteList(cache.Free);
+		}
+		deleteList(m_freeJobs);
+
+		if (t_jobSystem == this)
+		{
+			t_jobSystem = nullptr;
+		}
+	}
+
+	void JobSystem::Wait(const JobCounter& counter)
+	{
+		while (counter.load(std::memory_order_acquire) > 0)
+		{
+			if (!TryRunJob())
+			{
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	bool JobSystem::TryRunJob()
+	{
+		PendingJob* job = Take();
+		if (!job)
+		{
+			return false;
+		}
+
+		m_queuedCount.fetch_sub(1, std::memory_order_relaxed);
+		Execute(job);
+		return true;
+	}
+
+	void JobSystem::Push(PendingJob* job)
+	{
+		m_queuedCount.fetch_add(1, std::memory_order_seq_cst);
+
+		if (t_jobSystem != this || !m_queues[t_queueIndex]->Push(job))
+		{
+			std::lock_guard<std::mutex> lock(m_sharedMutex);
+			m_sharedJobs.push_back(job);
+		}
+
+		// A worker going to sleep checks m_queuedCount under the mutex, taking it here means the notify cannot slip in between
+		if (m_sleepingCount.load(std::memory_order_seq_cst) > 0)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_sleepMutex);
+			}
+			m_condition.notify_one();
+		}
+	}
+
+	JobSystem::PendingJob* JobSystem::Allocate()
+	{
+		if (t_jobSystem != this)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_freeMutex);
+				if (auto* job = m_freeJobs)
+				{
+					m_freeJobs = job->Next;
+					return job;
+				}
+			}
+
+			return new PendingJob;
+		}
+
+		auto& cache = m_jobCaches[t_queueIndex];
+		if (!cache.Free)
+		{
+			std::lock_guard<std::mutex> lock(m_freeMutex);
+			for (std::uint32_t i = 0; i < k_jobCacheBatch && m_freeJobs; ++i)
+			{
+				auto* job = m_freeJobs;
+				m_freeJobs = job->Next;
+				job->Next = cache.Free;
+				cache.Free = job;
+				++cache.Count;
+			}
+		}
+
+		if (auto* job = cache.Free)
+		{
+			cache.Free = job->Next;
+			--cache.Count;
+			return job;
+		}
+
+		return new PendingJob;
+	}
+
+	void JobSystem::Release(PendingJob* job)
+	{
+		job->Destroy(job->Storage);
+
+		if (t_jobSystem != this)
+		{
+			std::lock_guard<std::mutex> lock(m_freeMutex);
+			job->Next = m_freeJobs;
+			m_freeJobs = job;
+			return;
+		}
+
+		auto& cache = m_jobCaches[t_queueIndex];
+		job->Next = cache.Free;
+		cache.Free = job;
+		if (++cache.Count < 2 * k_jobCacheBatch)
+		{
+			return;
+		}
+
+		// Jobs queued by one thread and run by another pile up in the runner's cache, hand a batch back
+		PendingJob* first = cache.Free;
+		PendingJob* last = first;
+		for (std::uint32_t i = 1; i < k_jobCacheBatch; ++i)
+		{
+			last = last->Next;
+		}
+		cache.Free = last->Next;
+		cache.Count -= k_jobCacheBatch;
+
+		std::lock_guard<std::mutex> lock(m_freeMutex);
+		last->Next = m_freeJobs;
+		m_freeJobs = first;
+	}
+
+	void JobSystem::Park(PendingJob* job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sharedMutex);
+
+			// Counted before the dependency is read, Execute decrements it before reading the count: one of them sees the other
+			m_parkedCount.fetch_add(1, std::memory_order_seq_cst);
+			if (job->Dependency->load(std::memory_order_seq_cst) > 0)
+			{
+				auto& parked = m_parkedJobs[job->Dependency];
+				job->Next = parked;
+				parked = job;
+				return;
+			}
+			m_parkedCount.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		Push(job);
+	}
+
+	void JobSystem::ReleaseParked(const JobCounter* dependency)
+	{
+		PendingJob* ready = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(m_sharedMutex);
+
+			auto it = m_parkedJobs.find(dependency);
+			if (it == m_parkedJobs.end())
+			{
+				return;
+			}
+
+			// The drained counter may already be gone and another one live at its address. Only parked jobs' dependencies
+			// are read, those are alive (see RunAfter)
+			PendingJob** link = &it->second;
+			while (auto* job = *link)
+			{
+				if (job->Dependency->load(std::memory_order_acquire) > 0)
+				{
+					link = &job->Next;
+					continue;
+				}
+
+				*link = job->Next;
+				job->Next = ready;
+				ready = job;
+				m_parkedCount.fetch_sub(1, std::memory_order_relaxed);
+			}
+
+			if (!it->second)
+			{
+				m_parkedJobs.erase(it);
+			}
+		}
+
+		while (ready)
+		{
+			Push(std::exchange(ready, ready->Next));
+		}
+	}
+
+	JobSystem::PendingJob* JobSystem::Take()
+	{
+		// Own deque newest first, work just pushed is still in cache
+		const bool hasQueue = t_jobSystem == this;
+		if (hasQueue)
+		{
+			if (auto* job = m_queues[t_queueIndex]->Pop())
+			{
+				return job;
+			}
+		}
+
+		// Oldest job of the other deques, starting past our own so thieves spread out
+		const std::size_t queueCount = m_queues.size();
+		const std::size_t first = hasQueue ? t_queueIndex + 1 : 0;
+		for (std::size_t i = 0; i < queueCount; ++i)
+		{
+			std::size_t index = (first + i) % queueCount;
+			if (hasQueue && index == t_queueIndex)
+			{
+				continue;
+			}
+
+			if (auto* job = m_queues[index]->Steal())
+			{
+				return job;
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(m_sharedMutex);
+		if (m_sharedJobs.empty())
+		{
+			return nullptr;
+		}
+
+		auto* job = m_sharedJobs.front();
+		m_sharedJobs.pop_front();
+		return job;
+	}
+
+	void JobSystem::WorkerLoop(std::uint32_t queueIndex)
+	{
+		t_jobSystem = this;
+		t_queueIndex = queueIndex;
+
+		std::uint32_t idleCount = 0;
+		while (m_running.load(std::memory_order_acquire))
+		{
+			if (TryRunJob())
+			{
+				idleCount = 0;
+				continue;
+			}
+
+			if (++idleCount < k_idleSpinCount)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			idleCount = 0;
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_sleepingCount.fetch_add(1, std::memory_order_seq_cst);
+			m_condition.wait(lock, [this]()
+			{
+				return !m_running.load(std::memory_order_relaxed) || m_queuedCount.load(std::memory_order_seq_cst) > 0;
+			});
+			m_sleepingCount.fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+	void JobSystem::Execute(PendingJob* job)
+	{
+		job->Invoke(job->Storage);
+
+		JobCounter* counter = job->Counter;
+		Release(job);
+
+		// A waiter may destroy the counter as soon as it drains, it is not touched after
+		if (counter && counter->fetch_sub(1, std::memory_order_seq_cst) == 1 && m_parkedCount.load(std::memory_order_seq_cst) > 0)
+		{
+			ReleaseParked(counter);
+		}
+	}
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Core/WorkStealingQueue.h>
+
+namespace alexis
+{
+	// Number of jobs still in flight. Wait() returns when it drops to zero
+	using JobCounter = std::atomic<std::uint32_t>;
+
+	// Fixed pool of worker threads. Every worker and the thread that created the system own a lock-free deque:
+	// jobs queued by a thread go to its own deque, idle threads steal from the others. Threads without a deque
+	// use a shared locked queue. Jobs are recycled, callables up to k_jobStorageSize bytes are stored in them
+	class JobSystem
+	{
+	public:
+		static constexpr std::size_t k_jobStorageSize = 64;
+
+		// workerCount == 0 spawns one worker per hardware thread minus the calling one
+		explicit JobSystem(std::uint32_t workerCount = 0);
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		// Queue job, counter (if any) is incremented now and decremented after job is done
+		template<class Func>
+		void Run(Func&& job, JobCounter* counter = nullptr)
+		{
+			Push(MakeJob(std::forward<Func>(job), counter, nullptr));
+		}
+
+		// Queue job that starts only once dependency reaches zero. The dependency must count jobs of this system and stay alive
+		// until the job starts: the job is parked aside and released by whichever of them finishes last
+		template<class Func>
+		void RunAfter(const JobCounter& dependency, Func&& job, JobCounter* counter = nullptr)
+		{
+			Park(MakeJob(std::forward<Func>(job), counter, &dependency));
+		}
+
+		// Block until counter reaches zero, executing pending jobs meanwhile
+		void Wait(const JobCounter& counter);
+
+		// Execute one pending job on the calling thread: its own deque first, then the shared queue, then steal.
+		// Returns false if no job could be started
+		bool TryRunJob();
+
+		// Split [0, count) into batches of batchSize and call func(begin, end) for each of them.
+		// The calling thread participates and returns when all batches are done
+		template<class Func>
+		void ParallelFor(std::size_t count, std::size_t batchSize, Func&& func)
+		{
+			if (count == 0)
+			{
+				return;
+			}
+
+			batchSize = batchSize > 0 ? batchSize : 1;
+			if (count <= batchSize || m_workers.empty())
+			{
+				func(std::size_t{ 0 }, count);
+				return;
+			}
+
+			JobCounter counter{ 0 };
+			for (std::size_t begin = batchSize; begin < count; begin += batchSize)
+			{
+				std::size_t end = begin + batchSize < count ? begin + batchSize : count;
+				Run([&func, begin, end]() { func(begin, end); }, &counter);
+			}
+
+			// First batch on the calling thread
+			func(std::size_t{ 0 }, batchSize);
+
+			Wait(counter);
+		}
+
+		std::uint32_t GetWorkerCount() const
+		{
+			return static_cast<std::uint32_t>(m_workers.size());
+		}
+
+	private:
+		// Callable stored inline, or a pointer to it when it does not fit
+		struct PendingJob
+		{
+			alignas(std::max_align_t) unsigned char Storage[k_jobStorageSize];
+			void (*Invoke)(void* storage){ nullptr };
+			void (*Destroy)(void* storage){ nullptr };
+			JobCounter* Counter{ nullptr };
+			const JobCounter* Dependency{ nullptr };
+
+			// Next free or parked job
+			PendingJob* Next{ nullptr };
+		};
+
+		// Free jobs of a deque owner, only touched by that thread
+		struct alignas(64) JobCache
+		{
+			PendingJob* Free{ nullptr };
+			std::uint32_t Count{ 0 };
+		};
+
+		using JobQueue = WorkStealingQueue<PendingJob>;
+
+		template<class Func>
+		PendingJob* MakeJob(Func&& func, JobCounter* counter, const JobCounter* dependency)
+		{
+			using Callable = std::decay_t<Func>;
+
+			if (counter)
+			{
+				counter->fetch_add(1, std::memory_order_relaxed);
+			}
+
+			PendingJob* job = Allocate();
+			if constexpr (sizeof(Callable) <= k_jobStorageSize && alignof(Callable) <= alignof(std::max_align_t))
+			{
+				new (job->Storage) Callable(std::forward<Func>(func));
+				job->Invoke = [](void* storage) { (*static_cast<Callable*>(storage))(); };
+				job->Destroy = [](void* storage) { static_cast<Callable*>(storage)->~Callable(); };
+			}
+			else
+			{
+				new (job->Storage) Callable*(new Callable(std::forward<Func>(func)));
+				job->Invoke = [](void* storage) { (**static_cast<Callable**>(storage))(); };
+				job->Destroy = [](void* storage) { delete *static_cast<Callable**>(storage); };
+			}
+
+			job->Counter = counter;
+			job->Dependency = dependency;
+			return job;
+		}
+
+		PendingJob* Allocate();
+		void Release(PendingJob* job);
+		void Push(PendingJob* job);
+		void Park(PendingJob* job);
+		void ReleaseParked(const JobCounter* dependency);
+		PendingJob* Take();
+		void WorkerLoop(std::uint32_t queueIndex);
+		void Execute(PendingJob* job);
+
+		std::vector<std::thread> m_workers;
+
+		// Index 0 belongs to the creating thread, i + 1 to worker i
+		std::vector<std::unique_ptr<JobQueue>> m_queues;
+		std::vector<JobCache> m_jobCaches;
+
+		// Free jobs of threads without a deque, and batches handed back by caches that grew too big
+		PendingJob* m_freeJobs{ nullptr };
+		std::mutex m_freeMutex;
+
+		// Jobs queued by threads without a deque and overflow of full deques
+		std::deque<PendingJob*> m_sharedJobs;
+		std::mutex m_sharedMutex;
+
+		// Jobs waiting for a dependency, listed by dependency and guarded by m_sharedMutex. They are not queued until it reaches zero
+		std::unordered_map<const JobCounter*, PendingJob*> m_parkedJobs;
+		std::atomic<std::uint32_t> m_parkedCount{ 0 };
+
+		// Queued jobs not taken yet, idle workers sleep while it is zero
+		std::atomic<std::uint32_t> m_queuedCount{ 0 };
+		std::atomic<std::uint32_t> m_sleepingCount{ 0 };
+		std::mutex m_sleepMutex;
+		std::condition_variable m_condition;
+		std::atomic<bool> m_running{ true };
+	};
+}
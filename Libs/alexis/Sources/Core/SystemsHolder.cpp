@@ -11,8 +11,10 @@
 #include <ECS/Components/LightComponent.h>
 #include <ECS/Components/NameComponent.h>
 #include <ECS/Components/DoNotSerializeComponent.h>
+#include <ECS/Components/HierarchyComponent.h>
 
 #include <ECS/Systems/ModelSystem.h>
+#include <ECS/Systems/TransformSystem.h>
 #include <ECS/Systems/ShadowSystem.h>
 #include <ECS/Systems/CameraSystem.h>
 #include <ECS/Systems/LightingSystem.h>
@@ -39,6 +41,7 @@ namespace alexis
 		ecsWorld.RegisterComponent<ecs::LightComponent>();
 		ecsWorld.RegisterComponent<ecs::NameComponent>();
 		ecsWorld.RegisterComponent<ecs::DoNotSerializeComponent>();
+		ecsWorld.RegisterComponent<ecs::HierarchyComponent>();
 
 		// Model System
 		m_modelSystem = ecsWorld.RegisterSystem<ecs::ModelSystem>();
@@ -48,6 +51,22 @@ namespace alexis
 		modelSystemMask.set(ecsWorld.GetComponentType<ecs::TransformComponent>());
 		ecsWorld.SetSystemComponentMask<ecs::ModelSystem>(modelSystemMask);
 
+		// No per-frame Update: models are only read by Extract, outside of the update graph
+
+		// Transform System
+		m_transformSystem = ecsWorld.RegisterSystem<ecs::TransformSystem>();
+
+		ecs::ComponentMask transformSystemMask;
+		transformSystemMask.set(ecsWorld.GetComponentType<ecs::TransformComponent>());
+		ecsWorld.SetSystemComponentMask<ecs::TransformSystem>(transformSystemMask);
+
+		// Update propagates world matrices into models
+		ecs::SystemAccess transformSystemAccess;
+		transformSystemAccess.Reads.set(ecsWorld.GetComponentType<ecs::TransformComponent>());
+		transformSystemAccess.Reads.set(ecsWorld.GetComponentType<ecs::HierarchyComponent>());
+		transformSystemAccess.Writes.set(ecsWorld.GetComponentType<ecs::ModelComponent>());
+		ecsWorld.SetSystemAccess<ecs::TransformSystem>(transformSystemAccess);
+
 		// Shadow System
 		m_shadowSystem = ecsWorld.RegisterSystem<ecs::ShadowSystem>();
 
@@ -64,6 +83,12 @@ namespace alexis
 		cameraSystemMask.set(ecsWorld.GetComponentType<ecs::TransformComponent>());
 		ecsWorld.SetSystemComponentMask<ecs::CameraSystem>(cameraSystemMask);
 
+		// Update refreshes view/projection matrices of moved cameras
+		ecs::SystemAccess cameraSystemAccess;
+		cameraSystemAccess.Writes.set(ecsWorld.GetComponentType<ecs::CameraComponent>());
+		cameraSystemAccess.Reads.set(ecsWorld.GetComponentType<ecs::TransformComponent>());
+		ecsWorld.SetSystemAccess<ecs::CameraSystem>(cameraSystemAccess);
+
 		m_environmentSystem = ecsWorld.RegisterSystem<ecs::EnvironmentSystem>();
 
 		// Lighting System
@@ -77,6 +102,11 @@ namespace alexis
 		m_hdr2SdrSystem = ecsWorld.RegisterSystem<ecs::Hdr2SdrSystem>();
 
 		m_imguiSystem = ecsWorld.RegisterSystem<ecs::ImguiSystem>();
+
+		// ImGui frame has to be started on the window thread
+		ecs::SystemAccess imguiSystemAccess;
+		imguiSystemAccess.MainThreadOnly = true;
+		ecsWorld.SetSystemAccess<ecs::ImguiSystem>(imguiSystemAccess);
 	}
 
 	void SystemsHolder::InitInternal()
@@ -5,6 +5,7 @@ namespace alexis
 	namespace ecs
 	{
 		class ModelSystem;
+		class TransformSystem;
 		class ShadowSystem;
 		class CameraSystem;
 		class LightingSystem;
@@ -23,6 +24,7 @@ namespace alexis
 		void InitInternal();
 
 		std::shared_ptr<alexis::ecs::ModelSystem> m_modelSystem;
+		std::shared_ptr<alexis::ecs::TransformSystem> m_transformSystem;
 		std::shared_ptr<alexis::ecs::ShadowSystem> m_shadowSystem;
 		std::shared_ptr<alexis::ecs::CameraSystem> m_cameraSystem;
 		std::shared_ptr<alexis::ecs::LightingSystem> m_lightingSystem;
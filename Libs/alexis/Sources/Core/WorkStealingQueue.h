@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace alexis
+{
+	// Lock-free bounded Chase-Lev deque of pointers (Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models").
+	// Owner thread pushes and pops at the bottom, any other thread steals from the top
+	template<class T, std::size_t Capacity = 4096>
+	class WorkStealingQueue
+	{
+		static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+	public:
+		WorkStealingQueue()
+		{
+			for (auto& item : m_items)
+			{
+				item.store(nullptr, std::memory_order_relaxed);
+			}
+		}
+
+		WorkStealingQueue(const WorkStealingQueue&) = delete;
+		WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+
+		// Owner only. Returns false if the queue is full
+		bool Push(T* item)
+		{
+			std::int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+			std::int64_t top = m_top.load(std::memory_order_acquire);
+			if (bottom - top >= static_cast<std::int64_t>(Capacity))
+			{
+				return false;
+			}
+
+			// Release on the slot as well as the fence, so a thief reading the item also sees what it points to
+			m_items[bottom & k_mask].store(item, std::memory_order_release);
+			std::atomic_thread_fence(std::memory_order_release);
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		// Owner only. Latest pushed item or nullptr
+		T* Pop()
+		{
+			std::int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+			m_bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			std::int64_t top = m_top.load(std::memory_order_relaxed);
+
+			if (top > bottom)
+			{
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			T* item = m_items[bottom & k_mask].load(std::memory_order_relaxed);
+			if (top == bottom)
+			{
+				// Last item, race the thieves for it
+				if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					item = nullptr;
+				}
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+
+			return item;
+		}
+
+		// Any thread. Oldest item, nullptr if empty or another thread took it first
+		T* Steal()
+		{
+			std::int64_t top = m_top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			std::int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+			if (top >= bottom)
+			{
+				return nullptr;
+			}
+
+			T* item = m_items[top & k_mask].load(std::memory_order_acquire);
+			if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				return nullptr;
+			}
+
+			return item;
+		}
+
+		bool IsEmpty() const
+		{
+			return m_top.load(std::memory_order_relaxed) >= m_bottom.load(std::memory_order_relaxed);
+		}
+
+	private:
+		static constexpr std::int64_t k_mask = static_cast<std::int64_t>(Capacity - 1);
+
+		// Owner and thieves write different ends, keep them on separate cache lines
+		alignas(64) std::atomic<std::int64_t> m_top{ 0 };
+		alignas(64) std::atomic<std::int64_t> m_bottom{ 0 };
+		alignas(64) std::array<std::atomic<T*>, Capacity> m_items;
+	};
+}
@@ -0,0 +1,191 @@
+#include <Precompiled.h>
+
+#include "Archetype.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace alexis
+{
+	namespace ecs
+	{
+		namespace
+		{
+			std::size_t AlignUp(std::size_t value, std::size_t alignment)
+			{
+				return (value + alignment - 1) & ~(alignment - 1);
+			}
+		}
+
+		Archetype::Archetype(ComponentMask componentMask, const std::array<ComponentInfo, k_maxComponents>& componentInfos, ChunkAllocator& chunkAllocator) :
+			m_componentMask(componentMask),
+			m_chunkAllocator(chunkAllocator)
+		{
+			m_columnIndices.fill(-1);
+
+			std::size_t rowSize = sizeof(Entity);
+			for (ComponentType type = 0; type < k_maxComponents; ++type)
+			{
+				if (!componentMask.test(type))
+				{
+					continue;
+				}
+
+				m_columnIndices[type] = static_cast<std::int8_t>(m_columns.size());
+				m_columns.push_back({ type, componentInfos[type], 0 });
+
+				rowSize += componentInfos[type].Size;
+			}
+
+			// Shrink capacity until the aligned columns fit into one chunk
+			m_chunkCapacity = static_cast<std::uint32_t>(k_chunkSize / rowSize);
+			while (m_chunkCapacity > 1 && CalculateLayout(m_chunkCapacity) > k_chunkSize)
+			{
+				--m_chunkCapacity;
+			}
+
+			assert(m_chunkCapacity > 0 && CalculateLayout(m_chunkCapacity) <= k_chunkSize && "Components do not fit into chunk!");
+		}
+
+		Archetype::~Archetype()
+		{
+			for (auto& chunk : m_chunks)
+			{
+				for (const auto& column : m_columns)
+				{
+					for (std::uint32_t i = 0; i < chunk.Count; ++i)
+					{
+						column.Info.Destroy(chunk.Data + column.Offset + column.Info.Size * i);
+					}
+				}
+
+				m_chunkAllocator.Free(chunk.Data);
+			}
+		}
+
+		std::uint32_t Archetype::AllocateRow(Entity entity, std::uint32_t changeVersion)
+		{
+			if (m_chunks.empty() || m_chunks.back().Count == m_chunkCapacity)
+			{
+				Chunk chunk;
+				chunk.Data = m_chunkAllocator.Allocate();
+				m_chunks.push_back(chunk);
+			}
+
+			auto& chunk = m_chunks.back();
+			std::uint32_t index = chunk.Count++;
+			reinterpret_cast<Entity*>(chunk.Data)[index] = entity;
+
+			std::fill_n(chunk.ChangeVersions.begin(), m_columns.size(), changeVersion);
+
+			return static_cast<std::uint32_t>(m_chunks.size() - 1) * m_chunkCapacity + index;
+		}
+
+		std::uint32_t Archetype::AllocateRows(const Entity* entities, std::uint32_t count, std::uint32_t changeVersion)
+		{
+			std::uint32_t firstRow = static_cast<std::uint32_t>(m_chunks.size()) * m_chunkCapacity;
+			if (!m_chunks.empty())
+			{
+				firstRow -= m_chunkCapacity - m_chunks.back().Count;
+			}
+
+			std::uint32_t allocated = 0;
+			while (allocated < count)
+			{
+				if (m_chunks.empty() || m_chunks.back().Count == m_chunkCapacity)
+				{
+					Chunk chunk;
+					chunk.Data = m_chunkAllocator.Allocate();
+					m_chunks.push_back(chunk);
+				}
+
+				auto& chunk = m_chunks.back();
+				std::uint32_t batch = std::min(count - allocated, m_chunkCapacity - chunk.Count);
+
+				std::memcpy(reinterpret_cast<Entity*>(chunk.Data) + chunk.Count, entities + allocated, sizeof(Entity) * batch);
+				std::fill_n(chunk.ChangeVersions.begin(), m_columns.size(), changeVersion);
+
+				chunk.Count += batch;
+				allocated += batch;
+			}
+
+			return firstRow;
+		}
+
+		void Archetype::CopyConstructRows(ComponentType type, std::uint32_t firstRow, std::uint32_t count, const void* prototype)
+		{
+			assert(m_columnIndices[type] >= 0 && "Archetype does not contain component!");
+
+			const auto& column = m_columns[m_columnIndices[type]];
+			assert(column.Info.CopyConstructN && "Component is not copyable!");
+
+			std::uint32_t row = firstRow;
+			std::uint32_t lastRow = firstRow + count;
+			while (row < lastRow)
+			{
+				std::uint32_t index = row % m_chunkCapacity;
+				std::uint32_t batch = std::min(lastRow - row, m_chunkCapacity - index);
+
+				auto& chunk = m_chunks[row / m_chunkCapacity];
+				column.Info.CopyConstructN(chunk.Data + column.Offset + column.Info.Size * index, prototype, batch);
+
+				row += batch;
+			}
+		}
+
+		Entity Archetype::FreeRow(std::uint32_t row, std::uint32_t changeVersion)
+		{
+			auto& chunk = m_chunks[row / m_chunkCapacity];
+			std::uint32_t index = row % m_chunkCapacity;
+
+			auto& lastChunk = m_chunks.back();
+			std::uint32_t lastIndex = lastChunk.Count - 1;
+
+			Entity movedEntity = k_invalidEntity;
+
+			for (const auto& column : m_columns)
+			{
+				void* removed = chunk.Data + column.Offset + column.Info.Size * index;
+				column.Info.Destroy(removed);
+
+				// Fill the hole with the last element to keep chunks packed
+				if (&chunk != &lastChunk || index != lastIndex)
+				{
+					void* last = lastChunk.Data + column.Offset + column.Info.Size * lastIndex;
+					column.Info.MoveConstruct(removed, last);
+					column.Info.Destroy(last);
+				}
+			}
+
+			if (&chunk != &lastChunk || index != lastIndex)
+			{
+				movedEntity = reinterpret_cast<Entity*>(lastChunk.Data)[lastIndex];
+				reinterpret_cast<Entity*>(chunk.Data)[index] = movedEntity;
+
+				// Row got new values
+				std::fill_n(chunk.ChangeVersions.begin(), m_columns.size(), changeVersion);
+			}
+
+			if (--lastChunk.Count == 0)
+			{
+				m_chunkAllocator.Free(lastChunk.Data);
+				m_chunks.pop_back();
+			}
+
+			return movedEntity;
+		}
+
+		std::size_t Archetype::CalculateLayout(std::uint32_t capacity)
+		{
+			std::size_t offset = sizeof(Entity) * capacity;
+			for (auto& column : m_columns)
+			{
+				offset = AlignUp(offset, column.Info.Alignment);
+				column.Offset = offset;
+				offset += column.Info.Size * capacity;
+			}
+
+			return offset;
+		}
+	}
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ECS/Types.h>
+#include <ECS/ChunkAllocator.h>
+
+namespace alexis
+{
+	namespace ecs
+	{
+		// Archetype storage
+		// Entities with the same component mask live together in fixed-size chunks.
+		// Every chunk is split into SoA columns: entity ids first, then one packed array per component type.
+		// Chunk memory comes from ChunkAllocator shared by all archetypes of a world.
+
+		// Type-erased operations needed to move component values between chunks
+		struct ComponentInfo
+		{
+			std::size_t Size{ 0 };
+			std::size_t Alignment{ 0 };
+
+			void (*MoveConstruct)(void* dst, void* src) { nullptr };
+			void (*Destroy)(void* ptr) { nullptr };
+
+			// Construct count copies of src at dst (null for non-copyable components)
+			void (*CopyConstructN)(void* dst, const void* src, std::size_t count) { nullptr };
+
+			template<class T>
+			static ComponentInfo Create()
+			{
+				static_assert(alignof(T) <= k_chunkAlignment, "Component alignment exceeds chunk alignment!");
+
+				ComponentInfo info;
+				info.Size = sizeof(T);
+				info.Alignment = alignof(T);
+				info.MoveConstruct = [](void* dst, void* src) { new (dst) T(std::move(*static_cast<T*>(src))); };
+				info.Destroy = [](void* ptr) { static_cast<T*>(ptr)->~T(); };
+
+				if constexpr (std::is_copy_constructible_v<T>)
+				{
+					info.CopyConstructN = [](void* dst, const void* src, std::size_t count) { std::uninitialized_fill_n(static_cast<T*>(dst), count, *static_cast<const T*>(src)); };
+				}
+				return info;
+			}
+		};
+
+		struct Chunk
+		{
+			std::byte* Data{ nullptr };
+			std::uint32_t Count{ 0 };
+
+			// Per column: change version of the last write (see View, Changed<T>)
+			std::array<std::uint32_t, k_maxComponents> ChangeVersions{};
+		};
+
+		class Archetype
+		{
+		public:
+			Archetype(ComponentMask componentMask, const std::array<ComponentInfo, k_maxComponents>& componentInfos, ChunkAllocator& chunkAllocator);
+			~Archetype();
+
+			Archetype(const Archetype&) = delete;
+			Archetype& operator=(const Archetype&) = delete;
+
+			ComponentMask GetComponentMask() const
+			{
+				return m_componentMask;
+			}
+
+			std::uint32_t GetChunkCapacity() const
+			{
+				return m_chunkCapacity;
+			}
+
+			std::size_t GetChunkCount() const
+			{
+				return m_chunks.size();
+			}
+
+			std::uint32_t GetEntityCount(std::size_t chunk) const
+			{
+				return m_chunks[chunk].Count;
+			}
+
+			const Entity* GetEntities(std::size_t chunk) const
+			{
+				return reinterpret_cast<const Entity*>(m_chunks[chunk].Data);
+			}
+
+			// Reserve a row at the end of the archetype. Components of the row are left unconstructed
+			// All columns of the chunk receiving the row are marked changed with changeVersion
+			std::uint32_t AllocateRow(Entity entity, std::uint32_t changeVersion);
+
+			// Same as AllocateRow for count entities. Rows are consecutive, returns the first one
+			std::uint32_t AllocateRows(const Entity* entities, std::uint32_t count, std::uint32_t changeVersion);
+
+			// Copy prototype into the column of count rows starting from firstRow, chunk by chunk
+			void CopyConstructRows(ComponentType type, std::uint32_t firstRow, std::uint32_t count, const void* prototype);
+
+			// Destroy components of the row and fill the hole with the last row
+			// Returns entity which was moved into the row or k_invalidEntity
+			Entity FreeRow(std::uint32_t row, std::uint32_t changeVersion);
+
+			std::size_t GetChunkIndex(std::uint32_t row) const
+			{
+				return row / m_chunkCapacity;
+			}
+
+			std::uint32_t GetChangeVersion(ComponentType type, std::size_t chunk) const
+			{
+				assert(m_columnIndices[type] >= 0 && "Archetype does not contain component!");
+
+				return m_chunks[chunk].ChangeVersions[m_columnIndices[type]];
+			}
+
+			void MarkChanged(ComponentType type, std::size_t chunk, std::uint32_t changeVersion)
+			{
+				assert(m_columnIndices[type] >= 0 && "Archetype does not contain component!");
+
+				m_chunks[chunk].ChangeVersions[m_columnIndices[type]] = changeVersion;
+			}
+
+			void* GetComponent(ComponentType type, std::uint32_t row)
+			{
+				assert(m_columnIndices[type] >= 0 && "Archetype does not contain component!");
+
+				const auto& column = m_columns[m_columnIndices[type]];
+				auto& chunk = m_chunks[row / m_chunkCapacity];
+				return chunk.Data + column.Offset + column.Info.Size * (row % m_chunkCapacity);
+			}
+
+			template<class T>
+			T* GetColumn(ComponentType type, std::size_t chunk)
+			{
+				assert(m_columnIndices[type] >= 0 && "Archetype does not contain component!");
+
+				const auto& column = m_columns[m_columnIndices[type]];
+				return reinterpret_cast<T*>(m_chunks[chunk].Data + column.Offset);
+			}
+
+			// Cached transitions to archetypes with one more/one less component
+			std::array<Archetype*, k_maxComponents> AddEdges{};
+			std::array<Archetype*, k_maxComponents> RemoveEdges{};
+
+		private:
+			struct Column
+			{
+				ComponentType Type{ 0 };
+				ComponentInfo Info;
+				std::size_t Offset{ 0 };
+			};
+
+			std::size_t CalculateLayout(std::uint32_t capacity);
+
+			ComponentMask m_componentMask;
+
+			std::vector<Column> m_columns;
+			std::array<std::int8_t, k_maxComponents> m_columnIndices;
+
+			std::vector<Chunk> m_chunks;
+			std::uint32_t m_chunkCapacity{ 0 };
+
+			ChunkAllocator& m_chunkAllocator;
+		};
+	}
+}
@@ -0,0 +1,56 @@
+#include <Precompiled.h>
+
+#include "ChunkAllocator.h"
+
+#include <new>
+
+namespace alexis
+{
+	namespace ecs
+	{
+		ChunkAllocator::~ChunkAllocator()
+		{
+			assert(m_freeChunkCount == m_slabs.size() * k_chunksPerSlab && "Chunks are still in use!");
+
+			for (auto* slab : m_slabs)
+			{
+				::operator delete(slab, std::align_val_t{ k_chunkAlignment });
+			}
+		}
+
+		std::byte* ChunkAllocator::Allocate()
+		{
+			if (!m_freeList)
+			{
+				AllocateSlab();
+			}
+
+			FreeChunk* chunk = m_freeList;
+			m_freeList = chunk->Next;
+			--m_freeChunkCount;
+
+			chunk->~FreeChunk();
+			return reinterpret_cast<std::byte*>(chunk);
+		}
+
+		void ChunkAllocator::Free(std::byte* chunk)
+		{
+			assert(chunk && "Freeing null chunk!");
+
+			m_freeList = new (chunk) FreeChunk{ m_freeList };
+			++m_freeChunkCount;
+		}
+
+		void ChunkAllocator::AllocateSlab()
+		{
+			auto* slab = static_cast<std::byte*>(::operator new(k_chunkSize * k_chunksPerSlab, std::align_val_t{ k_chunkAlignment }));
+			m_slabs.push_back(slab);
+
+			// Push in reverse so chunks are handed out in address order
+			for (std::size_t i = k_chunksPerSlab; i > 0; --i)
+			{
+				Free(slab + (i - 1) * k_chunkSize);
+			}
+		}
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace alexis
+{
+	namespace ecs
+	{
+		static constexpr std::size_t k_chunkSize = 16 * 1024;
+		static constexpr std::size_t k_chunkAlignment = 64;
+
+		// Pooled storage for archetype chunks
+		// Chunks are carved from aligned slabs and recycled through an intrusive free list:
+		// once the pool has grown to the peak chunk count, structural changes do not touch the heap.
+		// Not thread-safe, same as the structural changes using it.
+		class ChunkAllocator
+		{
+		public:
+			static constexpr std::size_t k_chunksPerSlab = 16;
+
+			ChunkAllocator() = default;
+			~ChunkAllocator();
+
+			ChunkAllocator(const ChunkAllocator&) = delete;
+			ChunkAllocator& operator=(const ChunkAllocator&) = delete;
+
+			// Returns k_chunkSize bytes aligned to k_chunkAlignment
+			std::byte* Allocate();
+			void Free(std::byte* chunk);
+
+			std::size_t GetSlabCount() const
+			{
+				return m_slabs.size();
+			}
+
+			std::size_t GetFreeChunkCount() const
+			{
+				return m_freeChunkCount;
+			}
+
+		private:
+			struct FreeChunk
+			{
+				FreeChunk* Next{ nullptr };
+			};
+
+			void AllocateSlab();
+
+			std::vector<std::byte*> m_slabs;
+
+			FreeChunk* m_freeList{ nullptr };
+			std::size_t m_freeChunkCount{ 0 };
+		};
+	}
+}
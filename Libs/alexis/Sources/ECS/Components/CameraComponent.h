@@ -6,59 +6,32 @@ namespace alexis
 {
 	namespace ecs
 	{
+		class CameraSystem;
+
 		struct CameraComponent
 		{
-			CameraComponent()
-			{
-				CameraData = static_cast<AlignedCameraData*>(_aligned_malloc(sizeof(AlignedCameraData), 16));
-			}
-
-			CameraComponent(float fov, float aspectRatio, float nearZ, float farZ, bool isOrtho) :
-				Fov(fov),
-				AspectRatio(aspectRatio),
-				NearZ(nearZ),
-				FarZ(farZ),
-				IsOrtho(isOrtho)
-			{
-				CameraData = static_cast<AlignedCameraData*>(_aligned_malloc(sizeof(AlignedCameraData), 16));
-			}
-
-			CameraComponent(const CameraComponent& other) :
-				Fov(other.Fov),
-				AspectRatio(other.AspectRatio),
-				NearZ(other.NearZ),
-				FarZ(other.FarZ),
-				IsOrtho(other.IsOrtho)
-			{
-				CameraData = static_cast<AlignedCameraData*>(_aligned_malloc(sizeof(AlignedCameraData), 16));
-				memcpy_s(CameraData, sizeof(AlignedCameraData), other.CameraData, sizeof(AlignedCameraData));
-			}
-
-			CameraComponent& operator=(const CameraComponent& other)
-			{
-				Fov = other.Fov;
-				AspectRatio = other.AspectRatio;
-				NearZ = other.NearZ;
-				FarZ = other.FarZ;
-				IsOrtho = other.IsOrtho;
-
-				CameraData = static_cast<AlignedCameraData*>(_aligned_malloc(sizeof(AlignedCameraData), 16));
-				memcpy_s(CameraData, sizeof(AlignedCameraData), other.CameraData, sizeof(AlignedCameraData));
-
-				return *this;
-			}
-
-			~CameraComponent()
+			// Vertical extent of orthographic projection in world units, width follows the aspect ratio
+			static constexpr float k_defaultOrthoHeight = 40.0f;
+
+			CameraComponent() = default;
+
+			CameraComponent(float fov, float aspectRatio, float nearZ, float farZ, bool isOrtho, float orthoHeight = k_defaultOrthoHeight) :
+				m_fov(fov),
+				m_aspectRatio(aspectRatio),
+				m_nearZ(nearZ),
+				m_farZ(farZ),
+				m_orthoHeight(orthoHeight),
+				m_isOrtho(isOrtho)
 			{
-				_aligned_free(CameraData);
-				CameraData = nullptr;
 			}
 
-			float Fov{ 45.0f };
-			float AspectRatio{ 1.0f };
-			float NearZ{ 0.01f };
-			float FarZ{ 100.0f };
-			bool IsOrtho{ false };
+			// Projection parameters are changed through CameraSystem only, so that Proj/InvProj never go stale
+			float GetFov() const { return m_fov; }
+			float GetAspectRatio() const { return m_aspectRatio; }
+			float GetNearZ() const { return m_nearZ; }
+			float GetFarZ() const { return m_farZ; }
+			float GetOrthoHeight() const { return m_orthoHeight; }
+			bool IsOrtho() const { return m_isOrtho; }
 
 			__declspec(align(16)) struct AlignedCameraData
 			{
@@ -69,12 +42,19 @@ namespace alexis
 				DirectX::XMMATRIX InvProj;
 			};
 
-			AlignedCameraData* CameraData{ nullptr };
+			// Kept up to date by CameraSystem
+			// Stored inline: archetype chunks honor component alignment
+			AlignedCameraData CameraData;
+
+		private:
+			friend class CameraSystem;
 
-			bool IsViewDirty{ true };
-			bool IsInvViewDirty{ true };
-			bool IsProjDirty{ true };
-			bool IsInvProjDirty{ true };
+			float m_fov{ 45.0f };
+			float m_aspectRatio{ 1.0f };
+			float m_nearZ{ 0.01f };
+			float m_farZ{ 100.0f };
+			float m_orthoHeight{ k_defaultOrthoHeight };
+			bool m_isOrtho{ false };
 		};
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <ECS/Types.h>
+
+namespace alexis
+{
+	namespace ecs
+	{
+		// Makes entity transform relative to Parent's one (see TransformSystem)
+		struct HierarchyComponent
+		{
+			Entity Parent;
+		};
+	}
+}
@@ -11,11 +11,16 @@ namespace alexis
 			enum class LightType
 			{
 				Point = 0,
-				Spot
+				Spot,
+				// Sun, shines along +Z of the transform and casts the shadow cascades. Only one is used
+				Directional
 			};
 
 			LightType Type{ LightType::Point };
 			DirectX::XMVECTOR Color;
+
+			// Spot only: cone half angle in radians, the cone points along +Z of the transform
+			float SpotAngle{ DirectX::XM_PIDIV4 };
 		};
 	}
 }
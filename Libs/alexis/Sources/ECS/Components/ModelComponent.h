@@ -11,18 +11,12 @@ namespace alexis
 	{
 		struct ModelComponent
 		{
-			struct Mat
-			{
-				DirectX::XMMATRIX ModelMatrix;
-				DirectX::XMMATRIX ModelViewMatrix;
-				DirectX::XMMATRIX ModelViewProjectionMatrix;
-			};
-
-			Mesh* Mesh;
-			Material* Material;
+			// Qualified: members reuse the type names
+			alexis::Mesh* Mesh;
+			alexis::Material* Material;
 
+			// Written by TransformSystem. Per-view matrices are not stored, passes combine it with RenderScene::Views
 			DirectX::XMMATRIX ModelMatrix;
-			bool IsTransformDirty{ true };
 		};
 	}
 }
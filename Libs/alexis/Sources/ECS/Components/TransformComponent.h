@@ -9,8 +9,6 @@ namespace alexis
 			DirectX::XMVECTOR Position;
 			DirectX::XMVECTOR Rotation;
 			float UniformScale;
-
-			bool IsTransformDirty;
 		};
 	}
 }
\ No newline at end of file
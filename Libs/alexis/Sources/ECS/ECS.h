@@ -1,14 +1,22 @@
 #pragma once
 
-#include <bitset>
 #include <cstdint>
-#include <queue>
+#include <algorithm>
+#include <iterator>
 #include <array>
+#include <atomic>
 #include <unordered_map>
 #include <memory>
-#include <set>
+#include <mutex>
+#include <vector>
+#include <type_traits>
+#include <utility>
 #include <cassert>
 
+#include <ECS/Types.h>
+#include <ECS/Archetype.h>
+#include <ECS/View.h>
+
 namespace alexis
 {
 	namespace ecs
@@ -16,239 +24,570 @@ namespace alexis
 		// ECS implementation
 		// Inspired by https://austinmorlan.com/posts/entity_component_system/#source-code
 
-		// Entity is simple int
-		using Entity = std::uint64_t;
-		const Entity k_maxEntities = 5000;
-
-		// Int type of component for mask
-		using ComponentType = std::uint8_t;
-		const ComponentType k_maxComponents = 32;
-
-		// bit mask for components belong to entity
-		using ComponentMask = std::bitset<k_maxComponents>;
-
 		class EntityManager
 		{
 		public:
-			EntityManager()
+			Entity CreateEntity()
 			{
-				for (Entity entity = 0; entity < k_maxEntities; ++entity)
+				Entity entity;
+
+				if (!m_freeIndices.empty())
 				{
-					m_availableEntities.push(entity);
+					entity.Index = m_freeIndices.back();
+					m_freeIndices.pop_back();
 				}
-			}
+				else
+				{
+					assert(m_generations.size() < k_invalidEntityIndex && "Total Entity number reached maximum entities per game!");
 
-			Entity CreateEntity()
-			{
-				assert(m_livingEntityCount < k_maxEntities && "Total Entity number reached maximum entities per game!");
+					entity.Index = static_cast<std::uint32_t>(m_generations.size());
+					m_generations.push_back(0);
+					m_componentMasks.emplace_back();
+				}
 
-				Entity id = m_availableEntities.front();
-				m_availableEntities.pop();
+				entity.Generation = m_generations[entity.Index];
 				++m_livingEntityCount;
 
-				return id;
+				return entity;
 			}
 
 			void DestroyEntity(Entity entity)
 			{
-				assert(entity < k_maxEntities && "Entity is out of range!");
+				assert(IsAlive(entity) && "Destroying dead or stale Entity!");
 
 				// Invalidate destroyed entity components componentMask
-				m_componentMasks[entity].reset();
+				m_componentMasks[entity.Index].reset();
 
-				m_availableEntities.push(entity);
+				// Bump generation: all handles to this entity become stale
+				++m_generations[entity.Index];
+
+				m_freeIndices.push_back(entity.Index);
 				--m_livingEntityCount;
 			}
 
+			bool IsAlive(Entity entity) const
+			{
+				return entity.Index < m_generations.size() && m_generations[entity.Index] == entity.Generation;
+			}
+
 			void SetComponentMask(Entity entity, ComponentMask componentMask)
 			{
-				assert(entity < k_maxEntities && "Entity is out of range!");
+				assert(IsAlive(entity) && "Entity is dead or stale!");
 
-				m_componentMasks[entity] = componentMask;
+				m_componentMasks[entity.Index] = componentMask;
 			}
 
-			ComponentMask GetComponentMask(Entity entity)
+			ComponentMask GetComponentMask(Entity entity) const
 			{
-				assert(entity < k_maxEntities && "Entity is out of range!");
+				assert(IsAlive(entity) && "Entity is dead or stale!");
 
-				return m_componentMasks[entity];
+				return m_componentMasks[entity.Index];
+			}
+
+			// Create count entities sharing componentMask
+			void CreateEntities(std::size_t count, ComponentMask componentMask, Entity* entities)
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					entities[i] = CreateEntity();
+					m_componentMasks[entities[i].Index] = componentMask;
+				}
+			}
+
+			std::uint32_t GetLivingEntityCount() const
+			{
+				return m_livingEntityCount;
 			}
 
 		private:
-			std::queue<Entity> m_availableEntities;
-			std::array<ComponentMask, k_maxEntities> m_componentMasks;
+			// Current generation per entity index
+			std::vector<std::uint32_t> m_generations;
+			std::vector<ComponentMask> m_componentMasks;
+
+			// Indices of destroyed entities ready for reuse
+			std::vector<std::uint32_t> m_freeIndices;
 
 			std::uint32_t m_livingEntityCount{ 0 };
 		};
 
-		// The one instance of virtual inheritance in the entire implementation.
-		// An interface is needed so that the ComponentManager (seen later)
-		// can tell a generic ComponentArray that an entity has been destroyed
-		// and that it needs to update its array mappings.
-		class IComponentArray
+		// Component Manager
+		// Owns archetypes and keeps track where every entity's components are stored
+		class ComponentManager
 		{
 		public:
-			virtual ~IComponentArray() = default;
-			virtual void EntityDestroyed(Entity entity) = 0;
-		};
+			template<class T>
+			void RegisterComponent()
+			{
+				ComponentType type = GetComponentTypeId<T>();
 
-		template<class T>
-		class ComponentArray : public IComponentArray
-		{
-		public:
-			void InsertData(Entity entity, T& component)
+				assert(!m_registeredComponents.test(type) && "Component has been already registered!");
+
+				m_registeredComponents.set(type);
+				m_componentInfos[type] = ComponentInfo::Create<T>();
+
+				if constexpr (k_isTagComponent<T>)
+				{
+					m_tagComponents.set(type);
+				}
+			}
+
+			// Bits of tag components, these never reach archetypes
+			ComponentMask GetTagMask() const
+			{
+				return m_tagComponents;
+			}
+
+			template<class T>
+			ComponentType GetComponentType()
 			{
-				assert(m_entityToIndexMap.find(entity) == m_entityToIndexMap.end() && "Trying add component to Entity that already has it!");
+				ComponentType type = GetComponentTypeId<T>();
 
-				std::size_t newIndex = m_size;
-				m_entityToIndexMap[entity] = newIndex;
-				m_indexToEntityMap[newIndex] = entity;
-				m_componentArray[newIndex] = std::move(component);
-				++m_size;
+				assert(m_registeredComponents.test(type) && "Component does not exist!");
+
+				return type;
 			}
 
-			void RemoveData(Entity entity)
+			template<class T>
+			void AddComponent(Entity entity, T&& component)
 			{
-				// Copy last elem to deleted elem
-				std::size_t indexOfRemovedEntity = m_entityToIndexMap[entity];
-				std::size_t indexOfLastElement = m_size - 1;
+				using ComponentT = std::decay_t<T>;
+
+				static_assert(!k_isTagComponent<ComponentT>, "Tags are stored in the entity mask only!");
 
-				std::swap(m_componentArray[indexOfRemovedEntity], m_componentArray[indexOfLastElement]);
+				ComponentType type = GetComponentType<ComponentT>();
+				auto& location = GetLocation(entity);
 
-				// Update map to point to moved spot
-				Entity entityOfLastElement = m_indexToEntityMap[indexOfLastElement];
-				m_entityToIndexMap[entityOfLastElement] = indexOfRemovedEntity;
-				m_indexToEntityMap[indexOfRemovedEntity] = entityOfLastElement;
+				assert((!location.Owner || !location.Owner->GetComponentMask().test(type)) && "Trying add component to Entity that already has it!");
+
+				Archetype* archetype = location.Owner ? location.Owner : GetArchetype(ComponentMask{});
+				Archetype* newArchetype = archetype->AddEdges[type];
+				if (!newArchetype)
+				{
+					newArchetype = GetArchetype(ComponentMask{ archetype->GetComponentMask() }.set(type));
+					archetype->AddEdges[type] = newArchetype;
+					newArchetype->RemoveEdges[type] = archetype;
+				}
 
-				m_entityToIndexMap.erase(entity);
-				m_indexToEntityMap.erase(indexOfLastElement);
-				--m_size;
+				std::uint32_t newRow = MoveEntity(entity, newArchetype);
+				new (newArchetype->GetComponent(type, newRow)) ComponentT(std::forward<T>(component));
 			}
 
-			T& GetData(Entity entity)
+			template<class T>
+			void RemoveComponent(Entity entity)
 			{
-				assert(m_entityToIndexMap.find(entity) != m_entityToIndexMap.end() && "Retrieving non-existent component.");
+				static_assert(!k_isTagComponent<T>, "Tags are stored in the entity mask only!");
+
+				ComponentType type = GetComponentType<T>();
+				auto& location = GetLocation(entity);
+
+				assert(location.Owner && location.Owner->GetComponentMask().test(type) && "Removing non-existent component.");
+
+				Archetype* archetype = location.Owner;
+				Archetype* newArchetype = archetype->RemoveEdges[type];
+				if (!newArchetype)
+				{
+					newArchetype = GetArchetype(ComponentMask{ archetype->GetComponentMask() }.reset(type));
+					archetype->RemoveEdges[type] = newArchetype;
+					newArchetype->AddEdges[type] = archetype;
+				}
 
-				return m_componentArray[m_entityToIndexMap[entity]];
+				MoveEntity(entity, newArchetype);
 			}
 
-			bool HasData(Entity entity)
+			// Non-const T marks the component as changed, use GetComponent<const T> for reading
+			template<class T>
+			T& GetComponent(Entity entity)
 			{
-				return m_entityToIndexMap.contains(entity);
+				using ComponentT = std::remove_const_t<T>;
+
+				static_assert(!k_isTagComponent<ComponentT>, "Tags have no value to retrieve!");
+
+				assert(HasComponent<ComponentT>(entity) && "Retrieving non-existent component.");
+
+				ComponentType type = GetComponentType<ComponentT>();
+				const auto& location = GetLocation(entity);
+
+				if constexpr (!std::is_const_v<T>)
+				{
+					location.Owner->MarkChanged(type, location.Owner->GetChunkIndex(location.Row), GetChangeVersion());
+				}
+
+				return *static_cast<T*>(location.Owner->GetComponent(type, location.Row));
 			}
 
-			void EntityDestroyed(Entity entity) override
+			// Change version of the chunk holding entity's T
+			template<class T>
+			std::uint32_t GetComponentChangeVersion(Entity entity)
 			{
-				// Remove component when entity is destroyed
-				if (m_entityToIndexMap.find(entity) != m_entityToIndexMap.end())
+				assert(HasComponent<T>(entity) && "Retrieving non-existent component.");
+
+				const auto& location = GetLocation(entity);
+				return location.Owner->GetChangeVersion(GetComponentType<T>(), location.Owner->GetChunkIndex(location.Row));
+			}
+
+			template<class T>
+			bool HasComponent(Entity entity)
+			{
+				const auto& location = GetLocation(entity);
+				return location.Owner && location.Owner->GetComponentMask().test(GetComponentType<std::remove_const_t<T>>());
+			}
+
+			void EntityDestroyed(Entity entity)
+			{
+				auto& location = GetLocation(entity);
+				if (!location.Owner)
 				{
-					RemoveData(entity);
+					return;
 				}
+
+				Entity movedEntity = location.Owner->FreeRow(location.Row, GetChangeVersion());
+				if (movedEntity != k_invalidEntity)
+				{
+					m_entityLocations[movedEntity.Index].Row = location.Row;
+				}
+
+				location = {};
 			}
 
-		private:
-			// Packed array of component of type T
-			std::array<T, k_maxEntities> m_componentArray;
+			// Apply several component changes with a single archetype move.
+			// components[type] (if set) is moved into the entity, replacing existing value. Tag bits are ignored
+			void SetComponents(Entity entity, ComponentMask componentMask, const std::array<void*, k_maxComponents>& components)
+			{
+				assert((componentMask & m_registeredComponents) == componentMask && "Component does not exist!");
 
-			// Map from entity ID to array index
-			std::unordered_map<Entity, std::size_t> m_entityToIndexMap;
+				componentMask &= ~m_tagComponents;
 
-			// Map from array index to entity ID
-			std::unordered_map<Entity, std::size_t> m_indexToEntityMap;
+				auto& location = GetLocation(entity);
+				ComponentMask oldMask = location.Owner ? location.Owner->GetComponentMask() : ComponentMask{};
 
-			// Total number of valid entries in array
-			std::size_t m_size{ 0 };
-		};
+				Archetype* archetype = location.Owner;
+				std::uint32_t row = location.Row;
+				if (!archetype || oldMask != componentMask)
+				{
+					archetype = GetArchetype(componentMask);
+					row = MoveEntity(entity, archetype);
+				}
 
-		// Component Manager
-		class ComponentManager
-		{
-		public:
-			template<class T>
-			void RegisterComponent()
+				for (ComponentType type = 0; type < k_maxComponents; ++type)
+				{
+					if (!componentMask.test(type) || !components[type])
+					{
+						continue;
+					}
+
+					void* component = archetype->GetComponent(type, row);
+					if (oldMask.test(type))
+					{
+						m_componentInfos[type].Destroy(component);
+					}
+
+					m_componentInfos[type].MoveConstruct(component, components[type]);
+					archetype->MarkChanged(type, archetype->GetChunkIndex(row), GetChangeVersion());
+				}
+			}
+
+			// Place new entities into the archetype of componentMask in one go, copying prototypes[type] into each
+			void InstantiateEntities(const Entity* entities, std::uint32_t count, ComponentMask componentMask, const std::array<void*, k_maxComponents>& prototypes)
 			{
-				const char* typeName = typeid(T).name();
+				componentMask &= ~m_tagComponents;
 
-				assert(m_componentTypes.find(typeName) == m_componentTypes.end() && "Component has been already registered!");
+				if (count == 0 || componentMask.none())
+				{
+					return;
+				}
 
-				m_componentTypes.insert({ typeName, m_nextComponentType });
+				Archetype* archetype = GetArchetype(componentMask);
+				std::uint32_t firstRow = archetype->AllocateRows(entities, count, GetChangeVersion());
 
-				m_componentArrays.insert({ typeName, std::make_shared<ComponentArray<T>>() });
+				for (ComponentType type = 0; type < k_maxComponents; ++type)
+				{
+					if (componentMask.test(type))
+					{
+						assert(prototypes[type] && "Missing component prototype!");
+						archetype->CopyConstructRows(type, firstRow, count, prototypes[type]);
+					}
+				}
+
+				for (std::uint32_t i = 0; i < count; ++i)
+				{
+					auto& location = GetLocation(entities[i]);
+					assert(!location.Owner && "Instantiating Entity which already has components!");
 
-				++m_nextComponentType;
+					location.Owner = archetype;
+					location.Row = firstRow + i;
+				}
 			}
 
-			template<class T>
-			ComponentType GetComponentType()
+			const ComponentInfo& GetComponentInfo(ComponentType type) const
 			{
-				const char* typeName = typeid(T).name();
+				assert(m_registeredComponents.test(type) && "Component does not exist!");
 
-				assert(m_componentTypes.find(typeName) != m_componentTypes.end() && "Component does not exist!");
+				return m_componentInfos[type];
+			}
+
+			template<class... Ts, class... Filters>
+			View<Ts...> GetView(const Filters&... filters)
+			{
+				static_assert(!(k_isTagComponent<Ts> || ...), "Tags have no storage to iterate, filter by them with System masks!");
 
-				return m_componentTypes[typeName];
+				ComponentMask queryMask;
+				(queryMask.set(GetComponentType<std::remove_const_t<Ts>>()), ...);
+
+				View<Ts...> view(GetQuery(queryMask), { GetComponentType<std::remove_const_t<Ts>>()... }, GetChangeVersion());
+				(view.AddChangedFilter(GetComponentType<typename Filters::ComponentT>(), filters.SinceVersion), ...);
+
+				return view;
 			}
 
-			template<class T>
-			void AddComponent(Entity entity, T& component)
+			// Version stamped on component writes
+			std::uint32_t GetChangeVersion() const
 			{
-				GetComponentArray<T>()->InsertData(entity, component);
+				return m_changeVersion.load(std::memory_order_relaxed);
 			}
 
-			template<class T>
-			void RemoveComponent(Entity entity, T component)
+			// Returns current version, writes after this call get a greater one
+			std::uint32_t AdvanceChangeVersion()
 			{
-				GetComponentArray<T>()->RemoveData(entity, component);
+				return m_changeVersion.fetch_add(1, std::memory_order_relaxed);
 			}
 
-			template<class T>
-			T& GetComponent(Entity entity)
+		private:
+			struct EntityLocation
 			{
-				return GetComponentArray<T>()->GetData(entity);
+				Archetype* Owner{ nullptr };
+				std::uint32_t Row{ 0 };
+			};
+
+			EntityLocation& GetLocation(Entity entity)
+			{
+				if (entity.Index >= m_entityLocations.size())
+				{
+					m_entityLocations.resize(entity.Index + 1);
+				}
+
+				return m_entityLocations[entity.Index];
 			}
 
-			template<class T>
-			bool HasComponent(Entity entity)
+			Archetype* GetArchetype(ComponentMask componentMask)
 			{
-				return GetComponentArray<T>()->HasData(entity);
+				auto it = m_archetypesByMask.find(componentMask);
+				if (it != m_archetypesByMask.end())
+				{
+					return it->second;
+				}
+
+				auto* archetype = m_archetypes.emplace_back(std::make_unique<Archetype>(componentMask, m_componentInfos, m_chunkAllocator)).get();
+				m_archetypesByMask.insert({ componentMask, archetype });
+
+				// Keep cached queries up to date instead of rescanning on every view
+				std::lock_guard<std::mutex> lock(m_queriesMutex);
+				for (const auto& [queryMask, query] : m_queries)
+				{
+					if ((componentMask & queryMask) == queryMask)
+					{
+						query->Archetypes.push_back(archetype);
+					}
+				}
+
+				return archetype;
 			}
 
-			void EntityDestroyed(Entity entity)
+			Query* GetQuery(ComponentMask queryMask)
 			{
-				// Notify each component array that entity has been destroyed
-				for (const auto& pair : m_componentArrays)
+				// Views can be requested concurrently from systems running in parallel
+				std::lock_guard<std::mutex> lock(m_queriesMutex);
+
+				auto it = m_queries.find(queryMask);
+				if (it != m_queries.end())
 				{
-					const auto& component = pair.second;
+					return it->second.get();
+				}
 
-					component->EntityDestroyed(entity);
+				auto query = std::make_unique<Query>();
+				query->Mask = queryMask;
+
+				for (const auto& archetype : m_archetypes)
+				{
+					if ((archetype->GetComponentMask() & queryMask) == queryMask)
+					{
+						query->Archetypes.push_back(archetype.get());
+					}
 				}
+
+				return m_queries.emplace(queryMask, std::move(query)).first->second.get();
 			}
 
-		private:
-			// Map from type string pointer to a component type
-			std::unordered_map<const char*, ComponentType> m_componentTypes;
+			// Move components shared by both archetypes, destroy the rest. Returns row in new archetype
+			std::uint32_t MoveEntity(Entity entity, Archetype* newArchetype)
+			{
+				auto& location = GetLocation(entity);
+				std::uint32_t newRow = newArchetype->AllocateRow(entity, GetChangeVersion());
 
-			// Map from type string pointer to a component array
-			std::unordered_map<const char*, std::shared_ptr<IComponentArray>> m_componentArrays;
+				if (location.Owner)
+				{
+					auto sharedMask = location.Owner->GetComponentMask() & newArchetype->GetComponentMask();
+					for (ComponentType type = 0; type < k_maxComponents; ++type)
+					{
+						if (sharedMask.test(type))
+						{
+							m_componentInfos[type].MoveConstruct(newArchetype->GetComponent(type, newRow), location.Owner->GetComponent(type, location.Row));
+						}
+					}
 
-			// Component type to be assigned for next registered component
-			ComponentType m_nextComponentType{ 0 };
+					Entity movedEntity = location.Owner->FreeRow(location.Row, GetChangeVersion());
+					if (movedEntity != k_invalidEntity)
+					{
+						m_entityLocations[movedEntity.Index].Row = location.Row;
+					}
+				}
+
+				location.Owner = newArchetype;
+				location.Row = newRow;
+
+				return newRow;
+			}
 
 			template<class T>
-			std::shared_ptr<ComponentArray<T>> GetComponentArray()
+			static ComponentType GetComponentTypeId()
 			{
-				const char* typeName = typeid(T).name();
+				std::uint32_t id = TypeIdGenerator<ComponentManager>::GetId<T>();
 
-				assert(m_componentTypes.find(typeName) != m_componentTypes.end() && "Component is not registered!");
+				assert(id < k_maxComponents && "Too many component types!");
 
-				return std::static_pointer_cast<ComponentArray<T>>(m_componentArrays[typeName]);
+				return static_cast<ComponentType>(id);
 			}
+
+			// Bit per registered component type
+			ComponentMask m_registeredComponents;
+			ComponentMask m_tagComponents;
+
+			// Layout and lifetime info per component type
+			std::array<ComponentInfo, k_maxComponents> m_componentInfos;
+
+			// Has to outlive archetypes
+			ChunkAllocator m_chunkAllocator;
+
+			std::vector<std::unique_ptr<Archetype>> m_archetypes;
+			std::unordered_map<ComponentMask, Archetype*> m_archetypesByMask;
+
+			// Cached archetype lists per queried component mask
+			std::unordered_map<ComponentMask, std::unique_ptr<Query>> m_queries;
+			std::mutex m_queriesMutex;
+
+			// Indexed by Entity::Index
+			std::vector<EntityLocation> m_entityLocations;
+
+			// Starts above zero so that everything is new for a system which never ran
+			std::atomic<std::uint32_t> m_changeVersion{ 1 };
 		};
 
 		// Systems
 
+		// Dense set of entities: packed array for iteration + sparse index by Entity::Index
+		class EntitySet
+		{
+		public:
+			void insert(Entity entity)
+			{
+				if (entity.Index >= m_sparse.size())
+				{
+					m_sparse.resize(entity.Index + 1, k_invalidEntityIndex);
+				}
+
+				auto& position = m_sparse[entity.Index];
+				if (position != k_invalidEntityIndex)
+				{
+					m_dense[position] = entity;
+					return;
+				}
+
+				position = static_cast<std::uint32_t>(m_dense.size());
+				m_dense.push_back(entity);
+				++m_version;
+			}
+
+			void erase(Entity entity)
+			{
+				if (!contains(entity))
+				{
+					return;
+				}
+
+				// Swap with last to keep entities packed
+				std::uint32_t position = m_sparse[entity.Index];
+				Entity last = m_dense.back();
+
+				m_dense[position] = last;
+				m_sparse[last.Index] = position;
+
+				m_dense.pop_back();
+				m_sparse[entity.Index] = k_invalidEntityIndex;
+				++m_version;
+			}
+
+			bool contains(Entity entity) const
+			{
+				return entity.Index < m_sparse.size() && m_sparse[entity.Index] != k_invalidEntityIndex && m_dense[m_sparse[entity.Index]] == entity;
+			}
+
+			std::size_t size() const
+			{
+				return m_dense.size();
+			}
+
+			bool empty() const
+			{
+				return m_dense.empty();
+			}
+
+			std::vector<Entity>::const_iterator begin() const
+			{
+				return m_dense.cbegin();
+			}
+
+			std::vector<Entity>::const_iterator end() const
+			{
+				return m_dense.cend();
+			}
+
+			const std::vector<Entity>& GetDense() const
+			{
+				return m_dense;
+			}
+
+			// Changes whenever an entity is inserted or erased
+			std::uint32_t GetVersion() const
+			{
+				return m_version;
+			}
+
+		private:
+			std::vector<Entity> m_dense;
+			std::vector<std::uint32_t> m_sparse;
+			std::uint32_t m_version{ 0 };
+		};
+
 		struct System
 		{
-			std::set<Entity> Entities;
+			EntitySet Entities;
+
+			// Change version at the start of previous Update, pass to Changed<T> to get what was written since
+			std::uint32_t LastSystemVersion{ 0 };
+		};
+
+		// Components a system reads and writes in its Update. Used to order and parallelize systems
+		struct SystemAccess
+		{
+			ComponentMask Reads;
+			ComponentMask Writes;
+
+			// System touches non thread-safe state (ImGui, window etc)
+			bool MainThreadOnly{ false };
+
+			bool ConflictsWith(const SystemAccess& other) const
+			{
+				return (Writes & (other.Reads | other.Writes)).any() || (other.Writes & Reads).any();
+			}
 		};
 
 		class SystemManager
@@ -257,74 +596,177 @@ namespace alexis
 			template<class T>
 			std::shared_ptr<T> RegisterSystem()
 			{
-				const char* typeName = typeid(T).name();
+				std::uint32_t id = TypeIdGenerator<SystemManager>::GetId<T>();
+				if (id >= m_systems.size())
+				{
+					m_systems.resize(id + 1);
+					m_componentMasks.resize(id + 1);
+					m_accesses.resize(id + 1);
+				}
 
-				assert(m_systems.find(typeName) == m_systems.end() && "System has been already registered!");
+				assert(!m_systems[id] && "System has been already registered!");
 
 				auto system = std::make_shared<T>();
-				m_systems.insert({ typeName, system });
+				m_systems[id] = system;
+
+				InvalidateMatchingSystems();
+
 				return system;
 			}
 
 			template<class T>
-			std::shared_ptr<T> GetSystem()
+			T* GetSystem()
 			{
-				const char* typeName = typeid(T).name();
+				std::uint32_t id = TypeIdGenerator<SystemManager>::GetId<T>();
 
-				auto it = m_systems.find(typeName);
-				assert(it != m_systems.end() && "System not found!");
+				assert(id < m_systems.size() && m_systems[id] && "System not found!");
 
-				return std::static_pointer_cast<T>(it->second);
+				return static_cast<T*>(m_systems[id].get());
 			}
 
 			template<class T>
 			void SetComponentMask(ComponentMask componentMask)
 			{
-				const char* typeName = typeid(T).name();
+				std::uint32_t id = TypeIdGenerator<SystemManager>::GetId<T>();
 
-				auto it = m_systems.find(typeName);
-				assert(it != m_systems.end() && "System not found!");
+				assert(id < m_systems.size() && m_systems[id] && "System not found!");
 
-				m_componentMasks.insert({ typeName, componentMask });
+				m_componentMasks[id] = componentMask;
+
+				InvalidateMatchingSystems();
 			}
 
-			void EntityDestroyed(Entity entity)
+			template<class T>
+			void SetAccess(const SystemAccess& access)
 			{
-				for (const auto& pair : m_systems)
-				{
-					const auto& system = pair.second;
+				std::uint32_t id = TypeIdGenerator<SystemManager>::GetId<T>();
 
-					system->Entities.erase(entity);
-				}
+				assert(id < m_systems.size() && m_systems[id] && "System not found!");
+
+				m_accesses[id] = access;
+			}
+
+			template<class T>
+			const SystemAccess& GetAccess() const
+			{
+				std::uint32_t id = TypeIdGenerator<SystemManager>::GetId<T>();
+
+				assert(id < m_systems.size() && m_systems[id] && "System not found!");
+
+				return m_accesses[id];
 			}
 
-			void EntityComponentMaskChanged(Entity entity, ComponentMask componentMask)
+			void EntityDestroyed(Entity entity, ComponentMask componentMask)
 			{
-				// Notify all systems that entity componentMask was changed
-				for (const auto& pair : m_systems)
+				for (auto id : GetMatchingSystems(componentMask))
 				{
-					const auto& type = pair.first;
-					const auto& system = pair.second;
-					const auto& systemComponentMask = m_componentMasks[type];
+					m_systems[id]->Entities.erase(entity);
+				}
+			}
 
-					if ((componentMask & systemComponentMask) == systemComponentMask)
+			// Batch version of EntityComponentMaskChanged for new entities sharing componentMask
+			void EntitiesCreated(const Entity* entities, std::size_t count, ComponentMask componentMask)
+			{
+				for (auto id : GetMatchingSystems(componentMask))
+				{
+					auto& system = m_systems[id];
+					for (std::size_t i = 0; i < count; ++i)
 					{
-						system->Entities.insert(entity);
+						system->Entities.insert(entities[i]);
 					}
-					else
+				}
+			}
+
+			// Only systems whose membership differs between the masks are touched
+			void EntityComponentMaskChanged(Entity entity, ComponentMask oldComponentMask, ComponentMask componentMask)
+			{
+				const auto& transition = GetMaskTransition(oldComponentMask, componentMask);
+
+				for (auto id : transition.Removed)
+				{
+					m_systems[id]->Entities.erase(entity);
+				}
+
+				for (auto id : transition.Added)
+				{
+					m_systems[id]->Entities.insert(entity);
+				}
+			}
+
+		private:
+			// System type id -> component mask
+			std::vector<ComponentMask> m_componentMasks;
+
+			// System type id -> declared component access
+			std::vector<SystemAccess> m_accesses;
+
+			// System type id -> System pointer
+			std::vector<std::shared_ptr<System>> m_systems;
+
+			struct MaskTransition
+			{
+				std::vector<std::uint32_t> Added;
+				std::vector<std::uint32_t> Removed;
+			};
+
+			// Ids of systems whose mask is satisfied by componentMask, ascending
+			const std::vector<std::uint32_t>& GetMatchingSystems(ComponentMask componentMask)
+			{
+				auto it = m_matchingSystems.find(componentMask);
+				if (it != m_matchingSystems.end())
+				{
+					return it->second;
+				}
+
+				std::vector<std::uint32_t> matchingSystems;
+				for (std::uint32_t id = 0; id < m_systems.size(); ++id)
+				{
+					// Systems without a component mask match every entity (e.g. the editor outliner)
+					if (m_systems[id] && (componentMask & m_componentMasks[id]) == m_componentMasks[id])
 					{
-						system->Entities.erase(entity);
+						matchingSystems.push_back(id);
 					}
 				}
+
+				return m_matchingSystems.emplace(componentMask, std::move(matchingSystems)).first->second;
 			}
 
-		private:
-			// Map System type -> component mask
-			std::unordered_map<const char*, ComponentMask> m_componentMasks;
+			const MaskTransition& GetMaskTransition(ComponentMask oldComponentMask, ComponentMask componentMask)
+			{
+				std::uint64_t key = (std::uint64_t{ oldComponentMask.to_ulong() } << k_maxComponents) | componentMask.to_ulong();
+
+				auto it = m_maskTransitions.find(key);
+				if (it != m_maskTransitions.end())
+				{
+					return it->second;
+				}
+
+				// Map nodes are stable, both references survive the second lookup
+				const auto& oldSystems = GetMatchingSystems(oldComponentMask);
+				const auto& newSystems = GetMatchingSystems(componentMask);
+
+				MaskTransition transition;
+				std::set_difference(newSystems.begin(), newSystems.end(), oldSystems.begin(), oldSystems.end(), std::back_inserter(transition.Added));
+				std::set_difference(oldSystems.begin(), oldSystems.end(), newSystems.begin(), newSystems.end(), std::back_inserter(transition.Removed));
+
+				return m_maskTransitions.emplace(key, std::move(transition)).first->second;
+			}
+
+			// System set or masks changed: cached matches are stale
+			void InvalidateMatchingSystems()
+			{
+				m_matchingSystems.clear();
+				m_maskTransitions.clear();
+			}
+
+			// Per distinct entity mask (archetype): matching systems
+			std::unordered_map<ComponentMask, std::vector<std::uint32_t>> m_matchingSystems;
+
+			// Per (old mask, new mask) pair: systems to join and leave
+			std::unordered_map<std::uint64_t, MaskTransition> m_maskTransitions;
+		};
 
-			// Map System type to System pointer
-			std::unordered_map<const char*, std::shared_ptr<System>> m_systems;
-		};;
+		class Prefab;
 
 		// ECS World
 		class World
@@ -339,14 +781,41 @@ namespace alexis
 
 			Entity CreateEntity()
 			{
-				return m_entityManager->CreateEntity();
+				Entity entity = m_entityManager->CreateEntity();
+				m_systemManager->EntitiesCreated(&entity, 1, ComponentMask{});
+
+				return entity;
 			}
 
+			// Create count entities without components
+			std::vector<Entity> CreateEntities(std::size_t count)
+			{
+				std::vector<Entity> entities(count);
+				m_entityManager->CreateEntities(count, ComponentMask{}, entities.data());
+				m_systemManager->EntitiesCreated(entities.data(), count, ComponentMask{});
+
+				return entities;
+			}
+
+			// Create count copies of prefab: single archetype allocation and system update for the batch
+			// Defined in ECS/Prefab.h
+			std::vector<Entity> CreateEntities(std::size_t count, const Prefab& prefab);
+
 			void DestroyEntity(Entity entity)
 			{
+				assert(IsAlive(entity) && "Destroying dead or stale Entity!");
+
+				ComponentMask componentMask = m_entityManager->GetComponentMask(entity);
+
 				m_entityManager->DestroyEntity(entity);
 				m_componentManager->EntityDestroyed(entity);
-				m_systemManager->EntityDestroyed(entity);
+				m_systemManager->EntityDestroyed(entity, componentMask);
+			}
+
+			// O(1) check that handle is not stale
+			bool IsAlive(Entity entity) const
+			{
+				return m_entityManager->IsAlive(entity);
 			}
 
 			// Component related
@@ -357,39 +826,85 @@ namespace alexis
 			}
 
 			template<class T>
-			void AddComponent(Entity entity, T component)
+			void AddComponent(Entity entity, T&& component)
 			{
-				m_componentManager->AddComponent<T>(entity, component);
+				using ComponentT = std::decay_t<T>;
+
+				assert(IsAlive(entity) && "Adding component to dead or stale Entity!");
+
+				auto oldComponentMask = m_entityManager->GetComponentMask(entity);
+				auto componentMask = oldComponentMask;
+				ComponentType type = m_componentManager->GetComponentType<ComponentT>();
+
+				// Tag is just the mask bit
+				if constexpr (k_isTagComponent<ComponentT>)
+				{
+					assert(!componentMask.test(type) && "Trying add component to Entity that already has it!");
+				}
+				else
+				{
+					m_componentManager->AddComponent(entity, std::forward<T>(component));
+				}
 
-				auto componentMask = m_entityManager->GetComponentMask(entity);
-				componentMask.set(m_componentManager->GetComponentType<T>(), true);
+				componentMask.set(type, true);
 				m_entityManager->SetComponentMask(entity, componentMask);
 
-				m_systemManager->EntityComponentMaskChanged(entity, componentMask);
+				m_systemManager->EntityComponentMaskChanged(entity, oldComponentMask, componentMask);
 			}
 
 			template<class T>
-			void RemoveComponent(Entity entity, T component)
+			void RemoveComponent(Entity entity)
 			{
-				m_componentManager->RemoveComponent<T>(entity, component);
+				assert(IsAlive(entity) && "Removing component from dead or stale Entity!");
 
-				auto componentMask = m_entityManager->GetComponentMask(entity);
-				componentMask.set(m_componentManager->GetComponentType<T>(), false);
+				auto oldComponentMask = m_entityManager->GetComponentMask(entity);
+				auto componentMask = oldComponentMask;
+				ComponentType type = m_componentManager->GetComponentType<T>();
+
+				if constexpr (k_isTagComponent<T>)
+				{
+					assert(componentMask.test(type) && "Removing non-existent component.");
+				}
+				else
+				{
+					m_componentManager->RemoveComponent<T>(entity);
+				}
+
+				componentMask.set(type, false);
 				m_entityManager->SetComponentMask(entity, componentMask);
 
-				m_systemManager->EntityComponentMaskChanged(entity, componentMask);
+				m_systemManager->EntityComponentMaskChanged(entity, oldComponentMask, componentMask);
 			}
 
+			// Non-const T marks the component as changed, use GetComponent<const T> for reading
 			template<class T>
 			T& GetComponent(Entity entity)
 			{
+				assert(IsAlive(entity) && "Accessing component of dead or stale Entity!");
+
 				return m_componentManager->GetComponent<T>(entity);
 			}
 
 			template<class T>
 			bool HasComponent(Entity entity)
 			{
-				return m_componentManager->HasComponent<T>(entity);
+				if constexpr (k_isTagComponent<T>)
+				{
+					return IsAlive(entity) && m_entityManager->GetComponentMask(entity).test(m_componentManager->GetComponentType<std::remove_const_t<T>>());
+				}
+				else
+				{
+					return IsAlive(entity) && m_componentManager->HasComponent<T>(entity);
+				}
+			}
+
+			// Last write to entity's T, tracked per chunk: compare with System::LastSystemVersion
+			template<class T>
+			std::uint32_t GetComponentChangeVersion(Entity entity)
+			{
+				assert(IsAlive(entity) && "Accessing component of dead or stale Entity!");
+
+				return m_componentManager->GetComponentChangeVersion<T>(entity);
 			}
 
 			template<class T>
@@ -398,6 +913,60 @@ namespace alexis
 				return m_componentManager->GetComponentType<T>();
 			}
 
+			const ComponentInfo& GetComponentInfo(ComponentType type) const
+			{
+				return m_componentManager->GetComponentInfo(type);
+			}
+
+			ComponentMask GetComponentMask(Entity entity) const
+			{
+				return m_entityManager->GetComponentMask(entity);
+			}
+
+			// Batched version of Add/RemoveComponent: entity ends up with exactly componentMask,
+			// moving in components[type] where set. Systems are notified once. Used by EntityCommandBuffer
+			void SetComponents(Entity entity, ComponentMask componentMask, const std::array<void*, k_maxComponents>& components)
+			{
+				assert(IsAlive(entity) && "Changing components of dead or stale Entity!");
+
+				ComponentMask oldComponentMask = m_entityManager->GetComponentMask(entity);
+
+				m_componentManager->SetComponents(entity, componentMask, components);
+				m_entityManager->SetComponentMask(entity, componentMask);
+
+				m_systemManager->EntityComponentMaskChanged(entity, oldComponentMask, componentMask);
+			}
+
+			// Entities having all of Ts, see View. Optional Changed<T> filters
+			template<class... Ts, class... Filters>
+			ecs::View<Ts...> View(const Filters&... filters)
+			{
+				return m_componentManager->GetView<Ts...>(filters...);
+			}
+
+			std::uint32_t GetChangeVersion() const
+			{
+				return m_componentManager->GetChangeVersion();
+			}
+
+			// Called before each system Update, result is stored as System::LastSystemVersion afterwards
+			std::uint32_t AdvanceChangeVersion()
+			{
+				return m_componentManager->AdvanceChangeVersion();
+			}
+
+			template<class... Ts, class Func, class... Filters>
+			void ForEachChunk(Func&& func, const Filters&... filters)
+			{
+				m_componentManager->GetView<Ts...>(filters...).ForEachChunk(std::forward<Func>(func));
+			}
+
+			template<class... Ts, class Executor, class Func, class... Filters>
+			void ParallelForEachChunk(Executor& executor, Func&& func, const Filters&... filters)
+			{
+				m_componentManager->GetView<Ts...>(filters...).ParallelForEachChunk(executor, std::forward<Func>(func));
+			}
+
 			// System related
 			template<class T>
 			std::shared_ptr<T> RegisterSystem()
@@ -412,7 +981,19 @@ namespace alexis
 			}
 
 			template<class T>
-			std::shared_ptr<T> GetSystem()
+			void SetSystemAccess(const SystemAccess& access)
+			{
+				m_systemManager->SetAccess<T>(access);
+			}
+
+			template<class T>
+			const SystemAccess& GetSystemAccess() const
+			{
+				return m_systemManager->GetAccess<T>();
+			}
+
+			template<class T>
+			T* GetSystem()
 			{
 				return m_systemManager->GetSystem<T>();
 			}
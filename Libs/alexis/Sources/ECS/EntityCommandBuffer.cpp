@@ -0,0 +1,193 @@
+#include <Precompiled.h>
+
+#include "EntityCommandBuffer.h"
+
+#include <algorithm>
+
+namespace alexis
+{
+	namespace ecs
+	{
+		EntityCommandBuffer::EntityCommandBuffer(World& world)
+			: m_world(world)
+		{
+		}
+
+		EntityCommandBuffer::~EntityCommandBuffer()
+		{
+			// Commands never played back still own their payloads
+			for (const auto& command : m_commands)
+			{
+				DestroyPayload(command);
+			}
+
+			for (const auto& page : m_pages)
+			{
+				::operator delete(page.Data, std::align_val_t{ k_chunkAlignment });
+			}
+		}
+
+		Entity EntityCommandBuffer::CreateEntity()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			Entity entity{ m_deferredEntityCount++, k_deferredGeneration };
+			m_commands.push_back({ CommandType::CreateEntity, entity, 0, nullptr });
+
+			return entity;
+		}
+
+		void EntityCommandBuffer::DestroyEntity(Entity entity)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_commands.push_back({ CommandType::DestroyEntity, entity, 0, nullptr });
+		}
+
+		void EntityCommandBuffer::Playback()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (m_commands.empty())
+			{
+				return;
+			}
+
+			// Resolve placeholders in creation order
+			std::vector<Entity> createdEntities = m_world.CreateEntities(m_deferredEntityCount);
+
+			for (auto& command : m_commands)
+			{
+				if (IsDeferred(command.Target))
+				{
+					assert(command.Target.Index < createdEntities.size() && "Entity placeholder from another command buffer!");
+					command.Target = createdEntities[command.Target.Index];
+				}
+			}
+
+			// Group commands by entity, keeping recording order inside each group
+			std::stable_sort(m_commands.begin(), m_commands.end(), [](const Command& lhs, const Command& rhs)
+			{
+				return lhs.Target.Index < rhs.Target.Index;
+			});
+
+			std::size_t first = 0;
+			while (first < m_commands.size())
+			{
+				Entity entity = m_commands[first].Target;
+
+				std::size_t last = first;
+				while (last < m_commands.size() && m_commands[last].Target.Index == entity.Index)
+				{
+					++last;
+				}
+
+				assert(m_world.IsAlive(entity) && "Command recorded for dead or stale Entity!");
+
+				ComponentMask componentMask = m_world.GetComponentMask(entity);
+				std::array<void*, k_maxComponents> components{};
+				bool isDestroyed = false;
+
+				// Only the final state per component matters
+				for (std::size_t i = first; i < last; ++i)
+				{
+					const auto& command = m_commands[i];
+					switch (command.Type)
+					{
+					case CommandType::DestroyEntity:
+						isDestroyed = true;
+						break;
+
+					case CommandType::AddComponent:
+						if (components[command.Component])
+						{
+							m_world.GetComponentInfo(command.Component).Destroy(components[command.Component]);
+						}
+						components[command.Component] = command.Payload;
+						componentMask.set(command.Component);
+						break;
+
+					case CommandType::RemoveComponent:
+						if (components[command.Component])
+						{
+							m_world.GetComponentInfo(command.Component).Destroy(components[command.Component]);
+							components[command.Component] = nullptr;
+						}
+						componentMask.reset(command.Component);
+						break;
+
+					default:
+						break;
+					}
+				}
+
+				if (isDestroyed)
+				{
+					m_world.DestroyEntity(entity);
+				}
+				else if (componentMask != m_world.GetComponentMask(entity) || std::any_of(components.begin(), components.end(), [](void* component) { return component != nullptr; }))
+				{
+					m_world.SetComponents(entity, componentMask, components);
+				}
+
+				// Values are moved into the world (or dropped), release moved-from payloads
+				for (ComponentType type = 0; type < k_maxComponents; ++type)
+				{
+					if (components[type])
+					{
+						m_world.GetComponentInfo(type).Destroy(components[type]);
+					}
+				}
+
+				first = last;
+			}
+
+			Reset();
+		}
+
+		void* EntityCommandBuffer::AllocatePayload(std::size_t size, std::size_t alignment)
+		{
+			while (m_currentPage < m_pages.size())
+			{
+				auto& page = m_pages[m_currentPage];
+
+				std::size_t offset = (m_pageOffset + alignment - 1) & ~(alignment - 1);
+				if (offset + size <= page.Size)
+				{
+					m_pageOffset = offset + size;
+					return page.Data + offset;
+				}
+
+				++m_currentPage;
+				m_pageOffset = 0;
+			}
+
+			Page page;
+			page.Size = std::max(k_chunkSize, size);
+			page.Data = static_cast<std::byte*>(::operator new(page.Size, std::align_val_t{ k_chunkAlignment }));
+			m_pages.push_back(page);
+
+			m_currentPage = m_pages.size() - 1;
+			m_pageOffset = size;
+
+			return page.Data;
+		}
+
+		void EntityCommandBuffer::DestroyPayload(const Command& command)
+		{
+			if (command.Type == CommandType::AddComponent && command.Payload)
+			{
+				m_world.GetComponentInfo(command.Component).Destroy(command.Payload);
+			}
+		}
+
+		void EntityCommandBuffer::Reset()
+		{
+			m_commands.clear();
+			m_deferredEntityCount = 0;
+
+			// Keep pages for the next recording
+			m_currentPage = 0;
+			m_pageOffset = 0;
+		}
+	}
+}
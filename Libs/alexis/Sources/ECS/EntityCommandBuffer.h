@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ECS/ECS.h>
+
+namespace alexis
+{
+	namespace ecs
+	{
+		// Records structural changes (create/destroy entity, add/remove component) and applies them later
+		// in one pass. Recording is thread-safe. On Playback all commands of one entity are merged,
+		// so the entity is moved between archetypes and re-matched against systems only once.
+		class EntityCommandBuffer
+		{
+		public:
+			explicit EntityCommandBuffer(World& world);
+			~EntityCommandBuffer();
+
+			EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+			EntityCommandBuffer& operator=(const EntityCommandBuffer&) = delete;
+
+			// Returns placeholder handle. Can be used with this buffer only, real Entity is created on Playback
+			Entity CreateEntity();
+
+			void DestroyEntity(Entity entity);
+
+			// Adding a component the entity already has replaces its value
+			template<class T>
+			void AddComponent(Entity entity, T&& component)
+			{
+				using ComponentT = std::decay_t<T>;
+
+				ComponentType type = m_world.GetComponentType<ComponentT>();
+
+				std::lock_guard<std::mutex> lock(m_mutex);
+
+				// Tags carry no payload, only the mask bit
+				void* payload = nullptr;
+				if constexpr (!k_isTagComponent<ComponentT>)
+				{
+					payload = AllocatePayload(sizeof(ComponentT), alignof(ComponentT));
+					new (payload) ComponentT(std::forward<T>(component));
+				}
+
+				m_commands.push_back({ CommandType::AddComponent, entity, type, payload });
+			}
+
+			template<class T>
+			void RemoveComponent(Entity entity)
+			{
+				ComponentType type = m_world.GetComponentType<T>();
+
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_commands.push_back({ CommandType::RemoveComponent, entity, type, nullptr });
+			}
+
+			// Apply all recorded commands to the world. Must be called from the thread owning the world
+			void Playback();
+
+			bool IsEmpty() const
+			{
+				return m_commands.empty();
+			}
+
+			static bool IsDeferred(Entity entity)
+			{
+				return entity.Generation == k_deferredGeneration;
+			}
+
+		private:
+			static constexpr std::uint32_t k_deferredGeneration = std::numeric_limits<std::uint32_t>::max();
+
+			enum class CommandType : std::uint8_t
+			{
+				CreateEntity,
+				DestroyEntity,
+				AddComponent,
+				RemoveComponent
+			};
+
+			struct Command
+			{
+				CommandType Type;
+				Entity Target;
+				ComponentType Component;
+
+				// Component value for AddComponent, lives in m_pages
+				void* Payload;
+			};
+
+			struct Page
+			{
+				std::byte* Data{ nullptr };
+				std::size_t Size{ 0 };
+			};
+
+			void* AllocatePayload(std::size_t size, std::size_t alignment);
+			void DestroyPayload(const Command& command);
+			void Reset();
+
+			World& m_world;
+
+			std::mutex m_mutex;
+			std::vector<Command> m_commands;
+			std::uint32_t m_deferredEntityCount{ 0 };
+
+			// Payloads never move once recorded: pages are only appended
+			std::vector<Page> m_pages;
+			std::size_t m_currentPage{ 0 };
+			std::size_t m_pageOffset{ 0 };
+		};
+	}
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ECS/ECS.h>
+
+namespace alexis
+{
+	namespace ecs
+	{
+		// Component template for World::CreateEntities
+		// Every instance gets a copy of each component set on the prefab
+		class Prefab
+		{
+		public:
+			explicit Prefab(World& world) :
+				m_world(world)
+			{
+			}
+
+			~Prefab()
+			{
+				for (ComponentType type = 0; type < k_maxComponents; ++type)
+				{
+					if (m_components[type])
+					{
+						m_componentInfos[type].Destroy(m_components[type]);
+						::operator delete(m_components[type], std::align_val_t{ m_componentInfos[type].Alignment });
+					}
+				}
+			}
+
+			Prefab(const Prefab&) = delete;
+			Prefab& operator=(const Prefab&) = delete;
+
+			// Add component or replace its value
+			template<class T>
+			Prefab& Set(T&& component)
+			{
+				using ComponentT = std::decay_t<T>;
+
+				static_assert(std::is_copy_constructible_v<ComponentT>, "Prefab components have to be copyable!");
+
+				ComponentType type = m_world.GetComponentType<ComponentT>();
+
+				// Tags are instantiated from the mask alone
+				if constexpr (k_isTagComponent<ComponentT>)
+				{
+					m_componentMask.set(type);
+					return *this;
+				}
+
+				if (m_components[type])
+				{
+					*static_cast<ComponentT*>(m_components[type]) = std::forward<T>(component);
+					return *this;
+				}
+
+				m_componentInfos[type] = ComponentInfo::Create<ComponentT>();
+				m_components[type] = ::operator new(sizeof(ComponentT), std::align_val_t{ alignof(ComponentT) });
+				new (m_components[type]) ComponentT(std::forward<T>(component));
+
+				m_componentMask.set(type);
+
+				return *this;
+			}
+
+			template<class T>
+			T& Get()
+			{
+				static_assert(!k_isTagComponent<T>, "Tags have no value to retrieve!");
+
+				ComponentType type = m_world.GetComponentType<T>();
+
+				assert(m_components[type] && "Prefab does not contain component!");
+
+				return *static_cast<T*>(m_components[type]);
+			}
+
+			template<class T>
+			bool Has() const
+			{
+				return m_componentMask.test(m_world.GetComponentType<T>());
+			}
+
+			ComponentMask GetComponentMask() const
+			{
+				return m_componentMask;
+			}
+
+			// Per component type: prototype value or nullptr
+			const std::array<void*, k_maxComponents>& GetComponents() const
+			{
+				return m_components;
+			}
+
+		private:
+			World& m_world;
+
+			ComponentMask m_componentMask;
+			std::array<void*, k_maxComponents> m_components{};
+			std::array<ComponentInfo, k_maxComponents> m_componentInfos;
+		};
+
+		inline std::vector<Entity> World::CreateEntities(std::size_t count, const Prefab& prefab)
+		{
+			std::vector<Entity> entities(count);
+
+			ComponentMask componentMask = prefab.GetComponentMask();
+			m_entityManager->CreateEntities(count, componentMask, entities.data());
+			m_componentManager->InstantiateEntities(entities.data(), static_cast<std::uint32_t>(count), componentMask, prefab.GetComponents());
+			m_systemManager->EntitiesCreated(entities.data(), count, componentMask);
+
+			return entities;
+		}
+	}
+}
@@ -3,6 +3,7 @@
 #include "CameraSystem.h"
 
 #include <Core/Core.h>
+#include <Render/RenderScene.h>
 #include <ECS/Components/CameraComponent.h>
 #include <ECS/Components/TransformComponent.h>
 
@@ -21,6 +22,44 @@ namespace alexis
 			m_activeCamera = cameraEntity;
 		}
 
+		void CameraSystem::Update(float dt)
+		{
+			auto& ecsWorld = Core::Get().GetECSWorld();
+
+			// Setters below keep matrices up to date, catch transforms written directly (editor, new cameras).
+			// Projection parameters are private to the component, so they cannot change behind the setters' back
+			ecsWorld.ForEachChunk<CameraComponent, const TransformComponent>([](std::size_t count, const Entity* entities, CameraComponent* cameras, const TransformComponent* transforms)
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					UpdateViewMatrices(cameras[i], transforms[i]);
+					UpdateProjMatrices(cameras[i]);
+				}
+			}, Changed<TransformComponent>{ LastSystemVersion });
+		}
+
+		void CameraSystem::Extract(RenderScene& renderScene) const
+		{
+			auto& ecsWorld = Core::Get().GetECSWorld();
+
+			if (!ecsWorld.IsAlive(m_activeCamera))
+			{
+				return;
+			}
+
+			ExtractView(m_activeCamera, renderScene.Views[RenderScene::k_mainView]);
+		}
+
+		void CameraSystem::ExtractView(Entity entity, ViewData& viewData) const
+		{
+			auto& ecsWorld = Core::Get().GetECSWorld();
+			const auto& cameraComponent = ecsWorld.GetComponent<const CameraComponent>(entity);
+			const auto& transformComponent = ecsWorld.GetComponent<const TransformComponent>(entity);
+			const auto& cameraData = cameraComponent.CameraData;
+
+			BuildViewData(transformComponent.Position, cameraData.View, cameraData.InvView, cameraData.Proj, cameraData.InvProj, viewData);
+		}
+
 		void XM_CALLCONV CameraSystem::SetPosition(Entity entity, DirectX::FXMVECTOR position)
 		{
 			auto& ecsWorld = Core::Get().GetECSWorld();
@@ -29,8 +68,7 @@ namespace alexis
 
 			transformComponent.Position = position;
 
-			cameraComponent.IsViewDirty = true;
-			cameraComponent.IsInvViewDirty = true;
+			UpdateViewMatrices(cameraComponent, transformComponent);
 		}
 
 		void XM_CALLCONV CameraSystem::SetRotation(Entity entity, DirectX::FXMVECTOR rotation)
@@ -41,8 +79,7 @@ namespace alexis
 
 			transformComponent.Rotation = rotation;
 
-			cameraComponent.IsViewDirty = true;
-			cameraComponent.IsInvViewDirty = true;
+			UpdateViewMatrices(cameraComponent, transformComponent);
 		}
 
 		void XM_CALLCONV CameraSystem::SetTransform(Entity entity, DirectX::FXMVECTOR position, DirectX::FXMVECTOR rotation)
@@ -54,72 +91,51 @@ namespace alexis
 			transformComponent.Position = position;
 			transformComponent.Rotation = rotation;
 
-			cameraComponent.IsViewDirty = true;
-			cameraComponent.IsInvViewDirty = true;
+			UpdateViewMatrices(cameraComponent, transformComponent);
 		}
 
 		DirectX::XMMATRIX CameraSystem::GetViewMatrix(Entity entity) const
 		{
 			auto& ecsWorld = Core::Get().GetECSWorld();
-			auto& cameraComponent = ecsWorld.GetComponent<CameraComponent>(entity);
-
-			if (cameraComponent.IsViewDirty)
-			{
-				UpdateViewMatrix(entity);
-			}
+			const auto& cameraComponent = ecsWorld.GetComponent<const CameraComponent>(entity);
 
-			return cameraComponent.CameraData->View;
+			return cameraComponent.CameraData.View;
 		}
 
 		DirectX::XMMATRIX CameraSystem::GetInvViewMatrix(Entity entity) const
 		{
 			auto& ecsWorld = Core::Get().GetECSWorld();
-			auto& cameraComponent = ecsWorld.GetComponent<CameraComponent>(entity);
-
-			if (cameraComponent.IsInvViewDirty)
-			{
-				UpdateInvViewMatrix(entity);
-			}
+			const auto& cameraComponent = ecsWorld.GetComponent<const CameraComponent>(entity);
 
-			return cameraComponent.CameraData->InvView;
+			return cameraComponent.CameraData.InvView;
 		}
 
 		DirectX::XMMATRIX CameraSystem::GetProjMatrix(Entity entity) const
 		{
 			auto& ecsWorld = Core::Get().GetECSWorld();
-			auto& cameraComponent = ecsWorld.GetComponent<CameraComponent>(entity);
-
-			if (cameraComponent.IsProjDirty)
-			{
-				UpdateProjMatrix(entity);
-			}
+			const auto& cameraComponent = ecsWorld.GetComponent<const CameraComponent>(entity);
 
-			return cameraComponent.CameraData->Proj;
+			return cameraComponent.CameraData.Proj;
 		}
 
 		DirectX::XMMATRIX CameraSystem::GetInvProjMatrix(Entity entity) const
 		{
 			auto& ecsWorld = Core::Get().GetECSWorld();
-			auto& cameraComponent = ecsWorld.GetComponent<CameraComponent>(entity);
-
-			if (cameraComponent.IsInvProjDirty)
-			{
-				UpdateInvProjMatrix(entity);
-			}
+			const auto& cameraComponent = ecsWorld.GetComponent<const CameraComponent>(entity);
 
-			return cameraComponent.CameraData->InvProj;
+			return cameraComponent.CameraData.InvProj;
 		}
 
 		void CameraSystem::SetFov(Entity entity, float fov)
 		{
 			auto& ecsWorld = Core::Get().GetECSWorld();
-			auto& cameraComponent = ecsWorld.GetComponent<CameraComponent>(entity);
 
-			if (!IsEqual(cameraComponent.Fov, fov))
+			if (!IsEqual(ecsWorld.GetComponent<const CameraComponent>(entity).GetFov(), fov))
 			{
-				cameraComponent.Fov = fov;
-				cameraComponent.IsProjDirty = true;
-				cameraComponent.IsInvProjDirty = true;
+				auto& cameraComponent = ecsWorld.GetComponent<CameraComponent>(entity);
+				cameraComponent.m_fov = fov;
+
+				UpdateProjMatrices(cameraComponent);
 			}
 		}
 
@@ -128,88 +144,62 @@ namespace alexis
 			auto& ecsWorld = Core::Get().GetECSWorld();
 			auto& cameraComponent = ecsWorld.GetComponent<CameraComponent>(entity);
 
-			cameraComponent.Fov = fov;
-			cameraComponent.AspectRatio = aspectRatio;
-			cameraComponent.NearZ = nearZ;
-			cameraComponent.FarZ = farZ;
+			cameraComponent.m_fov = fov;
+			cameraComponent.m_aspectRatio = aspectRatio;
+			cameraComponent.m_nearZ = nearZ;
+			cameraComponent.m_farZ = farZ;
 
-			cameraComponent.IsProjDirty = true;
-			cameraComponent.IsInvProjDirty = true;
+			UpdateProjMatrices(cameraComponent);
 		}
 
-		void CameraSystem::LookAt(Entity entity, DirectX::XMVECTOR targetPos, DirectX::XMVECTOR up) const
+		void CameraSystem::SetOrthoHeight(Entity entity, float height)
 		{
 			auto& ecsWorld = Core::Get().GetECSWorld();
-			auto& cameraComponent = ecsWorld.GetComponent<CameraComponent>(entity);
-			auto& transformComponent = ecsWorld.GetComponent<TransformComponent>(entity);
 
-			auto mat = XMMatrixLookAtLH(transformComponent.Position, targetPos, up);
-			transformComponent.Rotation = XMQuaternionRotationMatrix(XMMatrixTranspose(mat));
+			if (!IsEqual(ecsWorld.GetComponent<const CameraComponent>(entity).GetOrthoHeight(), height))
+			{
+				auto& cameraComponent = ecsWorld.GetComponent<CameraComponent>(entity);
+				cameraComponent.m_orthoHeight = height;
 
-			cameraComponent.IsViewDirty = true;
-			cameraComponent.IsInvViewDirty = true;
+				UpdateProjMatrices(cameraComponent);
+			}
 		}
 
-		void CameraSystem::UpdateViewMatrix(Entity entity) const
+		void CameraSystem::LookAt(Entity entity, DirectX::XMVECTOR targetPos, DirectX::XMVECTOR up) const
 		{
 			auto& ecsWorld = Core::Get().GetECSWorld();
 			auto& cameraComponent = ecsWorld.GetComponent<CameraComponent>(entity);
 			auto& transformComponent = ecsWorld.GetComponent<TransformComponent>(entity);
 
-			XMMATRIX translationMatrix = XMMatrixTranslationFromVector(-(transformComponent.Position));
-			XMMATRIX rotationMatrix = XMMatrixTranspose(XMMatrixRotationQuaternion(transformComponent.Rotation));
-
-			cameraComponent.CameraData->View = translationMatrix * rotationMatrix;
+			auto mat = XMMatrixLookAtLH(transformComponent.Position, targetPos, up);
+			transformComponent.Rotation = XMQuaternionRotationMatrix(XMMatrixTranspose(mat));
 
-			cameraComponent.IsInvViewDirty = true;
-			cameraComponent.IsViewDirty = false;
+			UpdateViewMatrices(cameraComponent, transformComponent);
 		}
 
-		void CameraSystem::UpdateInvViewMatrix(Entity entity) const
+		void CameraSystem::UpdateViewMatrices(CameraComponent& cameraComponent, const TransformComponent& transformComponent)
 		{
-			auto& ecsWorld = Core::Get().GetECSWorld();
-			auto& cameraComponent = ecsWorld.GetComponent<CameraComponent>(entity);
-
-			if (cameraComponent.IsViewDirty)
-			{
-				UpdateViewMatrix(entity);
-			}
+			XMMATRIX translationMatrix = XMMatrixTranslationFromVector(-(transformComponent.Position));
+			XMMATRIX rotationMatrix = XMMatrixTranspose(XMMatrixRotationQuaternion(transformComponent.Rotation));
 
-			cameraComponent.CameraData->InvView = XMMatrixInverse(nullptr, cameraComponent.CameraData->View);
-			cameraComponent.IsInvViewDirty = false;
+			cameraComponent.CameraData.View = translationMatrix * rotationMatrix;
+			cameraComponent.CameraData.InvView = XMMatrixInverse(nullptr, cameraComponent.CameraData.View);
 		}
 
-		void CameraSystem::UpdateProjMatrix(Entity entity) const
+		void CameraSystem::UpdateProjMatrices(CameraComponent& cameraComponent)
 		{
-			auto& ecsWorld = Core::Get().GetECSWorld();
-			auto& cameraComponent = ecsWorld.GetComponent<CameraComponent>(entity);
-
-			if (cameraComponent.IsOrtho)
+			if (cameraComponent.m_isOrtho)
 			{
-				cameraComponent.CameraData->Proj = XMMatrixOrthographicLH(40.f, 40.f, cameraComponent.NearZ, cameraComponent.FarZ);
+				float height = cameraComponent.m_orthoHeight;
+				cameraComponent.CameraData.Proj = XMMatrixOrthographicLH(height * cameraComponent.m_aspectRatio, height, cameraComponent.m_nearZ, cameraComponent.m_farZ);
 			}
 			else
 			{
-				cameraComponent.CameraData->Proj = XMMatrixPerspectiveFovLH(XMConvertToRadians(cameraComponent.Fov), cameraComponent.AspectRatio, cameraComponent.NearZ, cameraComponent.FarZ);
-			}
-
-			cameraComponent.IsProjDirty = false;
-			cameraComponent.IsInvProjDirty = true;
-		}
-
-		void CameraSystem::UpdateInvProjMatrix(Entity entity) const
-		{
-			auto& ecsWorld = Core::Get().GetECSWorld();
-			auto& cameraComponent = ecsWorld.GetComponent<CameraComponent>(entity);
-
-			if (cameraComponent.IsProjDirty)
-			{
-				UpdateProjMatrix(entity);
+				cameraComponent.CameraData.Proj = XMMatrixPerspectiveFovLH(XMConvertToRadians(cameraComponent.m_fov), cameraComponent.m_aspectRatio, cameraComponent.m_nearZ, cameraComponent.m_farZ);
 			}
 
-			cameraComponent.CameraData->InvProj = XMMatrixInverse(nullptr, cameraComponent.CameraData->Proj);
-			cameraComponent.IsInvProjDirty = false;
+			cameraComponent.CameraData.InvProj = XMMatrixInverse(nullptr, cameraComponent.CameraData.Proj);
 		}
 
 	}
-}
+}
\ No newline at end of file
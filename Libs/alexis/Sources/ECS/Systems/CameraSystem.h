@@ -4,11 +4,24 @@
 
 namespace alexis
 {
+	struct RenderScene;
+	struct ViewData;
+
 	namespace ecs
 	{
+		struct CameraComponent;
+		struct TransformComponent;
+
 		class CameraSystem : public ecs::System
 		{
 		public:
+			void Update(float dt);
+
+			// Builds RenderScene main view from the active camera
+			void Extract(RenderScene& renderScene) const;
+
+			void ExtractView(Entity entity, ViewData& viewData) const;
+
 			Entity GetActiveCamera() const;
 			void SetActiveCamera(Entity cameraEntity);
 
@@ -24,16 +37,14 @@ namespace alexis
 
 			void SetFov(Entity entity, float fov);
 			void SetProjectionParams(Entity entity, float fov, float aspectRatio, float nearZ, float farZ);
+			void SetOrthoHeight(Entity entity, float height);
 			void LookAt(Entity entity, DirectX::XMVECTOR targetPos, DirectX::XMVECTOR up) const;
 
 		private:
-			void UpdateViewMatrix(Entity entity) const;
-			void UpdateInvViewMatrix(Entity entity) const;
-
-			void UpdateProjMatrix(Entity entity) const;
-			void UpdateInvProjMatrix(Entity entity) const;
+			static void UpdateViewMatrices(CameraComponent& cameraComponent, const TransformComponent& transformComponent);
+			static void UpdateProjMatrices(CameraComponent& cameraComponent);
 
-			Entity m_activeCamera{ 0 };
+			Entity m_activeCamera;
 		};
 	}
 }
\ No newline at end of file
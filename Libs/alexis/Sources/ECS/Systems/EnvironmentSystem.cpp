@@ -5,19 +5,81 @@
 #include <Core/Core.h>
 #include <Core/ResourceManager.h>
 #include <Render/Render.h>
+#include <Render/RenderScene.h>
 #include <Render/CommandContext.h>
 #include <Render/RenderTargetManager.h>
+#include <Render/CommandManager.h>
 
 #include <ECS/Systems/CameraSystem.h>
 #include <ECS/Components/TransformComponent.h>
 
+#include <Utils/BakeCache.h>
+#include <Utils/SpecularIBL.h>
+
 namespace alexis
 {
 
 	namespace
 	{
-		static constexpr UINT k_irradianceMapSize = 32;
 		static constexpr UINT k_cubemapSize = 1024;
+
+		static constexpr UINT k_prefilteredMapSize = 128;
+		static constexpr UINT k_brdfLutSize = 512;
+		static constexpr std::uint32_t k_specularSampleCount = 1024;
+
+		// Bump when the baked layout or algorithm changes
+		static constexpr std::uint32_t k_irradianceSHVersion = 1;
+		static constexpr std::string_view k_prefilteredMapKind = "ggx.v1.dds";
+		static constexpr std::string_view k_brdfLutFileName = "BrdfLut.v2.dds";
+
+		// Equirect environment map as RGBA float texels, the layout the CPU bakers read
+		const Image* LoadEnvironmentMap(const std::wstring& path, ScratchImage& scratchImage)
+		{
+			TexMetadata metadata;
+			ThrowIfFailed(
+				LoadFromHDRFile(path.c_str(), &metadata, scratchImage)
+			);
+
+			if (metadata.format != DXGI_FORMAT_R32G32B32A32_FLOAT)
+			{
+				ScratchImage convertedImage;
+				ThrowIfFailed(
+					Convert(*scratchImage.GetImage(0, 0, 0), DXGI_FORMAT_R32G32B32A32_FLOAT, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, convertedImage)
+				);
+				scratchImage = std::move(convertedImage);
+			}
+
+			const Image* image = scratchImage.GetImage(0, 0, 0);
+			assert(image->rowPitch == image->width * sizeof(XMFLOAT4) && "Rows must be tightly packed");
+			return image;
+		}
+
+		// Baked DDS is usable if it has the layout the GPU texture is created with
+		bool LoadBakedDDS(const fs::path& path, const D3D12_RESOURCE_DESC& desc, ScratchImage& scratchImage)
+		{
+			TexMetadata metadata;
+			if (!fs::exists(path) || FAILED(LoadFromDDSFile(path.c_str(), DDS_FLAGS_NONE, &metadata, scratchImage)))
+			{
+				return false;
+			}
+
+			return metadata.width == desc.Width && metadata.height == desc.Height && metadata.arraySize == desc.DepthOrArraySize
+				&& metadata.mipLevels == desc.MipLevels && metadata.format == desc.Format;
+		}
+
+		// Saved aside and renamed, so an interrupted write never leaves a valid looking file
+		void SaveBakedDDS(const fs::path& path, const ScratchImage& scratchImage)
+		{
+			std::error_code error;
+			fs::create_directories(path.parent_path(), error);
+
+			auto tempPath = path;
+			tempPath += ".tmp";
+			if (SUCCEEDED(SaveToDDSFile(scratchImage.GetImages(), scratchImage.GetImageCount(), scratchImage.GetMetadata(), DDS_FLAGS_NONE, tempPath.c_str())))
+			{
+				fs::rename(tempPath, path, error);
+			}
+		}
 	}
 
 	__declspec(align(16)) struct CameraParams
@@ -26,11 +88,6 @@ namespace alexis
 		XMMATRIX ProjMatrix;
 	};
 
-	__declspec(align(16)) struct RoughnessParams
-	{
-		float Roughness;
-	};
-
 	ecs::EnvironmentSystem::~EnvironmentSystem()
 	{
 
@@ -56,40 +113,11 @@ namespace alexis
 		m_cubemap.Create(desc);
 		m_cubemap.GetResource()->SetName(L"Env Cubemap");
 
-		desc.Width = k_irradianceMapSize;
-		desc.Height = k_irradianceMapSize;
-		m_irradianceMap.Create(desc);
-		m_irradianceMap.GetResource()->SetName(L"Irradiance Map");
-
-		desc.Width = 512;
-		desc.Height = 512;
-		desc.MipLevels = 1;
-		m_convolutedBRDFMap.Create(desc);
-		m_convolutedBRDFMap.GetResource()->SetName(L"Convoluted BRDF Map");
-
-		desc.Width = 128;
-		desc.Height = 128;
-		desc.MipLevels = 6;
-		m_prefilteredMap.Create(desc);
-		m_prefilteredMap.GetResource()->SetName(L"Prefiltered Map");
-
 		auto* rtManager = Render::GetInstance()->GetRTManager();
 		auto cubemapRT = std::make_unique<RenderTarget>();
 		cubemapRT->AttachTexture(m_cubemap, RenderTarget::Slot0);
 		rtManager->EmplaceTarget(L"CUBEMAP", std::move(cubemapRT));
 
-		auto irradianceRT = std::make_unique<RenderTarget>();
-		irradianceRT->AttachTexture(m_irradianceMap, RenderTarget::Slot0);
-		rtManager->EmplaceTarget(L"CUBEMAP_Irradiance", std::move(irradianceRT));
-
-		auto prefilteredRT = std::make_unique<RenderTarget>();
-		prefilteredRT->AttachTexture(m_prefilteredMap, RenderTarget::Slot0);
-		rtManager->EmplaceTarget(L"CUBEMAP_Prefiltered", std::move(prefilteredRT));
-
-		auto convolutedBRDFRT = std::make_unique<RenderTarget>();
-		convolutedBRDFRT->AttachTexture(m_convolutedBRDFMap, RenderTarget::Slot0);
-		rtManager->EmplaceTarget(L"ConvolutedBRDF", std::move(convolutedBRDFRT));
-
 		// Env cubemap
 		for (int i = 0; i < 6; ++i)
 		{
@@ -106,99 +134,147 @@ namespace alexis
 			m_cubemapRTVs[i] = alloc.CpuPtr;
 		}
 
-		// Irradiance map
-		for (int i = 0; i < 6; ++i)
+		m_envRectToCubeMaterial = rm->GetMaterial(L"Resources/Materials/system/EnvRectToCube.material");
+		m_skyboxMaterial = rm->GetMaterial(L"Resources/Materials/system/Skybox.material");
+
+		// Baked data is cached by environment map content
+		const auto& envMapPath = m_envRectToCubeMaterial->GetTexturePaths()[0];
+		const auto envMapHash = utils::HashFileContent(envMapPath);
+		BakeIrradianceSH(envMapPath, envMapHash);
+		LoadSpecularIBL(envMapPath, envMapHash);
+	}
+
+	void ecs::EnvironmentSystem::BakeIrradianceSH(const std::wstring& envMapPath, std::uint64_t sourceHash)
+	{
+		const auto cachePath = utils::GetBakeCachePath(envMapPath, sourceHash, "sh9");
+
+		if (sourceHash != 0 && utils::ReadBakeCache(cachePath, k_irradianceSHVersion, &m_irradianceSH, sizeof(m_irradianceSH)))
 		{
-			D3D12_RENDER_TARGET_VIEW_DESC rtvDesc;
-			rtvDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2DARRAY;
-			rtvDesc.Format = desc.Format;
-			rtvDesc.Texture2DArray.MipSlice = 0;
-			rtvDesc.Texture2DArray.PlaneSlice = 0;
+			return;
+		}
 
-			rtvDesc.Texture2DArray.FirstArraySlice = i;
-			rtvDesc.Texture2DArray.ArraySize = 1;
+		ScratchImage scratchImage;
+		const Image* image = LoadEnvironmentMap(envMapPath, scratchImage);
 
-			auto alloc = Render::GetInstance()->AllocateRTV(m_irradianceMap.GetResource(), rtvDesc);
-			m_irradianceRTVs[i] = alloc.CpuPtr;
+		m_irradianceSH = utils::ProjectIrradianceSH(reinterpret_cast<const XMFLOAT4*>(image->pixels), image->width, image->height, &Core::Get().GetJobSystem());
+
+		if (sourceHash != 0)
+		{
+			utils::WriteBakeCache(cachePath, k_irradianceSHVersion, &m_irradianceSH, sizeof(m_irradianceSH));
 		}
+	}
 
-		// Prefiltered map
-		for (int i = 0; i < 6; ++i)
+	void ecs::EnvironmentSystem::LoadSpecularIBL(const std::wstring& envMapPath, std::uint64_t sourceHash)
+	{
+		// Both textures stay named render targets, materials look them up as $CUBEMAP_Prefiltered and $ConvolutedBRDF
+		auto prefilteredDesc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R16G16B16A16_FLOAT, k_prefilteredMapSize, k_prefilteredMapSize, 6, static_cast<UINT16>(k_munMipLevels),
+			1, 0, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+		auto brdfLutDesc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R16G16_FLOAT, k_brdfLutSize, k_brdfLutSize, 1, 1,
+			1, 0, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+
+		auto& jobSystem = Core::Get().GetJobSystem();
+
+		const auto prefilteredPath = utils::GetBakeCachePath(envMapPath, sourceHash, k_prefilteredMapKind);
+
+		ScratchImage prefiltered;
+		if (sourceHash == 0 || !LoadBakedDDS(prefilteredPath, prefilteredDesc, prefiltered))
 		{
-			for (int mip = 0; mip < k_munMipLevels; ++mip)
+			ScratchImage envMap;
+			const Image* image = LoadEnvironmentMap(envMapPath, envMap);
+
+			const auto cubemap = utils::PrefilterEnvironmentGGX(reinterpret_cast<const XMFLOAT4*>(image->pixels), image->width, image->height,
+				k_prefilteredMapSize, k_munMipLevels, k_specularSampleCount, &jobSystem);
+
+			ScratchImage baked;
+			ThrowIfFailed(
+				baked.InitializeCube(DXGI_FORMAT_R32G32B32A32_FLOAT, k_prefilteredMapSize, k_prefilteredMapSize, 1, k_munMipLevels)
+			);
+
+			for (std::size_t face = 0; face < 6; ++face)
 			{
-				D3D12_RENDER_TARGET_VIEW_DESC rtvDesc;
-				rtvDesc.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2DARRAY;
-				rtvDesc.Format = desc.Format;
-				rtvDesc.Texture2DArray.MipSlice = mip;
-				rtvDesc.Texture2DArray.PlaneSlice = 0;
+				for (std::size_t mip = 0; mip < k_munMipLevels; ++mip)
+				{
+					const auto& texels = cubemap.Images[face * k_munMipLevels + mip];
+					std::memcpy(baked.GetImage(mip, face, 0)->pixels, texels.data(), texels.size() * sizeof(XMFLOAT4));
+				}
+			}
 
-				rtvDesc.Texture2DArray.FirstArraySlice = i;
-				rtvDesc.Texture2DArray.ArraySize = 1;
+			ThrowIfFailed(
+				Convert(baked.GetImages(), baked.GetImageCount(), baked.GetMetadata(), prefilteredDesc.Format, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, prefiltered)
+			);
 
-				auto alloc = Render::GetInstance()->AllocateRTV(m_prefilteredMap.GetResource(), rtvDesc);
-				m_prefilteredRTVs[i * k_munMipLevels + mip] = alloc.CpuPtr;
+			if (sourceHash != 0)
+			{
+				SaveBakedDDS(prefilteredPath, prefiltered);
 			}
 		}
 
-		m_envRectToCubeMaterial = rm->GetMaterial(L"Resources/Materials/system/EnvRectToCube.material");
-		m_skyboxMaterial = rm->GetMaterial(L"Resources/Materials/system/Skybox.material");
-		m_irradianceMaterial = rm->GetMaterial(L"Resources/Materials/system/IrradianceMap.material");
-		m_prefilteredMaterial = rm->GetMaterial(L"Resources/Materials/system/PrefilteredMap.material");
-		m_convoluteBRDFMaterial = rm->GetMaterial(L"Resources/Materials/system/ConvoluteBRDF.material");
+		// BRDF LUT depends on nothing but the baker
+		const auto brdfLutPath = fs::path(utils::k_bakeCacheDirectory) / k_brdfLutFileName;
 
-		m_fsQuad = Core::Get().GetResourceManager()->GetMesh(L"$FS_QUAD");
-	}
+		ScratchImage brdfLut;
+		if (!LoadBakedDDS(brdfLutPath, brdfLutDesc, brdfLut))
+		{
+			const auto lut = utils::IntegrateEnvironmentBRDF(k_brdfLutSize, k_specularSampleCount, &jobSystem);
 
-	void ecs::EnvironmentSystem::CaptureCubemap(CommandContext* context)
-	{
-		PIXScopedEvent(context->List.Get(), PIX_COLOR(0, 255, 0), "EnvSystem: Capture Cubemap");
+			ScratchImage baked;
+			ThrowIfFailed(
+				baked.Initialize2D(DXGI_FORMAT_R32G32_FLOAT, k_brdfLutSize, k_brdfLutSize, 1, 1)
+			);
+			std::memcpy(baked.GetPixels(), lut.data(), lut.size() * sizeof(XMFLOAT2));
 
-		if (m_irradianceCalculated)
-		{
-			return;
+			ThrowIfFailed(
+				Convert(*baked.GetImage(0, 0, 0), brdfLutDesc.Format, TEX_FILTER_DEFAULT, TEX_THRESHOLD_DEFAULT, brdfLut)
+			);
+
+			SaveBakedDDS(brdfLutPath, brdfLut);
 		}
 
-		XMMATRIX projMatrix = XMMatrixPerspectiveFovLH(XMConvertToRadians(90.0f), 1.0f, 0.1f, 10.f);
-		std::array<XMMATRIX, 6> viewMatrices =
-		{
-			XMMatrixLookAtLH({ 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }),		// +X
-			XMMatrixLookAtLH({ 0.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }),	// -X
-			XMMatrixLookAtLH({ 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f }),	// +Y
-			XMMatrixLookAtLH({ 0.0f, 0.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }),	// -Y
-			XMMatrixLookAtLH({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f }),		// +Z
-			XMMatrixLookAtLH({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f }),	// -Z
-		};
+		m_prefilteredMap.Create(prefilteredDesc);
+		m_prefilteredMap.GetResource()->SetName(L"Prefiltered Map");
 
-		context->TransitionResource(m_cubemap, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET);
+		m_convolutedBRDFMap.Create(brdfLutDesc);
+		m_convolutedBRDFMap.GetResource()->SetName(L"Convoluted BRDF Map");
 
-		for (int i = 0; i < viewMatrices.size(); ++i)
+		auto* copyContext = Render::GetInstance()->GetCommandManager()->CreateCommandContext(D3D12_COMMAND_LIST_TYPE_COPY);
+		auto upload = [copyContext](TextureBuffer& texture, const ScratchImage& scratchImage)
 		{
-			m_envRectToCubeMaterial->Set(context);
-
-			//const float clearColor[4] = { 0, 0, 0, 0 };
-			//context->List->ClearRenderTargetView(m_cubemapRTVs[i], clearColor, 0, nullptr);
-			context->List->OMSetRenderTargets(1, &m_cubemapRTVs[i], FALSE, nullptr);
+			// Images are in subresource order, array slice major
+			std::vector<D3D12_SUBRESOURCE_DATA> subresources(scratchImage.GetImageCount());
+			const Image* images = scratchImage.GetImages();
+			for (std::size_t i = 0; i < subresources.size(); ++i)
+			{
+				subresources[i].RowPitch = images[i].rowPitch;
+				subresources[i].SlicePitch = images[i].slicePitch;
+				subresources[i].pData = images[i].pixels;
+			}
 
-			D3D12_VIEWPORT viewport{ 0, 0, k_cubemapSize, k_cubemapSize };
-			CD3DX12_RECT rect{ 0, 0, k_cubemapSize, k_cubemapSize };
+			copyContext->InitializeTexture(texture, static_cast<UINT>(subresources.size()), subresources.data());
+		};
+		upload(m_prefilteredMap, prefiltered);
+		upload(m_convolutedBRDFMap, brdfLut);
+		copyContext->Flush(true);
 
-			context->SetViewport(Viewport{ viewport, rect });
+		auto* rtManager = Render::GetInstance()->GetRTManager();
+		auto prefilteredRT = std::make_unique<RenderTarget>();
+		prefilteredRT->AttachTexture(m_prefilteredMap, RenderTarget::Slot0);
+		rtManager->EmplaceTarget(L"CUBEMAP_Prefiltered", std::move(prefilteredRT));
 
-			CameraParams cameraParams;
-			cameraParams.ViewMatrix = viewMatrices[i];
-			cameraParams.ProjMatrix = projMatrix;
-			context->SetDynamicCBV(0, sizeof(cameraParams), &cameraParams);
+		auto convolutedBRDFRT = std::make_unique<RenderTarget>();
+		convolutedBRDFRT->AttachTexture(m_convolutedBRDFMap, RenderTarget::Slot0);
+		rtManager->EmplaceTarget(L"ConvolutedBRDF", std::move(convolutedBRDFRT));
+	}
 
-			m_cubeMesh->Draw(context);
-		}
+	void ecs::EnvironmentSystem::Extract(RenderScene& renderScene) const
+	{
+		renderScene.IrradianceSH = m_irradianceSH;
 	}
 
-	void ecs::EnvironmentSystem::ConvoluteCubemap(CommandContext* context)
+	void ecs::EnvironmentSystem::CaptureCubemap(CommandContext* context)
 	{
-		PIXScopedEvent(context->List.Get(), PIX_COLOR(0, 255, 0), "EnvSystem: Convolute Cubemap");
+		PIXScopedEvent(context->List.Get(), PIX_COLOR(0, 255, 0), "EnvSystem: Capture Cubemap");
 
-		if (m_irradianceCalculated)
+		if (m_isEnvironmentCaptured)
 		{
 			return;
 		}
@@ -214,19 +290,18 @@ namespace alexis
 			XMMatrixLookAtLH({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f }),	// -Z
 		};
 
-		context->TransitionResource(m_irradianceMap, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET);
-		context->TransitionResource(m_cubemap, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+		context->TransitionResource(m_cubemap, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET);
 
 		for (int i = 0; i < viewMatrices.size(); ++i)
 		{
-			m_irradianceMaterial->Set(context);
+			m_envRectToCubeMaterial->Set(context);
 
 			//const float clearColor[4] = { 0, 0, 0, 0 };
 			//context->List->ClearRenderTargetView(m_cubemapRTVs[i], clearColor, 0, nullptr);
-			context->List->OMSetRenderTargets(1, &m_irradianceRTVs[i], FALSE, nullptr);
+			context->List->OMSetRenderTargets(1, &m_cubemapRTVs[i], FALSE, nullptr);
 
-			D3D12_VIEWPORT viewport{ 0, 0, k_irradianceMapSize, k_irradianceMapSize };
-			CD3DX12_RECT rect{ 0, 0, k_irradianceMapSize, k_irradianceMapSize };
+			D3D12_VIEWPORT viewport{ 0, 0, k_cubemapSize, k_cubemapSize };
+			CD3DX12_RECT rect{ 0, 0, k_cubemapSize, k_cubemapSize };
 
 			context->SetViewport(Viewport{ viewport, rect });
 
@@ -238,96 +313,14 @@ namespace alexis
 			m_cubeMesh->Draw(context);
 		}
 
-		m_irradianceCalculated = true;
-
-		context->TransitionResource(m_irradianceMap, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COMMON);
-	}
-
-	void ecs::EnvironmentSystem::CapturePreFilteredTexture(CommandContext* context)
-	{
-		PIXScopedEvent(context->List.Get(), PIX_COLOR(0, 255, 0), "EnvSystem: Capture Prefiltered Texture");
-
-		if (m_irradianceCalculated)
-		{
-			return;
-		}
-
-		context->TransitionResource(m_cubemap, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-		context->TransitionResource(m_prefilteredMap, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET);
-
-		m_prefilteredMaterial->Set(context);
-
-		for (std::size_t mip = 0; mip < k_munMipLevels; ++mip)
-		{
-			RoughnessParams rcb{ static_cast<float>(mip) / static_cast<float>(k_munMipLevels - 1) };
-
-			context->SetDynamicCBV(1, sizeof(rcb), &rcb);
-
-			LONG mipWidth = 128 * std::pow(0.5f, mip);
-			LONG mipHeight = 128 * std::pow(0.5f, mip);
-
-			XMMATRIX projMatrix = XMMatrixPerspectiveFovLH(XMConvertToRadians(90.0f), 1.0f, 0.1f, 10.f);
-			std::array<XMMATRIX, 6> viewMatrices =
-			{
-				XMMatrixLookAtLH({ 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }),		// +X
-				XMMatrixLookAtLH({ 0.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }),	// -X
-				XMMatrixLookAtLH({ 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f }),	// +Y
-				XMMatrixLookAtLH({ 0.0f, 0.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }),	// -Y
-				XMMatrixLookAtLH({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 1.0f, 0.0f }),		// +Z
-				XMMatrixLookAtLH({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f }),	// -Z
-			};
-
-			D3D12_VIEWPORT viewport{ 0, 0, mipWidth, mipHeight };
-			CD3DX12_RECT rect{ 0, 0, mipWidth, mipHeight };
-
-			context->SetViewport(Viewport{ viewport, rect });
-
-			CameraParams cameraParams;
-			cameraParams.ProjMatrix = projMatrix;
-
-			for (int i = 0; i < viewMatrices.size(); ++i)
-			{
-				context->List->OMSetRenderTargets(1, &m_prefilteredRTVs[i*k_munMipLevels+mip], FALSE, nullptr);
+		context->TransitionResource(m_cubemap, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COMMON);
 
-				cameraParams.ViewMatrix = viewMatrices[i];
-				context->SetDynamicCBV(0, sizeof(cameraParams), &cameraParams);
-
-				m_cubeMesh->Draw(context);
-			}
-		}
-
-		context->TransitionResource(m_prefilteredMap, D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COMMON);
-	}
-
-	void ecs::EnvironmentSystem::ConvoluteBRDF(CommandContext* context)
-	{
-		if (m_irradianceCalculated)
-		{
-			return;
-		}
-
-		auto* render = alexis::Render::GetInstance();
-		auto* rtManager = render->GetRTManager();
-		auto* rt = rtManager->GetRenderTarget(L"ConvolutedBRDF");
-
-		context->TransitionResource(rt->GetTexture(RenderTarget::Slot0), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET);
-
-		m_convoluteBRDFMaterial->Set(context);
-
-		context->SetRenderTarget(*rt);
-		context->SetViewport(rt->GetViewport());
-
-		m_fsQuad->Draw(context);
-
-		context->TransitionResource(rt->GetTexture(RenderTarget::Slot0), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_COMMON);
+		// Prefiltered map and BRDF LUT are baked in Init, the cubemap only feeds the skybox
+		m_isEnvironmentCaptured = true;
 	}
 
 	void ecs::EnvironmentSystem::RenderSkybox(CommandContext* context)
 	{
-		auto& ecsWorld = Core::Get().GetECSWorld();
-		auto cameraSystem = ecsWorld.GetSystem<CameraSystem>();
-		auto activeCamera = cameraSystem->GetActiveCamera();
-
 		auto* render = alexis::Render::GetInstance();
 		auto* rtManager = render->GetRTManager();
 
@@ -343,8 +336,9 @@ namespace alexis
 		context->SetViewport(rt->GetViewport());
 
 		CameraParams cameraParams;
-		cameraParams.ViewMatrix = cameraSystem->GetViewMatrix(activeCamera);
-		cameraParams.ProjMatrix = cameraSystem->GetProjMatrix(activeCamera);
+		const auto& mainView = render->GetRenderScene()->Views[RenderScene::k_mainView];
+		cameraParams.ViewMatrix = mainView.View;
+		cameraParams.ProjMatrix = mainView.Proj;
 		context->SetDynamicCBV(0, sizeof(cameraParams), &cameraParams);
 
 		m_cubeMesh->Draw(context);
@@ -4,11 +4,14 @@
 
 #include <Render/Buffers/GpuBuffer.h>
 
+#include <Utils/SphericalHarmonics.h>
+
 namespace alexis
 {
 	class CommandContext;
 	class Material;
 	class Mesh;
+	struct RenderScene;
 
 	namespace ecs
 	{
@@ -18,32 +21,33 @@ namespace alexis
 			~EnvironmentSystem();
 			void Init();
 			void CaptureCubemap(CommandContext* context);
-			void ConvoluteCubemap(CommandContext* context);
-			void CapturePreFilteredTexture(CommandContext* context);
-			void ConvoluteBRDF(CommandContext* context);
 			void RenderSkybox(CommandContext* context);
 
+			// Copies the diffuse irradiance baked in Init to RenderScene
+			void Extract(RenderScene& renderScene) const;
+
 		private:
+			// Projects the equirect environment map on SH on the CPU, the result is cached on disk by source content
+			void BakeIrradianceSH(const std::wstring& envMapPath, std::uint64_t sourceHash);
+
+			// Prefiltered specular map and BRDF LUT are baked on the CPU into DDS files in the bake cache, then uploaded
+			void LoadSpecularIBL(const std::wstring& envMapPath, std::uint64_t sourceHash);
+
 			Mesh* m_cubeMesh{ nullptr };
 			TextureBuffer m_cubemap;
-			TextureBuffer m_irradianceMap;
 			TextureBuffer m_prefilteredMap;
 			TextureBuffer m_convolutedBRDFMap;
 			//TODO: Create CubeRT and RT encapsulating RTVs
 			std::array<D3D12_CPU_DESCRIPTOR_HANDLE, 6> m_cubemapRTVs;
-			std::array<D3D12_CPU_DESCRIPTOR_HANDLE, 6> m_irradianceRTVs;
 
 			static constexpr std::size_t k_munMipLevels = 6;
-			std::array<D3D12_CPU_DESCRIPTOR_HANDLE, 6 * k_munMipLevels + k_munMipLevels> m_prefilteredRTVs;
 
 			Material* m_envRectToCubeMaterial{ nullptr };
-			Material* m_irradianceMaterial{ nullptr };
 			Material* m_skyboxMaterial{ nullptr };
-			Material* m_prefilteredMaterial{ nullptr };
-			Material* m_convoluteBRDFMaterial{ nullptr };
-			Mesh* m_fsQuad{ nullptr };
 
-			bool m_irradianceCalculated{ false };
+			utils::IrradianceSH m_irradianceSH;
+
+			bool m_isEnvironmentCaptured{ false };
 		};
 
 	}
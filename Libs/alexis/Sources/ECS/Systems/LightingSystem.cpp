@@ -11,6 +11,7 @@
 #include <Core/Core.h>
 #include <Core/ResourceManager.h>
 #include <Render/Render.h>
+#include <Render/RenderScene.h>
 #include <Render/CommandContext.h>
 
 namespace alexis
@@ -24,31 +25,33 @@ namespace alexis
 			XMMATRIX InvProjMatrix;
 		};
 
-		__declspec(align(16)) struct DirectionalLight
+		// Matches SunLight_ps.hlsl
+		__declspec(align(16)) struct SunParams
 		{
 			XMVECTOR Direction;
 			XMVECTOR Color;
+			XMMATRIX ViewMatrix;
+			XMVECTOR CascadeSplits; // Far depth of each cascade
+			XMVECTOR CascadeTexelSizes;
+			XMMATRIX ShadowMatrices[RenderScene::k_shadowCascadeCount];
 		};
 
-		__declspec(align(16)) struct ShadowMapParams
+		__declspec(align(16)) struct ClusterParams
 		{
-			XMMATRIX LightSpaceMatrix;
+			std::uint32_t Grid[4]; // x, y - tile count, z - slice count
+			XMVECTOR Slicing; // slice = log(viewZ) * x + y
+			XMMATRIX ViewMatrix;
 		};
 
-		__declspec(align(16)) struct LightParams
+		// Matches ClusteredLights_ps.hlsl
+		struct ClusteredLight
 		{
-			XMMATRIX WVPMatriX;
-		};
-
-		__declspec(align(16)) struct ScreenParams
-		{
-			XMVECTOR Params;
-		};
-
-		__declspec(align(16)) struct PointLightParams
-		{
-			XMVECTOR Position;
-			XMVECTOR Color;
+			XMFLOAT3 Position;
+			float Range;
+			XMFLOAT3 Color;
+			float CosAngle; // Spot only
+			XMFLOAT3 Direction; // Spot only
+			std::uint32_t Type; // 0 - point, 1 - spot
 		};
 
 		float CalculatePointLightScale(const XMVECTOR& color, const XMVECTOR& position)
@@ -60,48 +63,71 @@ namespace alexis
 			return sqrtf(maxChannel * 256);
 		}
 
+		void WritePointLightProxy(RenderScene::PointLightProxies& pointLights, std::uint32_t proxy, const LightComponent& light, const TransformComponent& transform)
+		{
+			XMFLOAT3 position;
+			XMStoreFloat3(&position, transform.Position);
+
+			pointLights.PositionX[proxy] = position.x;
+			pointLights.PositionY[proxy] = position.y;
+			pointLights.PositionZ[proxy] = position.z;
+			pointLights.Colors[proxy] = light.Color;
+			pointLights.Scales[proxy] = CalculatePointLightScale(light.Color, transform.Position);
+		}
+
+		void WriteSpotLightProxy(RenderScene::SpotLightProxies& spotLights, std::uint32_t proxy, const LightComponent& light, const TransformComponent& transform)
+		{
+			auto& cone = spotLights.Cones[proxy];
+			XMStoreFloat3(&cone.Apex, transform.Position);
+			XMStoreFloat3(&cone.Direction, XMVector3Rotate(g_XMIdentityR2, transform.Rotation));
+			cone.Range = CalculatePointLightScale(light.Color, transform.Position);
+			cone.CosAngle = std::cos(light.SpotAngle);
+
+			spotLights.Colors[proxy] = light.Color;
+		}
+
+		void WriteSunProxy(RenderScene::DirectionalLightProxy& sun, const LightComponent& light, const TransformComponent& transform)
+		{
+			sun.Direction = XMVector3Normalize(XMVector3Rotate(g_XMIdentityR2, transform.Rotation));
+			sun.Color = light.Color;
+			sun.IsEnabled = true;
+			++sun.Version;
+		}
+
 		void LightingSystem::Init()
 		{
 			auto* resMgr = Core::Get().GetResourceManager();
 
 			m_fsQuad = Core::Get().GetResourceManager()->GetMesh(L"$FS_QUAD");
-			m_sphere = Core::Get().GetResourceManager()->GetMesh(L"Resources/Models/Sphere.dae");
 
-			// Point Light Stencil Material
+			// Clustered Lights Material
 			{
 				MaterialLoadParams params;
-				params.VSPath = L"PointLight_vs";
+				params.VSPath = L"ClusteredLights_vs";
+				params.PSPath = L"ClusteredLights_ps";
+				params.Textures = { L"$GB#0", L"$GB#1", L"$GB#2", L"$GB#Depth" };
 				params.RTV = L"$HDR";
 
-				params.CullMode = D3D12_CULL_MODE_NONE;
-
-				CD3DX12_DEPTH_STENCIL_DESC depthDesc{ D3D12_DEFAULT };
-				depthDesc.DepthEnable = TRUE;
-				depthDesc.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
-				depthDesc.StencilEnable = TRUE;
-				depthDesc.StencilReadMask = 0x00;
-				depthDesc.BackFace.StencilFunc = D3D12_COMPARISON_FUNC_ALWAYS;
-				depthDesc.BackFace.StencilDepthFailOp = D3D12_STENCIL_OP_INCR;
-				depthDesc.BackFace.StencilPassOp = D3D12_STENCIL_OP_KEEP;
-				depthDesc.FrontFace.StencilFunc = D3D12_COMPARISON_FUNC_ALWAYS;
-				depthDesc.FrontFace.StencilDepthFailOp = D3D12_STENCIL_OP_DECR;
-				depthDesc.FrontFace.StencilPassOp = D3D12_STENCIL_OP_KEEP;
-
-				params.CustomDS = true;
-				params.DepthStencil = depthDesc;
-				m_pointLightStencil = std::make_unique<Material>(params);
+				CD3DX12_BLEND_DESC blendDesc{ D3D12_DEFAULT };
+				blendDesc.RenderTarget[0].BlendEnable = true;
+				blendDesc.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
+				blendDesc.RenderTarget[0].DestBlend = D3D12_BLEND_ONE;
+				blendDesc.RenderTarget[0].SrcBlend = D3D12_BLEND_ONE;
+
+				params.BlendDesc = blendDesc;
+
+				params.DepthEnable = false;
+				m_clusteredLights = std::make_unique<Material>(params);
 			}
 
-			// Point Light Material
+			// Sun Light Material
 			{
 				MaterialLoadParams params;
-				params.VSPath = L"PointLight_vs";
-				params.PSPath = L"PointLight_ps";
+				params.VSPath = L"SunLight_vs";
+				params.PSPath = L"SunLight_ps";
 				params.Textures = { L"$GB#0", L"$GB#1", L"$GB#2", L"$GB#Depth", L"$Shadow Map#Depth" };
 				params.RTV = L"$HDR";
 
-				params.CullMode = D3D12_CULL_MODE_FRONT;
-
 				CD3DX12_BLEND_DESC blendDesc{ D3D12_DEFAULT };
 				blendDesc.RenderTarget[0].BlendEnable = true;
 				blendDesc.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
@@ -110,17 +136,8 @@ namespace alexis
 
 				params.BlendDesc = blendDesc;
 
-				CD3DX12_DEPTH_STENCIL_DESC depthDesc{ D3D12_DEFAULT };
-				depthDesc.DepthEnable = false;
-				depthDesc.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
-				depthDesc.StencilEnable = TRUE;
-				depthDesc.StencilWriteMask = 0x00;
-				depthDesc.BackFace.StencilFunc = D3D12_COMPARISON_FUNC_NOT_EQUAL;
-				depthDesc.FrontFace.StencilFunc = D3D12_COMPARISON_FUNC_NOT_EQUAL;
-
-				params.CustomDS = true;
-				params.DepthStencil = depthDesc;
-				m_pointLight = std::make_unique<Material>(params);
+				params.DepthEnable = false;
+				m_sunLight = std::make_unique<Material>(params);
 			}
 
 			// Ambient Light Material
@@ -128,8 +145,7 @@ namespace alexis
 				MaterialLoadParams params;
 				params.VSPath = L"AmbientLight_vs";
 				params.PSPath = L"AmbientLight_ps";
-				//params.Textures = { L"$GB#0", L"$GB#1", L"$GB#2", L"$GB#Depth", L"$Shadow Map#Depth", L"$CUBEMAP_Irradiance", L"$CUBEMAP_Prefiltered", L"$ConvolutedBRDF" };
-				params.Textures = { L"$GB#0", L"$GB#1", L"$GB#2", L"$GB#Depth", L"$CUBEMAP_Irradiance", L"$CUBEMAP_Prefiltered", L"$ConvolutedBRDF" };
+				params.Textures = { L"$GB#0", L"$GB#1", L"$GB#2", L"$GB#Depth", L"$CUBEMAP_Prefiltered", L"$ConvolutedBRDF" };
 				params.RTV = L"$HDR";
 
 				CD3DX12_BLEND_DESC blendDesc{ D3D12_DEFAULT };
@@ -145,13 +161,164 @@ namespace alexis
 			}
 		}
 
+		void LightingSystem::Extract(RenderScene& renderScene)
+		{
+			auto& ecsWorld = Core::Get().GetECSWorld();
+			auto& pointLights = renderScene.PointLights;
+			auto& spotLights = renderScene.SpotLights;
+
+			bool isRebuildNeeded = m_extractedEntitiesVersion != Entities.GetVersion();
+			if (!isRebuildNeeded)
+			{
+				auto updateChunk = [this, &renderScene, &pointLights, &spotLights, &isRebuildNeeded](std::size_t count, const Entity* entities, const LightComponent* lights, const TransformComponent* transforms)
+				{
+					for (std::size_t i = 0; i < count; ++i)
+					{
+						std::uint32_t proxy = m_proxyIndices[entities[i].Index];
+
+						// Light changed its type
+						if (lights[i].Type != GetProxyType(proxy))
+						{
+							isRebuildNeeded = true;
+							return;
+						}
+
+						switch (lights[i].Type)
+						{
+						case LightComponent::LightType::Point:
+							WritePointLightProxy(pointLights, proxy, lights[i], transforms[i]);
+							break;
+						case LightComponent::LightType::Spot:
+							WriteSpotLightProxy(spotLights, proxy & ~k_spotProxyFlag, lights[i], transforms[i]);
+							break;
+						case LightComponent::LightType::Directional:
+							if (entities[i].Index == m_sunEntityIndex)
+							{
+								WriteSunProxy(renderScene.Sun, lights[i], transforms[i]);
+							}
+							break;
+						}
+					}
+				};
+
+				ecsWorld.ForEachChunk<const LightComponent, const TransformComponent>(updateChunk, Changed<LightComponent>{ m_lastExtractVersion });
+				ecsWorld.ForEachChunk<const LightComponent, const TransformComponent>(updateChunk, Changed<TransformComponent>{ m_lastExtractVersion });
+			}
+
+			if (isRebuildNeeded)
+			{
+				RebuildProxies(renderScene);
+			}
+
+			m_lastExtractVersion = ecsWorld.AdvanceChangeVersion();
+
+			BinLights(renderScene);
+		}
+
+		void LightingSystem::RebuildProxies(RenderScene& renderScene)
+		{
+			auto& ecsWorld = Core::Get().GetECSWorld();
+			auto& pointLights = renderScene.PointLights;
+			auto& spotLights = renderScene.SpotLights;
+
+			m_proxyIndices.assign(m_proxyIndices.size(), k_invalidProxy);
+			pointLights.Resize(0);
+			spotLights.Resize(0);
+
+			renderScene.Sun.IsEnabled = false;
+			++renderScene.Sun.Version;
+			m_sunEntityIndex = k_invalidEntityIndex;
+
+			for (auto entity : Entities)
+			{
+				if (entity.Index >= m_proxyIndices.size())
+				{
+					m_proxyIndices.resize(entity.Index + 1, k_invalidProxy);
+				}
+
+				const auto& lightComponent = ecsWorld.GetComponent<const LightComponent>(entity);
+				const auto& transformComponent = ecsWorld.GetComponent<const TransformComponent>(entity);
+
+				if (lightComponent.Type == LightComponent::LightType::Directional)
+				{
+					m_proxyIndices[entity.Index] = k_sunProxy;
+
+					// First directional light is the sun
+					if (!renderScene.Sun.IsEnabled)
+					{
+						m_sunEntityIndex = entity.Index;
+						WriteSunProxy(renderScene.Sun, lightComponent, transformComponent);
+					}
+				}
+				else if (lightComponent.Type == LightComponent::LightType::Spot)
+				{
+					std::uint32_t proxy = static_cast<std::uint32_t>(spotLights.Size());
+					m_proxyIndices[entity.Index] = proxy | k_spotProxyFlag;
+					spotLights.Resize(proxy + 1);
+					WriteSpotLightProxy(spotLights, proxy, lightComponent, transformComponent);
+				}
+				else
+				{
+					std::uint32_t proxy = static_cast<std::uint32_t>(pointLights.Size());
+					m_proxyIndices[entity.Index] = proxy;
+					pointLights.Resize(proxy + 1);
+					WritePointLightProxy(pointLights, proxy, lightComponent, transformComponent);
+				}
+			}
+
+			m_extractedEntitiesVersion = Entities.GetVersion();
+		}
+
+		LightComponent::LightType LightingSystem::GetProxyType(std::uint32_t proxy)
+		{
+			if (proxy == k_sunProxy)
+			{
+				return LightComponent::LightType::Directional;
+			}
+
+			return (proxy & k_spotProxyFlag) != 0 ? LightComponent::LightType::Spot : LightComponent::LightType::Point;
+		}
+
+		void LightingSystem::BinLights(RenderScene& renderScene)
+		{
+			const auto& mainView = renderScene.Views[RenderScene::k_mainView];
+			auto& clusters = renderScene.LightClusters;
+
+			XMFLOAT4X4 proj;
+			XMStoreFloat4x4(&proj, mainView.Proj);
+
+			// Grid follows the camera projection
+			XMFLOAT4 projection{ proj._11, proj._22, proj._33, proj._43 };
+			if (!XMVector4Equal(XMLoadFloat4(&projection), XMLoadFloat4(&m_clusterProjection)))
+			{
+				// Perspective LH: _33 = far / (far - near), _43 = -near * _33
+				float nearZ = -proj._43 / proj._33;
+				float farZ = proj._43 / (1.0f - proj._33);
+
+				clusters.SetGrid(k_clusterTilesX, k_clusterTilesY, k_clusterSlices, std::min(std::max(nearZ, k_clusterNearZ), 0.5f * farZ), farZ, proj._11, proj._22);
+				m_clusterProjection = projection;
+			}
+
+			const auto& pointLights = renderScene.PointLights;
+			const auto& spotLights = renderScene.SpotLights;
+
+			utils::SphereStreams spheres;
+			spheres.CenterX = pointLights.PositionX.data();
+			spheres.CenterY = pointLights.PositionY.data();
+			spheres.CenterZ = pointLights.PositionZ.data();
+			spheres.Radius = pointLights.Scales.data();
+
+			clusters.Bin(mainView.View, spheres, pointLights.Size(), spotLights.Cones.data(), spotLights.Size(), &Core::Get().GetJobSystem());
+		}
+
 		void LightingSystem::Render(CommandContext* context)
 		{
-			PointLights(context);
+			ClusteredLights(context);
+			SunLight(context);
 			AmbientLight(context);
 		}
 
-		void LightingSystem::PointLights(CommandContext* context)
+		void LightingSystem::ClusteredLights(CommandContext* context)
 		{
 			auto* render = Render::GetInstance();
 			auto* rtManager = render->GetRTManager();
@@ -167,74 +334,128 @@ namespace alexis
 			context->SetRenderTarget(*hdr, *gbuffer);
 			context->SetViewport(hdr->GetViewport());
 
-			auto& ecsWorld = Core::Get().GetECSWorld();
-			auto cameraSystem = ecsWorld.GetSystem<CameraSystem>();
-			auto activeCamera = cameraSystem->GetActiveCamera();
-			auto& transformComponent = ecsWorld.GetComponent<TransformComponent>(activeCamera);
+			// Depth is only read from here on
+			auto barrierStencil = CD3DX12_RESOURCE_BARRIER::Transition(depth.GetResource(), D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, 0);
+			auto barrierStencil2 = CD3DX12_RESOURCE_BARRIER::Transition(depth.GetResource(), D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_DEPTH_READ, 1);
+			D3D12_RESOURCE_BARRIER barriers[] = { barrierStencil , barrierStencil2 };
+			context->List->ResourceBarrier(2, barriers);
 
-			// Point Lights
-			{
-				PIXScopedEvent(context->List.Get(), PIX_COLOR(0, 255, 0), "Point Light Stencil");
+			const auto& renderScene = *render->GetRenderScene();
+			const auto& pointLights = renderScene.PointLights;
+			const auto& spotLights = renderScene.SpotLights;
+			const auto& clusters = renderScene.LightClusters;
+			const auto& mainView = renderScene.Views[RenderScene::k_mainView];
 
-				m_pointLightStencil->Set(context);
+			if (clusters.GetClusters().empty())
+			{
+				return;
+			}
 
-				for (auto entity : Entities)
-				{
-					auto& lightComponent = ecsWorld.GetComponent<LightComponent>(entity);
-					auto& transformComponent = ecsWorld.GetComponent<TransformComponent>(entity);
-					if (lightComponent.Type == ecs::LightComponent::LightType::Point)
-					{
-						float scale = CalculatePointLightScale(lightComponent.Color, transformComponent.Position);
-						XMMATRIX wvpMatrix = XMMatrixIdentity() * XMMatrixScaling(scale, scale, scale) * XMMatrixTranslationFromVector(transformComponent.Position) * cameraSystem->GetViewMatrix(activeCamera) * cameraSystem->GetProjMatrix(activeCamera);
+			PIXScopedEvent(context->List.Get(), PIX_COLOR(0, 255, 0), "Clustered Lights");
 
-						LightParams lightCB{ wvpMatrix };
-						context->SetDynamicCBV(0, sizeof(lightCB), &lightCB);
+			// Point lights first, light indices in clusters follow that order
+			std::vector<ClusteredLight> lights(pointLights.Size() + spotLights.Size());
+			for (std::size_t i = 0; i < pointLights.Size(); ++i)
+			{
+				auto& light = lights[i];
+				light.Position = { pointLights.PositionX[i], pointLights.PositionY[i], pointLights.PositionZ[i] };
+				light.Range = pointLights.Scales[i];
+				XMStoreFloat3(&light.Color, pointLights.Colors[i]);
+				light.CosAngle = -1.0f;
+				light.Direction = { 0.0f, 0.0f, 1.0f };
+				light.Type = 0;
+			}
 
-						m_sphere->Draw(context);
-					}
-				}
+			for (std::size_t i = 0; i < spotLights.Size(); ++i)
+			{
+				const auto& cone = spotLights.Cones[i];
+
+				auto& light = lights[pointLights.Size() + i];
+				light.Position = cone.Apex;
+				light.Range = cone.Range;
+				XMStoreFloat3(&light.Color, spotLights.Colors[i]);
+				light.CosAngle = cone.CosAngle;
+				light.Direction = cone.Direction;
+				light.Type = 1;
 			}
 
+			m_clusteredLights->Set(context);
+
+			CameraParams cameraParams;
+			cameraParams.CameraPos = mainView.Position;
+			cameraParams.InvViewMatrix = mainView.InvView;
+			cameraParams.InvProjMatrix = mainView.InvProj;
+			context->SetDynamicCBV(0, sizeof(cameraParams), &cameraParams);
+
+			ClusterParams clusterParams;
+			clusterParams.Grid[0] = clusters.GetTilesX();
+			clusterParams.Grid[1] = clusters.GetTilesY();
+			clusterParams.Grid[2] = clusters.GetSliceCount();
+			clusterParams.Grid[3] = 0;
+			clusterParams.Slicing = XMVectorSet(clusters.GetSliceScale(), clusters.GetSliceBias(), 0.0f, 0.0f);
+			clusterParams.ViewMatrix = mainView.View;
+			context->SetDynamicCBV(1, sizeof(clusterParams), &clusterParams);
+
+			context->SetDynamicSRV(2, lights.size() * sizeof(ClusteredLight), lights.data());
+			context->SetDynamicSRV(3, clusters.GetClusters().size() * sizeof(utils::LightClusters::Cluster), clusters.GetClusters().data());
+			context->SetDynamicSRV(4, clusters.GetLightIndices().size() * sizeof(std::uint32_t), clusters.GetLightIndices().data());
+
+			m_fsQuad->Draw(context);
+		}
+
+		void LightingSystem::SunLight(CommandContext* context)
+		{
+			auto* render = Render::GetInstance();
+			const auto& renderScene = *render->GetRenderScene();
+			const auto& sun = renderScene.Sun;
+
+			if (!sun.IsEnabled)
 			{
-				PIXScopedEvent(context->List.Get(), PIX_COLOR(0, 255, 0), "Point Light Shading");
-				auto barrierStencil = CD3DX12_RESOURCE_BARRIER::Transition(depth.GetResource(), D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, 0);
-				auto barrierStencil2 = CD3DX12_RESOURCE_BARRIER::Transition(depth.GetResource(), D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_DEPTH_READ, 1);
-				D3D12_RESOURCE_BARRIER barriers[] = { barrierStencil , barrierStencil2 };
-				context->List->ResourceBarrier(2, barriers);
-				context->List->OMSetStencilRef(0);
+				return;
+			}
 
-				m_pointLight->Set(context);
+			PIXScopedEvent(context->List.Get(), PIX_COLOR(0, 255, 0), "Sun Light");
 
-				ScreenParams screenParams;
-				screenParams.Params = { static_cast<float>(alexis::g_clientWidth), static_cast<float>(alexis::g_clientHeight),
-					1.0f / alexis::g_clientWidth, 1.0f / alexis::g_clientHeight };
+			auto* rtManager = render->GetRTManager();
+			auto* gbuffer = rtManager->GetRenderTarget(L"GB");
+			auto* hdr = rtManager->GetRenderTarget(L"HDR");
+			auto& shadowMap = rtManager->GetRenderTarget(L"Shadow Map")->GetTexture(RenderTarget::DepthStencil);
 
-				context->SetDynamicCBV(2, sizeof(screenParams), &screenParams);
+			// ShadowSystem::EndRender left the shadow map in COMMON, depth textures are not promoted implicitly
+			context->TransitionResource(shadowMap, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
-				CameraParams cameraParams;
-				cameraParams.CameraPos = transformComponent.Position;
-				cameraParams.InvViewMatrix = cameraSystem->GetInvViewMatrix(activeCamera);
-				cameraParams.InvProjMatrix = cameraSystem->GetInvProjMatrix(activeCamera);
+			context->SetRenderTarget(*hdr, *gbuffer);
+			context->SetViewport(hdr->GetViewport());
 
-				context->SetDynamicCBV(3, sizeof(cameraParams), &cameraParams);
+			m_sunLight->Set(context);
 
-				for (auto entity : Entities)
-				{
-					auto& lightComponent = ecsWorld.GetComponent<LightComponent>(entity);
-					auto& transformComponent = ecsWorld.GetComponent<TransformComponent>(entity);
-					if (lightComponent.Type == ecs::LightComponent::LightType::Point)
-					{
-						float scale = CalculatePointLightScale(lightComponent.Color, transformComponent.Position);
-						XMMATRIX wvpMatrix = XMMatrixIdentity() * XMMatrixScaling(scale, scale, scale) * XMMatrixTranslationFromVector(transformComponent.Position) * cameraSystem->GetViewMatrix(activeCamera) * cameraSystem->GetProjMatrix(activeCamera);
+			const auto& mainView = renderScene.Views[RenderScene::k_mainView];
 
-						PointLightParams pl{ transformComponent.Position, lightComponent.Color };
+			CameraParams cameraParams;
+			cameraParams.CameraPos = mainView.Position;
+			cameraParams.InvViewMatrix = mainView.InvView;
+			cameraParams.InvProjMatrix = mainView.InvProj;
+			context->SetDynamicCBV(0, sizeof(cameraParams), &cameraParams);
 
-						context->SetDynamicCBV(1, sizeof(pl), &pl);
+			static_assert(RenderScene::k_shadowCascadeCount == 4, "SunParams packs one cascade per vector component");
 
-						m_sphere->Draw(context);
-					}
-				}
+			const auto& cascades = renderScene.ShadowCascades;
+
+			SunParams sunParams;
+			sunParams.Direction = sun.Direction;
+			sunParams.Color = sun.Color;
+			sunParams.ViewMatrix = mainView.View;
+			sunParams.CascadeSplits = XMVectorSet(cascades[0].SplitFar, cascades[1].SplitFar, cascades[2].SplitFar, cascades[3].SplitFar);
+			sunParams.CascadeTexelSizes = XMVectorSet(cascades[0].TexelSize, cascades[1].TexelSize, cascades[2].TexelSize, cascades[3].TexelSize);
+			for (std::size_t i = 0; i < RenderScene::k_shadowCascadeCount; ++i)
+			{
+				sunParams.ShadowMatrices[i] = cascades[i].ShadowMatrix;
 			}
+			context->SetDynamicCBV(1, sizeof(sunParams), &sunParams);
+
+			m_fsQuad->Draw(context);
+
+			context->TransitionResource(shadowMap, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COMMON);
 		}
 
 		void LightingSystem::AmbientLight(CommandContext* context)
@@ -242,46 +463,30 @@ namespace alexis
 			auto* render = Render::GetInstance();
 			auto* rtManager = render->GetRTManager();
 			auto* gbuffer = rtManager->GetRenderTarget(L"GB");
-			//auto* shadowMapRT = rtManager->GetRenderTarget(L"Shadow Map");
 			auto* hdr = rtManager->GetRenderTarget(L"HDR");
-			auto* irradiance = rtManager->GetRenderTarget(L"CUBEMAP_Irradiance");
 			auto* prefiltered = rtManager->GetRenderTarget(L"CUBEMAP_Prefiltered");
 			auto* convBRDF = rtManager->GetRenderTarget(L"ConvolutedBRDF");
 
 			auto& depth = gbuffer->GetTexture(RenderTarget::DepthStencil);
-			//auto& shadowMap = shadowMapRT->GetTexture(RenderTarget::DepthStencil);
 
 			context->SetRenderTarget(*hdr, *gbuffer);
 			context->SetViewport(hdr->GetViewport());
 
 			m_ambientLight->Set(context);
 
-			auto& ecsWorld = Core::Get().GetECSWorld();
-			auto cameraSystem = ecsWorld.GetSystem<CameraSystem>();
-			auto activeCamera = cameraSystem->GetActiveCamera();
-
-			auto& transformComponent = ecsWorld.GetComponent<TransformComponent>(activeCamera);
+			const auto& renderScene = *render->GetRenderScene();
+			const auto& mainView = renderScene.Views[RenderScene::k_mainView];
 
 			CameraParams cameraParams;
-			cameraParams.CameraPos = transformComponent.Position;
-			cameraParams.InvViewMatrix = cameraSystem->GetInvViewMatrix(activeCamera);
-			cameraParams.InvProjMatrix = cameraSystem->GetInvProjMatrix(activeCamera);
+			cameraParams.CameraPos = mainView.Position;
+			cameraParams.InvViewMatrix = mainView.InvView;
+			cameraParams.InvProjMatrix = mainView.InvProj;
 			context->SetDynamicCBV(0, sizeof(cameraParams), &cameraParams);
 
-			//ShadowMapParams depthParams;
-
-			//auto shadowSystem = ecsWorld.GetSystem<ShadowSystem>();
-			//depthParams.LightSpaceMatrix = shadowSystem->GetShadowMatrix();
-
-			//context->SetDynamicCBV(2, sizeof(depthParams), &depthParams);
+			context->SetDynamicCBV(2, sizeof(renderScene.IrradianceSH), &renderScene.IrradianceSH);
 
 			m_fsQuad->Draw(context);
 		}
 
-		DirectX::XMVECTOR LightingSystem::GetSunDirection() const
-		{
-			return { 0., 0., 0.f };
-		}
-
 	}
 }
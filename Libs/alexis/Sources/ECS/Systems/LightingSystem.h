@@ -1,12 +1,18 @@
 #pragma once
 
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 #include <ECS/ECS.h>
+#include <ECS/Components/LightComponent.h>
 
 namespace alexis
 {
 	class Material;
 	class CommandContext;
 	class Mesh;
+	struct RenderScene;
 
 	namespace ecs
 	{
@@ -14,18 +20,58 @@ namespace alexis
 		{
 		public:
 			void Init();
+
+			// Copies lights into RenderScene::PointLights, SpotLights and Sun, only chunks changed since the previous extract are read.
+			// Then bins point and spot lights into RenderScene::LightClusters for the main view
+			void Extract(RenderScene& renderScene);
+
 			void Render(CommandContext* context);
-			void PointLights(CommandContext* context);
+
+			// Point and spot lights in one full-screen pass, every pixel shades the lights of its cluster
+			void ClusteredLights(CommandContext* context);
+
+			// Sun in a full-screen pass, shadowed by RenderScene::ShadowCascades
+			void SunLight(CommandContext* context);
 			void AmbientLight(CommandContext* context);
-			DirectX::XMVECTOR GetSunDirection() const;
 
 		private:
+			static constexpr std::uint32_t k_invalidProxy = std::numeric_limits<std::uint32_t>::max();
+
+			// Set in proxy indices of spot lights
+			static constexpr std::uint32_t k_spotProxyFlag = 1u << 31;
+
+			// Proxy index of directional lights, only the sun entity is extracted
+			static constexpr std::uint32_t k_sunProxy = k_invalidProxy - 1;
+
+			// Cluster grid, depths below k_clusterNearZ share the first slice
+			static constexpr std::uint32_t k_clusterTilesX = 16;
+			static constexpr std::uint32_t k_clusterTilesY = 9;
+			static constexpr std::uint32_t k_clusterSlices = 24;
+			static constexpr float k_clusterNearZ = 0.5f;
+
+			static LightComponent::LightType GetProxyType(std::uint32_t proxy);
+
+			void RebuildProxies(RenderScene& renderScene);
+			void BinLights(RenderScene& renderScene);
+
 			Mesh* m_fsQuad{ nullptr };
-			Mesh* m_sphere{ nullptr };
 
-			std::unique_ptr<Material> m_pointLightStencil;
-			std::unique_ptr<Material> m_pointLight;
+			std::unique_ptr<Material> m_clusteredLights;
+			std::unique_ptr<Material> m_sunLight;
 			std::unique_ptr<Material> m_ambientLight;
+
+			// Entity::Index -> proxy index in RenderScene::PointLights, or in RenderScene::SpotLights with k_spotProxyFlag
+			std::vector<std::uint32_t> m_proxyIndices;
+
+			// Entity::Index of the directional light in RenderScene::Sun
+			std::uint32_t m_sunEntityIndex{ k_invalidEntityIndex };
+
+			// Projection the cluster grid was built for: Proj._11, Proj._22, Proj._33, Proj._43
+			DirectX::XMFLOAT4 m_clusterProjection{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+			// Entities.GetVersion() the proxies were built for
+			std::uint32_t m_extractedEntitiesVersion{ std::numeric_limits<std::uint32_t>::max() };
+			std::uint32_t m_lastExtractVersion{ 0 };
 		};
 	}
 }
\ No newline at end of file
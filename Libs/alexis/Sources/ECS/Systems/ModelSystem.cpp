@@ -4,13 +4,11 @@
 
 #include <Core/Core.h>
 #include <Render/Render.h>
+#include <Render/RenderScene.h>
 #include <Render/Mesh.h>
 #include <Render/CommandContext.h>
 #include <Render/Materials/MaterialBase.h>
 
-#include <ECS/Systems/CameraSystem.h>
-
-#include <ECS/Components/CameraComponent.h>
 #include <ECS/Components/ModelComponent.h>
 #include <ECS/Components/TransformComponent.h>
 
@@ -24,61 +22,85 @@ namespace alexis
 			XMMATRIX projMatrix;
 		};
 
-		void ModelSystem::Update(float dt)
+		void ModelSystem::QueryFrustum(const std::array<XMVECTOR, 6>& planes, std::vector<Entity>& out) const
 		{
-			auto& ecsWorld = Core::Get().GetECSWorld();
-			for (const auto& entity : Entities)
-			{
-				auto& modelComponent = ecsWorld.GetComponent<ModelComponent>(entity);
-				auto& transformComponent = ecsWorld.GetComponent<TransformComponent>(entity);
-
-				if (modelComponent.IsTransformDirty || transformComponent.IsTransformDirty)
-				{
-					XMMATRIX translationMatrix = XMMatrixTranslationFromVector(transformComponent.Position);
-					XMMATRIX rotationMatrix = XMMatrixRotationQuaternion(transformComponent.Rotation);
-					XMMATRIX scalingMatrix = XMMatrixScaling(transformComponent.UniformScale, transformComponent.UniformScale, transformComponent.UniformScale);
-
-					modelComponent.ModelMatrix = XMMatrixMultiply(XMMatrixMultiply(scalingMatrix, rotationMatrix), translationMatrix);
-					
-					modelComponent.IsTransformDirty = false;
-					transformComponent.IsTransformDirty = false;
-				}
-			}
+			thread_local std::vector<std::uint32_t> proxies;
+			proxies.clear();
+
+			alexis::Render::GetInstance()->GetRenderScene()->ModelBvh.QueryFrustum(planes, proxies);
+			AppendEntities(proxies, out);
 		}
 
-		// TODO: remove XMMATRIX viewProj arg
-		void XM_CALLCONV ModelSystem::Render(CommandContext* context)
+		void XM_CALLCONV ModelSystem::QuerySphere(FXMVECTOR center, float radius, std::vector<Entity>& out) const
 		{
-			PIXScopedEvent(context->List.Get(), PIX_COLOR(0, 255, 0), "ModelSystem Render");
+			thread_local std::vector<std::uint32_t> proxies;
+			proxies.clear();
+
+			alexis::Render::GetInstance()->GetRenderScene()->ModelBvh.QuerySphere(center, radius, proxies);
+			AppendEntities(proxies, out);
+		}
 
-			auto& ecsWorld = Core::Get().GetECSWorld();
-			auto cameraSystem = ecsWorld.GetSystem<CameraSystem>();
-			auto activeCamera = cameraSystem->GetActiveCamera();
+		void ModelSystem::QueryBox(const BoundingBox& box, std::vector<Entity>& out) const
+		{
+			thread_local std::vector<std::uint32_t> proxies;
+			proxies.clear();
 
-			auto viewMatrix = cameraSystem->GetViewMatrix(activeCamera);
-			auto projMatrix = cameraSystem->GetProjMatrix(activeCamera);
+			alexis::Render::GetInstance()->GetRenderScene()->ModelBvh.QueryBox(box, proxies);
+			AppendEntities(proxies, out);
+		}
 
-			//auto viewProjMatrix = XMMatrixMultiply(viewMatrix, projMatrix);
+		bool XM_CALLCONV ModelSystem::Raycast(FXMVECTOR origin, FXMVECTOR direction, float maxDistance, Entity& outEntity, float& outDistance) const
+		{
+			std::uint32_t proxy = 0;
+			if (!alexis::Render::GetInstance()->GetRenderScene()->ModelBvh.Raycast(origin, direction, maxDistance, proxy, outDistance))
+			{
+				return false;
+			}
+
+			outEntity = m_proxyEntities[proxy];
+			return true;
+		}
+
+		void ModelSystem::AppendEntities(const std::vector<std::uint32_t>& proxies, std::vector<Entity>& out) const
+		{
+			out.reserve(out.size() + proxies.size());
+			for (auto proxy : proxies)
+			{
+				out.push_back(m_proxyEntities[proxy]);
+			}
+		}
+
+		void ModelSystem::Render(CommandContext* context, std::size_t first, std::size_t last)
+		{
+			PIXScopedEvent(context->List.Get(), PIX_COLOR(0, 255, 0), "ModelSystem Render");
 
 			auto* render = alexis::Render::GetInstance();
 			auto* rtManager = render->GetRTManager();
 			auto* gbuffer = rtManager->GetRenderTarget(L"GB");
 
+			const auto& renderScene = *render->GetRenderScene();
+			const auto& models = renderScene.Models;
+
 			context->SetRenderTarget(*gbuffer);
 			context->SetViewport(gbuffer->GetViewport());
 
-			for (const auto& entity : Entities)
-			{
-				auto& modelComponent = ecsWorld.GetComponent<ModelComponent>(entity);
-				CameraCB cameraCB;
-				cameraCB.viewMatrix = viewMatrix;
-				cameraCB.projMatrix = projMatrix;
+			const auto& mainView = renderScene.Views[RenderScene::k_mainView];
 
-				modelComponent.Material->Set(context);
+			CameraCB cameraCB;
+			cameraCB.viewMatrix = mainView.View;
+			cameraCB.projMatrix = mainView.Proj;
+
+			const auto& visibleModels = renderScene.VisibleModels[RenderScene::k_mainView];
+			assert(first <= last && last <= visibleModels.size() && "Draw range out of the visible models");
+
+			for (std::size_t draw = first; draw < last; ++draw)
+			{
+				auto i = visibleModels[draw];
+				models.Materials[i]->Set(context);
 
 				context->SetDynamicCBV(0, sizeof(cameraCB), &cameraCB);
-				context->SetDynamicCBV(1, sizeof(modelComponent.ModelMatrix), &modelComponent.ModelMatrix);
-				modelComponent.Mesh->Draw(context);
+				context->SetDynamicCBV(1, sizeof(models.WorldMatrices[i]), &models.WorldMatrices[i]);
+				models.Meshes[i]->Draw(context);
 			}
 		}
 	}
@@ -1,6 +1,13 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 #include <DirectXMath.h>
+#include <DirectXCollision.h>
 
 #include <ECS/ECS.h>
 
@@ -8,14 +15,41 @@ namespace alexis
 {
 	class Mesh;
 	class CommandContext;
+	struct RenderScene;
 
 	namespace ecs
 	{
 		class ModelSystem : public ecs::System
 		{
 		public:
-			void Update(float dt);
-			void XM_CALLCONV Render(CommandContext* context);
+			// Copies models into RenderScene::Models, only chunks changed since the previous extract are read.
+			// Models moved by the write are listed in RenderScene::MovedModels
+			void Extract(RenderScene& renderScene);
+
+			// Draws [first, last) of the models visible in the main view, ranges can be recorded into different contexts in parallel
+			void Render(CommandContext* context, std::size_t first, std::size_t last);
+
+			// Spatial queries over model world bounds as of the last Extract, results are appended to out.
+			// Frustum planes as in ViewData::FrustumPlanes, ray direction must be normalized
+			void QueryFrustum(const std::array<DirectX::XMVECTOR, 6>& planes, std::vector<Entity>& out) const;
+			void XM_CALLCONV QuerySphere(DirectX::FXMVECTOR center, float radius, std::vector<Entity>& out) const;
+			void QueryBox(const DirectX::BoundingBox& box, std::vector<Entity>& out) const;
+			bool XM_CALLCONV Raycast(DirectX::FXMVECTOR origin, DirectX::FXMVECTOR direction, float maxDistance, Entity& outEntity, float& outDistance) const;
+
+		private:
+			void AppendEntities(const std::vector<std::uint32_t>& proxies, std::vector<Entity>& out) const;
+
+			static constexpr std::uint32_t k_invalidProxy = std::numeric_limits<std::uint32_t>::max();
+
+			// Entity::Index -> proxy index in RenderScene::Models
+			std::vector<std::uint32_t> m_proxyIndices;
+
+			// Proxy index -> entity, maps query results back
+			std::vector<Entity> m_proxyEntities;
+
+			// Entities.GetVersion() the proxies were built for
+			std::uint32_t m_extractedEntitiesVersion{ std::numeric_limits<std::uint32_t>::max() };
+			std::uint32_t m_lastExtractVersion{ 0 };
 		};
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,114 @@
+#include <Precompiled.h>
+
+#include <cstring>
+
+#include "ModelSystem.h"
+
+#include <Core/Core.h>
+#include <Core/JobSystem.h>
+#include <Render/RenderScene.h>
+#include <Render/Mesh.h>
+
+#include <ECS/Components/ModelComponent.h>
+
+// Extract only reads ECS and writes RenderScene, kept apart from the D3D side of ModelSystem so it builds headless
+namespace alexis
+{
+	namespace ecs
+	{
+		namespace
+		{
+			bool IsMoved(const RenderScene::ModelProxies& models, std::uint32_t proxy, const ModelComponent& modelComponent)
+			{
+				return models.Meshes[proxy] != modelComponent.Mesh || std::memcmp(&models.WorldMatrices[proxy], &modelComponent.ModelMatrix, sizeof(XMMATRIX)) != 0;
+			}
+
+			void WriteProxy(RenderScene::ModelProxies& models, std::uint32_t proxy, const ModelComponent& modelComponent)
+			{
+				models.WorldMatrices[proxy] = modelComponent.ModelMatrix;
+				models.Meshes[proxy] = modelComponent.Mesh;
+				models.Materials[proxy] = modelComponent.Material;
+
+				BoundingSphere worldSphere;
+				modelComponent.Mesh->GetBoundingSphere().Transform(worldSphere, modelComponent.ModelMatrix);
+				models.SphereCenterX[proxy] = worldSphere.Center.x;
+				models.SphereCenterY[proxy] = worldSphere.Center.y;
+				models.SphereCenterZ[proxy] = worldSphere.Center.z;
+				models.SphereRadius[proxy] = worldSphere.Radius;
+
+				modelComponent.Mesh->GetBoundingBox().Transform(models.Boxes[proxy], modelComponent.ModelMatrix);
+			}
+		}
+
+		void ModelSystem::Extract(RenderScene& renderScene)
+		{
+			auto& ecsWorld = Core::Get().GetECSWorld();
+			auto& models = renderScene.Models;
+			auto& movedModels = renderScene.MovedModels;
+
+			movedModels.clear();
+
+			if (m_extractedEntitiesVersion != Entities.GetVersion())
+			{
+				// Membership changed: rebuild proxies in Entities order
+				m_proxyIndices.assign(m_proxyIndices.size(), k_invalidProxy);
+				m_proxyEntities.resize(Entities.size());
+				models.Resize(Entities.size());
+
+				std::uint32_t proxy = 0;
+				for (auto entity : Entities)
+				{
+					if (entity.Index >= m_proxyIndices.size())
+					{
+						m_proxyIndices.resize(entity.Index + 1, k_invalidProxy);
+					}
+					m_proxyIndices[entity.Index] = proxy;
+					m_proxyEntities[proxy] = entity;
+
+					WriteProxy(models, proxy++, ecsWorld.GetComponent<const ModelComponent>(entity));
+				}
+
+				m_extractedEntitiesVersion = Entities.GetVersion();
+				++renderScene.ModelsVersion;
+
+				renderScene.ModelBvh.Build(models.Boxes.data(), models.Size(), &Core::Get().GetJobSystem());
+			}
+			else
+			{
+				bool isAnyWritten = false;
+				ecsWorld.ForEachChunk<const ModelComponent>([this, &models, &movedModels, &isAnyWritten](std::size_t count, const Entity* entities, const ModelComponent* modelComponents)
+				{
+					for (std::size_t i = 0; i < count; ++i)
+					{
+						// Models without transform are not rendered
+						std::uint32_t index = entities[i].Index;
+						if (index < m_proxyIndices.size() && m_proxyIndices[index] != k_invalidProxy)
+						{
+							// Whole chunks are reported changed, only models that really moved go to the list
+							std::uint32_t proxy = m_proxyIndices[index];
+							if (IsMoved(models, proxy, modelComponents[i]))
+							{
+								movedModels.push_back(proxy);
+							}
+
+							WriteProxy(models, proxy, modelComponents[i]);
+							isAnyWritten = true;
+						}
+					}
+				}, Changed<ModelComponent>{ m_lastExtractVersion });
+
+				// Moved models keep their place in the tree until refits degrade it too much
+				if (isAnyWritten)
+				{
+					renderScene.ModelBvh.Refit(models.Boxes.data());
+					if (renderScene.ModelBvh.NeedsRebuild())
+					{
+						renderScene.ModelBvh.Build(models.Boxes.data(), models.Size(), &Core::Get().GetJobSystem());
+					}
+				}
+			}
+
+			m_lastExtractVersion = ecsWorld.AdvanceChangeVersion();
+		}
+	}
+}
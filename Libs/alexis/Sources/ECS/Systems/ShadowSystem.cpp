@@ -5,17 +5,11 @@
 #include <Core/Core.h>
 #include <Core/ResourceManager.h>
 #include <Render/Render.h>
+#include <Render/RenderScene.h>
 #include <Render/Mesh.h>
 #include <Render/CommandContext.h>
 
-#include <ECS/Systems/CameraSystem.h>
-#include <ECS/Systems/LightingSystem.h>
-
-#include <ECS/Components/ModelComponent.h>
-#include <ECS/Components/TransformComponent.h>
-#include <ECS/Components/LightComponent.h>
-#include <ECS/Components/NameComponent.h>
-#include <ECS/Components/DoNotSerializeComponent.h>
+#include <Utils/ShadowCascades.h>
 
 namespace alexis
 {
@@ -32,71 +26,269 @@ namespace alexis
 			auto* resMgr = Core::Get().GetResourceManager();
 			m_shadowMaterial = resMgr->GetMaterial(L"Resources/Materials/system/ShadowMap.material");
 
-			auto& ecsWorld = Core::Get().GetECSWorld();
-			auto entity = ecsWorld.CreateEntity();
-			ecsWorld.AddComponent(entity, ecs::CameraComponent{ 0.1f, 1.0f, 0.01f, 100.f, true });
-			ecsWorld.AddComponent(entity, ecs::NameComponent{ "ShadowMap Phantom Camera" });
-			m_phantomCamera = entity;
+			m_casterCache.SetViewCount(RenderScene::k_shadowCascadeCount);
+		}
+
+		void ShadowSystem::Extract(RenderScene& renderScene)
+		{
+			static_assert(RenderScene::k_shadowCascadeCount <= k_cascadeAtlasColumns * k_cascadeAtlasColumns, "Cascades do not fit the shadow atlas");
+
+			auto* shadowRT = alexis::Render::GetInstance()->GetRTManager()->GetRenderTarget(L"Shadow Map");
+			const std::uint32_t cascadeResolution = shadowRT->GetSize().x / k_cascadeAtlasColumns;
+
+			const auto& mainView = renderScene.Views[RenderScene::k_mainView];
+
+			XMFLOAT4X4 proj;
+			XMStoreFloat4x4(&proj, mainView.Proj);
+			float nearZ = -proj._43 / proj._33;
+			float farZ = proj._43 / (1.0f - proj._33);
+
+			float splits[RenderScene::k_shadowCascadeCount + 1];
+			utils::ComputeCascadeSplits(nearZ, std::min(farZ, k_shadowDistance), k_cascadeSplitLambda, RenderScene::k_shadowCascadeCount, splits);
+
+			// Without a sun the cascades are still fitted, UpdateCasterCache leaves them empty
+			XMVECTOR sunDirection = renderScene.Sun.Direction;
+			BoundingBox casterBounds = renderScene.ModelBvh.GetBounds();
+
+			const float tileScale = 1.0f / k_cascadeAtlasColumns;
+
+			for (std::size_t i = 0; i < RenderScene::k_shadowCascadeCount; ++i)
+			{
+				auto projection = utils::FitCascade(sunDirection, mainView.InvView, proj._11, proj._22, splits[i], splits[i + 1], cascadeResolution, casterBounds,
+					k_cachedSnapTexels);
+
+				auto& view = renderScene.Views[RenderScene::k_shadowView + i];
+				BuildViewData(projection.Position, projection.View, XMMatrixInverse(nullptr, projection.View), projection.Proj, XMMatrixInverse(nullptr, projection.Proj), view);
+
+				// Casters under a texel do not show up in the map
+				view.MinModelRadius = 0.5f * projection.TexelSize;
 
-			auto lightingSystem = ecsWorld.GetSystem<LightingSystem>();
-			XMVECTOR rotation = XMQuaternionRotationRollPitchYaw(XMConvertToRadians(90.f), 0.f, 0);
-			ecsWorld.AddComponent(entity, ecs::TransformComponent{ -lightingSystem->GetSunDirection(), rotation, {1.f} });
-			ecsWorld.AddComponent(entity, ecs::DoNotSerializeComponent{}); // Dynamic object, do not serialize
-			
-			//auto cameraSystem = ecsWorld.GetSystem<CameraSystem>();
-			//cameraSystem->LookAt(m_phantomCamera, { 0.f, 0.f, 0.f }, { 0.f, 1.f, 0.f });
+				// Clip space -> UV of the cascade tile
+				float column = static_cast<float>(i % k_cascadeAtlasColumns);
+				float row = static_cast<float>(i / k_cascadeAtlasColumns);
+				XMMATRIX clipToTile = XMMatrixSet(
+					0.5f * tileScale, 0.0f, 0.0f, 0.0f,
+					0.0f, -0.5f * tileScale, 0.0f, 0.0f,
+					0.0f, 0.0f, 1.0f, 0.0f,
+					(0.5f + column) * tileScale, (0.5f + row) * tileScale, 0.0f, 1.0f);
+
+				auto& cascade = renderScene.ShadowCascades[i];
+				cascade.SplitNear = splits[i];
+				cascade.SplitFar = splits[i + 1];
+				cascade.TexelSize = projection.TexelSize;
+				cascade.ShadowMatrix = XMMatrixMultiply(view.ViewProj, clipToTile);
+			}
 		}
 
-		// TODO: remove XMMATRIX viewProj arg
-		void XM_CALLCONV ShadowSystem::Render(CommandContext* context)
+		void ShadowSystem::UpdateCasterCache(RenderScene& renderScene)
 		{
-			auto& ecsWorld = Core::Get().GetECSWorld();
+			if (!renderScene.Sun.IsEnabled)
+			{
+				for (auto& cascade : renderScene.ShadowCascades)
+				{
+					cascade.IsCacheStale = false;
+					cascade.StaticCasters.clear();
+					cascade.DynamicCasters.clear();
+				}
+				return;
+			}
 
-			auto cameraSystem = ecsWorld.GetSystem<CameraSystem>();
-			auto lightingSystem = ecsWorld.GetSystem<LightingSystem>();
-			cameraSystem->SetPosition(m_phantomCamera, -lightingSystem->GetSunDirection());
-			cameraSystem->LookAt(m_phantomCamera, { 0.f, 0.f, 0.f }, { 0.f, 1.f, 0.f });
+			const auto& movedModels = renderScene.MovedModels;
+			m_casterCache.UpdateCasters(renderScene.Models.Size(), renderScene.ModelsVersion, movedModels.data(), movedModels.size());
 
-			DepthCB depthParams;
+			for (std::size_t i = 0; i < RenderScene::k_shadowCascadeCount; ++i)
+			{
+				const std::size_t viewIndex = RenderScene::k_shadowView + i;
 
-			auto m2 = cameraSystem->GetViewMatrix(m_phantomCamera);
-			auto proj2 = cameraSystem->GetProjMatrix(m_phantomCamera);
-			depthParams.viewProjMatrix = XMMatrixMultiply(m2, proj2);
+				auto& cascade = renderScene.ShadowCascades[i];
+				cascade.IsCacheStale = m_casterCache.UpdateView(i, renderScene.Views[viewIndex].ViewProj, renderScene.Sun.Version, renderScene.VisibleModels[viewIndex],
+					cascade.StaticCasters, cascade.DynamicCasters);
+			}
+		}
 
+		bool ShadowSystem::IsCacheStale() const
+		{
+			const auto& cascades = alexis::Render::GetInstance()->GetRenderScene()->ShadowCascades;
+			return std::any_of(cascades.begin(), cascades.end(), [](const auto& cascade) { return cascade.IsCacheStale; });
+		}
+
+		bool ShadowSystem::IsCacheUsed() const
+		{
+			const auto& cascades = alexis::Render::GetInstance()->GetRenderScene()->ShadowCascades;
+			return std::any_of(cascades.begin(), cascades.end(), [](const auto& cascade) { return !cascade.StaticCasters.empty(); });
+		}
+
+		void ShadowSystem::BeginCache(CommandContext* context)
+		{
 			auto* render = alexis::Render::GetInstance();
-			auto* rtManager = render->GetRTManager();
-			auto* shadowRT = rtManager->GetRenderTarget(L"Shadow Map");
+			auto* cacheRT = render->GetRTManager()->GetRenderTarget(L"Shadow Cache");
+			const auto& cascades = render->GetRenderScene()->ShadowCascades;
 
-			context->SetRenderTarget(*shadowRT);
-			context->SetViewport(shadowRT->GetViewport());
+			context->TransitionResource(cacheRT->GetTexture(RenderTarget::DepthStencil), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+
+			for (std::size_t cascade = 0; cascade < RenderScene::k_shadowCascadeCount; ++cascade)
+			{
+				if (cascades[cascade].IsCacheStale)
+				{
+					context->ClearDSV(cacheRT->GetDsv(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, GetCascadeRect(*cacheRT, cascade), 1.0f, 0);
+				}
+			}
+		}
+
+		std::size_t ShadowSystem::GetCacheDrawCount() const
+		{
+			return CountCasters(*alexis::Render::GetInstance()->GetRenderScene(), true);
+		}
+
+		void XM_CALLCONV ShadowSystem::RenderCache(CommandContext* context, std::size_t first, std::size_t last)
+		{
+			if (first == last)
+			{
+				return;
+			}
+
+			auto* render = alexis::Render::GetInstance();
+			auto* cacheRT = render->GetRTManager()->GetRenderTarget(L"Shadow Cache");
 
 			m_shadowMaterial->Set(context);
+			context->SetRenderTarget(*cacheRT);
 
-			for (const auto& entity : Entities)
+			DrawCasters(context, *cacheRT, *render->GetRenderScene(), true, first, last);
+		}
+
+		void ShadowSystem::ResolveCache(CommandContext* context)
+		{
+			auto* rtManager = alexis::Render::GetInstance()->GetRTManager();
+			auto* shadowRT = rtManager->GetRenderTarget(L"Shadow Map");
+			auto& shadowDepth = shadowRT->GetTexture(RenderTarget::DepthStencil);
+			auto& cacheDepth = rtManager->GetRenderTarget(L"Shadow Cache")->GetTexture(RenderTarget::DepthStencil);
+
+			// BeginCache left the cache in DEPTH_WRITE
+			const bool isCacheWritten = IsCacheStale();
+
+			if (!IsCacheUsed())
 			{
-				auto& modelComponent = ecsWorld.GetComponent<ModelComponent>(entity);
+				if (isCacheWritten)
+				{
+					context->TransitionResource(cacheDepth, D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_COMMON);
+				}
+
+				context->TransitionResource(shadowDepth, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+				context->ClearDSV(shadowRT->GetDsv(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0);
+				return;
+			}
+
+			context->TransitionResource(cacheDepth, isCacheWritten ? D3D12_RESOURCE_STATE_DEPTH_WRITE : D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_SOURCE);
+
+			// Depth-stencil copies cover whole subresources, every tile is copied
+			context->TransitionResource(shadowDepth, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
+			context->CopyResource(shadowDepth, cacheDepth);
+			context->TransitionResource(cacheDepth, D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_RESOURCE_STATE_COMMON);
+			context->TransitionResource(shadowDepth, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_DEPTH_WRITE);
+		}
 
-				depthParams.modelMatrix = modelComponent.ModelMatrix;
+		std::size_t ShadowSystem::GetCasterDrawCount() const
+		{
+			return CountCasters(*alexis::Render::GetInstance()->GetRenderScene(), false);
+		}
 
-				context->SetDynamicCBV(0, sizeof(depthParams), &depthParams);
-				modelComponent.Mesh->Draw(context);
+		void XM_CALLCONV ShadowSystem::RenderCasters(CommandContext* context, std::size_t first, std::size_t last)
+		{
+			if (first == last)
+			{
+				return;
 			}
+
+			auto* render = alexis::Render::GetInstance();
+			auto* shadowRT = render->GetRTManager()->GetRenderTarget(L"Shadow Map");
+
+			m_shadowMaterial->Set(context);
+			context->SetRenderTarget(*shadowRT);
+
+			DrawCasters(context, *shadowRT, *render->GetRenderScene(), false, first, last);
 		}
 
-		DirectX::XMMATRIX ShadowSystem::GetShadowMatrix() const
+		void ShadowSystem::EndRender(CommandContext* context)
 		{
-			auto& ecsWorld = Core::Get().GetECSWorld();
+			auto* shadowRT = alexis::Render::GetInstance()->GetRTManager()->GetRenderTarget(L"Shadow Map");
 
-			auto cameraSystem = ecsWorld.GetSystem<CameraSystem>();
+			// Back to the state the next frame expects
+			context->TransitionResource(shadowRT->GetTexture(RenderTarget::DepthStencil), D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_RESOURCE_STATE_COMMON);
+		}
 
-			auto modelMatrix = XMMatrixIdentity();
-			auto viewMatrix = cameraSystem->GetViewMatrix(m_phantomCamera);
-			auto projMatrix = cameraSystem->GetProjMatrix(m_phantomCamera);
+		Viewport ShadowSystem::GetCascadeViewport(const RenderTarget& atlas, std::size_t cascade)
+		{
+			const float tileScale = 1.0f / k_cascadeAtlasColumns;
 
-			auto modelView = XMMatrixMultiply(modelMatrix, viewMatrix);
+			float column = static_cast<float>(cascade % k_cascadeAtlasColumns);
+			float row = static_cast<float>(cascade / k_cascadeAtlasColumns);
+			return atlas.GetViewport({ tileScale, tileScale }, { column * tileScale, row * tileScale });
+		}
 
-			return XMMatrixMultiply(modelView, projMatrix);
+		D3D12_RECT ShadowSystem::GetCascadeRect(const RenderTarget& atlas, std::size_t cascade)
+		{
+			auto viewport = GetCascadeViewport(atlas, cascade);
+			return CD3DX12_RECT(static_cast<LONG>(viewport.Viewport.TopLeftX), static_cast<LONG>(viewport.Viewport.TopLeftY),
+				static_cast<LONG>(viewport.Viewport.TopLeftX + viewport.Viewport.Width), static_cast<LONG>(viewport.Viewport.TopLeftY + viewport.Viewport.Height));
 		}
 
+		std::size_t ShadowSystem::CountCasters(const RenderScene& renderScene, bool isCache)
+		{
+			std::size_t count = 0;
+			for (const auto& cascade : renderScene.ShadowCascades)
+			{
+				if (!isCache)
+				{
+					count += cascade.DynamicCasters.size();
+				}
+				else if (cascade.IsCacheStale)
+				{
+					count += cascade.StaticCasters.size();
+				}
+			}
+
+			return count;
+		}
+
+		void ShadowSystem::DrawCasters(CommandContext* context, const RenderTarget& atlas, const RenderScene& renderScene, bool isCache, std::size_t first, std::size_t last) const
+		{
+			const auto& models = renderScene.Models;
+
+			std::size_t listStart = 0;
+			for (std::size_t cascade = 0; cascade < RenderScene::k_shadowCascadeCount && listStart < last; ++cascade)
+			{
+				const auto& shadowCascade = renderScene.ShadowCascades[cascade];
+				if (isCache && !shadowCascade.IsCacheStale)
+				{
+					continue;
+				}
+
+				const auto& casters = isCache ? shadowCascade.StaticCasters : shadowCascade.DynamicCasters;
+
+				// Part of the range falling into this list
+				std::size_t begin = std::max(first, listStart) - listStart;
+				std::size_t end = std::min(last, listStart + casters.size()) - listStart;
+				listStart += casters.size();
+
+				if (begin >= end)
+				{
+					continue;
+				}
+
+				context->SetViewport(GetCascadeViewport(atlas, cascade));
+
+				DepthCB depthParams;
+				depthParams.viewProjMatrix = renderScene.Views[RenderScene::k_shadowView + cascade].ViewProj;
+
+				for (std::size_t draw = begin; draw < end; ++draw)
+				{
+					auto i = casters[draw];
+					depthParams.modelMatrix = models.WorldMatrices[i];
+
+					context->SetDynamicCBV(0, sizeof(depthParams), &depthParams);
+					models.Meshes[i]->Draw(context);
+				}
+			}
+		}
 	}
-}
\ No newline at end of file
+}
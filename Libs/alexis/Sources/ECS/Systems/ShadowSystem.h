@@ -1,15 +1,23 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 #include <DirectXMath.h>
 
+#include <Render/Viewport.h>
 #include <ECS/ECS.h>
-#include <ECS/Components/CameraComponent.h>
+
+#include <Utils/ShadowCasterCache.h>
 
 namespace alexis
 {
 	class Mesh;
 	class Material;
 	class CommandContext;
+	class RenderTarget;
+	struct RenderScene;
 
 	namespace ecs
 	{
@@ -17,13 +25,68 @@ namespace alexis
 		{
 		public:
 			void Init();
-			void XM_CALLCONV Render(CommandContext* context);
 
-			DirectX::XMMATRIX GetShadowMatrix() const;
+			// Fits RenderScene::ShadowCascades to the main view and builds their shadow views.
+			// Runs after the main view, the model bounds and RenderScene::Sun are extracted
+			void Extract(RenderScene& renderScene);
+
+			// Splits casters of every cascade in static and dynamic and marks the cascades whose tile must be redrawn.
+			// Runs after CullModels. Without a sun every cascade is left without casters
+			void UpdateCasterCache(RenderScene& renderScene);
+
+			// Stale cascades redraw their static casters into the shadow cache, the cache is copied into the shadow map
+			// and every cascade draws its dynamic casters over it. Casters are culled against the cascade view.
+			// Rendering is split in steps so caster ranges can be recorded into different contexts in parallel, contexts
+			// are submitted in this order: BeginCache, RenderCache ranges (only if IsCacheStale), ResolveCache, RenderCasters ranges, EndRender
+			bool IsCacheStale() const;
+
+			// Some cascade has static casters in the shadow cache
+			bool IsCacheUsed() const;
+
+			// Clears the tiles of stale cascades in the shadow cache
+			void BeginCache(CommandContext* context);
+
+			// Static casters of stale cascades, [first, last) of GetCacheDrawCount()
+			std::size_t GetCacheDrawCount() const;
+			void XM_CALLCONV RenderCache(CommandContext* context, std::size_t first, std::size_t last);
+
+			// Copies the shadow cache into the shadow map, without anything cached the shadow map is only cleared
+			void ResolveCache(CommandContext* context);
+
+			// Dynamic casters of all cascades, [first, last) of GetCasterDrawCount()
+			std::size_t GetCasterDrawCount() const;
+			void XM_CALLCONV RenderCasters(CommandContext* context, std::size_t first, std::size_t last);
+
+			void EndRender(CommandContext* context);
 
 		private:
+			// Cascades cover main view depths up to k_shadowDistance
+			static constexpr float k_shadowDistance = 60.0f;
+
+			// Split distribution, 0 is uniform, 1 is logarithmic
+			static constexpr float k_cascadeSplitLambda = 0.7f;
+
+			// Shadow atlas holds k_cascadeAtlasColumns x k_cascadeAtlasColumns cascades
+			static constexpr std::uint32_t k_cascadeAtlasColumns = 2;
+
+			// Cascades snap to k_cachedSnapTexels texels and keep their fit until the camera moves that far, so the static casters
+			// of a near cascade stay cached while the camera stands or walks slowly. A refit only redraws the tile of that cascade
+			static constexpr std::uint32_t k_cachedSnapTexels = 32;
+
+			// Tile of the cascade in a shadow atlas
+			static Viewport GetCascadeViewport(const RenderTarget& atlas, std::size_t cascade);
+			static D3D12_RECT GetCascadeRect(const RenderTarget& atlas, std::size_t cascade);
+
+			// Caster lists of the cascades taken back to back: static casters of stale cascades for the cache, dynamic casters otherwise
+			static std::size_t CountCasters(const RenderScene& renderScene, bool isCache);
+
+			// Draws [first, last) of the caster lists, see CountCasters
+			void DrawCasters(CommandContext* context, const RenderTarget& atlas, const RenderScene& renderScene, bool isCache, std::size_t first, std::size_t last) const;
+
 			Material* m_shadowMaterial{ nullptr };
-			ecs::Entity m_phantomCamera;
+
+			// Invalidation of the shadow cache, view i is cascade i
+			utils::ShadowCasterCache m_casterCache;
 		};
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,249 @@
+#include <Precompiled.h>
+
+#include "TransformSystem.h"
+
+#include <Core/Core.h>
+#include <Core/JobSystem.h>
+
+#include <ECS/Components/HierarchyComponent.h>
+#include <ECS/Components/ModelComponent.h>
+#include <ECS/Components/TransformComponent.h>
+
+#include <Utils/MatrixBatch.h>
+
+namespace alexis
+{
+	namespace ecs
+	{
+		static constexpr std::size_t k_rootsPerJob = 64;
+
+		void TransformSystem::Update(float dt)
+		{
+			auto& ecsWorld = Core::Get().GetECSWorld();
+
+			std::uint32_t sinceVersion = LastSystemVersion;
+			if (m_entitiesVersion != Entities.GetVersion() || ecsWorld.View<const HierarchyComponent>(Changed<HierarchyComponent>{ LastSystemVersion }).Count() > 0)
+			{
+				RebuildHierarchy();
+
+				// New order: recompute everything
+				sinceVersion = 0;
+			}
+			else if (ecsWorld.View<const TransformComponent>(Changed<TransformComponent>{ LastSystemVersion }).Count() == 0)
+			{
+				// Nothing moved
+				return;
+			}
+
+			Core::Get().GetJobSystem().ParallelFor(m_roots.size(), k_rootsPerJob, [this, sinceVersion](std::size_t begin, std::size_t end)
+			{
+				PropagateRoots(begin, end, sinceVersion);
+			});
+
+			// Writes mark model chunks as changed, keep them on one thread
+			for (std::size_t i = 0; i < m_entities.size(); ++i)
+			{
+				if (m_dirty[i] && ecsWorld.HasComponent<ModelComponent>(m_entities[i]))
+				{
+					ecsWorld.GetComponent<ModelComponent>(m_entities[i]).ModelMatrix = m_worldMatrices[i];
+				}
+			}
+		}
+
+		bool TransformSystem::SetParent(Entity child, Entity parent)
+		{
+			auto& ecsWorld = Core::Get().GetECSWorld();
+
+			// Walk up from the new parent, reaching child means the link would close a cycle.
+			// Chain ends at the first entity without transform, same as in RebuildHierarchy
+			Entity ancestor = parent;
+			for (std::size_t depth = 0; Entities.contains(ancestor) && depth <= Entities.size(); ++depth)
+			{
+				if (ancestor == child)
+				{
+					return false;
+				}
+
+				if (!ecsWorld.HasComponent<HierarchyComponent>(ancestor))
+				{
+					break;
+				}
+				ancestor = ecsWorld.GetComponent<const HierarchyComponent>(ancestor).Parent;
+			}
+
+			if (parent == child)
+			{
+				return false;
+			}
+
+			if (ecsWorld.HasComponent<HierarchyComponent>(child))
+			{
+				ecsWorld.GetComponent<HierarchyComponent>(child).Parent = parent;
+			}
+			else
+			{
+				ecsWorld.AddComponent(child, HierarchyComponent{ parent });
+			}
+
+			return true;
+		}
+
+		DirectX::XMMATRIX TransformSystem::GetWorldMatrix(Entity entity) const
+		{
+			assert(entity.Index < m_nodeIndices.size() && m_nodeIndices[entity.Index] != k_invalidNode && "Entity has no world matrix yet!");
+
+			return m_worldMatrices[m_nodeIndices[entity.Index]];
+		}
+
+		void TransformSystem::RebuildHierarchy()
+		{
+			auto& ecsWorld = Core::Get().GetECSWorld();
+
+			std::vector<Entity> roots;
+			std::unordered_map<std::uint32_t, std::vector<Entity>> children;
+
+			for (auto entity : Entities)
+			{
+				Entity parent = k_invalidEntity;
+				if (ecsWorld.HasComponent<HierarchyComponent>(entity))
+				{
+					parent = ecsWorld.GetComponent<const HierarchyComponent>(entity).Parent;
+				}
+
+				// Parent without transform (or dead one) does not affect the child
+				if (parent != entity && Entities.contains(parent))
+				{
+					children[parent.Index].push_back(entity);
+				}
+				else
+				{
+					roots.push_back(entity);
+				}
+			}
+
+			m_entities.clear();
+			m_parents.clear();
+			m_roots.clear();
+
+			m_nodeIndices.assign(m_nodeIndices.size(), k_invalidNode);
+
+			for (auto root : roots)
+			{
+				AppendSubtree(root, children);
+			}
+
+			// Cycles written directly into HierarchyComponent have no root, break them so they keep updating
+			if (m_entities.size() != Entities.size())
+			{
+				for (auto entity : Entities)
+				{
+					if (entity.Index >= m_nodeIndices.size() || m_nodeIndices[entity.Index] == k_invalidNode)
+					{
+						AppendSubtree(entity, children);
+					}
+				}
+			}
+
+			assert(m_entities.size() == Entities.size() && "Hierarchy has unplaced nodes!");
+
+			m_worldMatrices.resize(m_entities.size());
+			m_dirty.assign(m_entities.size(), 0);
+
+			m_entitiesVersion = Entities.GetVersion();
+		}
+
+		void TransformSystem::AppendSubtree(Entity root, const std::unordered_map<std::uint32_t, std::vector<Entity>>& children)
+		{
+			RootRange range;
+			range.Begin = static_cast<std::uint32_t>(m_entities.size());
+
+			// Depth-first, the subtree ends up in one contiguous range
+			auto& stack = m_subtreeStack;
+			stack.push_back({ root, k_invalidNode });
+			while (!stack.empty())
+			{
+				auto [entity, parentNode] = stack.back();
+				stack.pop_back();
+
+				if (entity.Index >= m_nodeIndices.size())
+				{
+					m_nodeIndices.resize(entity.Index + 1, k_invalidNode);
+				}
+				else if (m_nodeIndices[entity.Index] != k_invalidNode)
+				{
+					// Closes a cycle back into this subtree
+					continue;
+				}
+
+				std::uint32_t node = static_cast<std::uint32_t>(m_entities.size());
+				m_entities.push_back(entity);
+				m_parents.push_back(parentNode);
+				m_nodeIndices[entity.Index] = node;
+
+				auto it = children.find(entity.Index);
+				if (it != children.end())
+				{
+					for (auto child = it->second.rbegin(); child != it->second.rend(); ++child)
+					{
+						stack.push_back({ *child, node });
+					}
+				}
+			}
+
+			range.End = static_cast<std::uint32_t>(m_entities.size());
+			m_roots.push_back(range);
+		}
+
+		void TransformSystem::PropagateRoots(std::size_t rootBegin, std::size_t rootEnd, std::uint32_t sinceVersion)
+		{
+			auto& ecsWorld = Core::Get().GetECSWorld();
+
+			// Scratch is reused by every job running on this thread
+			thread_local utils::TransformBatch batch;
+			thread_local std::vector<XMMATRIX> localMatrices;
+
+			std::uint32_t begin = m_roots[rootBegin].Begin;
+			std::uint32_t end = m_roots[rootEnd - 1].End;
+
+			batch.Clear();
+
+			for (std::uint32_t node = begin; node < end; ++node)
+			{
+				Entity entity = m_entities[node];
+				std::uint32_t parent = m_parents[node];
+
+				// Parent is always earlier in the range, so its flag is final already
+				bool isDirty = ecsWorld.GetComponentChangeVersion<TransformComponent>(entity) > sinceVersion || (parent != k_invalidNode && m_dirty[parent]);
+				m_dirty[node] = isDirty;
+
+				if (isDirty)
+				{
+					const auto& transformComponent = ecsWorld.GetComponent<const TransformComponent>(entity);
+					batch.Add(transformComponent.Position, transformComponent.Rotation, transformComponent.UniformScale);
+				}
+			}
+
+			if (batch.Size() == 0)
+			{
+				return;
+			}
+
+			localMatrices.resize(batch.Size());
+			utils::BatchWorldMatrices(batch.GetStreams(), batch.Size(), localMatrices.data(), sizeof(XMMATRIX));
+
+			std::size_t local = 0;
+			for (std::uint32_t node = begin; node < end; ++node)
+			{
+				if (!m_dirty[node])
+				{
+					continue;
+				}
+
+				std::uint32_t parent = m_parents[node];
+				const XMMATRIX& localMatrix = localMatrices[local++];
+
+				m_worldMatrices[node] = parent != k_invalidNode ? XMMatrixMultiply(localMatrix, m_worldMatrices[parent]) : localMatrix;
+			}
+		}
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <DirectXMath.h>
+
+#include <ECS/ECS.h>
+
+namespace alexis
+{
+	namespace ecs
+	{
+		// Computes world matrices of all transforms, taking HierarchyComponent into account,
+		// and writes them into ModelComponent::ModelMatrix.
+		// Nodes are stored depth-first so every subtree is a contiguous range with parents before children:
+		// propagation is one linear sweep per root, roots are processed in parallel.
+		// Local matrices of dirty nodes are built in SoA batches before the sweep.
+		class TransformSystem : public ecs::System
+		{
+		public:
+			void Update(float dt);
+
+			// Adds or updates HierarchyComponent. Pass k_invalidEntity to detach.
+			// Returns false and leaves the hierarchy untouched if parent is child itself or one of its descendants
+			bool SetParent(Entity child, Entity parent);
+
+			DirectX::XMMATRIX GetWorldMatrix(Entity entity) const;
+
+		private:
+			static constexpr std::uint32_t k_invalidNode = std::numeric_limits<std::uint32_t>::max();
+
+			struct RootRange
+			{
+				std::uint32_t Begin{ 0 };
+				std::uint32_t End{ 0 };
+			};
+
+			void RebuildHierarchy();
+			// Appends the subtree of root in depth-first order, nodes already placed are skipped
+			void AppendSubtree(Entity root, const std::unordered_map<std::uint32_t, std::vector<Entity>>& children);
+			// Roots [rootBegin, rootEnd) cover one contiguous node range
+			void PropagateRoots(std::size_t rootBegin, std::size_t rootEnd, std::uint32_t sinceVersion);
+
+			// Depth-first order
+			std::vector<Entity> m_entities;
+			std::vector<std::uint32_t> m_parents;
+			std::vector<DirectX::XMMATRIX> m_worldMatrices;
+			std::vector<std::uint8_t> m_dirty;
+
+			std::vector<RootRange> m_roots;
+
+			// Entity::Index -> node
+			std::vector<std::uint32_t> m_nodeIndices;
+
+			// Scratch of AppendSubtree: entity and its parent node
+			std::vector<std::pair<Entity, std::uint32_t>> m_subtreeStack;
+
+			// Entities.GetVersion() the order was built for
+			std::uint32_t m_entitiesVersion{ std::numeric_limits<std::uint32_t>::max() };
+		};
+	}
+}
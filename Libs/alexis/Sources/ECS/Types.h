@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <bitset>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace alexis
+{
+	namespace ecs
+	{
+		const std::uint32_t k_invalidEntityIndex = std::numeric_limits<std::uint32_t>::max();
+
+		// Entity is 32-bit index into entity tables + 32-bit generation of that index
+		// Generation is bumped on destroy, so stale handles never alias a recycled index
+		struct Entity
+		{
+			std::uint32_t Index{ k_invalidEntityIndex };
+			std::uint32_t Generation{ 0 };
+
+			bool IsValid() const
+			{
+				return Index != k_invalidEntityIndex;
+			}
+
+			auto operator<=>(const Entity&) const = default;
+		};
+
+		const Entity k_invalidEntity{};
+
+		// Int type of component for mask
+		using ComponentType = std::uint8_t;
+		const ComponentType k_maxComponents = 32;
+
+		// bit mask for components belong to entity
+		using ComponentMask = std::bitset<k_maxComponents>;
+
+		// Empty components are tags: they exist only as a bit of the entity's ComponentMask, without storage
+		template<class T>
+		inline constexpr bool k_isTagComponent = std::is_empty_v<std::remove_const_t<T>>;
+
+		// Sequential ids per type family, assigned on first use
+		// After that an id lookup is a single static load: no RTTI, no hashing
+		template<class Family>
+		class TypeIdGenerator
+		{
+		public:
+			template<class T>
+			static std::uint32_t GetId()
+			{
+				static const std::uint32_t id = s_nextId.fetch_add(1);
+				return id;
+			}
+
+		private:
+			static inline std::atomic<std::uint32_t> s_nextId{ 0 };
+		};
+	}
+}
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ECS/Types.h>
+#include <ECS/Archetype.h>
+
+namespace alexis
+{
+	namespace ecs
+	{
+		// Archetypes matching a component mask
+		// Cached by ComponentManager and extended incrementally when new archetypes appear
+		struct Query
+		{
+			ComponentMask Mask;
+			std::vector<Archetype*> Archetypes;
+		};
+
+		// View filter: only chunks where T was written after SinceVersion (see World::AdvanceChangeVersion)
+		// ecsWorld.View<ModelComponent, const TransformComponent>(Changed<TransformComponent>{ LastSystemVersion })
+		template<class T>
+		struct Changed
+		{
+			using ComponentT = std::remove_const_t<T>;
+
+			std::uint32_t SinceVersion{ 0 };
+		};
+
+		// Iterates entities of a query with packed references to their components
+		// for (auto [entity, transform, model] : ecsWorld.View<TransformComponent, ModelComponent>())
+		// Structural changes (add/remove component, create/destroy entity) invalidate the view
+		// Visiting a chunk through non-const Ts marks these components as changed in the chunk
+		template<class... Ts>
+		class View
+		{
+		public:
+			using ComponentTypes = std::array<ComponentType, sizeof...(Ts)>;
+
+			class Iterator
+			{
+			public:
+				Iterator(const View* view, std::size_t archetype) :
+					m_view(view),
+					m_archetype(archetype)
+				{
+					SeekChunk();
+				}
+
+				std::tuple<Entity, Ts&...> operator*() const
+				{
+					return std::apply([this](Ts*... columns)
+					{
+						return std::tuple<Entity, Ts&...>{ m_entities[m_row], columns[m_row]... };
+					}, m_columns);
+				}
+
+				Iterator& operator++()
+				{
+					if (++m_row == m_count)
+					{
+						++m_chunk;
+						SeekChunk();
+					}
+
+					return *this;
+				}
+
+				bool operator==(const Iterator& other) const
+				{
+					return m_archetype == other.m_archetype && m_chunk == other.m_chunk && m_row == other.m_row;
+				}
+
+			private:
+				// Move to the first row of the next non-empty chunk passing the filter
+				void SeekChunk()
+				{
+					m_row = 0;
+
+					const auto& archetypes = m_view->m_query->Archetypes;
+					while (m_archetype < archetypes.size())
+					{
+						auto* archetype = archetypes[m_archetype];
+						while (m_chunk < archetype->GetChunkCount())
+						{
+							if (m_view->IsChunkIncluded(archetype, m_chunk))
+							{
+								m_count = archetype->GetEntityCount(m_chunk);
+								m_entities = archetype->GetEntities(m_chunk);
+								m_columns = m_view->LoadColumns(archetype, m_chunk, std::index_sequence_for<Ts...>{});
+								return;
+							}
+
+							++m_chunk;
+						}
+
+						++m_archetype;
+						m_chunk = 0;
+					}
+				}
+
+				const View* m_view{ nullptr };
+
+				std::size_t m_archetype{ 0 };
+				std::size_t m_chunk{ 0 };
+				std::uint32_t m_row{ 0 };
+				std::uint32_t m_count{ 0 };
+
+				const Entity* m_entities{ nullptr };
+				std::tuple<Ts*...> m_columns;
+			};
+
+			View(const Query* query, ComponentTypes types, std::uint32_t changeVersion) :
+				m_query(query),
+				m_types(types),
+				m_changeVersion(changeVersion)
+			{
+			}
+
+			// Skip chunks where none of the filtered components changed after sinceVersion
+			void AddChangedFilter(ComponentType type, std::uint32_t sinceVersion)
+			{
+				assert(m_query->Mask.test(type) && "Changed filter component is not part of the view!");
+
+				m_changedSince = m_changedFilter.none() ? sinceVersion : std::min(m_changedSince, sinceVersion);
+				m_changedFilter.set(type);
+			}
+
+			Iterator begin() const
+			{
+				return Iterator(this, 0);
+			}
+
+			Iterator end() const
+			{
+				return Iterator(this, m_query->Archetypes.size());
+			}
+
+			// Iterate packed component arrays chunk by chunk
+			// func(std::size_t count, const Entity* entities, Ts*... components)
+			template<class Func>
+			void ForEachChunk(Func&& func) const
+			{
+				ForEachChunk(std::forward<Func>(func), std::index_sequence_for<Ts...>{});
+			}
+
+			// Same as ForEachChunk but chunks are distributed over executor's workers.
+			// Executor is expected to provide ParallelFor(count, batchSize, func(begin, end)) (see JobSystem)
+			template<class Executor, class Func>
+			void ParallelForEachChunk(Executor& executor, Func&& func) const
+			{
+				ParallelForEachChunk(executor, std::forward<Func>(func), std::index_sequence_for<Ts...>{});
+			}
+
+			std::size_t Count() const
+			{
+				std::size_t count = 0;
+				for (auto* archetype : m_query->Archetypes)
+				{
+					for (std::size_t chunk = 0; chunk < archetype->GetChunkCount(); ++chunk)
+					{
+						if (IsChunkIncluded(archetype, chunk))
+						{
+							count += archetype->GetEntityCount(chunk);
+						}
+					}
+				}
+
+				return count;
+			}
+
+		private:
+			bool IsChunkIncluded(const Archetype* archetype, std::size_t chunk) const
+			{
+				if (m_changedFilter.none())
+				{
+					return true;
+				}
+
+				for (ComponentType type = 0; type < k_maxComponents; ++type)
+				{
+					if (m_changedFilter.test(type) && archetype->GetChangeVersion(type, chunk) > m_changedSince)
+					{
+						return true;
+					}
+				}
+
+				return false;
+			}
+
+			// Columns of the chunk, components accessed as non-const are marked changed
+			template<std::size_t... I>
+			std::tuple<Ts*...> LoadColumns(Archetype* archetype, std::size_t chunk, std::index_sequence<I...>) const
+			{
+				(MarkChanged<Ts>(archetype, m_types[I], chunk), ...);
+
+				return std::tuple<Ts*...>{ archetype->GetColumn<Ts>(m_types[I], chunk)... };
+			}
+
+			template<class T>
+			void MarkChanged(Archetype* archetype, ComponentType type, std::size_t chunk) const
+			{
+				if constexpr (!std::is_const_v<T>)
+				{
+					archetype->MarkChanged(type, chunk, m_changeVersion);
+				}
+			}
+
+			template<class Func, std::size_t... I>
+			void ForEachChunk(Func&& func, std::index_sequence<I...>) const
+			{
+				for (auto* archetype : m_query->Archetypes)
+				{
+					for (std::size_t chunk = 0; chunk < archetype->GetChunkCount(); ++chunk)
+					{
+						if (IsChunkIncluded(archetype, chunk))
+						{
+							std::apply([&](Ts*... columns) { func(archetype->GetEntityCount(chunk), archetype->GetEntities(chunk), columns...); }, LoadColumns(archetype, chunk, std::index_sequence<I...>{}));
+						}
+					}
+				}
+			}
+
+			template<class Executor, class Func, std::size_t... I>
+			void ParallelForEachChunk(Executor& executor, Func&& func, std::index_sequence<I...>) const
+			{
+				for (auto* archetype : m_query->Archetypes)
+				{
+					executor.ParallelFor(archetype->GetChunkCount(), 1, [&](std::size_t begin, std::size_t end)
+					{
+						for (std::size_t chunk = begin; chunk < end; ++chunk)
+						{
+							if (IsChunkIncluded(archetype, chunk))
+							{
+								std::apply([&](Ts*... columns) { func(archetype->GetEntityCount(chunk), archetype->GetEntities(chunk), columns...); }, LoadColumns(archetype, chunk, std::index_sequence<I...>{}));
+							}
+						}
+					});
+				}
+			}
+
+			const Query* m_query{ nullptr };
+			ComponentTypes m_types;
+
+			// Version written into chunks accessed for write
+			std::uint32_t m_changeVersion{ 0 };
+
+			ComponentMask m_changedFilter;
+			std::uint32_t m_changedSince{ 0 };
+		};
+	}
+}
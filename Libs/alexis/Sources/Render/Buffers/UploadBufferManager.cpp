@@ -26,6 +26,8 @@ namespace alexis
 			throw std::bad_alloc();
 		}
 
+		std::scoped_lock lock(m_mutex);
+
 		if (!m_currentPage || !m_currentPage->HasSpace(sizeInBytes, alignment))
 		{
 			m_currentPage = RequestPage();
@@ -36,6 +38,8 @@ namespace alexis
 
 	void UploadBufferManager::Reset()
 	{
+		std::scoped_lock lock(m_mutex);
+
 		m_currentPage = nullptr;
 		// Reset all available pages.
 		m_availablePages = m_pagePool;
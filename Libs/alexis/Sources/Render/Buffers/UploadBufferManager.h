@@ -3,6 +3,7 @@
 #include <wrl.h>
 #include <d3d12.h>
 
+#include <mutex>
 #include <queue>
 
 namespace alexis
@@ -26,6 +27,7 @@ namespace alexis
 			return m_pageSize;
 		}
 
+		// Thread safe, contexts recording in parallel allocate from the same pages
 		Allocation Allocate(std::size_t sizeInBytes, std::size_t alignment = 256);
 		void Reset();
 	private:
@@ -59,6 +61,8 @@ namespace alexis
 
 		std::shared_ptr<Page> m_currentPage;
 
+		std::mutex m_mutex;
+
 		std::size_t m_pageSize;
 	};
 }
\ No newline at end of file
@@ -80,14 +80,24 @@ namespace alexis
 		// TODO: calculate sizeof here instead of args
 		assert(bufferData && Math::IsAligned(bufferData, 16));
 
-		auto device = Render::GetInstance()->GetDevice();
-		auto bufferManager = Render::GetInstance()->GetUploadBufferManager();
-		auto cb = bufferManager->Allocate(bufferSize);
+		auto cb = AllocateUpload(bufferSize);
 		memcpy(cb.Cpu, bufferData, bufferSize);
 
 		List->SetGraphicsRootConstantBufferView(rootParameterIdx, cb.Gpu);
 	}
 
+	void CommandContext::SetDynamicSRV(uint32_t rootParameterIdx, std::size_t bufferSize, const void* bufferData)
+	{
+		// Empty buffers still need a valid address
+		auto buffer = AllocateUpload(std::max<std::size_t>(bufferSize, 16));
+		if (bufferSize > 0)
+		{
+			memcpy(buffer.Cpu, bufferData, bufferSize);
+		}
+
+		List->SetGraphicsRootShaderResourceView(rootParameterIdx, buffer.Gpu);
+	}
+
 	void CommandContext::ClearRTV(D3D12_CPU_DESCRIPTOR_HANDLE rtv, const float clearColor[4])
 	{
 		List->ClearRenderTargetView(rtv, clearColor, 0, nullptr);
@@ -98,6 +108,11 @@ namespace alexis
 		List->ClearDepthStencilView(dsv, clearFlags, depth, stencil, 0, nullptr);
 	}
 
+	void CommandContext::ClearDSV(D3D12_CPU_DESCRIPTOR_HANDLE dsv, D3D12_CLEAR_FLAGS clearFlags, const D3D12_RECT& rect, float depth /*= 1.0f*/, uint8_t stencil /*= 0*/)
+	{
+		List->ClearDepthStencilView(dsv, clearFlags, depth, stencil, 1, &rect);
+	}
+
 	void CommandContext::SetRenderTarget(const RenderTarget& renderTarget)
 	{
 		SetRenderTarget(renderTarget, renderTarget);
@@ -173,11 +188,9 @@ namespace alexis
 
 	void CommandContext::CopyBuffer(GpuBuffer& destination, const void* data, std::size_t numElements, std::size_t elementSize)
 	{
-		auto device = Render::GetInstance()->GetDevice();
-		auto bufferManager = Render::GetInstance()->GetUploadBufferManager();
 		const std::size_t sizeInBytes = numElements * elementSize;
 
-		auto allocation = bufferManager->Allocate(sizeInBytes, elementSize);
+		auto allocation = AllocateUpload(sizeInBytes, elementSize);
 		memcpy(allocation.Cpu, data, sizeInBytes);
 
 		TransitionResource(destination, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
@@ -185,13 +198,16 @@ namespace alexis
 		//TransitionResource(destination, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ);
 	}
 
+	void CommandContext::CopyResource(const GpuBuffer& destination, const GpuBuffer& source)
+	{
+		List->CopyResource(destination.GetResource(), source.GetResource());
+	}
+
 	void CommandContext::InitializeTexture(TextureBuffer& destination, UINT numSubresources, D3D12_SUBRESOURCE_DATA subData[])
 	{
 		UINT64 uploadBufferSize = GetRequiredIntermediateSize(destination.GetResource(), 0, numSubresources);
 
-		auto device = Render::GetInstance()->GetDevice();
-		auto bufferManager = Render::GetInstance()->GetUploadBufferManager();
-		auto allocation = bufferManager->Allocate(uploadBufferSize, 512);
+		auto allocation = AllocateUpload(uploadBufferSize, 512);
 
 		TransitionResource(destination, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
 		UpdateSubresources(List.Get(), destination.GetResource(), allocation.Resource, allocation.Offset, 0, numSubresources, subData);
@@ -285,6 +301,38 @@ namespace alexis
 		List->Reset(Allocator.Get(), nullptr);
 
 		m_rootSignature = nullptr;
+
+		m_uploadBlock = {};
+		m_uploadBlockOffset = 0;
+	}
+
+	UploadBufferManager::Allocation CommandContext::AllocateUpload(std::size_t sizeInBytes, std::size_t alignment)
+	{
+		auto bufferManager = Render::GetInstance()->GetUploadBufferManager();
+
+		if (sizeInBytes + alignment > k_uploadBlockSize)
+		{
+			return bufferManager->Allocate(sizeInBytes, alignment);
+		}
+
+		// Offsets are aligned within the page, the block itself may start anywhere
+		std::size_t offset = Math::AlignUp(m_uploadBlock.Offset + m_uploadBlockOffset, alignment);
+		if (!m_uploadBlock.Resource || offset + sizeInBytes > m_uploadBlock.Offset + k_uploadBlockSize)
+		{
+			m_uploadBlock = bufferManager->Allocate(k_uploadBlockSize);
+			offset = Math::AlignUp(m_uploadBlock.Offset, alignment);
+		}
+
+		const std::size_t blockOffset = offset - m_uploadBlock.Offset;
+		m_uploadBlockOffset = blockOffset + sizeInBytes;
+
+		UploadBufferManager::Allocation allocation;
+		allocation.Cpu = static_cast<uint8_t*>(m_uploadBlock.Cpu) + blockOffset;
+		allocation.Gpu = m_uploadBlock.Gpu + blockOffset;
+		allocation.Offset = offset;
+		allocation.Resource = m_uploadBlock.Resource;
+
+		return allocation;
 	}
 
 	std::mutex CommandContext::s_textureCacheMutex;
@@ -7,6 +7,7 @@
 #include <Render/Viewport.h>
 #include <Render/RootSignature.h>
 #include <Render/Buffers/GpuBuffer.h>
+#include <Render/Buffers/UploadBufferManager.h>
 #include <Render/RenderTarget.h>
 
 namespace alexis
@@ -36,8 +37,12 @@ namespace alexis
 
 		void SetDynamicCBV(uint32_t rootParameterIdx, std::size_t bufferSize, const void* bufferData);
 
+		// Copy data to the upload heap and bind it as a root SRV (structured or raw buffer)
+		void SetDynamicSRV(uint32_t rootParameterIdx, std::size_t bufferSize, const void* bufferData);
+
 		void ClearRTV(D3D12_CPU_DESCRIPTOR_HANDLE rtv, const float clearColor[4]);
 		void ClearDSV(D3D12_CPU_DESCRIPTOR_HANDLE dsv, D3D12_CLEAR_FLAGS clearFlags, float depth = 1.0f, uint8_t stencil = 0);
+		void ClearDSV(D3D12_CPU_DESCRIPTOR_HANDLE dsv, D3D12_CLEAR_FLAGS clearFlags, const D3D12_RECT& rect, float depth = 1.0f, uint8_t stencil = 0);
 
 		void SetRenderTarget(const RenderTarget& renderTarget);
 		void SetRenderTarget(const RenderTarget& renderTarget, const RenderTarget& customDepth);
@@ -48,6 +53,9 @@ namespace alexis
 
 		void CopyBuffer(GpuBuffer& destination, const void* data, std::size_t numElements, std::size_t elementSize);
 
+		// Whole resource copy, states must be COPY_DEST and COPY_SOURCE
+		void CopyResource(const GpuBuffer& destination, const GpuBuffer& source);
+
 		void InitializeTexture(TextureBuffer& destination, UINT numSubresources, D3D12_SUBRESOURCE_DATA subData[]);
 
 		void LoadTextureFromFile(TextureBuffer& destination, const std::wstring& filename);
@@ -58,6 +66,15 @@ namespace alexis
 		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> List;
 
 	private:
+		// Small allocations are carved from a block of the upload heap owned by the context,
+		// so contexts recorded on different threads rarely contend on UploadBufferManager
+		UploadBufferManager::Allocation AllocateUpload(std::size_t sizeInBytes, std::size_t alignment = 256);
+
+		static constexpr std::size_t k_uploadBlockSize = 16 * 1024;
+
+		UploadBufferManager::Allocation m_uploadBlock{};
+		std::size_t m_uploadBlockOffset{ 0 };
+
 		ID3D12RootSignature* m_rootSignature{ nullptr };
 		D3D12_COMMAND_LIST_TYPE m_type{ D3D12_COMMAND_LIST_TYPE_DIRECT };
 
@@ -0,0 +1,86 @@
+#include <Precompiled.h>
+
+#include "Culling.h"
+
+#include <Core/JobSystem.h>
+#include <Render/RenderScene.h>
+
+#include <Utils/FrustumCulling.h>
+
+namespace alexis
+{
+	namespace
+	{
+		// Proxies per job, small scenes are culled on the calling thread
+		static constexpr std::size_t k_cullBatchSize = 4096;
+
+		void RemoveSmallModels(const RenderScene::ModelProxies& models, float minRadius, std::vector<std::uint32_t>& visible)
+		{
+			if (minRadius > 0.0f)
+			{
+				std::erase_if(visible, [&models, minRadius](std::uint32_t i) { return models.SphereRadius[i] < minRadius; });
+			}
+		}
+	}
+
+	void CullModels(RenderScene& renderScene, JobSystem& jobSystem)
+	{
+		static_assert(ViewData::PlaneCount == utils::k_frustumPlaneCount, "Frustum plane count mismatch");
+
+		const auto& models = renderScene.Models;
+		const std::size_t count = models.Size();
+
+		if (renderScene.ModelBvh.GetPrimitiveCount() == count)
+		{
+			// One view per job, the tree rejects whole groups of models at once
+			jobSystem.ParallelFor(RenderScene::k_viewCount, 1, [&renderScene](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t view = begin; view < end; ++view)
+				{
+					auto& visible = renderScene.VisibleModels[view];
+					visible.clear();
+					renderScene.ModelBvh.QueryFrustum(renderScene.Views[view].FrustumPlanes, visible);
+					RemoveSmallModels(renderScene.Models, renderScene.Views[view].MinModelRadius, visible);
+				}
+			});
+
+			return;
+		}
+
+		// Linear fallback over bounding spheres
+		const std::size_t batchCount = (count + k_cullBatchSize - 1) / k_cullBatchSize;
+
+		utils::SphereStreams spheres;
+		spheres.CenterX = models.SphereCenterX.data();
+		spheres.CenterY = models.SphereCenterY.data();
+		spheres.CenterZ = models.SphereCenterZ.data();
+		spheres.Radius = models.SphereRadius.data();
+
+		std::vector<std::size_t> batchVisibleCounts(batchCount);
+
+		for (std::size_t view = 0; view < RenderScene::k_viewCount; ++view)
+		{
+			const auto& planes = renderScene.Views[view].FrustumPlanes;
+			auto& visible = renderScene.VisibleModels[view];
+			visible.resize(count);
+
+			// Every batch compacts into its own range of visible
+			jobSystem.ParallelFor(count, k_cullBatchSize, [&spheres, &planes, &visible, &batchVisibleCounts](std::size_t begin, std::size_t end)
+			{
+				batchVisibleCounts[begin / k_cullBatchSize] = utils::CullSpheres(spheres, begin, end, planes, visible.data() + begin);
+			});
+
+			// Close the gaps between batches, destination never overtakes source
+			std::size_t visibleCount = 0;
+			for (std::size_t batch = 0; batch < batchCount; ++batch)
+			{
+				auto batchBegin = visible.begin() + batch * k_cullBatchSize;
+				std::copy(batchBegin, batchBegin + batchVisibleCounts[batch], visible.begin() + visibleCount);
+				visibleCount += batchVisibleCounts[batch];
+			}
+
+			visible.resize(visibleCount);
+			RemoveSmallModels(models, renderScene.Views[view].MinModelRadius, visible);
+		}
+	}
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+namespace alexis
+{
+	class JobSystem;
+	struct RenderScene;
+
+	// Fills RenderScene::VisibleModels of every view from model bounds and the view frustum.
+	// Runs after models and views are extracted, uses ModelBvh when it covers all models
+	void CullModels(RenderScene& renderScene, JobSystem& jobSystem);
+}
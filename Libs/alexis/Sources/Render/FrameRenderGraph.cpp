@@ -3,7 +3,10 @@
 #include "FrameRenderGraph.h"
 
 #include <Core/Core.h>
+#include <Core/JobSystem.h>
 #include <Render/Render.h>
+#include <Render/Culling.h>
+#include <Utils/DrawRanges.h>
 
 #include <ECS/ECS.h>
 #include <ECS/Systems/ModelSystem.h>
@@ -16,20 +19,83 @@
 
 namespace alexis
 {
+	namespace
+	{
+		// Draw lists shorter than this are not worth another context
+		static constexpr std::size_t k_minDrawsPerContext = 128;
+	}
+
+	void FrameRenderGraph::Extract()
+	{
+		m_stageClock.Tick();
+
+		auto& ecsWorld = Core::Get().GetECSWorld();
+		auto& renderScene = *alexis::Render::GetInstance()->GetRenderScene();
+
+		ecsWorld.GetSystem<ecs::CameraSystem>()->Extract(renderScene);
+		ecsWorld.GetSystem<ecs::ModelSystem>()->Extract(renderScene);
+		ecsWorld.GetSystem<ecs::LightingSystem>()->Extract(renderScene);
+		ecsWorld.GetSystem<ecs::EnvironmentSystem>()->Extract(renderScene);
+
+		// Cascades are fitted to the main view and the model bounds
+		ecsWorld.GetSystem<ecs::ShadowSystem>()->Extract(renderScene);
+
+		CullModels(renderScene, Core::Get().GetJobSystem());
+		m_occlusionCuller.Cull(renderScene, Core::Get().GetJobSystem());
+
+		ecsWorld.GetSystem<ecs::ShadowSystem>()->UpdateCasterCache(renderScene);
+
+		m_stageClock.Tick();
+		m_timingSums.ExtractMs += m_stageClock.GetDeltaMilliseconds();
+	}
 
 	void FrameRenderGraph::Render()
 	{
+		m_stageClock.Tick();
+
 		auto& ecsWorld = Core::Get().GetECSWorld();
+		auto& jobSystem = Core::Get().GetJobSystem();
 		auto render = alexis::Render::GetInstance();
 		auto commandManager = render->GetCommandManager();
+		const auto& renderScene = *render->GetRenderScene();
 
 		auto gbuffer = render->GetRTManager()->GetRenderTarget(L"GB");
 		auto hdrRT = render->GetRTManager()->GetRenderTarget(L"HDR");
-		auto shadowRT = render->GetRTManager()->GetRenderTarget(L"Shadow Map");
+
+		auto modelSystem = ecsWorld.GetSystem<ecs::ModelSystem>();
+		auto shadowSystem = ecsWorld.GetSystem<ecs::ShadowSystem>();
+		auto lightingSystem = ecsWorld.GetSystem<ecs::LightingSystem>();
+		auto envSystem = ecsWorld.GetSystem<ecs::EnvironmentSystem>();
+		auto hdr2SdrSystem = ecsWorld.GetSystem<ecs::Hdr2SdrSystem>();
+		auto imguiSystem = ecsWorld.GetSystem<ecs::ImguiSystem>();
+
+		// Contexts are created in submission order, every pass is recorded into its own one by a job
+		std::vector<CommandContext*> contexts;
+		JobCounter recordCounter{ 0 };
+
+		auto addPass = [&](auto record)
+		{
+			auto* context = commandManager->CreateCommandContext();
+			contexts.push_back(context);
+			jobSystem.Run([context, record]() { record(context); }, &recordCounter);
+		};
+
+		// Draw lists are split in ranges, one context each, at most one range per thread.
+		// record(context, first, last) sees first == 0 in the first range and last == drawCount in the last one
+		const std::size_t maxRangeCount = jobSystem.GetWorkerCount() + 1;
+		auto addDrawPass = [&](std::size_t drawCount, auto record)
+		{
+			std::size_t rangeCount = utils::GetDrawRangeCount(drawCount, k_minDrawsPerContext, maxRangeCount);
+			for (std::size_t range = 0; range < rangeCount; ++range)
+			{
+				std::size_t first = utils::GetDrawRangeStart(drawCount, rangeCount, range);
+				std::size_t last = utils::GetDrawRangeStart(drawCount, rangeCount, range + 1);
+				addPass([record, first, last](CommandContext* context) { record(context, first, last); });
+			}
+		};
 
 		// TODO: RTManager flush every frame flag impl
-		auto* clearTargetContext = commandManager->CreateCommandContext();
-		auto clearTask = [gbuffer, hdrRT, shadowRT, clearTargetContext]()
+		addPass([gbuffer, hdrRT](CommandContext* clearTargetContext)
 		{
 			static constexpr float clearColor[] = { 0.0f, 0.0f, 0.0f, 0.0f };
 
@@ -54,91 +120,96 @@ namespace alexis
 			clearTargetContext->TransitionResource(texture, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET);
 			clearTargetContext->ClearRTV(hdrRT->GetRtv(RenderTarget::Slot0), clearColor);
 
-			{
-				auto& shadowDepth = shadowRT->GetTexture(RenderTarget::DepthStencil);
-				clearTargetContext->TransitionResource(shadowDepth, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_DEPTH_WRITE);
-				clearTargetContext->ClearDSV(shadowRT->GetDsv(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0);
-			}
-		};
-		clearTask();
+			// Shadow map is overwritten by the shadow cache copy or cleared (see ShadowSystem::ResolveCache)
+		});
 
 		// PBR models rendering
-		auto* pbsContext = commandManager->CreateCommandContext();
-		auto pbrTask = [pbsContext, gbuffer, &ecsWorld]
+		addDrawPass(renderScene.VisibleModels[RenderScene::k_mainView].size(), [modelSystem](CommandContext* pbsContext, std::size_t first, std::size_t last)
 		{
-			auto modelSystem = ecsWorld.GetSystem<ecs::ModelSystem>();
-			modelSystem->Render(pbsContext);
-		};
-		pbrTask();
+			modelSystem->Render(pbsContext, first, last);
+		});
 
 		// Shadows Cast
-		//auto* shadowContext = commandManager->CreateCommandContext();
-		//auto shadowTask = [shadowContext, &ecsWorld]
-		//{
-		//	auto shadowSystem = ecsWorld.GetSystem<ecs::ShadowSystem>();
-		//	shadowSystem->Render(shadowContext);
-		//};
-		//shadowTask();
+		if (shadowSystem->IsCacheStale())
+		{
+			addDrawPass(shadowSystem->GetCacheDrawCount(), [shadowSystem](CommandContext* shadowContext, std::size_t first, std::size_t last)
+			{
+				if (first == 0)
+				{
+					shadowSystem->BeginCache(shadowContext);
+				}
 
-		// Lighting Resolve
-		auto lightingContext = commandManager->CreateCommandContext();
-		auto lightingTask = [lightingContext, &ecsWorld]
+				shadowSystem->RenderCache(shadowContext, first, last);
+			});
+		}
+
+		const std::size_t casterDrawCount = shadowSystem->GetCasterDrawCount();
+		addDrawPass(casterDrawCount, [shadowSystem, casterDrawCount](CommandContext* shadowContext, std::size_t first, std::size_t last)
 		{
-			auto lightingSystem = ecsWorld.GetSystem<ecs::LightingSystem>();
-			lightingSystem->Render(lightingContext);
-		};
-		lightingTask();
+			if (first == 0)
+			{
+				shadowSystem->ResolveCache(shadowContext);
+			}
+
+			shadowSystem->RenderCasters(shadowContext, first, last);
+
+			if (last == casterDrawCount)
+			{
+				shadowSystem->EndRender(shadowContext);
+			}
+		});
 
 		// Env System
-		auto* envContext = commandManager->CreateCommandContext();
-		auto envTask = [envContext, &ecsWorld]
+		addPass([envSystem](CommandContext* envContext)
 		{
-			auto envSystem = ecsWorld.GetSystem<ecs::EnvironmentSystem>();
 			envSystem->CaptureCubemap(envContext);
-			envSystem->CapturePreFilteredTexture(envContext);
-			envSystem->ConvoluteBRDF(envContext);
-			envSystem->ConvoluteCubemap(envContext);
-		};
-		envTask();
+		});
 
-		// HDR resolve
-		auto* hdrContext = commandManager->CreateCommandContext();
-		auto hdrTask = [hdrContext, &ecsWorld]
+		// Lighting Resolve
+		addPass([lightingSystem](CommandContext* lightingContext)
 		{
-			auto hdr2SdrSystem = ecsWorld.GetSystem<ecs::Hdr2SdrSystem>();
-			hdr2SdrSystem->Render(hdrContext);
-		};
-		hdrTask();
+			lightingSystem->Render(lightingContext);
+		});
 
 		// Env System Skybox
-		auto* skyboxContext = commandManager->CreateCommandContext();
-		auto skyboxTask = [skyboxContext, &ecsWorld]
+		addPass([envSystem](CommandContext* skyboxContext)
 		{
-			auto envSystem = ecsWorld.GetSystem<ecs::EnvironmentSystem>();
 			envSystem->RenderSkybox(skyboxContext);
-		};
-		skyboxTask();
+		});
+
+		// HDR resolve
+		addPass([hdr2SdrSystem](CommandContext* hdrContext)
+		{
+			hdr2SdrSystem->Render(hdrContext);
+		});
 
 		// ImGUI
-		auto* imguiContext = commandManager->CreateCommandContext();
-		auto imguiTask = [imguiContext, &ecsWorld]
+		addPass([imguiSystem](CommandContext* imguiContext)
 		{
-			auto imguiSystem = ecsWorld.GetSystem<ecs::ImguiSystem>();
 			imguiSystem->Render(imguiContext);
-		};
-		imguiTask();
+		});
 
-		// Flush
+		// Flush, the calling thread records too while waiting
+		jobSystem.Wait(recordCounter);
+
+		m_stageClock.Tick();
+		m_timingSums.RecordMs += m_stageClock.GetDeltaMilliseconds();
+
+		for (auto* context : contexts)
 		{
-			clearTargetContext->Finish();
-			pbsContext->Finish();
-			//shadowContext->Finish();
-			envContext->Finish();
-			lightingContext->Finish();
-			skyboxContext->Finish();
-			hdrContext->Finish();
-			imguiContext->Finish();
+			context->Finish();
+		}
+
+		m_stageClock.Tick();
+		m_timingSums.SubmitMs += m_stageClock.GetDeltaMilliseconds();
+
+		if (++m_timingFrames == k_timingFrameCount)
+		{
+			m_cpuTimings.ExtractMs = m_timingSums.ExtractMs / k_timingFrameCount;
+			m_cpuTimings.RecordMs = m_timingSums.RecordMs / k_timingFrameCount;
+			m_cpuTimings.SubmitMs = m_timingSums.SubmitMs / k_timingFrameCount;
+			m_timingSums = {};
+			m_timingFrames = 0;
 		}
 	}
 }
-
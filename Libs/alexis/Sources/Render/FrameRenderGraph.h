@@ -1,10 +1,40 @@
 #pragma once
 
+#include <Core/HighResolutionClock.h>
+#include <Render/OcclusionCulling.h>
+
 namespace alexis
 {
 	class FrameRenderGraph
 	{
 	public:
+		// CPU wall time of the frame stages on the calling thread, averaged over k_timingFrameCount frames
+		struct CpuTimings
+		{
+			double ExtractMs{ 0.0 };
+			// Until every pass is recorded, the calling thread records too
+			double RecordMs{ 0.0 };
+			double SubmitMs{ 0.0 };
+		};
+
+		static constexpr std::uint32_t k_timingFrameCount = 64;
+
+		// Copy render-relevant ECS data into RenderScene, the only point where rendering reads the ECS
+		void Extract();
+
 		void Render();
+
+		const CpuTimings& GetCpuTimings() const
+		{
+			return m_cpuTimings;
+		}
+
+	private:
+		OcclusionCuller m_occlusionCuller;
+
+		HighResolutionClock m_stageClock;
+		CpuTimings m_cpuTimings;
+		CpuTimings m_timingSums;
+		std::uint32_t m_timingFrames{ 0 };
 	};
 }
\ No newline at end of file
@@ -12,7 +12,8 @@
 namespace alexis
 {
 	Material::Material(const MaterialLoadParams& params) :
-		m_path(params.Path)
+		m_path(params.Path),
+		m_texturePaths(params.Textures)
 	{
 		ComPtr<ID3DBlob> vertexShaderBlob;
 		ComPtr<ID3DBlob> pixelShaderBlob;
@@ -197,4 +198,9 @@ namespace alexis
 		return m_path;
 	}
 
+	const std::vector<std::wstring>& Material::GetTexturePaths() const
+	{
+		return m_texturePaths;
+	}
+
 }
@@ -47,6 +47,9 @@ namespace alexis
 		
 		const std::wstring& GetPath() const;
 
+		// As given in MaterialLoadParams::Textures
+		const std::vector<std::wstring>& GetTexturePaths() const;
+
 	private:
 		ComPtr<ID3D12RootSignature> m_rootSignature;
 		ComPtr<ID3D12PipelineState> m_pso;
@@ -58,5 +61,6 @@ namespace alexis
 		ComPtr<ID3DBlob> m_pixelShader;
 
 		std::wstring m_path;
+		std::vector<std::wstring> m_texturePaths;
 	};
 }
\ No newline at end of file
@@ -72,6 +72,26 @@ namespace alexis
 		return m_path;
 	}
 
+	const DirectX::BoundingBox& Mesh::GetBoundingBox() const
+	{
+		return m_boundingBox;
+	}
+
+	const DirectX::BoundingSphere& Mesh::GetBoundingSphere() const
+	{
+		return m_boundingSphere;
+	}
+
+	const std::vector<DirectX::XMFLOAT3>& Mesh::GetPositions() const
+	{
+		return m_positions;
+	}
+
+	const IndexCollection& Mesh::GetIndices() const
+	{
+		return m_indices;
+	}
+
 	void Mesh::Initialize(CommandContext* commandContext, VertexCollection& vertices, IndexCollection& indices)
 	{
 		if (vertices.size() >= USHRT_MAX)
@@ -80,6 +100,19 @@ namespace alexis
 		}
 		m_indexCount = static_cast<UINT>(indices.size());
 
+		if (!vertices.empty())
+		{
+			BoundingBox::CreateFromPoints(m_boundingBox, vertices.size(), &vertices[0].Position, sizeof(VertexDef));
+			BoundingSphere::CreateFromPoints(m_boundingSphere, vertices.size(), &vertices[0].Position, sizeof(VertexDef));
+		}
+
+		m_positions.resize(vertices.size());
+		for (std::size_t i = 0; i < vertices.size(); ++i)
+		{
+			m_positions[i] = vertices[i].Position;
+		}
+		m_indices = indices;
+
 		m_vertexBuffer.Create(vertices.size(), sizeof(VertexDef));
 		m_indexBuffer.Create(m_indexCount, sizeof(uint16_t));
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <DirectXMath.h>
+#include <DirectXCollision.h>
 #include <Render/Buffers/GpuBuffer.h>
 
 namespace alexis
@@ -34,6 +35,14 @@ namespace alexis
 
 		const std::wstring& GetPath() const;
 
+		// Object space bounds, computed from vertices at import
+		const DirectX::BoundingBox& GetBoundingBox() const;
+		const DirectX::BoundingSphere& GetBoundingSphere() const;
+
+		// CPU copy of the geometry, occluder input
+		const std::vector<DirectX::XMFLOAT3>& GetPositions() const;
+		const IndexCollection& GetIndices() const;
+
 	private:
 		friend class ResourceManager;
 
@@ -43,6 +52,12 @@ namespace alexis
 		IndexBuffer m_indexBuffer;
 		UINT m_indexCount{ 0 };
 
+		DirectX::BoundingBox m_boundingBox;
+		DirectX::BoundingSphere m_boundingSphere;
+
+		std::vector<DirectX::XMFLOAT3> m_positions;
+		IndexCollection m_indices;
+
 		std::wstring m_path; // Mesh source file path
 	};
 }
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include <Precompiled.h>
+
+#include "OcclusionCulling.h"
+
+#include <Core/JobSystem.h>
+#include <Render/Mesh.h>
+#include <Render/RenderScene.h>
+
+namespace alexis
+{
+	namespace
+	{
+		static constexpr std::uint32_t k_depthWidth = 256;
+		static constexpr std::uint32_t k_depthHeight = 144;
+
+		static constexpr std::size_t k_maxOccluders = 32;
+
+		// Estimated screen coverage of the bounding sphere, in screens. Smaller models are not worth drawing
+		static constexpr float k_minOccluderCoverage = 0.005f;
+
+		static constexpr std::size_t k_testBatchSize = 256;
+
+		// Clip space to pixels and depth. False if the point is in front of the near plane
+		inline bool XM_CALLCONV ToScreen(FXMVECTOR clip, XMFLOAT3& screen)
+		{
+			XMFLOAT4 position;
+			XMStoreFloat4(&position, clip);
+
+			if (position.w <= 0.0f || position.z < 0.0f)
+			{
+				return false;
+			}
+
+			float invW = 1.0f / position.w;
+			screen.x = (position.x * invW * 0.5f + 0.5f) * k_depthWidth;
+			screen.y = (0.5f - position.y * invW * 0.5f) * k_depthHeight;
+			screen.z = position.z * invW;
+			return true;
+		}
+
+		// Screen rectangle and nearest depth of a box: the corners are the clip space center plus or minus the
+		// clip space half axes, 4 transforms instead of 8. False if the box crosses the near plane
+		inline bool XM_CALLCONV GetScreenBounds(const BoundingBox& box, FXMMATRIX viewProj, XMFLOAT3& screenMin, XMFLOAT2& screenMax)
+		{
+			const XMVECTOR center = XMVector3Transform(XMLoadFloat3(&box.Center), viewProj);
+			const XMVECTOR axes[3] = { XMVectorScale(viewProj.r[0], box.Extents.x), XMVectorScale(viewProj.r[1], box.Extents.y), XMVectorScale(viewProj.r[2], box.Extents.z) };
+
+			XMVECTOR clipMin = g_XMFltMax;
+			XMVECTOR ndcMin = g_XMFltMax;
+			XMVECTOR ndcMax = XMVectorNegate(g_XMFltMax);
+			for (std::size_t corner = 0; corner < BoundingBox::CORNER_COUNT; ++corner)
+			{
+				XMVECTOR clip = center;
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					clip = (corner >> axis) & 1 ? XMVectorAdd(clip, axes[axis]) : XMVectorSubtract(clip, axes[axis]);
+				}
+
+				XMVECTOR ndc = XMVectorDivide(clip, XMVectorSplatW(clip));
+				clipMin = XMVectorMin(clipMin, clip);
+				ndcMin = XMVectorMin(ndcMin, ndc);
+				ndcMax = XMVectorMax(ndcMax, ndc);
+			}
+
+			XMFLOAT4 nearest;
+			XMStoreFloat4(&nearest, clipMin);
+			if (nearest.w <= 0.0f || nearest.z < 0.0f)
+			{
+				return false;
+			}
+
+			XMFLOAT3 minimum;
+			XMFLOAT3 maximum;
+			XMStoreFloat3(&minimum, ndcMin);
+			XMStoreFloat3(&maximum, ndcMax);
+
+			// Y flips, the top of the rectangle comes from the largest y
+			screenMin = { (minimum.x * 0.5f + 0.5f) * k_depthWidth, (0.5f - maximum.y * 0.5f) * k_depthHeight, minimum.z };
+			screenMax = { (maximum.x * 0.5f + 0.5f) * k_depthWidth, (0.5f - minimum.y * 0.5f) * k_depthHeight };
+			return true;
+		}
+	}
+
+	OcclusionCuller::OcclusionCuller()
+	{
+		m_depthBuffer.Resize(k_depthWidth, k_depthHeight);
+	}
+
+	void OcclusionCuller::Cull(RenderScene& renderScene, JobSystem& jobSystem)
+	{
+		auto& visible = renderScene.VisibleModels[RenderScene::k_mainView];
+
+		m_stats = {};
+
+		SelectOccluders(renderScene);
+		if (m_occluders.empty())
+		{
+			return;
+		}
+
+		TransformOccluders(renderScene, jobSystem);
+		BinTriangles();
+
+		jobSystem.ParallelFor(m_depthBuffer.GetBandCount(), 1, [this](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t band = begin; band < end; ++band)
+			{
+				const auto& triangles = m_bandTriangles[band];
+				m_depthBuffer.RasterizeBand(static_cast<std::uint32_t>(band), triangles.data(), triangles.size());
+			}
+		});
+
+		// Boxes are tested by their screen rectangle and nearest corner (see GetScreenBounds)
+		const auto& boxes = renderScene.Models.Boxes;
+		const XMMATRIX viewProj = renderScene.Views[RenderScene::k_mainView].ViewProj;
+
+		m_isOccluded.assign(visible.size(), 0);
+
+		jobSystem.ParallelFor(visible.size(), k_testBatchSize, [this, &visible, &boxes, &viewProj](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				XMFLOAT3 screenMin;
+				XMFLOAT2 screenMax;
+				if (GetScreenBounds(boxes[visible[i]], viewProj, screenMin, screenMax) && m_depthBuffer.IsOccluded(screenMin.x, screenMin.y, screenMax.x, screenMax.y, screenMin.z))
+				{
+					m_isOccluded[i] = 1;
+				}
+			}
+		});
+
+		std::size_t visibleCount = 0;
+		for (std::size_t i = 0; i < visible.size(); ++i)
+		{
+			if (!m_isOccluded[i])
+			{
+				visible[visibleCount++] = visible[i];
+			}
+		}
+
+		m_stats.TestedCount = static_cast<std::uint32_t>(visible.size());
+		m_stats.OccludedCount = static_cast<std::uint32_t>(visible.size() - visibleCount);
+
+		visible.resize(visibleCount);
+	}
+
+	const OcclusionCuller::Stats& OcclusionCuller::GetStats() const
+	{
+		return m_stats;
+	}
+
+	const utils::DepthRasterizer& OcclusionCuller::GetDepthBuffer() const
+	{
+		return m_depthBuffer;
+	}
+
+	void OcclusionCuller::SelectOccluders(const RenderScene& renderScene)
+	{
+		const auto& models = renderScene.Models;
+		const auto& visible = renderScene.VisibleModels[RenderScene::k_mainView];
+
+		const auto& mainView = renderScene.Views[RenderScene::k_mainView];
+
+		XMFLOAT3 viewPosition;
+		XMStoreFloat3(&viewPosition, mainView.Position);
+
+		// Ellipse of radius / distance scaled by the projection, over the 2x2 clip space square
+		XMFLOAT4X4 proj;
+		XMStoreFloat4x4(&proj, mainView.Proj);
+		const float coverageScale = XM_PI * proj._11 * proj._22 / 4.0f;
+
+		// Largest on screen first
+		thread_local std::vector<std::pair<float, std::uint32_t>> candidates;
+		candidates.clear();
+
+		for (auto proxy : visible)
+		{
+			float dx = models.SphereCenterX[proxy] - viewPosition.x;
+			float dy = models.SphereCenterY[proxy] - viewPosition.y;
+			float dz = models.SphereCenterZ[proxy] - viewPosition.z;
+			float distanceSq = std::max(dx * dx + dy * dy + dz * dz, 1e-6f);
+
+			float coverage = std::min(coverageScale * models.SphereRadius[proxy] * models.SphereRadius[proxy] / distanceSq, 1.0f);
+			if (coverage >= k_minOccluderCoverage)
+			{
+				candidates.emplace_back(coverage, proxy);
+			}
+		}
+
+		std::sort(candidates.begin(), candidates.end(), std::greater<>());
+
+		m_occluders.clear();
+		m_triangleOffsets.clear();
+
+		std::size_t triangleCount = 0;
+		float totalCoverage = 0.0f;
+		for (const auto& [coverage, proxy] : candidates)
+		{
+			std::size_t meshTriangles = models.Meshes[proxy]->GetIndices().size() / 3;
+			if (triangleCount + meshTriangles > k_maxTriangles || totalCoverage + coverage > k_maxCoverage)
+			{
+				continue;
+			}
+
+			m_occluders.push_back(proxy);
+			m_triangleOffsets.push_back(static_cast<std::uint32_t>(triangleCount));
+			triangleCount += meshTriangles;
+			totalCoverage += coverage;
+
+			if (m_occluders.size() == k_maxOccluders)
+			{
+				break;
+			}
+		}
+
+		m_triangles.resize(triangleCount);
+		m_triangleCounts.assign(m_occluders.size(), 0);
+
+		m_stats.OccluderCount = static_cast<std::uint32_t>(m_occluders.size());
+		m_stats.Coverage = totalCoverage;
+	}
+
+	void OcclusionCuller::TransformOccluders(const RenderScene& renderScene, JobSystem& jobSystem)
+	{
+		const auto& models = renderScene.Models;
+		const XMMATRIX viewProj = renderScene.Views[RenderScene::k_mainView].ViewProj;
+
+		jobSystem.ParallelFor(m_occluders.size(), 1, [this, &models, &viewProj](std::size_t begin, std::size_t end)
+		{
+			thread_local std::vector<XMFLOAT3> screenVertices;
+			thread_local std::vector<std::uint8_t> isVertexValid;
+
+			for (std::size_t occluder = begin; occluder < end; ++occluder)
+			{
+				std::uint32_t proxy = m_occluders[occluder];
+				const auto& positions = models.Meshes[proxy]->GetPositions();
+				const auto& indices = models.Meshes[proxy]->GetIndices();
+
+				XMMATRIX worldViewProj = XMMatrixMultiply(models.WorldMatrices[proxy], viewProj);
+
+				screenVertices.resize(positions.size());
+				isVertexValid.resize(positions.size());
+				for (std::size_t i = 0; i < positions.size(); ++i)
+				{
+					isVertexValid[i] = ToScreen(XMVector3Transform(XMLoadFloat3(&positions[i]), worldViewProj), screenVertices[i]) ? 1 : 0;
+				}
+
+				// Triangles crossing the near plane and back faces (clockwise is front, like the PBR pipeline) are dropped,
+				// drawing less only makes culling more conservative
+				auto* triangles = m_triangles.data() + m_triangleOffsets[occluder];
+				std::uint32_t count = 0;
+				for (std::size_t t = 0; t < indices.size() / 3; ++t)
+				{
+					std::uint16_t i0 = indices[3 * t];
+					std::uint16_t i1 = indices[3 * t + 1];
+					std::uint16_t i2 = indices[3 * t + 2];
+
+					if (!isVertexValid[i0] || !isVertexValid[i1] || !isVertexValid[i2])
+					{
+						continue;
+					}
+
+					const XMFLOAT3& v0 = screenVertices[i0];
+					const XMFLOAT3& v1 = screenVertices[i1];
+					const XMFLOAT3& v2 = screenVertices[i2];
+					if ((v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x) > 0.0f)
+					{
+						triangles[count++] = { v0, v1, v2 };
+					}
+				}
+				m_triangleCounts[occluder] = count;
+			}
+		});
+	}
+
+	void OcclusionCuller::BinTriangles()
+	{
+		const std::uint32_t bandCount = m_depthBuffer.GetBandCount();
+		m_bandTriangles.resize(bandCount);
+		for (auto& triangles : m_bandTriangles)
+		{
+			triangles.clear();
+		}
+
+		std::uint32_t triangleCount = 0;
+		for (std::size_t occluder = 0; occluder < m_occluders.size(); ++occluder)
+		{
+			const auto* triangles = m_triangles.data() + m_triangleOffsets[occluder];
+			for (std::uint32_t t = 0; t < m_triangleCounts[occluder]; ++t)
+			{
+				const auto& vertices = triangles[t].Vertices;
+				float minY = std::min(std::min(vertices[0].y, vertices[1].y), vertices[2].y);
+				float maxY = std::max(std::max(vertices[0].y, vertices[1].y), vertices[2].y);
+				if (maxY < 0.0f || minY >= static_cast<float>(k_depthHeight))
+				{
+					continue;
+				}
+
+				std::uint32_t firstBand = static_cast<std::uint32_t>(std::max(minY, 0.0f)) / utils::DepthRasterizer::k_bandHeight;
+				std::uint32_t lastBand = std::min(static_cast<std::uint32_t>(maxY) / utils::DepthRasterizer::k_bandHeight, bandCount - 1);
+				for (std::uint32_t band = firstBand; band <= lastBand; ++band)
+				{
+					m_bandTriangles[band].push_back(triangles[t]);
+				}
+			}
+			triangleCount += m_triangleCounts[occluder];
+		}
+
+		m_stats.TriangleCount = triangleCount;
+	}
+}
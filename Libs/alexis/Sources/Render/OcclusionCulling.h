@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <Utils/DepthRasterizer.h>
+
+namespace alexis
+{
+	class JobSystem;
+	struct RenderScene;
+
+	// CPU occlusion culling of the main view: the largest visible models are rasterized into a low resolution
+	// depth buffer and models hidden behind them are removed from RenderScene::VisibleModels
+	class OcclusionCuller
+	{
+	public:
+		// Per frame rasterization budget, the cost is about the triangle count plus the pixels covered.
+		// Once occluders cover the screen about twice, more of them mostly add overdraw
+		static constexpr std::size_t k_maxTriangles = 4096;
+		static constexpr float k_maxCoverage = 2.0f;
+
+		struct Stats
+		{
+			std::uint32_t OccluderCount{ 0 };
+			// Front facing triangles in front of the near plane
+			std::uint32_t TriangleCount{ 0 };
+			// Estimated screen coverage of the occluders, in screens
+			float Coverage{ 0.0f };
+			std::uint32_t TestedCount{ 0 };
+			std::uint32_t OccludedCount{ 0 };
+		};
+
+		OcclusionCuller();
+
+		// Runs after CullModels, reads the main view visible list and filters it in place
+		void Cull(RenderScene& renderScene, JobSystem& jobSystem);
+
+		const Stats& GetStats() const;
+		const utils::DepthRasterizer& GetDepthBuffer() const;
+
+	private:
+		void SelectOccluders(const RenderScene& renderScene);
+		void TransformOccluders(const RenderScene& renderScene, JobSystem& jobSystem);
+		void BinTriangles();
+
+		utils::DepthRasterizer m_depthBuffer;
+
+		// Proxy indices, offsets and counts of their triangles in m_triangles
+		std::vector<std::uint32_t> m_occluders;
+		std::vector<std::uint32_t> m_triangleOffsets;
+		std::vector<std::uint32_t> m_triangleCounts;
+		std::vector<utils::ScreenTriangle> m_triangles;
+
+		// Triangles overlapping each band of the depth buffer
+		std::vector<std::vector<utils::ScreenTriangle>> m_bandTriangles;
+
+		// Per entry of the main view visible list
+		std::vector<std::uint8_t> m_isOccluded;
+
+		Stats m_stats;
+	};
+}
@@ -25,6 +25,7 @@ namespace alexis
 		m_rtManager = std::make_unique<RenderTargetManager>();
 
 		m_frameRenderGraph = std::make_unique<FrameRenderGraph>();
+		m_renderScene = std::make_unique<RenderScene>();
 
 		InitPipeline();
 
@@ -42,6 +43,7 @@ namespace alexis
 	{
 		WaitForSingleObjectEx(m_swapChainEvent, 100, FALSE);
 
+		m_frameRenderGraph->Extract();
 		m_frameRenderGraph->Render();
 	}
 
@@ -503,22 +505,25 @@ namespace alexis
 			m_rtManager->EmplaceTarget(L"HDR", std::move(hdrTarget));
 		}
 
-		// Create shadow map target
+		// Create shadow map targets, atlases of 2x2 cascades. Shadow Cache keeps depth of static casters (see ShadowSystem)
 		{
 			DXGI_FORMAT shadowFormat = DXGI_FORMAT_R24G8_TYPELESS;
-			auto shadowDesc = CD3DX12_RESOURCE_DESC::Tex2D(shadowFormat, 1024, 1024);
+			auto shadowDesc = CD3DX12_RESOURCE_DESC::Tex2D(shadowFormat, 2048, 2048);
 			shadowDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
 
 			D3D12_CLEAR_VALUE shadowDepthClearValue;
 			shadowDepthClearValue.Format = shadowDesc.Format;
 			shadowDepthClearValue.DepthStencil = { 1.0f, 0 };
 
-			TextureBuffer shadowDepthTexture;
-			shadowDepthTexture.Create(shadowDesc, &shadowDepthClearValue);
+			for (const auto* name : { L"Shadow Map", L"Shadow Cache" })
+			{
+				TextureBuffer shadowDepthTexture;
+				shadowDepthTexture.Create(shadowDesc, &shadowDepthClearValue);
 
-			auto shadowRT = std::make_unique<RenderTarget>();
-			shadowRT->AttachTexture(shadowDepthTexture, RenderTarget::DepthStencil);
-			m_rtManager->EmplaceTarget(L"Shadow Map", std::move(shadowRT));
+				auto shadowRT = std::make_unique<RenderTarget>();
+				shadowRT->AttachTexture(shadowDepthTexture, RenderTarget::DepthStencil);
+				m_rtManager->EmplaceTarget(name, std::move(shadowRT));
+			}
 		}
 
 		// Wait
@@ -11,6 +11,7 @@
 #include <Render/CommandManager.h>
 #include <Render/Buffers/UploadBufferManager.h>
 #include <Render/FrameRenderGraph.h>
+#include <Render/RenderScene.h>
 #include <Render/RenderTarget.h>
 #include <Render/RenderTargetManager.h>
 
@@ -56,6 +57,16 @@ namespace alexis
 			return m_rtManager.get();
 		}
 
+		RenderScene* GetRenderScene() const
+		{
+			return m_renderScene.get();
+		}
+
+		const FrameRenderGraph* GetFrameRenderGraph() const
+		{
+			return m_frameRenderGraph.get();
+		}
+
 		bool IsVSync() const;
 		void SetVSync(bool vSync);
 		void ToggleVSync();
@@ -103,6 +114,7 @@ namespace alexis
 		std::unique_ptr<UploadBufferManager> m_uploadBufferManager;
 
 		std::unique_ptr<FrameRenderGraph> m_frameRenderGraph;
+		std::unique_ptr<RenderScene> m_renderScene;
 
 		std::unique_ptr<CommandManager> m_commandManager;
 		std::unique_ptr<RenderTargetManager> m_rtManager;
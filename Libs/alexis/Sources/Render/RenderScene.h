@@ -0,0 +1,176 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+#include <Render/ViewData.h>
+#include <Utils/Bvh.h>
+#include <Utils/LightClusters.h>
+#include <Utils/SphericalHarmonics.h>
+
+namespace alexis
+{
+	class Mesh;
+	class Material;
+
+	// Render-side copy of the scene
+	// Filled from ECS in the extract phase at the start of the frame (see FrameRenderGraph::Extract),
+	// command recording reads only these arrays and never touches the ECS
+	struct RenderScene
+	{
+		// Model proxies, SoA
+		struct ModelProxies
+		{
+			std::vector<DirectX::XMMATRIX> WorldMatrices;
+			std::vector<Mesh*> Meshes;
+			std::vector<Material*> Materials;
+
+			// World space bounding spheres, culling input
+			std::vector<float> SphereCenterX;
+			std::vector<float> SphereCenterY;
+			std::vector<float> SphereCenterZ;
+			std::vector<float> SphereRadius;
+
+			// World space boxes, ModelBvh input
+			std::vector<DirectX::BoundingBox> Boxes;
+
+			std::size_t Size() const
+			{
+				return Meshes.size();
+			}
+
+			void Resize(std::size_t size)
+			{
+				WorldMatrices.resize(size);
+				Meshes.resize(size);
+				Materials.resize(size);
+				SphereCenterX.resize(size);
+				SphereCenterY.resize(size);
+				SphereCenterZ.resize(size);
+				SphereRadius.resize(size);
+				Boxes.resize(size);
+			}
+		};
+
+		// Point light proxies, SoA
+		struct PointLightProxies
+		{
+			// Positions, clustering input together with Scales
+			std::vector<float> PositionX;
+			std::vector<float> PositionY;
+			std::vector<float> PositionZ;
+
+			std::vector<DirectX::XMVECTOR> Colors;
+
+			// Light volume radius
+			std::vector<float> Scales;
+
+			std::size_t Size() const
+			{
+				return Colors.size();
+			}
+
+			void Resize(std::size_t size)
+			{
+				PositionX.resize(size);
+				PositionY.resize(size);
+				PositionZ.resize(size);
+				Colors.resize(size);
+				Scales.resize(size);
+			}
+		};
+
+		// Spot light proxies, SoA
+		struct SpotLightProxies
+		{
+			std::vector<utils::LightCone> Cones;
+			std::vector<DirectX::XMVECTOR> Colors;
+
+			std::size_t Size() const
+			{
+				return Colors.size();
+			}
+
+			void Resize(std::size_t size)
+			{
+				Cones.resize(size);
+				Colors.resize(size);
+			}
+		};
+
+		// Directional light proxy
+		struct DirectionalLightProxy
+		{
+			// Direction the light travels, normalized
+			DirectX::XMVECTOR Direction = DirectX::g_XMNegIdentityR1;
+			DirectX::XMVECTOR Color = DirectX::g_XMZero;
+
+			// Scene has a directional light
+			bool IsEnabled{ false };
+
+			// Bumped whenever the proxy is written
+			std::uint32_t Version{ 0 };
+		};
+
+		// Directional shadow cascade, drawn into its own tile of the shadow atlas
+		struct alignas(16) ShadowCascade
+		{
+			// Main view depths covered by the cascade
+			float SplitNear;
+			float SplitFar;
+
+			// World units per shadow map texel
+			float TexelSize;
+
+			// World -> shadow atlas UV and depth
+			DirectX::XMMATRIX ShadowMatrix;
+
+			// Cached depth of StaticCasters must be redrawn this frame
+			bool IsCacheStale;
+
+			// Casters of the cascade view split by ShadowSystem::UpdateCasterCache: static ones are drawn into the shadow cache
+			// when it is stale, dynamic ones are drawn over the cache copy every frame
+			std::vector<std::uint32_t> StaticCasters;
+			std::vector<std::uint32_t> DynamicCasters;
+		};
+
+		// View indices, cascade i is drawn from view k_shadowView + i
+		static constexpr std::size_t k_mainView = 0;
+		static constexpr std::size_t k_shadowView = 1;
+		static constexpr std::size_t k_shadowCascadeCount = 4;
+		static constexpr std::size_t k_viewCount = k_shadowView + k_shadowCascadeCount;
+
+		ModelProxies Models;
+
+		// Bumped when ModelSystem rebuilds Models, proxy indices of different versions do not match
+		std::uint32_t ModelsVersion{ 0 };
+
+		// Proxies whose world matrix or mesh changed in the last ModelSystem::Extract
+		std::vector<std::uint32_t> MovedModels;
+		PointLightProxies PointLights;
+		SpotLightProxies SpotLights;
+		DirectionalLightProxy Sun;
+
+		// Diffuse irradiance of the environment (see EnvironmentSystem::Extract)
+		utils::IrradianceSH IrradianceSH;
+
+		// Over Models.Boxes, primitive index is the proxy index. Kept up to date by ModelSystem::Extract
+		utils::Bvh ModelBvh;
+
+		std::array<ViewData, k_viewCount> Views;
+
+		// Indices into Models visible from each view (see CullModels)
+		std::array<std::vector<std::uint32_t>, k_viewCount> VisibleModels;
+
+		// Sun shadow cascades, near to far (see ShadowSystem::Extract). Caster lists are empty without a sun
+		std::array<ShadowCascade, k_shadowCascadeCount> ShadowCascades;
+
+		// Point and spot lights binned in the main view frustum, point lights come first (see LightingSystem::Extract)
+		utils::LightClusters LightClusters;
+	};
+}
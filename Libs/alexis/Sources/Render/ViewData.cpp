@@ -0,0 +1,29 @@
+#include <Precompiled.h>
+
+#include "ViewData.h"
+
+namespace alexis
+{
+	void XM_CALLCONV BuildViewData(FXMVECTOR position, FXMMATRIX view, CXMMATRIX invView, CXMMATRIX proj, CXMMATRIX invProj, ViewData& viewData)
+	{
+		viewData.View = view;
+		viewData.InvView = invView;
+		viewData.Proj = proj;
+		viewData.InvProj = invProj;
+
+		viewData.ViewProj = XMMatrixMultiply(view, proj);
+		viewData.InvViewProj = XMMatrixMultiply(invProj, invView);
+
+		viewData.Position = position;
+
+		// Row vectors: clip = p * ViewProj, planes are combinations of its columns (D3D depth range 0..w)
+		XMMATRIX columns = XMMatrixTranspose(viewData.ViewProj);
+
+		viewData.FrustumPlanes[ViewData::Left] = XMPlaneNormalize(XMVectorAdd(columns.r[3], columns.r[0]));
+		viewData.FrustumPlanes[ViewData::Right] = XMPlaneNormalize(XMVectorSubtract(columns.r[3], columns.r[0]));
+		viewData.FrustumPlanes[ViewData::Bottom] = XMPlaneNormalize(XMVectorAdd(columns.r[3], columns.r[1]));
+		viewData.FrustumPlanes[ViewData::Top] = XMPlaneNormalize(XMVectorSubtract(columns.r[3], columns.r[1]));
+		viewData.FrustumPlanes[ViewData::Near] = XMPlaneNormalize(columns.r[2]);
+		viewData.FrustumPlanes[ViewData::Far] = XMPlaneNormalize(XMVectorSubtract(columns.r[3], columns.r[2]));
+	}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+
+#include <DirectXMath.h>
+
+namespace alexis
+{
+	// Per-frame data of one view (camera), computed once in the extract phase
+	// Passes read it by view index from RenderScene::Views instead of querying cameras
+	struct alignas(16) ViewData
+	{
+		enum FrustumPlane
+		{
+			Left = 0,
+			Right,
+			Bottom,
+			Top,
+			Near,
+			Far,
+			PlaneCount
+		};
+
+		DirectX::XMMATRIX View;
+		DirectX::XMMATRIX InvView;
+
+		DirectX::XMMATRIX Proj;
+		DirectX::XMMATRIX InvProj;
+
+		DirectX::XMMATRIX ViewProj;
+		DirectX::XMMATRIX InvViewProj;
+
+		DirectX::XMVECTOR Position;
+
+		// World space, normalized, normals point inside: XMPlaneDotCoord(plane, p) >= 0 for points inside
+		std::array<DirectX::XMVECTOR, PlaneCount> FrustumPlanes;
+
+		// Models with a smaller bounding sphere are culled, shadow views skip casters below a texel
+		float MinModelRadius{ 0.0f };
+	};
+
+	// Fill viewData from camera matrices, inverses are taken as is
+	void XM_CALLCONV BuildViewData(DirectX::FXMVECTOR position, DirectX::FXMMATRIX view, DirectX::CXMMATRIX invView, DirectX::CXMMATRIX proj, DirectX::CXMMATRIX invProj, ViewData& viewData);
+}
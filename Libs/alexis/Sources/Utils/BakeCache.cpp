@@ -0,0 +1,106 @@
+#include <Precompiled.h>
+
+#include "BakeCache.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+
+namespace alexis
+{
+	namespace utils
+	{
+		namespace
+		{
+			static constexpr std::uint32_t k_bakeCacheMagic = 0x4B414241; // "ABAK"
+
+			struct BakeCacheHeader
+			{
+				std::uint32_t Magic;
+				std::uint32_t Version;
+				std::uint64_t Size;
+			};
+		}
+
+		std::uint64_t HashFileContent(const std::filesystem::path& path)
+		{
+			std::ifstream file(path, std::ios::binary);
+			if (!file)
+			{
+				return 0;
+			}
+
+			std::uint64_t hash = 0xcbf29ce484222325ull;
+
+			std::vector<char> buffer(1 << 16);
+			while (file)
+			{
+				file.read(buffer.data(), buffer.size());
+				const auto readCount = static_cast<std::size_t>(file.gcount());
+				for (std::size_t i = 0; i < readCount; ++i)
+				{
+					hash ^= static_cast<unsigned char>(buffer[i]);
+					hash *= 0x100000001b3ull;
+				}
+			}
+
+			return hash;
+		}
+
+		std::filesystem::path GetBakeCachePath(const std::filesystem::path& source, std::uint64_t sourceHash, std::string_view kind)
+		{
+			char hashText[17];
+			std::snprintf(hashText, sizeof(hashText), "%016" PRIx64, sourceHash);
+
+			std::string fileName = source.stem().string() + "." + hashText + "." + std::string(kind);
+			return std::filesystem::path(k_bakeCacheDirectory) / fileName;
+		}
+
+		bool ReadBakeCache(const std::filesystem::path& cachePath, std::uint32_t version, void* data, std::size_t size)
+		{
+			std::ifstream file(cachePath, std::ios::binary);
+			if (!file)
+			{
+				return false;
+			}
+
+			BakeCacheHeader header{};
+			file.read(reinterpret_cast<char*>(&header), sizeof(header));
+			if (!file || header.Magic != k_bakeCacheMagic || header.Version != version || header.Size != size)
+			{
+				return false;
+			}
+
+			file.read(static_cast<char*>(data), size);
+			return static_cast<std::size_t>(file.gcount()) == size;
+		}
+
+		bool WriteBakeCache(const std::filesystem::path& cachePath, std::uint32_t version, const void* data, std::size_t size)
+		{
+			std::error_code error;
+			std::filesystem::create_directories(cachePath.parent_path(), error);
+
+			// Written aside and renamed, so an interrupted write never leaves a valid looking file
+			auto tempPath = cachePath;
+			tempPath += ".tmp";
+			{
+				std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+				if (!file)
+				{
+					return false;
+				}
+
+				BakeCacheHeader header{ k_bakeCacheMagic, version, size };
+				file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+				file.write(static_cast<const char*>(data), size);
+				if (!file)
+				{
+					return false;
+				}
+			}
+
+			std::filesystem::rename(tempPath, cachePath, error);
+			return !error;
+		}
+	}
+}
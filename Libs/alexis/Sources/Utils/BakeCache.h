@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace alexis
+{
+	namespace utils
+	{
+		// Data baked from source assets is cached on disk under k_bakeCacheDirectory, keyed by a hash of the source content.
+		// Blobs of WriteBakeCache are a header (magic, format version, payload size) followed by the payload
+		inline constexpr std::string_view k_bakeCacheDirectory = "Cache";
+
+		// FNV-1a 64 of the file content, 0 if the file cannot be read
+		std::uint64_t HashFileContent(const std::filesystem::path& path);
+
+		// Cache file of source baked as kind, e.g. Cache/Newport_Loft_Ref.0123456789abcdef.sh9
+		std::filesystem::path GetBakeCachePath(const std::filesystem::path& source, std::uint64_t sourceHash, std::string_view kind);
+
+		// Fails if the file is missing or was written with another version or size
+		bool ReadBakeCache(const std::filesystem::path& cachePath, std::uint32_t version, void* data, std::size_t size);
+		bool WriteBakeCache(const std::filesystem::path& cachePath, std::uint32_t version, const void* data, std::size_t size);
+	}
+}
@@ -0,0 +1,544 @@
+#include <Precompiled.h>
+
+#include "Bvh.h"
+
+#include <limits>
+
+#include <Core/JobSystem.h>
+
+namespace alexis
+{
+	namespace utils
+	{
+		namespace
+		{
+			static constexpr std::uint32_t k_maxLeafSize = 4;
+			static constexpr std::uint32_t k_binCount = 16;
+
+			// Subtrees with more primitives are built as separate jobs
+			static constexpr std::uint32_t k_parallelBuildSize = 16384;
+
+			// Refit cost above build cost * ratio asks for a rebuild
+			static constexpr float k_rebuildCostRatio = 1.5f;
+
+			static constexpr std::uint32_t k_invalidNode = std::numeric_limits<std::uint32_t>::max();
+
+			struct Aabb
+			{
+				XMFLOAT3 Min{ std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+				XMFLOAT3 Max{ -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max() };
+
+				void Grow(const XMFLOAT3& min, const XMFLOAT3& max)
+				{
+					Min = { std::min(Min.x, min.x), std::min(Min.y, min.y), std::min(Min.z, min.z) };
+					Max = { std::max(Max.x, max.x), std::max(Max.y, max.y), std::max(Max.z, max.z) };
+				}
+
+				void Grow(const Aabb& other)
+				{
+					Grow(other.Min, other.Max);
+				}
+
+				void Grow(const XMFLOAT3& point)
+				{
+					Grow(point, point);
+				}
+
+				float SurfaceArea() const
+				{
+					float x = Max.x - Min.x;
+					float y = Max.y - Min.y;
+					float z = Max.z - Min.z;
+					return x < 0.0f ? 0.0f : 2.0f * (x * y + y * z + z * x);
+				}
+			};
+
+			inline float Axis(const XMFLOAT3& v, int axis)
+			{
+				return (&v.x)[axis];
+			}
+
+			struct BuildNode
+			{
+				Aabb Bounds;
+				std::uint32_t Left{ k_invalidNode };
+				std::uint32_t Right{ k_invalidNode };
+				std::uint32_t Count{ 0 };
+			};
+
+			// Partitioned in place, so every subtree reads a contiguous range
+			struct BuildPrimitive
+			{
+				Aabb Bounds;
+				XMFLOAT3 Centroid;
+				std::uint32_t Index;
+			};
+
+			struct BuildContext
+			{
+				std::vector<BuildPrimitive> Primitives;
+
+				// Preallocated for 2 * count - 1 nodes, so references stay valid while other jobs allocate
+				std::vector<BuildNode> Nodes;
+				std::atomic<std::uint32_t> NodeCount{ 1 };
+
+				JobSystem* Jobs{ nullptr };
+			};
+
+			void BuildSubtree(BuildContext& context, std::uint32_t nodeIndex, std::uint32_t first, std::uint32_t count)
+			{
+				auto& node = context.Nodes[nodeIndex];
+				node.Count = count;
+
+				auto begin = context.Primitives.begin() + first;
+				auto end = begin + count;
+
+				Aabb centroidBounds;
+				for (auto it = begin; it != end; ++it)
+				{
+					node.Bounds.Grow(it->Bounds);
+					centroidBounds.Grow(it->Centroid);
+				}
+
+				if (count <= k_maxLeafSize)
+				{
+					return;
+				}
+
+				std::uint32_t left = context.NodeCount.fetch_add(2, std::memory_order_relaxed);
+				node.Left = left;
+				node.Right = left + 1;
+
+				XMFLOAT3 extent{ centroidBounds.Max.x - centroidBounds.Min.x, centroidBounds.Max.y - centroidBounds.Min.y, centroidBounds.Max.z - centroidBounds.Min.z };
+				int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+
+				// Binning does not pay off for a few primitives: object median on the widest axis
+				if (count <= k_binCount)
+				{
+					std::uint32_t leftCount = count / 2;
+					std::nth_element(begin, begin + leftCount, end, [axis](const BuildPrimitive& a, const BuildPrimitive& b)
+					{
+						return Axis(a.Centroid, axis) < Axis(b.Centroid, axis);
+					});
+
+					BuildSubtree(context, left, first, leftCount);
+					BuildSubtree(context, left + 1, first + leftCount, count - leftCount);
+					return;
+				}
+
+				// Binned SAH along the same axis
+				float minCentroid = Axis(centroidBounds.Min, axis);
+				float scale = Axis(extent, axis) > 0.0f ? k_binCount / Axis(extent, axis) : 0.0f;
+
+				auto getBin = [axis, minCentroid, scale](const BuildPrimitive& primitive)
+				{
+					return std::min(static_cast<std::uint32_t>((Axis(primitive.Centroid, axis) - minCentroid) * scale), k_binCount - 1);
+				};
+
+				Aabb binBounds[k_binCount];
+				std::uint32_t binCounts[k_binCount] = {};
+
+				for (auto it = begin; it != end; ++it)
+				{
+					auto bin = getBin(*it);
+					binBounds[bin].Grow(it->Bounds);
+					++binCounts[bin];
+				}
+
+				// Right sweep stores cost of bins [split, k_binCount), left sweep adds [0, split)
+				float rightCosts[k_binCount] = {};
+				Aabb rightBounds;
+				std::uint32_t rightCount = 0;
+				for (std::uint32_t split = k_binCount - 1; split > 0; --split)
+				{
+					rightBounds.Grow(binBounds[split]);
+					rightCount += binCounts[split];
+					rightCosts[split] = rightBounds.SurfaceArea() * rightCount;
+				}
+
+				std::uint32_t bestSplit = 0;
+				float bestCost = std::numeric_limits<float>::max();
+
+				Aabb leftBounds;
+				std::uint32_t leftCount = 0;
+				for (std::uint32_t split = 1; split < k_binCount; ++split)
+				{
+					leftBounds.Grow(binBounds[split - 1]);
+					leftCount += binCounts[split - 1];
+
+					float cost = leftBounds.SurfaceArea() * leftCount + rightCosts[split];
+					if (leftCount > 0 && leftCount < count && cost < bestCost)
+					{
+						bestCost = cost;
+						bestSplit = split;
+					}
+				}
+
+				// All centroids coincide: split in halves
+				leftCount = count / 2;
+				if (bestSplit > 0)
+				{
+					auto middle = std::partition(begin, end, [&getBin, bestSplit](const BuildPrimitive& primitive)
+					{
+						return getBin(primitive) < bestSplit;
+					});
+
+					leftCount = static_cast<std::uint32_t>(middle - begin);
+				}
+
+				if (context.Jobs && count > k_parallelBuildSize)
+				{
+					JobCounter counter{ 0 };
+					context.Jobs->Run([&context, left, first, leftCount]() { BuildSubtree(context, left, first, leftCount); }, &counter);
+					BuildSubtree(context, left + 1, first + leftCount, count - leftCount);
+					context.Jobs->Wait(counter);
+				}
+				else
+				{
+					BuildSubtree(context, left, first, leftCount);
+					BuildSubtree(context, left + 1, first + leftCount, count - leftCount);
+				}
+			}
+
+			inline XMFLOAT3 BoxMin(const BoundingBox& box)
+			{
+				return { box.Center.x - box.Extents.x, box.Center.y - box.Extents.y, box.Center.z - box.Extents.z };
+			}
+
+			inline XMFLOAT3 BoxMax(const BoundingBox& box)
+			{
+				return { box.Center.x + box.Extents.x, box.Center.y + box.Extents.y, box.Center.z + box.Extents.z };
+			}
+		}
+
+		template<class Test, class Visit>
+		void Bvh::Traverse(Test&& test, Visit&& visit) const
+		{
+			const std::uint32_t nodeCount = static_cast<std::uint32_t>(m_nodes.size());
+
+			// First primitive of the current node, advanced past every finished subtree
+			std::uint32_t cursor = 0;
+			std::uint32_t nodeIndex = 0;
+
+			while (nodeIndex < nodeCount)
+			{
+				const auto& node = m_nodes[nodeIndex];
+				Overlap overlap = test(XMLoadFloat3(&node.Min), XMLoadFloat3(&node.Max));
+
+				if (overlap == Overlap::Intersects && node.Skip != nodeIndex + 1)
+				{
+					++nodeIndex;
+					continue;
+				}
+
+				if (overlap == Overlap::Inside)
+				{
+					for (std::uint32_t i = cursor; i < cursor + node.PrimitiveCount; ++i)
+					{
+						visit(m_primitives[i].Index);
+					}
+				}
+				else if (overlap == Overlap::Intersects)
+				{
+					for (std::uint32_t i = cursor; i < cursor + node.PrimitiveCount; ++i)
+					{
+						const auto& primitive = m_primitives[i];
+						if (test(XMLoadFloat3(&primitive.Min), XMLoadFloat3(&primitive.Max)) != Overlap::Outside)
+						{
+							visit(primitive.Index);
+						}
+					}
+				}
+
+				cursor += node.PrimitiveCount;
+				nodeIndex = node.Skip;
+			}
+		}
+
+		void Bvh::Build(const BoundingBox* boxes, std::size_t count, JobSystem* jobSystem)
+		{
+			Clear();
+
+			if (count == 0)
+			{
+				return;
+			}
+
+			assert(count < k_invalidNode / 2 && "Too many primitives");
+
+			BuildContext context;
+			context.Jobs = jobSystem;
+			context.Primitives.resize(count);
+			context.Nodes.resize(2 * count - 1);
+
+			for (std::uint32_t i = 0; i < count; ++i)
+			{
+				auto& primitive = context.Primitives[i];
+				primitive.Bounds.Min = BoxMin(boxes[i]);
+				primitive.Bounds.Max = BoxMax(boxes[i]);
+				primitive.Centroid = boxes[i].Center;
+				primitive.Index = i;
+			}
+
+			BuildSubtree(context, 0, 0, static_cast<std::uint32_t>(count));
+
+			// Flatten into depth-first order, children of a node cover consecutive primitive ranges
+			m_nodes.resize(context.NodeCount.load());
+			m_primitives.resize(count);
+
+			for (std::uint32_t i = 0; i < count; ++i)
+			{
+				const auto& primitive = context.Primitives[i];
+				m_primitives[i] = { primitive.Bounds.Min, primitive.Index, primitive.Bounds.Max, 0 };
+			}
+
+			std::vector<std::pair<std::uint32_t, std::uint32_t>> stack; // Build node, flat node
+			stack.emplace_back(0, 0);
+
+			// Subtree sizes are known from primitive counts: a binary tree with n leaves has 2n - 1 nodes
+			std::vector<std::uint32_t> subtreeSizes(context.Nodes.size(), 1);
+			for (std::uint32_t i = context.NodeCount.load(); i-- > 0;)
+			{
+				const auto& buildNode = context.Nodes[i];
+				if (buildNode.Left != k_invalidNode)
+				{
+					subtreeSizes[i] = 1 + subtreeSizes[buildNode.Left] + subtreeSizes[buildNode.Right];
+				}
+			}
+
+			m_buildCost = 0.0f;
+			while (!stack.empty())
+			{
+				auto [buildIndex, flatIndex] = stack.back();
+				stack.pop_back();
+
+				const auto& buildNode = context.Nodes[buildIndex];
+				bool isLeaf = buildNode.Left == k_invalidNode;
+
+				m_nodes[flatIndex] = { buildNode.Bounds.Min, flatIndex + subtreeSizes[buildIndex], buildNode.Bounds.Max, buildNode.Count };
+				m_buildCost += buildNode.Bounds.SurfaceArea() * (isLeaf ? buildNode.Count : 1);
+
+				if (!isLeaf)
+				{
+					// Left child right after the parent, right child after the left subtree
+					stack.emplace_back(buildNode.Right, flatIndex + 1 + subtreeSizes[buildNode.Left]);
+					stack.emplace_back(buildNode.Left, flatIndex + 1);
+				}
+			}
+
+			m_cost = m_buildCost;
+		}
+
+		void Bvh::Refit(const BoundingBox* boxes)
+		{
+			for (auto& primitive : m_primitives)
+			{
+				primitive.Min = BoxMin(boxes[primitive.Index]);
+				primitive.Max = BoxMax(boxes[primitive.Index]);
+			}
+
+			// Children follow their parent, so a reverse walk visits them first.
+			// Leaves are met in reverse primitive order
+			std::uint32_t primitiveEnd = static_cast<std::uint32_t>(m_primitives.size());
+			m_cost = 0.0f;
+
+			for (std::uint32_t nodeIndex = static_cast<std::uint32_t>(m_nodes.size()); nodeIndex-- > 0;)
+			{
+				auto& node = m_nodes[nodeIndex];
+				Aabb bounds;
+
+				bool isLeaf = node.Skip == nodeIndex + 1;
+				if (isLeaf)
+				{
+					std::uint32_t first = primitiveEnd - node.PrimitiveCount;
+					for (std::uint32_t i = first; i < primitiveEnd; ++i)
+					{
+						bounds.Grow(m_primitives[i].Min, m_primitives[i].Max);
+					}
+					primitiveEnd = first;
+				}
+				else
+				{
+					const auto& left = m_nodes[nodeIndex + 1];
+					const auto& right = m_nodes[left.Skip];
+					bounds.Grow(left.Min, left.Max);
+					bounds.Grow(right.Min, right.Max);
+				}
+
+				node.Min = bounds.Min;
+				node.Max = bounds.Max;
+				m_cost += bounds.SurfaceArea() * (isLeaf ? node.PrimitiveCount : 1);
+			}
+		}
+
+		bool Bvh::NeedsRebuild() const
+		{
+			return m_cost > m_buildCost * k_rebuildCostRatio;
+		}
+
+		void Bvh::Clear()
+		{
+			m_nodes.clear();
+			m_primitives.clear();
+			m_buildCost = 0.0f;
+			m_cost = 0.0f;
+		}
+
+		std::size_t Bvh::GetPrimitiveCount() const
+		{
+			return m_primitives.size();
+		}
+
+		BoundingBox Bvh::GetBounds() const
+		{
+			BoundingBox bounds({ 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f });
+			if (!m_nodes.empty())
+			{
+				BoundingBox::CreateFromPoints(bounds, XMLoadFloat3(&m_nodes[0].Min), XMLoadFloat3(&m_nodes[0].Max));
+			}
+			return bounds;
+		}
+
+		void Bvh::QueryFrustum(const std::array<XMVECTOR, 6>& planes, std::vector<std::uint32_t>& out) const
+		{
+			// Planes in SoA form, 4 per group. Padding plane (0, 0, 0, 1) accepts everything
+			const XMMATRIX groups[2] =
+			{
+				XMMatrixTranspose(XMMATRIX(planes[0], planes[1], planes[2], planes[3])),
+				XMMatrixTranspose(XMMATRIX(planes[4], planes[5], g_XMIdentityR3, g_XMIdentityR3))
+			};
+
+			XMMATRIX absGroups[2];
+			for (int g = 0; g < 2; ++g)
+			{
+				for (int r = 0; r < 3; ++r)
+				{
+					absGroups[g].r[r] = XMVectorAbs(groups[g].r[r]);
+				}
+			}
+
+			auto test = [&groups, &absGroups](FXMVECTOR min, FXMVECTOR max)
+			{
+				XMVECTOR center = XMVectorScale(XMVectorAdd(min, max), 0.5f);
+				XMVECTOR extents = XMVectorScale(XMVectorSubtract(max, min), 0.5f);
+
+				XMVECTOR centerX = XMVectorSplatX(center);
+				XMVECTOR centerY = XMVectorSplatY(center);
+				XMVECTOR centerZ = XMVectorSplatZ(center);
+				XMVECTOR extentsX = XMVectorSplatX(extents);
+				XMVECTOR extentsY = XMVectorSplatY(extents);
+				XMVECTOR extentsZ = XMVectorSplatZ(extents);
+
+				Overlap overlap = Overlap::Inside;
+				for (int g = 0; g < 2; ++g)
+				{
+					// Signed distance of the center and projected box radius for 4 planes at once
+					XMVECTOR distance = XMVectorMultiplyAdd(centerZ, groups[g].r[2], XMVectorMultiplyAdd(centerY, groups[g].r[1], XMVectorMultiplyAdd(centerX, groups[g].r[0], groups[g].r[3])));
+					XMVECTOR radius = XMVectorMultiplyAdd(extentsZ, absGroups[g].r[2], XMVectorMultiplyAdd(extentsY, absGroups[g].r[1], XMVectorMultiply(extentsX, absGroups[g].r[0])));
+
+					if (XMComparisonAnyTrue(XMVector4GreaterR(XMVectorNegate(radius), distance)))
+					{
+						return Overlap::Outside;
+					}
+
+					if (!XMVector4GreaterOrEqual(distance, radius))
+					{
+						overlap = Overlap::Intersects;
+					}
+				}
+
+				return overlap;
+			};
+
+			Traverse(test, [&out](std::uint32_t index) { out.push_back(index); });
+		}
+
+		void XM_CALLCONV Bvh::QuerySphere(FXMVECTOR center, float radius, std::vector<std::uint32_t>& out) const
+		{
+			const float radiusSq = radius * radius;
+
+			auto test = [center, radiusSq](FXMVECTOR min, FXMVECTOR max)
+			{
+				XMVECTOR toClosest = XMVectorSubtract(XMVectorClamp(center, min, max), center);
+				if (XMVectorGetX(XMVector3LengthSq(toClosest)) > radiusSq)
+				{
+					return Overlap::Outside;
+				}
+
+				XMVECTOR toFarthest = XMVectorMax(XMVectorAbs(XMVectorSubtract(min, center)), XMVectorAbs(XMVectorSubtract(max, center)));
+				return XMVectorGetX(XMVector3LengthSq(toFarthest)) <= radiusSq ? Overlap::Inside : Overlap::Intersects;
+			};
+
+			Traverse(test, [&out](std::uint32_t index) { out.push_back(index); });
+		}
+
+		void Bvh::QueryBox(const BoundingBox& box, std::vector<std::uint32_t>& out) const
+		{
+			XMFLOAT3 boxMin = BoxMin(box);
+			XMFLOAT3 boxMax = BoxMax(box);
+			XMVECTOR queryMin = XMLoadFloat3(&boxMin);
+			XMVECTOR queryMax = XMLoadFloat3(&boxMax);
+
+			auto test = [queryMin, queryMax](FXMVECTOR min, FXMVECTOR max)
+			{
+				if (!XMVector3LessOrEqual(min, queryMax) || !XMVector3LessOrEqual(queryMin, max))
+				{
+					return Overlap::Outside;
+				}
+
+				return XMVector3LessOrEqual(queryMin, min) && XMVector3LessOrEqual(max, queryMax) ? Overlap::Inside : Overlap::Intersects;
+			};
+
+			Traverse(test, [&out](std::uint32_t index) { out.push_back(index); });
+		}
+
+		bool XM_CALLCONV Bvh::Raycast(FXMVECTOR origin, FXMVECTOR direction, float maxDistance, std::uint32_t& outPrimitive, float& outDistance) const
+		{
+			const XMVECTOR invDirection = XMVectorReciprocal(direction);
+
+			float closestDistance = maxDistance;
+			float hitDistance = 0.0f;
+			bool isHit = false;
+
+			// Slab test, boxes behind the closest hit so far are skipped
+			auto test = [origin, invDirection, &closestDistance, &hitDistance](FXMVECTOR min, FXMVECTOR max)
+			{
+				XMVECTOR t1 = XMVectorMultiply(XMVectorSubtract(min, origin), invDirection);
+				XMVECTOR t2 = XMVectorMultiply(XMVectorSubtract(max, origin), invDirection);
+
+				XMFLOAT3 tNear;
+				XMFLOAT3 tFar;
+				XMStoreFloat3(&tNear, XMVectorMin(t1, t2));
+				XMStoreFloat3(&tFar, XMVectorMax(t1, t2));
+
+				float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+				float exit = std::min(std::min(tFar.x, tFar.y), tFar.z);
+
+				if (enter > exit || enter > closestDistance)
+				{
+					return Overlap::Outside;
+				}
+
+				hitDistance = enter;
+				return Overlap::Intersects;
+			};
+
+			// Called right after the primitive test that set hitDistance
+			auto visit = [&closestDistance, &hitDistance, &isHit, &outPrimitive](std::uint32_t index)
+			{
+				closestDistance = hitDistance;
+				outPrimitive = index;
+				isHit = true;
+			};
+
+			Traverse(test, visit);
+
+			if (isHit)
+			{
+				outDistance = closestDistance;
+			}
+
+			return isHit;
+		}
+	}
+}
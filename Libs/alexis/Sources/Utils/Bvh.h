@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+namespace alexis
+{
+	class JobSystem;
+
+	namespace utils
+	{
+		// Bounding volume hierarchy over axis-aligned boxes, built with binned SAH.
+		// Nodes are stored in depth-first order with skip links, so queries walk them without a stack
+		class Bvh
+		{
+		public:
+			// Rebuild over boxes, box i is reported as primitive i. Large subtrees are built as jobs if jobSystem is given
+			void Build(const DirectX::BoundingBox* boxes, std::size_t count, JobSystem* jobSystem = nullptr);
+
+			// Update bounds after primitives moved, boxes must hold as many entries as the last Build. Topology is kept
+			void Refit(const DirectX::BoundingBox* boxes);
+
+			// Refits made the tree noticeably worse than a fresh build would be
+			bool NeedsRebuild() const;
+
+			void Clear();
+			std::size_t GetPrimitiveCount() const;
+
+			// Box around all primitives, empty box at the origin if the tree is empty
+			DirectX::BoundingBox GetBounds() const;
+
+			// Queries append primitives whose boxes pass the test to out, in tree order.
+			// Frustum planes are normalized and point inside (see ViewData::FrustumPlanes)
+			void QueryFrustum(const std::array<DirectX::XMVECTOR, 6>& planes, std::vector<std::uint32_t>& out) const;
+			void XM_CALLCONV QuerySphere(DirectX::FXMVECTOR center, float radius, std::vector<std::uint32_t>& out) const;
+			void QueryBox(const DirectX::BoundingBox& box, std::vector<std::uint32_t>& out) const;
+
+			// Closest primitive box hit within maxDistance, direction must be normalized
+			bool XM_CALLCONV Raycast(DirectX::FXMVECTOR origin, DirectX::FXMVECTOR direction, float maxDistance, std::uint32_t& outPrimitive, float& outDistance) const;
+
+		private:
+			enum class Overlap
+			{
+				Outside,
+				Intersects,
+				Inside
+			};
+
+			// Leaf if Skip == own index + 1, its primitives follow the ones of all preceding leaves
+			struct Node
+			{
+				DirectX::XMFLOAT3 Min;
+				std::uint32_t Skip; // Next node once this subtree is done
+				DirectX::XMFLOAT3 Max;
+				std::uint32_t PrimitiveCount; // Whole subtree
+			};
+
+			struct Primitive
+			{
+				DirectX::XMFLOAT3 Min;
+				std::uint32_t Index;
+				DirectX::XMFLOAT3 Max;
+				std::uint32_t Padding;
+			};
+
+			template<class Test, class Visit>
+			void Traverse(Test&& test, Visit&& visit) const;
+
+			std::vector<Node> m_nodes;
+			std::vector<Primitive> m_primitives;
+
+			// Surface area heuristic cost after the last Build and the last Refit
+			float m_buildCost{ 0.0f };
+			float m_cost{ 0.0f };
+		};
+	}
+}
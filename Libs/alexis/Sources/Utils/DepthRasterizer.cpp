@@ -0,0 +1,252 @@
+#include <Precompiled.h>
+
+#include "DepthRasterizer.h"
+
+#include <cmath>
+
+#if !defined(_XM_NO_INTRINSICS_)
+#include <immintrin.h>
+#endif
+
+namespace alexis
+{
+	namespace utils
+	{
+		void DepthRasterizer::Resize(std::uint32_t width, std::uint32_t height)
+		{
+			assert(width % (4u << k_levelCount) == 0 && "Width must be a multiple of 4 * 2^k_levelCount");
+			assert(height % k_bandHeight == 0 && "Height must be a multiple of k_bandHeight");
+
+			m_width = width;
+			m_height = height;
+
+			for (std::uint32_t level = 0; level <= k_levelCount; ++level)
+			{
+				m_levels[level].assign((width >> level) * (height >> level), 1.0f);
+			}
+		}
+
+		std::uint32_t DepthRasterizer::GetWidth() const
+		{
+			return m_width;
+		}
+
+		std::uint32_t DepthRasterizer::GetHeight() const
+		{
+			return m_height;
+		}
+
+		std::uint32_t DepthRasterizer::GetBandCount() const
+		{
+			return m_height / k_bandHeight;
+		}
+
+		void DepthRasterizer::RasterizeBand(std::uint32_t band, const ScreenTriangle* triangles, std::size_t triangleCount)
+		{
+			std::uint32_t rowBegin = band * k_bandHeight;
+			std::uint32_t rowEnd = rowBegin + k_bandHeight;
+
+			std::fill(m_levels[0].begin() + rowBegin * m_width, m_levels[0].begin() + rowEnd * m_width, 1.0f);
+
+			for (std::size_t i = 0; i < triangleCount; ++i)
+			{
+				DrawTriangle(triangles[i], rowBegin, rowEnd);
+			}
+
+			BuildLevels(rowBegin, rowEnd);
+		}
+
+		void DepthRasterizer::DrawTriangle(const ScreenTriangle& triangle, std::uint32_t rowBegin, std::uint32_t rowEnd)
+		{
+			XMFLOAT3 v0 = triangle.Vertices[0];
+			XMFLOAT3 v1 = triangle.Vertices[1];
+			XMFLOAT3 v2 = triangle.Vertices[2];
+
+			// Both windings are drawn, flip to positive area
+			float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+			if (area == 0.0f)
+			{
+				return;
+			}
+			if (area < 0.0f)
+			{
+				std::swap(v1, v2);
+				area = -area;
+			}
+
+			// Pixels whose centers are covered, clipped to the band
+			float minX = std::min(std::min(v0.x, v1.x), v2.x);
+			float maxX = std::max(std::max(v0.x, v1.x), v2.x);
+			float minY = std::min(std::min(v0.y, v1.y), v2.y);
+			float maxY = std::max(std::max(v0.y, v1.y), v2.y);
+
+			int x0 = std::max(static_cast<int>(std::floor(minX - 0.5f)), 0) & ~3;
+			int x1 = std::min(static_cast<int>(std::ceil(maxX - 0.5f)), static_cast<int>(m_width) - 1);
+			int y0 = std::max(static_cast<int>(std::floor(minY - 0.5f)), static_cast<int>(rowBegin));
+			int y1 = std::min(static_cast<int>(std::ceil(maxY - 0.5f)), static_cast<int>(rowEnd) - 1);
+
+			if (x0 > x1 || y0 > y1)
+			{
+				return;
+			}
+
+			// Edge i is opposite to vertex i: e(x, y) = a * x + b * y + c, positive inside
+			const float edgeA[3] = { v1.y - v2.y, v2.y - v0.y, v0.y - v1.y };
+			const float edgeB[3] = { v2.x - v1.x, v0.x - v2.x, v1.x - v0.x };
+			const float edgeC[3] = { v1.x * v2.y - v2.x * v1.y, v2.x * v0.y - v0.x * v2.y, v0.x * v1.y - v1.x * v0.y };
+
+			// Depth plane from barycentrics: z = (e0 * z0 + e1 * z1 + e2 * z2) / area
+			float invArea = 1.0f / area;
+			float depthA = (edgeA[0] * v0.z + edgeA[1] * v1.z + edgeA[2] * v2.z) * invArea;
+			float depthB = (edgeB[0] * v0.z + edgeB[1] * v1.z + edgeB[2] * v2.z) * invArea;
+			float depthC = (edgeC[0] * v0.z + edgeC[1] * v1.z + edgeC[2] * v2.z) * invArea;
+
+			float* depth = m_levels[0].data();
+
+#if !defined(_XM_NO_INTRINSICS_)
+			const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+			const __m128 zero = _mm_setzero_ps();
+
+			__m128 stepA[3];
+			__m128 stepX[3];
+			for (int e = 0; e < 3; ++e)
+			{
+				stepA[e] = _mm_set1_ps(edgeA[e]);
+				stepX[e] = _mm_set1_ps(edgeA[e] * 4.0f);
+			}
+			const __m128 depthStepA = _mm_set1_ps(depthA);
+			const __m128 depthStepX = _mm_set1_ps(depthA * 4.0f);
+
+			for (int y = y0; y <= y1; ++y)
+			{
+				float centerY = y + 0.5f;
+				__m128 centerX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x0)), laneOffsets);
+
+				__m128 edges[3];
+				for (int e = 0; e < 3; ++e)
+				{
+					edges[e] = _mm_add_ps(_mm_mul_ps(stepA[e], centerX), _mm_set1_ps(edgeB[e] * centerY + edgeC[e]));
+				}
+				__m128 z = _mm_add_ps(_mm_mul_ps(depthStepA, centerX), _mm_set1_ps(depthB * centerY + depthC));
+
+				float* row = depth + y * m_width;
+				for (int x = x0; x <= x1; x += 4)
+				{
+					// No branch on coverage: along triangle edges it mispredicts, writing back uncovered pixels is cheaper
+					__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edges[0], zero), _mm_cmpge_ps(edges[1], zero)), _mm_cmpge_ps(edges[2], zero));
+					__m128 current = _mm_loadu_ps(row + x);
+					__m128 nearest = _mm_min_ps(current, z);
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+
+					for (int e = 0; e < 3; ++e)
+					{
+						edges[e] = _mm_add_ps(edges[e], stepX[e]);
+					}
+					z = _mm_add_ps(z, depthStepX);
+				}
+			}
+#else
+			for (int y = y0; y <= y1; ++y)
+			{
+				float centerY = y + 0.5f;
+				float* row = depth + y * m_width;
+				for (int x = x0; x <= x1; ++x)
+				{
+					float centerX = x + 0.5f;
+					bool isInside = true;
+					for (int e = 0; e < 3; ++e)
+					{
+						isInside &= edgeA[e] * centerX + edgeB[e] * centerY + edgeC[e] >= 0.0f;
+					}
+
+					if (isInside)
+					{
+						row[x] = std::min(row[x], depthA * centerX + depthB * centerY + depthC);
+					}
+				}
+			}
+#endif
+		}
+
+		void DepthRasterizer::BuildLevels(std::uint32_t rowBegin, std::uint32_t rowEnd)
+		{
+			for (std::uint32_t level = 1; level <= k_levelCount; ++level)
+			{
+				const std::uint32_t srcWidth = m_width >> (level - 1);
+				const std::uint32_t dstWidth = m_width >> level;
+
+				const float* src = m_levels[level - 1].data();
+				float* dst = m_levels[level].data();
+
+				for (std::uint32_t y = rowBegin >> level; y < rowEnd >> level; ++y)
+				{
+					const float* srcRow0 = src + (2 * y) * srcWidth;
+					const float* srcRow1 = srcRow0 + srcWidth;
+					float* dstRow = dst + y * dstWidth;
+
+#if !defined(_XM_NO_INTRINSICS_)
+					// Every level is a multiple of 4 texels wide (see Resize)
+					for (std::uint32_t x = 0; x < dstWidth; x += 4)
+					{
+						__m128 low = _mm_max_ps(_mm_loadu_ps(srcRow0 + 2 * x), _mm_loadu_ps(srcRow1 + 2 * x));
+						__m128 high = _mm_max_ps(_mm_loadu_ps(srcRow0 + 2 * x + 4), _mm_loadu_ps(srcRow1 + 2 * x + 4));
+						_mm_storeu_ps(dstRow + x, _mm_max_ps(_mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1))));
+					}
+#else
+					for (std::uint32_t x = 0; x < dstWidth; ++x)
+					{
+						dstRow[x] = std::max(std::max(srcRow0[2 * x], srcRow0[2 * x + 1]), std::max(srcRow1[2 * x], srcRow1[2 * x + 1]));
+					}
+#endif
+				}
+			}
+		}
+
+		bool DepthRasterizer::IsOccluded(float minX, float minY, float maxX, float maxY, float minDepth) const
+		{
+			if (m_width == 0)
+			{
+				return false;
+			}
+
+			int x0 = std::max(static_cast<int>(std::floor(minX)), 0);
+			int y0 = std::max(static_cast<int>(std::floor(minY)), 0);
+			int x1 = std::min(static_cast<int>(std::floor(maxX)), static_cast<int>(m_width) - 1);
+			int y1 = std::min(static_cast<int>(std::floor(maxY)), static_cast<int>(m_height) - 1);
+
+			if (x0 > x1 || y0 > y1)
+			{
+				// Off screen, frustum culling decides
+				return false;
+			}
+
+			// Coarsest level where the rectangle spans at most 4 texels per side
+			std::uint32_t level = 0;
+			while (level < k_levelCount && (((x1 - x0) >> level) > 3 || ((y1 - y0) >> level) > 3))
+			{
+				++level;
+			}
+
+			const std::uint32_t levelWidth = m_width >> level;
+			const float* texels = m_levels[level].data();
+
+			for (int y = y0 >> level; y <= y1 >> static_cast<int>(level); ++y)
+			{
+				for (int x = x0 >> level; x <= x1 >> static_cast<int>(level); ++x)
+				{
+					if (texels[y * levelWidth + x] >= minDepth)
+					{
+						return false;
+					}
+				}
+			}
+
+			return true;
+		}
+
+		const float* DepthRasterizer::GetDepth() const
+		{
+			return m_levels[0].data();
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace alexis
+{
+	namespace utils
+	{
+		// Screen space triangle: x, y in pixels, z is depth in [0, 1]
+		struct ScreenTriangle
+		{
+			DirectX::XMFLOAT3 Vertices[3];
+		};
+
+		// Low resolution depth buffer for CPU occlusion culling.
+		// Occluders are rasterized 4 pixels at a time, then a max-depth hierarchy answers rectangle queries.
+		// Work is split in horizontal bands of k_bandHeight rows that may be processed in parallel
+		class DepthRasterizer
+		{
+		public:
+			static constexpr std::uint32_t k_bandHeight = 16;
+
+			// Hierarchy levels above the full resolution one, a band holds whole texels of every level
+			static constexpr std::uint32_t k_levelCount = 4;
+
+			// width must be a multiple of 4 * 2^k_levelCount, height a multiple of k_bandHeight
+			void Resize(std::uint32_t width, std::uint32_t height);
+
+			std::uint32_t GetWidth() const;
+			std::uint32_t GetHeight() const;
+			std::uint32_t GetBandCount() const;
+
+			// Clears the band, draws triangles overlapping it and updates its part of the hierarchy
+			void RasterizeBand(std::uint32_t band, const ScreenTriangle* triangles, std::size_t triangleCount);
+
+			// True if a rectangle (pixels, inclusive) whose nearest point is at minDepth is behind everything drawn
+			bool IsOccluded(float minX, float minY, float maxX, float maxY, float minDepth) const;
+
+			// Full resolution depth, row-major
+			const float* GetDepth() const;
+
+		private:
+			void DrawTriangle(const ScreenTriangle& triangle, std::uint32_t rowBegin, std::uint32_t rowEnd);
+			void BuildLevels(std::uint32_t rowBegin, std::uint32_t rowEnd);
+
+			std::uint32_t m_width{ 0 };
+			std::uint32_t m_height{ 0 };
+
+			// [0] is the depth buffer, [i] holds the max of 2x2 texels of [i - 1]
+			std::array<std::vector<float>, k_levelCount + 1> m_levels;
+		};
+	}
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+namespace alexis
+{
+	namespace utils
+	{
+		// Draw lists are recorded in ranges, one command context each: ranges hold at least minDraws draws,
+		// there are at most maxRangeCount of them and they split the list evenly
+		inline std::size_t GetDrawRangeCount(std::size_t drawCount, std::size_t minDraws, std::size_t maxRangeCount)
+		{
+			return std::clamp<std::size_t>((drawCount + minDraws - 1) / minDraws, 1, maxRangeCount);
+		}
+
+		// First draw of range, range == rangeCount gives drawCount
+		inline std::size_t GetDrawRangeStart(std::size_t drawCount, std::size_t rangeCount, std::size_t range)
+		{
+			return drawCount * range / rangeCount;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include <Precompiled.h>
+
+#include "FrustumCulling.h"
+
+#if !defined(_XM_NO_INTRINSICS_)
+#include <immintrin.h>
+#endif
+
+namespace alexis
+{
+	namespace utils
+	{
+		namespace
+		{
+			// Every lane is written, only visible ones advance the cursor
+			inline void AppendVisible(int mask, std::size_t laneCount, std::size_t index, std::uint32_t* outVisible, std::size_t& visibleCount)
+			{
+				for (std::size_t lane = 0; lane < laneCount; ++lane)
+				{
+					outVisible[visibleCount] = static_cast<std::uint32_t>(index + lane);
+					visibleCount += (mask >> lane) & 1;
+				}
+			}
+		}
+
+		std::size_t CullSpheres(const SphereStreams& spheres, std::size_t begin, std::size_t end,
+			const std::array<XMVECTOR, k_frustumPlaneCount>& planes, std::uint32_t* outVisible)
+		{
+			XMFLOAT4 planeValues[k_frustumPlaneCount];
+			for (std::size_t p = 0; p < k_frustumPlaneCount; ++p)
+			{
+				XMStoreFloat4(&planeValues[p], planes[p]);
+			}
+
+			std::size_t visibleCount = 0;
+			std::size_t i = begin;
+
+			// Sphere is visible if signed distance >= -radius for all planes
+#if !defined(_XM_NO_INTRINSICS_)
+#if defined(__AVX2__)
+			__m256 planeLanes8[k_frustumPlaneCount][4];
+			for (std::size_t p = 0; p < k_frustumPlaneCount; ++p)
+			{
+				planeLanes8[p][0] = _mm256_set1_ps(planeValues[p].x);
+				planeLanes8[p][1] = _mm256_set1_ps(planeValues[p].y);
+				planeLanes8[p][2] = _mm256_set1_ps(planeValues[p].z);
+				planeLanes8[p][3] = _mm256_set1_ps(planeValues[p].w);
+			}
+
+			for (; i + 8 <= end; i += 8)
+			{
+				__m256 x = _mm256_loadu_ps(spheres.CenterX + i);
+				__m256 y = _mm256_loadu_ps(spheres.CenterY + i);
+				__m256 z = _mm256_loadu_ps(spheres.CenterZ + i);
+				__m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(spheres.Radius + i));
+
+				__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+				for (std::size_t p = 0; p < k_frustumPlaneCount; ++p)
+				{
+					__m256 distance = _mm256_add_ps(_mm256_mul_ps(x, planeLanes8[p][0]), _mm256_mul_ps(y, planeLanes8[p][1]));
+					distance = _mm256_add_ps(distance, _mm256_add_ps(_mm256_mul_ps(z, planeLanes8[p][2]), planeLanes8[p][3]));
+					inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+				}
+
+				AppendVisible(_mm256_movemask_ps(inside), 8, i, outVisible, visibleCount);
+			}
+#endif
+			__m128 planeLanes[k_frustumPlaneCount][4];
+			for (std::size_t p = 0; p < k_frustumPlaneCount; ++p)
+			{
+				planeLanes[p][0] = _mm_set1_ps(planeValues[p].x);
+				planeLanes[p][1] = _mm_set1_ps(planeValues[p].y);
+				planeLanes[p][2] = _mm_set1_ps(planeValues[p].z);
+				planeLanes[p][3] = _mm_set1_ps(planeValues[p].w);
+			}
+
+			for (; i + 4 <= end; i += 4)
+			{
+				__m128 x = _mm_loadu_ps(spheres.CenterX + i);
+				__m128 y = _mm_loadu_ps(spheres.CenterY + i);
+				__m128 z = _mm_loadu_ps(spheres.CenterZ + i);
+				__m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(spheres.Radius + i));
+
+				__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+				for (std::size_t p = 0; p < k_frustumPlaneCount; ++p)
+				{
+					__m128 distance = _mm_add_ps(_mm_mul_ps(x, planeLanes[p][0]), _mm_mul_ps(y, planeLanes[p][1]));
+					distance = _mm_add_ps(distance, _mm_add_ps(_mm_mul_ps(z, planeLanes[p][2]), planeLanes[p][3]));
+					inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+				}
+
+				AppendVisible(_mm_movemask_ps(inside), 4, i, outVisible, visibleCount);
+			}
+#endif
+
+			for (; i < end; ++i)
+			{
+				int isInside = 1;
+				for (std::size_t p = 0; p < k_frustumPlaneCount; ++p)
+				{
+					const auto& plane = planeValues[p];
+					float distance = spheres.CenterX[i] * plane.x + spheres.CenterY[i] * plane.y + spheres.CenterZ[i] * plane.z + plane.w;
+					isInside &= distance >= -spheres.Radius[i] ? 1 : 0;
+				}
+
+				AppendVisible(isInside, 1, i, outVisible, visibleCount);
+			}
+
+			return visibleCount;
+		}
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <DirectXMath.h>
+
+namespace alexis
+{
+	namespace utils
+	{
+		static constexpr std::size_t k_frustumPlaneCount = 6;
+
+		// Structure-of-arrays bounding spheres: one float per sphere in every stream
+		struct SphereStreams
+		{
+			const float* CenterX{ nullptr };
+			const float* CenterY{ nullptr };
+			const float* CenterZ{ nullptr };
+
+			const float* Radius{ nullptr };
+		};
+
+		// Tests spheres [begin, end) against the frustum, 8 (AVX2) or 4 (SSE) spheres per iteration.
+		// Planes are normalized and point inside (see ViewData::FrustumPlanes).
+		// Indices of intersecting spheres are written compacted to outVisible (room for end - begin entries), returns their count
+		std::size_t CullSpheres(const SphereStreams& spheres, std::size_t begin, std::size_t end,
+			const std::array<DirectX::XMVECTOR, k_frustumPlaneCount>& planes, std::uint32_t* outVisible);
+	}
+}
@@ -0,0 +1,487 @@
+#include <Precompiled.h>
+
+#include "LightClusters.h"
+
+#include <bit>
+#include <cmath>
+
+#include <Core/JobSystem.h>
+
+#if !defined(_XM_NO_INTRINSICS_)
+#include <immintrin.h>
+#endif
+
+namespace alexis
+{
+	namespace utils
+	{
+		namespace
+		{
+			// Lights per job when transforming and bounding
+			static constexpr std::size_t k_binBatchSize = 1024;
+
+			// Bits [0, count)
+			inline std::uint32_t LowBits(std::uint32_t count)
+			{
+				return static_cast<std::uint32_t>((std::uint64_t{ 1 } << count) - 1);
+			}
+
+			// Bit of tile i in a 32 bit lane, nothing for the boundary past the last tile
+			inline int TileBit(std::uint32_t tile)
+			{
+				return tile < 32 ? static_cast<int>(1u << tile) : 0;
+			}
+
+			void TransformSpheres(const XMFLOAT4X4& view, const SphereStreams& spheres, std::size_t begin, std::size_t end,
+				float* outX, float* outY, float* outZ, float* outRadius)
+			{
+				std::size_t i = begin;
+
+#if !defined(_XM_NO_INTRINSICS_)
+				__m128 m[4][3];
+				for (int row = 0; row < 4; ++row)
+				{
+					for (int column = 0; column < 3; ++column)
+					{
+						m[row][column] = _mm_set1_ps(view.m[row][column]);
+					}
+				}
+
+				for (; i + 4 <= end; i += 4)
+				{
+					__m128 x = _mm_loadu_ps(spheres.CenterX + i);
+					__m128 y = _mm_loadu_ps(spheres.CenterY + i);
+					__m128 z = _mm_loadu_ps(spheres.CenterZ + i);
+
+					for (int column = 0; column < 3; ++column)
+					{
+						__m128 value = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m[0][column]), _mm_mul_ps(y, m[1][column])),
+							_mm_add_ps(_mm_mul_ps(z, m[2][column]), m[3][column]));
+
+						float* out = column == 0 ? outX : column == 1 ? outY : outZ;
+						_mm_storeu_ps(out + i, value);
+					}
+
+					_mm_storeu_ps(outRadius + i, _mm_loadu_ps(spheres.Radius + i));
+				}
+#endif
+
+				for (; i < end; ++i)
+				{
+					float x = spheres.CenterX[i];
+					float y = spheres.CenterY[i];
+					float z = spheres.CenterZ[i];
+
+					outX[i] = x * view._11 + y * view._21 + z * view._31 + view._41;
+					outY[i] = x * view._12 + y * view._22 + z * view._32 + view._42;
+					outZ[i] = x * view._13 + y * view._23 + z * view._33 + view._43;
+					outRadius[i] = spheres.Radius[i];
+				}
+			}
+
+			// Cone in view space and its bounding sphere
+			LightCone XM_CALLCONV TransformCone(FXMMATRIX view, const LightCone& cone, XMFLOAT4& outSphere)
+			{
+				XMVECTOR apex = XMVector3Transform(XMLoadFloat3(&cone.Apex), view);
+				XMVECTOR direction = XMVector3TransformNormal(XMLoadFloat3(&cone.Direction), view);
+
+				LightCone result = cone;
+				XMStoreFloat3(&result.Apex, apex);
+				XMStoreFloat3(&result.Direction, direction);
+
+				// Wide cones are bounded by the sphere through the cap rim, narrow ones by the sphere through apex and rim
+				float sinAngle = std::sqrt(std::max(1.0f - cone.CosAngle * cone.CosAngle, 0.0f));
+				float centerDistance = cone.CosAngle < 0.70710678f ? cone.Range * cone.CosAngle : cone.Range / (2.0f * cone.CosAngle);
+				float radius = cone.CosAngle < 0.70710678f ? cone.Range * sinAngle : centerDistance;
+
+				XMStoreFloat4(&outSphere, XMVectorMultiplyAdd(direction, XMVectorReplicate(centerDistance), apex));
+				outSphere.w = radius;
+
+				return result;
+			}
+		}
+
+		void LightClusters::SetGrid(std::uint32_t tilesX, std::uint32_t tilesY, std::uint32_t slices, float nearZ, float farZ, float projScaleX, float projScaleY)
+		{
+			assert(tilesX > 0 && tilesX <= k_maxTiles && tilesY > 0 && tilesY <= k_maxTiles && "Tile count out of range");
+			assert(slices >= 2 && "Need at least one slice past nearZ");
+			assert(nearZ > 0.0f && nearZ < farZ && "Invalid depth range");
+
+			m_tilesX = tilesX;
+			m_tilesY = tilesY;
+			m_slices = slices;
+			m_nearZ = nearZ;
+			m_farZ = farZ;
+
+			// Slice 1 starts at nearZ, slice m_slices ends at farZ
+			m_sliceScale = (slices - 1) / std::log(farZ / nearZ);
+			m_sliceBias = 1.0f - std::log(nearZ) * m_sliceScale;
+
+			// Boundary i is at NDC u: x = u * z / projScaleX
+			m_columnPlaneX.resize(tilesX + 1);
+			m_columnPlaneZ.resize(tilesX + 1);
+			for (std::uint32_t i = 0; i <= tilesX; ++i)
+			{
+				float u = -1.0f + 2.0f * i / tilesX;
+				float invLength = 1.0f / std::sqrt(1.0f + (u / projScaleX) * (u / projScaleX));
+				m_columnPlaneX[i] = invLength;
+				m_columnPlaneZ[i] = -u / projScaleX * invLength;
+			}
+
+			// Rows go from the top, boundary i is at NDC v: y = v * z / projScaleY
+			m_rowPlaneY.resize(tilesY + 1);
+			m_rowPlaneZ.resize(tilesY + 1);
+			for (std::uint32_t i = 0; i <= tilesY; ++i)
+			{
+				float v = 1.0f - 2.0f * i / tilesY;
+				float invLength = 1.0f / std::sqrt(1.0f + (v / projScaleY) * (v / projScaleY));
+				m_rowPlaneY[i] = -invLength;
+				m_rowPlaneZ[i] = v / projScaleY * invLength;
+			}
+
+			m_clusterSpheres.resize(GetClusterCount());
+			for (std::uint32_t slice = 0; slice < slices; ++slice)
+			{
+				float depths[2] = { slice == 0 ? 0.0f : std::exp((slice - m_sliceBias) / m_sliceScale), slice + 1 == slices ? farZ : std::exp((slice + 1 - m_sliceBias) / m_sliceScale) };
+
+				for (std::uint32_t y = 0; y < tilesY; ++y)
+				{
+					float v[2] = { 1.0f - 2.0f * (y + 1) / tilesY, 1.0f - 2.0f * y / tilesY };
+
+					for (std::uint32_t x = 0; x < tilesX; ++x)
+					{
+						float u[2] = { -1.0f + 2.0f * x / tilesX, -1.0f + 2.0f * (x + 1) / tilesX };
+
+						XMVECTOR boxMin = g_XMFltMax;
+						XMVECTOR boxMax = XMVectorNegate(g_XMFltMax);
+						for (int corner = 0; corner < 8; ++corner)
+						{
+							float z = depths[corner >> 2];
+							XMVECTOR point = XMVectorSet(u[corner & 1] * z / projScaleX, v[(corner >> 1) & 1] * z / projScaleY, z, 0.0f);
+							boxMin = XMVectorMin(boxMin, point);
+							boxMax = XMVectorMax(boxMax, point);
+						}
+
+						auto& sphere = m_clusterSpheres[GetClusterIndex(x, y, slice)];
+						XMStoreFloat4(&sphere, XMVectorScale(XMVectorAdd(boxMin, boxMax), 0.5f));
+						sphere.w = 0.5f * XMVectorGetX(XMVector3Length(XMVectorSubtract(boxMax, boxMin)));
+					}
+				}
+			}
+		}
+
+		void XM_CALLCONV LightClusters::Bin(FXMMATRIX view, const SphereStreams& spheres, std::size_t sphereCount,
+			const LightCone* cones, std::size_t coneCount, JobSystem* jobSystem)
+		{
+			assert(m_slices > 0 && "SetGrid must be called before Bin");
+
+			const std::size_t lightCount = sphereCount + coneCount;
+			m_sphereCount = sphereCount;
+			m_viewX.resize(lightCount);
+			m_viewY.resize(lightCount);
+			m_viewZ.resize(lightCount);
+			m_viewRadius.resize(lightCount);
+			m_viewCones.resize(coneCount);
+			m_lightBounds.resize(lightCount);
+
+			XMFLOAT4X4 viewValues;
+			XMStoreFloat4x4(&viewValues, view);
+
+			auto forEachRange = [jobSystem](std::size_t count, std::size_t batchSize, auto&& func)
+			{
+				if (jobSystem)
+				{
+					jobSystem->ParallelFor(count, batchSize, func);
+				}
+				else
+				{
+					func(std::size_t{ 0 }, count);
+				}
+			};
+
+			// View space bounding spheres, then the tiles and slices they touch
+			forEachRange(lightCount, k_binBatchSize, [&](std::size_t begin, std::size_t end)
+			{
+				TransformSpheres(viewValues, spheres, begin, std::min(end, sphereCount), m_viewX.data(), m_viewY.data(), m_viewZ.data(), m_viewRadius.data());
+
+				for (std::size_t light = std::max(begin, sphereCount); light < end; ++light)
+				{
+					XMFLOAT4 sphere;
+					m_viewCones[light - sphereCount] = TransformCone(view, cones[light - sphereCount], sphere);
+					m_viewX[light] = sphere.x;
+					m_viewY[light] = sphere.y;
+					m_viewZ[light] = sphere.z;
+					m_viewRadius[light] = sphere.w;
+				}
+
+				ComputeBounds(m_viewX.data(), m_viewY.data(), m_viewZ.data(), m_viewRadius.data(), begin, end, m_lightBounds.data());
+			});
+
+			// Lights touching each slice, in light order
+			const std::uint32_t lightCount32 = static_cast<std::uint32_t>(lightCount);
+
+			m_sliceLightOffsets.assign(m_slices + 1, 0);
+			for (const auto& bounds : m_lightBounds)
+			{
+				for (std::uint32_t slice = bounds.FirstSlice; slice <= bounds.LastSlice; ++slice)
+				{
+					++m_sliceLightOffsets[slice + 1];
+				}
+			}
+
+			for (std::uint32_t slice = 0; slice < m_slices; ++slice)
+			{
+				m_sliceLightOffsets[slice + 1] += m_sliceLightOffsets[slice];
+			}
+
+			m_sliceLights.resize(m_sliceLightOffsets[m_slices]);
+			std::vector<std::uint32_t> sliceCursors(m_sliceLightOffsets.begin(), m_sliceLightOffsets.end() - 1);
+			for (std::uint32_t light = 0; light < lightCount32; ++light)
+			{
+				const auto& bounds = m_lightBounds[light];
+				for (std::uint32_t slice = bounds.FirstSlice; slice <= bounds.LastSlice; ++slice)
+				{
+					m_sliceLights[sliceCursors[slice]++] = light;
+				}
+			}
+
+			// Count, allocate and fill lists. Every slice job owns the clusters of its slice
+			m_clusters.resize(GetClusterCount());
+
+			forEachRange(m_slices, 1, [this](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t slice = begin; slice < end; ++slice)
+				{
+					auto sliceBegin = m_clusters.begin() + slice * m_tilesX * m_tilesY;
+					std::fill(sliceBegin, sliceBegin + m_tilesX * m_tilesY, Cluster{ 0, 0 });
+
+					ForEachLightInSlice(static_cast<std::uint32_t>(slice), [this](std::uint32_t, std::uint32_t cluster)
+					{
+						++m_clusters[cluster].Count;
+					});
+				}
+			});
+
+			std::uint32_t offset = 0;
+			for (auto& cluster : m_clusters)
+			{
+				cluster.Offset = offset;
+				offset += cluster.Count;
+				cluster.Count = 0;
+			}
+
+			m_lightIndices.resize(offset);
+
+			forEachRange(m_slices, 1, [this](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t slice = begin; slice < end; ++slice)
+				{
+					ForEachLightInSlice(static_cast<std::uint32_t>(slice), [this](std::uint32_t light, std::uint32_t cluster)
+					{
+						auto& target = m_clusters[cluster];
+						m_lightIndices[target.Offset + target.Count++] = light;
+					});
+				}
+			});
+		}
+
+		template<class Visit>
+		void LightClusters::ForEachLightInSlice(std::uint32_t slice, Visit&& visit) const
+		{
+			for (std::uint32_t entry = m_sliceLightOffsets[slice]; entry < m_sliceLightOffsets[slice + 1]; ++entry)
+			{
+				const std::uint32_t light = m_sliceLights[entry];
+				const auto& bounds = m_lightBounds[light];
+
+				const LightCone* cone = light >= m_sphereCount ? &m_viewCones[light - m_sphereCount] : nullptr;
+
+				for (std::uint32_t rows = bounds.RowMask; rows != 0; rows &= rows - 1)
+				{
+					std::uint32_t y = std::countr_zero(rows);
+
+					for (std::uint32_t columns = bounds.ColumnMask; columns != 0; columns &= columns - 1)
+					{
+						std::uint32_t cluster = GetClusterIndex(std::countr_zero(columns), y, slice);
+						if (cone && IsConeOutside(*cone, cluster))
+						{
+							continue;
+						}
+
+						visit(light, cluster);
+					}
+				}
+			}
+		}
+
+		void LightClusters::ComputeBounds(const float* viewX, const float* viewY, const float* viewZ, const float* radius,
+			std::size_t begin, std::size_t end, LightBounds* bounds) const
+		{
+			std::size_t i = begin;
+
+			// 4 lights against one boundary plane at a time. Column/row i is touched if the light reaches past boundary i
+			// and does not lie wholly past boundary i + 1, bit i of both masks is accumulated in the light's lane
+#if !defined(_XM_NO_INTRINSICS_)
+			for (; i + 4 <= end; i += 4)
+			{
+				__m128 x = _mm_loadu_ps(viewX + i);
+				__m128 y = _mm_loadu_ps(viewY + i);
+				__m128 z = _mm_loadu_ps(viewZ + i);
+				__m128 r = _mm_loadu_ps(radius + i);
+				__m128 negR = _mm_sub_ps(_mm_setzero_ps(), r);
+
+				__m128i columnMasks = _mm_setzero_si128();
+				__m128i columnBefore = _mm_setzero_si128();
+				for (std::uint32_t plane = 0; plane <= m_tilesX; ++plane)
+				{
+					__m128 distance = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(m_columnPlaneX[plane])), _mm_mul_ps(z, _mm_set1_ps(m_columnPlaneZ[plane])));
+					__m128i after = _mm_castps_si128(_mm_cmpge_ps(distance, negR));
+					__m128i before = _mm_castps_si128(_mm_cmple_ps(distance, r));
+
+					columnMasks = _mm_or_si128(columnMasks, _mm_and_si128(after, _mm_set1_epi32(TileBit(plane))));
+					columnBefore = _mm_or_si128(columnBefore, _mm_and_si128(before, _mm_set1_epi32(plane > 0 ? TileBit(plane - 1) : 0)));
+				}
+
+				__m128i rowMasks = _mm_setzero_si128();
+				__m128i rowBefore = _mm_setzero_si128();
+				for (std::uint32_t plane = 0; plane <= m_tilesY; ++plane)
+				{
+					__m128 distance = _mm_add_ps(_mm_mul_ps(y, _mm_set1_ps(m_rowPlaneY[plane])), _mm_mul_ps(z, _mm_set1_ps(m_rowPlaneZ[plane])));
+					__m128i after = _mm_castps_si128(_mm_cmpge_ps(distance, negR));
+					__m128i before = _mm_castps_si128(_mm_cmple_ps(distance, r));
+
+					rowMasks = _mm_or_si128(rowMasks, _mm_and_si128(after, _mm_set1_epi32(TileBit(plane))));
+					rowBefore = _mm_or_si128(rowBefore, _mm_and_si128(before, _mm_set1_epi32(plane > 0 ? TileBit(plane - 1) : 0)));
+				}
+
+				alignas(16) std::uint32_t columnValues[4];
+				alignas(16) std::uint32_t rowValues[4];
+				alignas(16) float zValues[4];
+				alignas(16) float rValues[4];
+				_mm_store_si128(reinterpret_cast<__m128i*>(columnValues), _mm_and_si128(columnMasks, columnBefore));
+				_mm_store_si128(reinterpret_cast<__m128i*>(rowValues), _mm_and_si128(rowMasks, rowBefore));
+				_mm_store_ps(zValues, z);
+				_mm_store_ps(rValues, r);
+
+				for (int lane = 0; lane < 4; ++lane)
+				{
+					bounds[i + lane] = MakeBounds(columnValues[lane], rowValues[lane], zValues[lane], rValues[lane]);
+				}
+			}
+#endif
+
+			for (; i < end; ++i)
+			{
+				bounds[i] = ComputeBounds(viewX[i], viewY[i], viewZ[i], radius[i]);
+			}
+		}
+
+		LightClusters::LightBounds LightClusters::ComputeBounds(float x, float y, float z, float radius) const
+		{
+			std::uint32_t columnMask = 0;
+			for (std::uint32_t column = 0; column < m_tilesX; ++column)
+			{
+				float first = x * m_columnPlaneX[column] + z * m_columnPlaneZ[column];
+				float second = x * m_columnPlaneX[column + 1] + z * m_columnPlaneZ[column + 1];
+				columnMask |= static_cast<std::uint32_t>(first >= -radius && second <= radius) << column;
+			}
+
+			std::uint32_t rowMask = 0;
+			for (std::uint32_t row = 0; row < m_tilesY; ++row)
+			{
+				float first = y * m_rowPlaneY[row] + z * m_rowPlaneZ[row];
+				float second = y * m_rowPlaneY[row + 1] + z * m_rowPlaneZ[row + 1];
+				rowMask |= static_cast<std::uint32_t>(first >= -radius && second <= radius) << row;
+			}
+
+			return MakeBounds(columnMask, rowMask, z, radius);
+		}
+
+		LightClusters::LightBounds LightClusters::MakeBounds(std::uint32_t columnMask, std::uint32_t rowMask, float z, float radius) const
+		{
+			columnMask &= LowBits(m_tilesX);
+			rowMask &= LowBits(m_tilesY);
+
+			// Behind the eye, past the far plane or off screen
+			if (z + radius < 0.0f || z - radius > m_farZ || columnMask == 0 || rowMask == 0)
+			{
+				return { 0, 0, 1, 0 };
+			}
+
+			return { columnMask, rowMask, GetSlice(z - radius), GetSlice(z + radius) };
+		}
+
+		bool LightClusters::IsConeOutside(const LightCone& cone, std::uint32_t cluster) const
+		{
+			// Sphere vs cone: outside if past the angle, beyond the range or behind the apex
+			const auto& sphere = m_clusterSpheres[cluster];
+
+			float toSphereX = sphere.x - cone.Apex.x;
+			float toSphereY = sphere.y - cone.Apex.y;
+			float toSphereZ = sphere.z - cone.Apex.z;
+
+			float lengthSq = toSphereX * toSphereX + toSphereY * toSphereY + toSphereZ * toSphereZ;
+			float alongAxis = toSphereX * cone.Direction.x + toSphereY * cone.Direction.y + toSphereZ * cone.Direction.z;
+
+			float sinAngle = std::sqrt(std::max(1.0f - cone.CosAngle * cone.CosAngle, 0.0f));
+			float closestDistance = cone.CosAngle * std::sqrt(std::max(lengthSq - alongAxis * alongAxis, 0.0f)) - alongAxis * sinAngle;
+
+			return closestDistance > sphere.w || alongAxis > sphere.w + cone.Range || alongAxis < -sphere.w;
+		}
+
+		std::uint32_t LightClusters::GetTilesX() const
+		{
+			return m_tilesX;
+		}
+
+		std::uint32_t LightClusters::GetTilesY() const
+		{
+			return m_tilesY;
+		}
+
+		std::uint32_t LightClusters::GetSliceCount() const
+		{
+			return m_slices;
+		}
+
+		std::uint32_t LightClusters::GetClusterCount() const
+		{
+			return m_tilesX * m_tilesY * m_slices;
+		}
+
+		std::uint32_t LightClusters::GetClusterIndex(std::uint32_t x, std::uint32_t y, std::uint32_t slice) const
+		{
+			return (slice * m_tilesY + y) * m_tilesX + x;
+		}
+
+		float LightClusters::GetSliceScale() const
+		{
+			return m_sliceScale;
+		}
+
+		float LightClusters::GetSliceBias() const
+		{
+			return m_sliceBias;
+		}
+
+		std::uint32_t LightClusters::GetSlice(float viewZ) const
+		{
+			if (viewZ <= m_nearZ)
+			{
+				return 0;
+			}
+
+			float slice = std::floor(std::log(viewZ) * m_sliceScale + m_sliceBias);
+			return std::min(static_cast<std::uint32_t>(std::max(slice, 0.0f)), m_slices - 1);
+		}
+
+		const std::vector<LightClusters::Cluster>& LightClusters::GetClusters() const
+		{
+			return m_clusters;
+		}
+
+		const std::vector<std::uint32_t>& LightClusters::GetLightIndices() const
+		{
+			return m_lightIndices;
+		}
+	}
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+
+#include <Utils/FrustumCulling.h>
+
+namespace alexis
+{
+	class JobSystem;
+
+	namespace utils
+	{
+		// Spot light volume, world space
+		struct LightCone
+		{
+			DirectX::XMFLOAT3 Apex;
+			float Range;
+			DirectX::XMFLOAT3 Direction; // Normalized
+			float CosAngle; // Cosine of the half angle
+		};
+
+		// Clustered light assignment: the view frustum is split in TilesX x TilesY screen tiles and exponential depth slices,
+		// every cluster gets the list of lights whose bounds touch it. Lists of all clusters are packed in one index array
+		class LightClusters
+		{
+		public:
+			// Tile masks are 32 bit
+			static constexpr std::uint32_t k_maxTiles = 32;
+
+			struct Cluster
+			{
+				std::uint32_t Offset; // First entry in GetLightIndices()
+				std::uint32_t Count;
+			};
+
+			// Rebuild the grid for a perspective projection, projScaleX and projScaleY are Proj._11 and Proj._22.
+			// Slice 0 covers view depths [0, nearZ], the rest split [nearZ, farZ] exponentially
+			void SetGrid(std::uint32_t tilesX, std::uint32_t tilesY, std::uint32_t slices, float nearZ, float farZ, float projScaleX, float projScaleY);
+
+			// Assign lights to clusters. Sphere i gets light index i, cone i gets light index sphereCount + i.
+			// Lists are sorted by light index. Work is split by depth slice if jobSystem is given
+			void XM_CALLCONV Bin(DirectX::FXMMATRIX view, const SphereStreams& spheres, std::size_t sphereCount,
+				const LightCone* cones, std::size_t coneCount, JobSystem* jobSystem = nullptr);
+
+			std::uint32_t GetTilesX() const;
+			std::uint32_t GetTilesY() const;
+			std::uint32_t GetSliceCount() const;
+			std::uint32_t GetClusterCount() const;
+
+			// Tile x from the left, y from the top of the screen
+			std::uint32_t GetClusterIndex(std::uint32_t x, std::uint32_t y, std::uint32_t slice) const;
+
+			// slice = max(log(viewZ) * scale + bias, 0), for shaders
+			float GetSliceScale() const;
+			float GetSliceBias() const;
+			std::uint32_t GetSlice(float viewZ) const;
+
+			const std::vector<Cluster>& GetClusters() const;
+			const std::vector<std::uint32_t>& GetLightIndices() const;
+
+		private:
+			// Tiles and slices a light touches, no slices if FirstSlice > LastSlice
+			struct LightBounds
+			{
+				std::uint32_t ColumnMask;
+				std::uint32_t RowMask;
+				std::uint32_t FirstSlice;
+				std::uint32_t LastSlice;
+			};
+
+			void ComputeBounds(const float* viewX, const float* viewY, const float* viewZ, const float* radius,
+				std::size_t begin, std::size_t end, LightBounds* bounds) const;
+			LightBounds ComputeBounds(float x, float y, float z, float radius) const;
+			LightBounds MakeBounds(std::uint32_t columnMask, std::uint32_t rowMask, float z, float radius) const;
+
+			bool IsConeOutside(const LightCone& cone, std::uint32_t cluster) const;
+
+			// visit(light, cluster) for every cluster of the slice touched by a light, in light order
+			template<class Visit>
+			void ForEachLightInSlice(std::uint32_t slice, Visit&& visit) const;
+
+			std::uint32_t m_tilesX{ 0 };
+			std::uint32_t m_tilesY{ 0 };
+			std::uint32_t m_slices{ 0 };
+			float m_sliceScale{ 0.0f };
+			float m_sliceBias{ 0.0f };
+			float m_nearZ{ 0.0f };
+			float m_farZ{ 0.0f };
+
+			// Tile boundary planes through the eye, view space. Column/row i lies between boundaries i and i + 1,
+			// distance to boundary i is positive on the side of column/row i
+			std::vector<float> m_columnPlaneX;
+			std::vector<float> m_columnPlaneZ;
+			std::vector<float> m_rowPlaneY;
+			std::vector<float> m_rowPlaneZ;
+
+			// View space bounding spheres of clusters, for cones
+			std::vector<DirectX::XMFLOAT4> m_clusterSpheres;
+
+			// Per frame, lights [0, m_sphereCount) are spheres, the rest are cones
+			std::size_t m_sphereCount{ 0 };
+			std::vector<float> m_viewX;
+			std::vector<float> m_viewY;
+			std::vector<float> m_viewZ;
+			std::vector<float> m_viewRadius;
+			std::vector<LightCone> m_viewCones;
+			std::vector<LightBounds> m_lightBounds;
+
+			// Lights of slice i are m_sliceLights[m_sliceLightOffsets[i], m_sliceLightOffsets[i + 1])
+			std::vector<std::uint32_t> m_sliceLightOffsets;
+			std::vector<std::uint32_t> m_sliceLights;
+
+			std::vector<Cluster> m_clusters;
+			std::vector<std::uint32_t> m_lightIndices;
+		};
+	}
+}
@@ -0,0 +1,237 @@
+#include <Precompiled.h>
+
+#include "MatrixBatch.h"
+
+#if !defined(_XM_NO_INTRINSICS_)
+#include <immintrin.h>
+#endif
+
+namespace alexis
+{
+	namespace utils
+	{
+		namespace
+		{
+			enum StreamIndex
+			{
+				PositionX,
+				PositionY,
+				PositionZ,
+				RotationX,
+				RotationY,
+				RotationZ,
+				RotationW,
+				Scale,
+			};
+
+			inline XMMATRIX& MatrixAt(XMMATRIX* base, std::size_t stride, std::size_t index)
+			{
+				return *reinterpret_cast<XMMATRIX*>(reinterpret_cast<std::uint8_t*>(base) + index * stride);
+			}
+
+			void WorldMatricesScalar(const TransformStreams& transforms, std::size_t begin, std::size_t end, XMMATRIX* outWorld, std::size_t outStride)
+			{
+				for (std::size_t i = begin; i < end; ++i)
+				{
+					float x = transforms.RotationX[i];
+					float y = transforms.RotationY[i];
+					float z = transforms.RotationZ[i];
+					float w = transforms.RotationW[i];
+					float s = transforms.Scale[i];
+
+					float x2 = x + x;
+					float y2 = y + y;
+					float z2 = z + z;
+
+					float xx = x * x2;
+					float yy = y * y2;
+					float zz = z * z2;
+					float xy = x * y2;
+					float xz = x * z2;
+					float yz = y * z2;
+					float wx = w * x2;
+					float wy = w * y2;
+					float wz = w * z2;
+
+					XMFLOAT4X4 world(
+						s * (1.0f - yy - zz), s * (xy + wz), s * (xz - wy), 0.0f,
+						s * (xy - wz), s * (1.0f - xx - zz), s * (yz + wx), 0.0f,
+						s * (xz + wy), s * (yz - wx), s * (1.0f - xx - yy), 0.0f,
+						transforms.PositionX[i], transforms.PositionY[i], transforms.PositionZ[i], 1.0f);
+
+					MatrixAt(outWorld, outStride, i) = XMLoadFloat4x4(&world);
+				}
+			}
+
+#if !defined(_XM_NO_INTRINSICS_)
+			// Same math for 4 and 8 lanes, only the load/arithmetic helpers differ
+			inline __m128 Load(const float* src) { return _mm_loadu_ps(src); }
+			inline __m128 Add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+			inline __m128 Sub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+			inline __m128 Mul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+			inline void Splat(float value, __m128& out) { out = _mm_set1_ps(value); }
+
+#if defined(__AVX2__)
+			inline __m256 Load8(const float* src) { return _mm256_loadu_ps(src); }
+			inline __m256 Add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+			inline __m256 Sub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+			inline __m256 Mul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+			inline void Splat(float value, __m256& out) { out = _mm256_set1_ps(value); }
+#endif
+
+			// rows[r][c] holds element (r, c) of every lane's world matrix
+			template<class V, class LoadFunc>
+			inline void ComputeWorldLanes(const TransformStreams& transforms, std::size_t i, LoadFunc load, V (&rows)[4][4])
+			{
+				V zero;
+				V one;
+				Splat(0.0f, zero);
+				Splat(1.0f, one);
+
+				V x = load(transforms.RotationX + i);
+				V y = load(transforms.RotationY + i);
+				V z = load(transforms.RotationZ + i);
+				V w = load(transforms.RotationW + i);
+				V s = load(transforms.Scale + i);
+
+				V x2 = Add(x, x);
+				V y2 = Add(y, y);
+				V z2 = Add(z, z);
+
+				V xx = Mul(x, x2);
+				V yy = Mul(y, y2);
+				V zz = Mul(z, z2);
+				V xy = Mul(x, y2);
+				V xz = Mul(x, z2);
+				V yz = Mul(y, z2);
+				V wx = Mul(w, x2);
+				V wy = Mul(w, y2);
+				V wz = Mul(w, z2);
+
+				rows[0][0] = Mul(s, Sub(one, Add(yy, zz)));
+				rows[0][1] = Mul(s, Add(xy, wz));
+				rows[0][2] = Mul(s, Sub(xz, wy));
+				rows[0][3] = zero;
+
+				rows[1][0] = Mul(s, Sub(xy, wz));
+				rows[1][1] = Mul(s, Sub(one, Add(xx, zz)));
+				rows[1][2] = Mul(s, Add(yz, wx));
+				rows[1][3] = zero;
+
+				rows[2][0] = Mul(s, Add(xz, wy));
+				rows[2][1] = Mul(s, Sub(yz, wx));
+				rows[2][2] = Mul(s, Sub(one, Add(xx, yy)));
+				rows[2][3] = zero;
+
+				rows[3][0] = load(transforms.PositionX + i);
+				rows[3][1] = load(transforms.PositionY + i);
+				rows[3][2] = load(transforms.PositionZ + i);
+				rows[3][3] = one;
+			}
+
+			// SoA -> AoS: writes 4 consecutive matrices starting at index
+			inline void StoreLanes(__m128 (&rows)[4][4], XMMATRIX* outWorld, std::size_t outStride, std::size_t index)
+			{
+				for (std::size_t r = 0; r < 4; ++r)
+				{
+					_MM_TRANSPOSE4_PS(rows[r][0], rows[r][1], rows[r][2], rows[r][3]);
+					for (std::size_t lane = 0; lane < 4; ++lane)
+					{
+						MatrixAt(outWorld, outStride, index + lane).r[r] = rows[r][lane];
+					}
+				}
+			}
+#endif
+		}
+
+		void TransformBatch::Clear()
+		{
+			for (auto& stream : m_streams)
+			{
+				stream.clear();
+			}
+		}
+
+		void TransformBatch::Reserve(std::size_t count)
+		{
+			for (auto& stream : m_streams)
+			{
+				stream.reserve(count);
+			}
+		}
+
+		void XM_CALLCONV TransformBatch::Add(FXMVECTOR position, FXMVECTOR rotation, float scale)
+		{
+			XMFLOAT3 p;
+			XMFLOAT4 q;
+			XMStoreFloat3(&p, position);
+			XMStoreFloat4(&q, rotation);
+
+			m_streams[PositionX].push_back(p.x);
+			m_streams[PositionY].push_back(p.y);
+			m_streams[PositionZ].push_back(p.z);
+			m_streams[RotationX].push_back(q.x);
+			m_streams[RotationY].push_back(q.y);
+			m_streams[RotationZ].push_back(q.z);
+			m_streams[RotationW].push_back(q.w);
+			m_streams[Scale].push_back(scale);
+		}
+
+		std::size_t TransformBatch::Size() const
+		{
+			return m_streams[Scale].size();
+		}
+
+		TransformStreams TransformBatch::GetStreams() const
+		{
+			TransformStreams streams;
+			streams.PositionX = m_streams[PositionX].data();
+			streams.PositionY = m_streams[PositionY].data();
+			streams.PositionZ = m_streams[PositionZ].data();
+			streams.RotationX = m_streams[RotationX].data();
+			streams.RotationY = m_streams[RotationY].data();
+			streams.RotationZ = m_streams[RotationZ].data();
+			streams.RotationW = m_streams[RotationW].data();
+			streams.Scale = m_streams[Scale].data();
+			return streams;
+		}
+
+		void BatchWorldMatrices(const TransformStreams& transforms, std::size_t count, XMMATRIX* outWorld, std::size_t outStride)
+		{
+			std::size_t i = 0;
+
+#if !defined(_XM_NO_INTRINSICS_)
+#if defined(__AVX2__)
+			for (; i + 8 <= count; i += 8)
+			{
+				__m256 rows[4][4];
+				ComputeWorldLanes(transforms, i, Load8, rows);
+
+				// Lanes 0-3 and 4-7 are transposed separately
+				__m128 low[4][4];
+				__m128 high[4][4];
+				for (std::size_t r = 0; r < 4; ++r)
+				{
+					for (std::size_t c = 0; c < 4; ++c)
+					{
+						low[r][c] = _mm256_castps256_ps128(rows[r][c]);
+						high[r][c] = _mm256_extractf128_ps(rows[r][c], 1);
+					}
+				}
+
+				StoreLanes(low, outWorld, outStride, i);
+				StoreLanes(high, outWorld, outStride, i + 4);
+			}
+#endif
+			for (; i + 4 <= count; i += 4)
+			{
+				__m128 rows[4][4];
+				ComputeWorldLanes(transforms, i, Load, rows);
+				StoreLanes(rows, outWorld, outStride, i);
+			}
+#endif
+
+			WorldMatricesScalar(transforms, i, count, outWorld, outStride);
+		}
+	}
+}
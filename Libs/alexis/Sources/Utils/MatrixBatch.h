@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace alexis
+{
+	namespace utils
+	{
+		// Structure-of-arrays transform input: one float per transform in every stream
+		struct TransformStreams
+		{
+			const float* PositionX{ nullptr };
+			const float* PositionY{ nullptr };
+			const float* PositionZ{ nullptr };
+
+			const float* RotationX{ nullptr };
+			const float* RotationY{ nullptr };
+			const float* RotationZ{ nullptr };
+			const float* RotationW{ nullptr };
+
+			const float* Scale{ nullptr };
+		};
+
+		// Gathers AoS transforms into SoA streams for the batch kernels
+		class TransformBatch
+		{
+		public:
+			void Clear();
+			void Reserve(std::size_t count);
+			void XM_CALLCONV Add(DirectX::FXMVECTOR position, DirectX::FXMVECTOR rotation, float scale);
+
+			std::size_t Size() const;
+			TransformStreams GetStreams() const;
+
+		private:
+			std::array<std::vector<float>, 8> m_streams;
+		};
+
+		// world[i] = Scaling(scale[i]) * RotationQuaternion(rotation[i]) * Translation(position[i])
+		// Processes 8 (AVX2) or 4 (SSE) entries per iteration, tail and _XM_NO_INTRINSICS_ builds go scalar.
+		// Stride is in bytes, as in XMVector3TransformStream, so matrices may live inside components
+		void BatchWorldMatrices(const TransformStreams& transforms, std::size_t count, DirectX::XMMATRIX* outWorld, std::size_t outStride);
+	}
+}
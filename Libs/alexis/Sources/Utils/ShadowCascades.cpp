@@ -0,0 +1,86 @@
+#include <Precompiled.h>
+
+#include "ShadowCascades.h"
+
+#include <cmath>
+
+namespace alexis
+{
+	namespace utils
+	{
+		namespace
+		{
+			// Sphere radius is rounded up to this step, so small FOV or split changes do not resize texels every frame
+			static constexpr float k_radiusStep = 1.0f / 16.0f;
+		}
+
+		void ComputeCascadeSplits(float nearZ, float farZ, float lambda, std::size_t cascadeCount, float* outSplits)
+		{
+			assert(nearZ > 0.0f && nearZ < farZ && "Invalid depth range");
+			assert(cascadeCount > 0 && "No cascades");
+
+			outSplits[0] = nearZ;
+			for (std::size_t i = 1; i < cascadeCount; ++i)
+			{
+				float fraction = static_cast<float>(i) / cascadeCount;
+				float logSplit = nearZ * std::pow(farZ / nearZ, fraction);
+				float uniformSplit = nearZ + (farZ - nearZ) * fraction;
+
+				outSplits[i] = lambda * logSplit + (1.0f - lambda) * uniformSplit;
+			}
+			outSplits[cascadeCount] = farZ;
+		}
+
+		CascadeProjection XM_CALLCONV FitCascade(FXMVECTOR lightDirection, FXMMATRIX cameraInvView, float projScaleX, float projScaleY,
+			float splitNear, float splitFar, std::uint32_t resolution, const BoundingBox& casterBounds, std::uint32_t snapTexels)
+		{
+			assert(snapTexels > 0 && 2 * snapTexels < resolution && "Snap step does not fit the resolution");
+
+			// Smallest sphere around the slice, centered on the view axis. Corners are at distance k * z from the axis
+			float kSq = 1.0f / (projScaleX * projScaleX) + 1.0f / (projScaleY * projScaleY);
+			float centerZ = std::min(0.5f * (splitNear + splitFar) * (1.0f + kSq), splitFar);
+			float radius = std::sqrt((splitFar - centerZ) * (splitFar - centerZ) + splitFar * splitFar * kSq);
+			radius = std::ceil(radius / k_radiusStep) * k_radiusStep;
+
+			XMVECTOR center = XMVector3Transform(XMVectorSet(0.0f, 0.0f, centerZ, 1.0f), cameraInvView);
+
+			// Light space is fixed for a direction, only the projection follows the camera
+			XMVECTOR up = std::fabs(XMVectorGetY(lightDirection)) > 0.99f ? g_XMIdentityR2 : g_XMIdentityR1;
+			XMMATRIX lightView = XMMatrixLookToLH(g_XMZero, lightDirection, up);
+
+			XMFLOAT3 lightCenter;
+			XMStoreFloat3(&lightCenter, XMVector3Transform(center, lightView));
+
+			// Snapping moves the center by up to a step, one step of margin per side keeps the sphere inside
+			float texelSize = 2.0f * radius / (resolution - 2 * snapTexels);
+			float snapStep = snapTexels * texelSize;
+			float halfExtent = radius + snapStep;
+			lightCenter.x = std::floor(lightCenter.x / snapStep) * snapStep;
+			lightCenter.y = std::floor(lightCenter.y / snapStep) * snapStep;
+
+			// Casters between the light and the slice must land in the map
+			XMFLOAT3 corners[BoundingBox::CORNER_COUNT];
+			casterBounds.GetCorners(corners);
+
+			float nearZ = lightCenter.z - radius;
+			for (const auto& corner : corners)
+			{
+				nearZ = std::min(nearZ, XMVectorGetZ(XMVector3Transform(XMLoadFloat3(&corner), lightView)));
+			}
+			float farZ = lightCenter.z + radius;
+
+			// Depth range only grows by snapping
+			nearZ = std::floor(nearZ / snapStep) * snapStep;
+			farZ = std::ceil(farZ / snapStep) * snapStep;
+
+			// Snapped offset goes into the view, so the projection scale stays bit exact
+			CascadeProjection cascade;
+			cascade.View = XMMatrixMultiply(lightView, XMMatrixTranslation(-lightCenter.x, -lightCenter.y, 0.0f));
+			cascade.Proj = XMMatrixOrthographicLH(2.0f * halfExtent, 2.0f * halfExtent, nearZ, farZ);
+			cascade.Position = XMVector3Transform(XMVectorSet(lightCenter.x, lightCenter.y, nearZ, 1.0f), XMMatrixTranspose(lightView));
+			cascade.TexelSize = texelSize;
+
+			return cascade;
+		}
+	}
+}
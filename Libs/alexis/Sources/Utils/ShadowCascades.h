@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+namespace alexis
+{
+	namespace utils
+	{
+		// Split depths of cascadeCount cascades over [nearZ, farZ], outSplits holds cascadeCount + 1 entries.
+		// lambda blends uniform (0) and logarithmic (1) distribution
+		void ComputeCascadeSplits(float nearZ, float farZ, float lambda, std::size_t cascadeCount, float* outSplits);
+
+		struct alignas(16) CascadeProjection
+		{
+			DirectX::XMMATRIX View;
+			DirectX::XMMATRIX Proj;
+
+			// Center of the near plane, world space
+			DirectX::XMVECTOR Position;
+
+			// World units per shadow map texel
+			float TexelSize;
+		};
+
+		// Orthographic light projection covering the camera view depths [splitNear, splitFar].
+		// The slice is enclosed in a sphere, so the extent does not change when the camera rotates, and the projection
+		// moves in steps of snapTexels texels, so shadow edges do not crawl when the camera moves. Depth range reaches back
+		// to casterBounds and is snapped to the same step. A coarse step keeps the matrices bit exact over longer camera moves
+		// for snapTexels texels of margin per side.
+		// lightDirection is normalized and points from the light, projScaleX and projScaleY are camera Proj._11 and Proj._22
+		CascadeProjection XM_CALLCONV FitCascade(DirectX::FXMVECTOR lightDirection, DirectX::FXMMATRIX cameraInvView, float projScaleX, float projScaleY,
+			float splitNear, float splitFar, std::uint32_t resolution, const DirectX::BoundingBox& casterBounds, std::uint32_t snapTexels = 1);
+	}
+}
@@ -0,0 +1,79 @@
+#include <Precompiled.h>
+
+#include "ShadowCasterCache.h"
+
+#include <cstring>
+
+namespace alexis
+{
+	namespace utils
+	{
+		void ShadowCasterCache::SetViewCount(std::size_t viewCount)
+		{
+			m_views.resize(viewCount);
+		}
+
+		void ShadowCasterCache::UpdateCasters(std::size_t casterCount, std::uint32_t casterVersion, const std::uint32_t* moved, std::size_t movedCount)
+		{
+			++m_frame;
+
+			if (casterVersion != m_casterVersion || casterCount != m_lastMovedFrames.size())
+			{
+				m_lastMovedFrames.assign(casterCount, m_frame - k_settleFrames);
+				m_casterVersion = casterVersion;
+				Invalidate();
+				return;
+			}
+
+			for (std::size_t i = 0; i < movedCount; ++i)
+			{
+				assert(moved[i] < casterCount && "Caster out of range");
+				m_lastMovedFrames[moved[i]] = m_frame;
+			}
+		}
+
+		bool XM_CALLCONV ShadowCasterCache::UpdateView(std::size_t view, FXMMATRIX viewProj, std::uint32_t lightVersion, const std::vector<std::uint32_t>& casters,
+			std::vector<std::uint32_t>& outStatic, std::vector<std::uint32_t>& outDynamic)
+		{
+			assert(view < m_views.size() && "View out of range");
+
+			outStatic.clear();
+			outDynamic.clear();
+			for (auto caster : casters)
+			{
+				(IsStatic(caster) ? outStatic : outDynamic).push_back(caster);
+			}
+
+			XMFLOAT4X4 matrix;
+			XMStoreFloat4x4(&matrix, viewProj);
+
+			// Moved static caster turns dynamic and settled one turns static, both change the set
+			auto& state = m_views[view];
+			bool isStale = !state.IsValid || state.LightVersion != lightVersion || std::memcmp(&state.ViewProj, &matrix, sizeof(matrix)) != 0 ||
+				state.StaticCasters != outStatic;
+
+			if (isStale)
+			{
+				state.ViewProj = matrix;
+				state.LightVersion = lightVersion;
+				state.StaticCasters = outStatic;
+				state.IsValid = true;
+			}
+
+			return isStale;
+		}
+
+		void ShadowCasterCache::Invalidate()
+		{
+			for (auto& state : m_views)
+			{
+				state.IsValid = false;
+			}
+		}
+
+		bool ShadowCasterCache::IsStatic(std::uint32_t caster) const
+		{
+			return m_frame - m_lastMovedFrames[caster] >= k_settleFrames;
+		}
+	}
+}
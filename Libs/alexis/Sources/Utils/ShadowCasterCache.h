@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace alexis
+{
+	namespace utils
+	{
+		// Tracks when cached shadow depth of static casters goes stale, per shadow view.
+		// Casters that moved within the last k_settleFrames frames are dynamic and drawn every frame, the rest are static and cached.
+		// A view is stale when the light changed, its matrix changed (cascade refitted) or its set of static casters changed
+		class ShadowCasterCache
+		{
+		public:
+			// Casters still for this many frames become static
+			static constexpr std::uint32_t k_settleFrames = 8;
+
+			void SetViewCount(std::size_t viewCount);
+
+			// Start a frame, moved lists the casters whose transform changed since the previous frame.
+			// A new casterVersion means caster indices changed: every caster starts static and every view is stale
+			void UpdateCasters(std::size_t casterCount, std::uint32_t casterVersion, const std::uint32_t* moved, std::size_t movedCount);
+
+			// Split casters of a view in static and dynamic, in input order. Returns true if cached depth of the view must be redrawn.
+			// lightVersion changes whenever the light does
+			bool XM_CALLCONV UpdateView(std::size_t view, DirectX::FXMMATRIX viewProj, std::uint32_t lightVersion, const std::vector<std::uint32_t>& casters,
+				std::vector<std::uint32_t>& outStatic, std::vector<std::uint32_t>& outDynamic);
+
+			// Every view is stale on its next update
+			void Invalidate();
+
+			bool IsStatic(std::uint32_t caster) const;
+
+		private:
+			struct ViewState
+			{
+				DirectX::XMFLOAT4X4 ViewProj;
+				std::uint32_t LightVersion{ 0 };
+				std::vector<std::uint32_t> StaticCasters;
+				bool IsValid{ false };
+			};
+
+			std::vector<std::uint32_t> m_lastMovedFrames;
+			std::vector<ViewState> m_views;
+
+			std::uint32_t m_casterVersion{ 0 };
+
+			// Starts settled, so casters present from the start are static
+			std::uint32_t m_frame{ k_settleFrames };
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,417 @@
+#include <Precompiled.h>
+
+#include "SpecularIBL.h"
+
+#include <cmath>
+
+#include <Core/JobSystem.h>
+
+namespace alexis
+{
+	namespace utils
+	{
+		namespace
+		{
+			// Rows per job
+			static constexpr std::size_t k_rowBatchSize = 8;
+
+			// Footprint bias of filtered importance sampling, one level up hides the sample pattern
+			static constexpr float k_sampleLodBias = 1.0f;
+
+			float VanDerCorpusSequence(std::uint32_t bits)
+			{
+				bits = (bits << 16u) | (bits >> 16u);
+				bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+				bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+				bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+				bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+
+				return static_cast<float>(bits) * 2.3283064365386963e-10f; // 0x100000000
+			}
+
+			// Half vector around +Z for the i-th of sampleCount Hammersley points, same as ImportanceSampleGGX in PBSHelpers.hlsli
+			XMFLOAT3 ImportanceSampleGGX(std::uint32_t i, std::uint32_t sampleCount, float roughness)
+			{
+				float a = roughness * roughness;
+				float phi = XM_2PI * static_cast<float>(i) / static_cast<float>(sampleCount);
+				float xi = VanDerCorpusSequence(i);
+
+				float cosTheta = std::sqrt((1.0f - xi) / (1.0f + (a * a - 1.0f) * xi));
+				float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+
+				return { std::cos(phi) * sinTheta, std::sin(phi) * sinTheta, cosTheta };
+			}
+
+			// Hammersley point i of sampleCount on the unit disk, Edge = sqrt(1 - T1^2)
+			struct DiskSample
+			{
+				float T1;
+				float T2;
+				float Edge;
+			};
+
+			DiskSample GetDiskSample(std::uint32_t i, std::uint32_t sampleCount)
+			{
+				float r = std::sqrt(static_cast<float>(i) / static_cast<float>(sampleCount));
+				float phi = XM_2PI * VanDerCorpusSequence(i);
+				float t1 = r * std::cos(phi);
+				return { t1, r * std::sin(phi), std::sqrt(1.0f - t1 * t1) };
+			}
+
+			// Half vector around +Z drawn from the GGX normals visible from V (Heitz 2018), a = roughness^2. Vh is V in the xz plane
+			// stretched to unit roughness and normalized. Samples always face V, so grazing views do not waste them on reflections
+			// under the horizon
+			XMFLOAT3 ImportanceSampleVisibleGGX(const DiskSample& disk, float a, const XMFLOAT3& Vh)
+			{
+				// Warp the disk to the projected hemisphere seen from Vh, basis T1 = +Y, T2 = Vh x T1
+				float s = 0.5f * (1.0f + Vh.z);
+				float t2 = (1.0f - s) * disk.Edge + s * disk.T2;
+				float w = std::sqrt(std::max(0.0f, 1.0f - disk.T1 * disk.T1 - t2 * t2));
+
+				XMFLOAT3 h{ a * (w * Vh.x - t2 * Vh.z), a * disk.T1, std::max(t2 * Vh.x + w * Vh.z, 0.0f) };
+				float invLength = 1.0f / std::sqrt(h.x * h.x + h.y * h.y + h.z * h.z);
+				return { h.x * invLength, h.y * invLength, h.z * invLength };
+			}
+
+			// Exact Smith masking of GGX, the normalization of the visible normal distribution
+			float G1_SmithGGX(float NdotV, float roughness)
+			{
+				float a2 = roughness * roughness * roughness * roughness;
+				return 2.0f * NdotV / (NdotV + std::sqrt(a2 + (1.0f - a2) * NdotV * NdotV));
+			}
+
+			float D_TrowbridgeReitz(float NdotH, float roughness)
+			{
+				float a = roughness * roughness;
+				float a2 = a * a;
+				float denom = NdotH * NdotH * (a2 - 1.0f) + 1.0f;
+
+				return a2 / (XM_PI * denom * denom);
+			}
+
+			float G_SchlickGGX_IBL(float NdotV, float roughness)
+			{
+				float k = roughness * roughness / 2.0f;
+				return NdotV / (NdotV * (1.0f - k) + k);
+			}
+
+			// Equirect map and its box filtered mips, level 0 points to the source texels
+			struct EquirectLevel
+			{
+				const XMFLOAT4* Texels;
+				std::size_t Width;
+				std::size_t Height;
+			};
+
+			class EquirectMipChain
+			{
+			public:
+				EquirectMipChain(const XMFLOAT4* texels, std::size_t width, std::size_t height)
+				{
+					m_levels.push_back({ texels, width, height });
+
+					while (width > 1 || height > 1)
+					{
+						const auto& source = m_levels.back();
+						width = std::max<std::size_t>(width / 2, 1);
+						height = std::max<std::size_t>(height / 2, 1);
+
+						auto& storage = m_storage.emplace_back(width * height);
+						for (std::size_t y = 0; y < height; ++y)
+						{
+							std::size_t y0 = std::min(2 * y, source.Height - 1);
+							std::size_t y1 = std::min(2 * y + 1, source.Height - 1);
+
+							// Rows closer to a pole cover less solid angle
+							float weight0 = GetRowWeight(y0, source.Height);
+							float weight1 = GetRowWeight(y1, source.Height);
+							float scale = 0.5f / (weight0 + weight1);
+
+							for (std::size_t x = 0; x < width; ++x)
+							{
+								std::size_t x0 = std::min(2 * x, source.Width - 1);
+								std::size_t x1 = std::min(2 * x + 1, source.Width - 1);
+
+								XMVECTOR row0 = XMVectorAdd(XMLoadFloat4(&source.Texels[y0 * source.Width + x0]), XMLoadFloat4(&source.Texels[y0 * source.Width + x1]));
+								XMVECTOR row1 = XMVectorAdd(XMLoadFloat4(&source.Texels[y1 * source.Width + x0]), XMLoadFloat4(&source.Texels[y1 * source.Width + x1]));
+								XMVECTOR sum = XMVectorAdd(XMVectorScale(row0, weight0), XMVectorScale(row1, weight1));
+								XMStoreFloat4(&storage[y * width + x], XMVectorScale(sum, scale));
+							}
+						}
+
+						m_levels.push_back({ storage.data(), width, height });
+					}
+				}
+
+				// Solid angle of a level 0 texel on the equator
+				float GetTexelSolidAngle() const
+				{
+					return (XM_2PI / m_levels[0].Width) * (XM_PI / m_levels[0].Height);
+				}
+
+				// Trilinear sample in the direction, lod in level 0 texels
+				XMVECTOR XM_CALLCONV Sample(FXMVECTOR direction, float lod) const
+				{
+					XMFLOAT3 dir;
+					XMStoreFloat3(&dir, direction);
+
+					// Same mapping as EnvRectToCube_ps
+					float u = std::atan2(dir.z, dir.x) / XM_2PI + 0.5f;
+					float v = 0.5f - std::asin(std::clamp(dir.y, -1.0f, 1.0f)) / XM_PI;
+
+					lod = std::clamp(lod, 0.0f, static_cast<float>(m_levels.size() - 1));
+					std::size_t level = static_cast<std::size_t>(lod);
+					float blend = lod - level;
+
+					XMVECTOR color = SampleLevel(m_levels[level], u, v);
+					if (blend > 0.0f && level + 1 < m_levels.size())
+					{
+						color = XMVectorLerp(color, SampleLevel(m_levels[level + 1], u, v), blend);
+					}
+
+					return color;
+				}
+
+			private:
+				// cos(latitude) of the row center
+				static float GetRowWeight(std::size_t y, std::size_t height)
+				{
+					return std::cos((0.5f - (y + 0.5f) / height) * XM_PI);
+				}
+
+				// Bilinear, wraps around in longitude and clamps at the poles
+				static XMVECTOR SampleLevel(const EquirectLevel& level, float u, float v)
+				{
+					float x = u * level.Width - 0.5f;
+					float y = std::clamp(v * level.Height - 0.5f, 0.0f, static_cast<float>(level.Height - 1));
+
+					float xFloor = std::floor(x);
+					float yFloor = std::floor(y);
+					float tx = x - xFloor;
+					float ty = y - yFloor;
+
+					auto width = static_cast<std::ptrdiff_t>(level.Width);
+					std::size_t x0 = static_cast<std::size_t>(((static_cast<std::ptrdiff_t>(xFloor) % width) + width) % width);
+					std::size_t x1 = (x0 + 1) % level.Width;
+					std::size_t y0 = static_cast<std::size_t>(yFloor);
+					std::size_t y1 = std::min(y0 + 1, level.Height - 1);
+
+					XMVECTOR top = XMVectorLerp(XMLoadFloat4(&level.Texels[y0 * level.Width + x0]), XMLoadFloat4(&level.Texels[y0 * level.Width + x1]), tx);
+					XMVECTOR bottom = XMVectorLerp(XMLoadFloat4(&level.Texels[y1 * level.Width + x0]), XMLoadFloat4(&level.Texels[y1 * level.Width + x1]), tx);
+
+					return XMVectorLerp(top, bottom, ty);
+				}
+
+				std::vector<EquirectLevel> m_levels;
+				std::vector<std::vector<XMFLOAT4>> m_storage;
+			};
+
+			// Light direction around +Z with V = N, its NdotL weight and the source lod it is read at
+			struct LobeSample
+			{
+				XMFLOAT3 Direction;
+				float Weight;
+				float Lod;
+			};
+
+			// GGX lobe for every texel of a mip, texels only rotate it. mirrorLod is the footprint of a texel of the mip,
+			// the only filtering a mirror lobe gets
+			std::vector<LobeSample> BuildLobeSamples(float roughness, std::uint32_t sampleCount, float sourceTexelSolidAngle, float mirrorLod)
+			{
+				std::vector<LobeSample> samples;
+
+				// Every sample of a mirror lobe is the same
+				if (roughness == 0.0f)
+				{
+					samples.push_back({ XMFLOAT3{ 0.0f, 0.0f, 1.0f }, 1.0f, mirrorLod });
+					return samples;
+				}
+
+				samples.reserve(sampleCount);
+				for (std::uint32_t i = 0; i < sampleCount; ++i)
+				{
+					XMFLOAT3 h = ImportanceSampleGGX(i, sampleCount, roughness);
+
+					// L = reflect(-N, H), NdotH == VdotH
+					XMFLOAT3 l{ 2.0f * h.z * h.x, 2.0f * h.z * h.y, 2.0f * h.z * h.z - 1.0f };
+					if (l.z <= 0.0f)
+					{
+						continue;
+					}
+
+					// Solid angle the sample stands for: 1 / (count * pdf), pdf = D * NdotH / (4 * VdotH)
+					float pdf = D_TrowbridgeReitz(h.z, roughness) / 4.0f;
+					float sampleSolidAngle = 1.0f / (sampleCount * pdf);
+					float lod = 0.5f * std::log2(sampleSolidAngle / sourceTexelSolidAngle) + k_sampleLodBias;
+
+					samples.push_back({ l, l.z, lod });
+				}
+
+				return samples;
+			}
+		}
+
+		XMVECTOR XM_CALLCONV GetCubemapDirection(std::size_t face, float u, float v)
+		{
+			float s = 2.0f * u - 1.0f;
+			float t = 2.0f * v - 1.0f;
+
+			XMVECTOR direction;
+			switch (face)
+			{
+			case 0: direction = XMVectorSet(1.0f, -t, -s, 0.0f); break;		// +X
+			case 1: direction = XMVectorSet(-1.0f, -t, s, 0.0f); break;		// -X
+			case 2: direction = XMVectorSet(s, 1.0f, t, 0.0f); break;		// +Y
+			case 3: direction = XMVectorSet(s, -1.0f, -t, 0.0f); break;		// -Y
+			case 4: direction = XMVectorSet(s, -t, 1.0f, 0.0f); break;		// +Z
+			default: direction = XMVectorSet(-s, -t, -1.0f, 0.0f); break;	// -Z
+			}
+
+			return XMVector3Normalize(direction);
+		}
+
+		PrefilteredCubemap PrefilterEnvironmentGGX(const XMFLOAT4* texels, std::size_t width, std::size_t height,
+			std::size_t size, std::size_t mipCount, std::uint32_t sampleCount, JobSystem* jobSystem)
+		{
+			assert(width > 0 && height > 0 && "Empty environment map");
+			assert(size > 0 && mipCount > 0 && sampleCount > 0 && "Empty prefiltered cubemap");
+
+			const EquirectMipChain source(texels, width, height);
+			const float sourceTexelSolidAngle = source.GetTexelSolidAngle();
+
+			PrefilteredCubemap cubemap;
+			cubemap.Size = size;
+			cubemap.MipCount = mipCount;
+			cubemap.Images.resize(6 * mipCount);
+
+			for (std::size_t mip = 0; mip < mipCount; ++mip)
+			{
+				const std::size_t mipSize = std::max<std::size_t>(size >> mip, 1);
+				const float roughness = mipCount > 1 ? static_cast<float>(mip) / static_cast<float>(mipCount - 1) : 0.0f;
+
+				// A texel covers about a sixth of the sphere divided by its face texel count
+				const float texelSolidAngle = 4.0f * XM_PI / (6.0f * mipSize * mipSize);
+				const float mirrorLod = 0.5f * std::log2(texelSolidAngle / sourceTexelSolidAngle);
+				const auto samples = BuildLobeSamples(roughness, sampleCount, sourceTexelSolidAngle, mirrorLod);
+
+				for (std::size_t face = 0; face < 6; ++face)
+				{
+					cubemap.Images[face * mipCount + mip].resize(mipSize * mipSize);
+				}
+
+				// Rows of all faces, face major
+				auto prefilterRows = [&](std::size_t begin, std::size_t end)
+				{
+					for (std::size_t row = begin; row < end; ++row)
+					{
+						const std::size_t face = row / mipSize;
+						const std::size_t y = row % mipSize;
+						auto& image = cubemap.Images[face * mipCount + mip];
+
+						for (std::size_t x = 0; x < mipSize; ++x)
+						{
+							XMVECTOR N = GetCubemapDirection(face, (x + 0.5f) / mipSize, (y + 0.5f) / mipSize);
+
+							// Tangent frame as in ImportanceSampleGGX
+							XMVECTOR up = std::fabs(XMVectorGetZ(N)) < 0.999f ? g_XMIdentityR2 : g_XMIdentityR0;
+							XMVECTOR tangent = XMVector3Normalize(XMVector3Cross(up, N));
+							XMVECTOR bitangent = XMVector3Cross(N, tangent);
+
+							XMVECTOR color = XMVectorZero();
+							float totalWeight = 0.0f;
+							for (const auto& sample : samples)
+							{
+								XMVECTOR L = XMVectorMultiplyAdd(tangent, XMVectorReplicate(sample.Direction.x),
+									XMVectorMultiplyAdd(bitangent, XMVectorReplicate(sample.Direction.y), XMVectorScale(N, sample.Direction.z)));
+
+								color = XMVectorMultiplyAdd(source.Sample(L, sample.Lod), XMVectorReplicate(sample.Weight), color);
+								totalWeight += sample.Weight;
+							}
+
+							XMStoreFloat4(&image[y * mipSize + x], XMVectorSetW(XMVectorScale(color, 1.0f / totalWeight), 1.0f));
+						}
+					}
+				};
+
+				if (jobSystem)
+				{
+					jobSystem->ParallelFor(6 * mipSize, k_rowBatchSize, prefilterRows);
+				}
+				else
+				{
+					prefilterRows(0, 6 * mipSize);
+				}
+			}
+
+			return cubemap;
+		}
+
+		std::vector<XMFLOAT2> IntegrateEnvironmentBRDF(std::size_t size, std::uint32_t sampleCount, JobSystem* jobSystem)
+		{
+			assert(size > 0 && sampleCount > 0 && "Empty BRDF LUT");
+
+			std::vector<XMFLOAT2> lut(size * size);
+
+			// Split sum of F = F0 * (1 - Fc) + Fc, Fc = (1 - VdotH)^5. Visible normal samples have pdf G1(V) * D * VdotH / NdotV
+			// over H, with L = reflect(-V, H) the estimator of D * G * NdotL / (4 * NdotL * NdotV) is G / G1(V)
+			std::vector<DiskSample> diskSamples(sampleCount);
+			for (std::uint32_t i = 0; i < sampleCount; ++i)
+			{
+				diskSamples[i] = GetDiskSample(i, sampleCount);
+			}
+
+			auto integrateRows = [&](std::size_t begin, std::size_t end)
+			{
+				for (std::size_t y = begin; y < end; ++y)
+				{
+					const float roughness = (y + 0.5f) / size;
+					const float a = roughness * roughness;
+
+					for (std::size_t x = 0; x < size; ++x)
+					{
+						const float NdotV = (x + 0.5f) / size;
+						const XMFLOAT3 V{ std::sqrt(1.0f - NdotV * NdotV), 0.0f, NdotV };
+						const float G_VOverG1 = G_SchlickGGX_IBL(NdotV, roughness) / G1_SmithGGX(NdotV, roughness);
+
+						const float stretchedLength = std::sqrt(a * a * V.x * V.x + V.z * V.z);
+						const XMFLOAT3 Vh{ a * V.x / stretchedLength, 0.0f, V.z / stretchedLength };
+
+						float A = 0.0f;
+						float B = 0.0f;
+
+						for (const auto& disk : diskSamples)
+						{
+							XMFLOAT3 H = ImportanceSampleVisibleGGX(disk, a, Vh);
+							float VdotH = std::max(V.x * H.x + V.z * H.z, 0.0f);
+							float NdotL = 2.0f * VdotH * H.z - V.z;
+
+							if (NdotL > 0.0f)
+							{
+								float G_Vis = G_VOverG1 * G_SchlickGGX_IBL(NdotL, roughness);
+								float oneMinusVdotH = 1.0f - VdotH;
+								float oneMinusVdotH2 = oneMinusVdotH * oneMinusVdotH;
+								float Fc = oneMinusVdotH2 * oneMinusVdotH2 * oneMinusVdotH;
+
+								A += (1.0f - Fc) * G_Vis;
+								B += Fc * G_Vis;
+							}
+						}
+
+						lut[y * size + x] = { A / sampleCount, B / sampleCount };
+					}
+				}
+			};
+
+			if (jobSystem)
+			{
+				jobSystem->ParallelFor(size, k_rowBatchSize, integrateRows);
+			}
+			else
+			{
+				integrateRows(0, size);
+			}
+
+			return lut;
+		}
+	}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <DirectXMath.h>
+
+namespace alexis
+{
+	class JobSystem;
+
+	namespace utils
+	{
+		// Direction through (u, v) of a cubemap face, u and v in [0, 1] from the top left corner.
+		// Faces are in D3D order +X, -X, +Y, -Y, +Z, -Z, oriented like the views of EnvironmentSystem::CaptureCubemap
+		DirectX::XMVECTOR XM_CALLCONV GetCubemapDirection(std::size_t face, float u, float v);
+
+		// Environment prefiltered with the GGX lobe for the split sum approximation, mip m is roughness m / (MipCount - 1)
+		struct PrefilteredCubemap
+		{
+			std::size_t Size{ 0 };
+			std::size_t MipCount{ 0 };
+
+			// Size >> mip squared RGBA texels per face and mip, in D3D12 subresource order: Images[face * MipCount + mip]
+			std::vector<std::vector<DirectX::XMFLOAT4>> Images;
+		};
+
+		// Prefilter an equirect environment map (same layout as ProjectIrradianceSH takes) into a size x size cubemap.
+		// Every texel takes sampleCount GGX importance samples with V = N. Samples read a box filtered mip chain of the source
+		// at their footprint, so few of them are enough on bright spots. Texels are split between jobs if jobSystem is given
+		PrefilteredCubemap PrefilterEnvironmentGGX(const DirectX::XMFLOAT4* texels, std::size_t width, std::size_t height,
+			std::size_t size, std::size_t mipCount, std::uint32_t sampleCount, JobSystem* jobSystem = nullptr);
+
+		// Scale (x) and bias (y) to F0 of the GGX specular integral, size x size texels, rows top to bottom.
+		// Texel (x, y) is NdotV = (x + 0.5) / size and roughness = (y + 0.5) / size, like the LUT is sampled in EnvBRDF
+		std::vector<DirectX::XMFLOAT2> IntegrateEnvironmentBRDF(std::size_t size, std::uint32_t sampleCount, JobSystem* jobSystem = nullptr);
+	}
+}
@@ -0,0 +1,182 @@
+#include <Precompiled.h>
+
+#include "SphericalHarmonics.h"
+
+#include <cmath>
+
+#include <Core/JobSystem.h>
+
+namespace alexis
+{
+	namespace utils
+	{
+		namespace
+		{
+			// Real SH basis constants, direction (x, y, z)
+			static constexpr float k_sh0 = 0.282095f; // 1
+			static constexpr float k_sh1 = 0.488603f; // y, z, x
+			static constexpr float k_sh2 = 1.092548f; // xy, yz, xz
+			static constexpr float k_sh6 = 0.315392f; // 3z^2 - 1
+			static constexpr float k_sh8 = 0.546274f; // x^2 - y^2
+
+			// Cosine lobe convolution per band divided by pi: pi, 2pi/3, pi/4
+			static constexpr float k_band0 = 1.0f;
+			static constexpr float k_band1 = 2.0f / 3.0f;
+			static constexpr float k_band2 = 1.0f / 4.0f;
+
+			// Rows per job
+			static constexpr std::size_t k_rowBatchSize = 16;
+
+			// Radiance projection accumulated over rows
+			struct RadianceSH
+			{
+				std::array<XMVECTOR, 9> Coefficients;
+			};
+
+			// Texel (x, y) looks at longitude phi = (u - 0.5) * 2pi and latitude beta = (0.5 - v) * pi, direction is
+			// (cos(beta) * cos(phi), sin(beta), cos(beta) * sin(phi)). Basis functions split in a latitude part and a longitude part
+			// in 1, cos(phi), sin(phi), cos(2phi), sin(2phi), so every row needs 5 weighted sums of its texels
+			void ProjectRows(const XMFLOAT4* texels, std::size_t width, std::size_t height, const float* longitudeTable,
+				std::size_t rowBegin, std::size_t rowEnd, RadianceSH& out)
+			{
+				const float* cosPhi = longitudeTable;
+				const float* sinPhi = longitudeTable + width;
+				const float* cos2Phi = longitudeTable + 2 * width;
+				const float* sin2Phi = longitudeTable + 3 * width;
+
+				const float texelSolidAngle = (XM_2PI / width) * (XM_PI / height);
+
+				for (std::size_t y = rowBegin; y < rowEnd; ++y)
+				{
+					const XMFLOAT4* row = texels + y * width;
+
+					XMVECTOR sum = XMVectorZero();
+					XMVECTOR sumCos = XMVectorZero();
+					XMVECTOR sumSin = XMVectorZero();
+					XMVECTOR sumCos2 = XMVectorZero();
+					XMVECTOR sumSin2 = XMVectorZero();
+
+					for (std::size_t x = 0; x < width; ++x)
+					{
+						XMVECTOR radiance = XMLoadFloat4(&row[x]);
+						sum = XMVectorAdd(sum, radiance);
+						sumCos = XMVectorMultiplyAdd(radiance, XMVectorReplicate(cosPhi[x]), sumCos);
+						sumSin = XMVectorMultiplyAdd(radiance, XMVectorReplicate(sinPhi[x]), sumSin);
+						sumCos2 = XMVectorMultiplyAdd(radiance, XMVectorReplicate(cos2Phi[x]), sumCos2);
+						sumSin2 = XMVectorMultiplyAdd(radiance, XMVectorReplicate(sin2Phi[x]), sumSin2);
+					}
+
+					float beta = (0.5f - (y + 0.5f) / height) * XM_PI;
+					float sinBeta = std::sin(beta);
+					float cosBeta = std::cos(beta);
+					float cosBetaSq = cosBeta * cosBeta;
+
+					// Solid angle shrinks towards the poles
+					float weight = texelSolidAngle * cosBeta;
+
+					auto& c = out.Coefficients;
+					c[0] = XMVectorMultiplyAdd(sum, XMVectorReplicate(weight * k_sh0), c[0]);
+					c[1] = XMVectorMultiplyAdd(sum, XMVectorReplicate(weight * k_sh1 * sinBeta), c[1]);
+					c[2] = XMVectorMultiplyAdd(sumSin, XMVectorReplicate(weight * k_sh1 * cosBeta), c[2]);
+					c[3] = XMVectorMultiplyAdd(sumCos, XMVectorReplicate(weight * k_sh1 * cosBeta), c[3]);
+					c[4] = XMVectorMultiplyAdd(sumCos, XMVectorReplicate(weight * k_sh2 * sinBeta * cosBeta), c[4]);
+					c[5] = XMVectorMultiplyAdd(sumSin, XMVectorReplicate(weight * k_sh2 * sinBeta * cosBeta), c[5]);
+
+					// 3z^2 - 1 = 1.5 * cos^2(beta) * (1 - cos(2phi)) - 1
+					XMVECTOR zz = XMVectorSubtract(XMVectorScale(XMVectorSubtract(sum, sumCos2), 1.5f * cosBetaSq), sum);
+					c[6] = XMVectorMultiplyAdd(zz, XMVectorReplicate(weight * k_sh6), c[6]);
+
+					// xz = 0.5 * cos^2(beta) * sin(2phi)
+					c[7] = XMVectorMultiplyAdd(sumSin2, XMVectorReplicate(weight * k_sh2 * 0.5f * cosBetaSq), c[7]);
+
+					// x^2 - y^2 = 0.5 * cos^2(beta) * (1 + cos(2phi)) - sin^2(beta)
+					XMVECTOR xxyy = XMVectorSubtract(XMVectorScale(XMVectorAdd(sum, sumCos2), 0.5f * cosBetaSq), XMVectorScale(sum, sinBeta * sinBeta));
+					c[8] = XMVectorMultiplyAdd(xxyy, XMVectorReplicate(weight * k_sh8), c[8]);
+				}
+			}
+		}
+
+		IrradianceSH ProjectIrradianceSH(const XMFLOAT4* texels, std::size_t width, std::size_t height, JobSystem* jobSystem)
+		{
+			assert(width > 0 && height > 0 && "Empty environment map");
+
+			std::vector<float> longitudeTable(4 * width);
+			for (std::size_t x = 0; x < width; ++x)
+			{
+				float phi = ((x + 0.5f) / width - 0.5f) * XM_2PI;
+				longitudeTable[x] = std::cos(phi);
+				longitudeTable[width + x] = std::sin(phi);
+				longitudeTable[2 * width + x] = std::cos(2.0f * phi);
+				longitudeTable[3 * width + x] = std::sin(2.0f * phi);
+			}
+
+			// One partial sum per batch, added up in batch order so the result does not depend on scheduling
+			const std::size_t batchCount = (height + k_rowBatchSize - 1) / k_rowBatchSize;
+			std::vector<RadianceSH> partials(batchCount);
+			for (auto& partial : partials)
+			{
+				partial.Coefficients.fill(XMVectorZero());
+			}
+
+			auto projectBatches = [&](std::size_t begin, std::size_t end)
+			{
+				ProjectRows(texels, width, height, longitudeTable.data(), begin, end, partials[begin / k_rowBatchSize]);
+			};
+
+			if (jobSystem)
+			{
+				jobSystem->ParallelFor(height, k_rowBatchSize, projectBatches);
+			}
+			else
+			{
+				for (std::size_t begin = 0; begin < height; begin += k_rowBatchSize)
+				{
+					projectBatches(begin, std::min(begin + k_rowBatchSize, height));
+				}
+			}
+
+			static constexpr float k_bandScales[9] = { k_band0, k_band1, k_band1, k_band1, k_band2, k_band2, k_band2, k_band2, k_band2 };
+
+			IrradianceSH sh;
+			for (std::size_t i = 0; i < sh.Coefficients.size(); ++i)
+			{
+				XMVECTOR coefficient = XMVectorZero();
+				for (const auto& partial : partials)
+				{
+					coefficient = XMVectorAdd(coefficient, partial.Coefficients[i]);
+				}
+
+				XMStoreFloat4(&sh.Coefficients[i], XMVectorSetW(XMVectorScale(coefficient, k_bandScales[i]), 0.0f));
+			}
+
+			return sh;
+		}
+
+		XMVECTOR XM_CALLCONV EvaluateIrradianceSH(const IrradianceSH& sh, FXMVECTOR direction)
+		{
+			XMFLOAT3 n;
+			XMStoreFloat3(&n, direction);
+
+			const float basis[9] =
+			{
+				k_sh0,
+				k_sh1 * n.y,
+				k_sh1 * n.z,
+				k_sh1 * n.x,
+				k_sh2 * n.x * n.y,
+				k_sh2 * n.y * n.z,
+				k_sh6 * (3.0f * n.z * n.z - 1.0f),
+				k_sh2 * n.x * n.z,
+				k_sh8 * (n.x * n.x - n.y * n.y),
+			};
+
+			XMVECTOR irradiance = XMVectorZero();
+			for (std::size_t i = 0; i < sh.Coefficients.size(); ++i)
+			{
+				irradiance = XMVectorMultiplyAdd(XMLoadFloat4(&sh.Coefficients[i]), XMVectorReplicate(basis[i]), irradiance);
+			}
+
+			return XMVectorMax(irradiance, XMVectorZero());
+		}
+	}
+}
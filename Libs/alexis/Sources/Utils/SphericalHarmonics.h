@@ -0,0 +1,30 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include <DirectXMath.h>
+
+namespace alexis
+{
+	class JobSystem;
+
+	namespace utils
+	{
+		// Diffuse irradiance of an environment as 9 order-2 spherical harmonics coefficients, RGB in xyz.
+		// Laid out as float4[9] for constant buffers. Basis and scale match EvaluateIrradianceSH in PBSHelpers.hlsli
+		struct IrradianceSH
+		{
+			std::array<DirectX::XMFLOAT4, 9> Coefficients;
+		};
+
+		// Project an equirect environment map onto irradiance SH. Texels are RGBA float, rows top to bottom,
+		// mapped to directions the way EnvRectToCube_ps samples them. Rows are split between jobs if jobSystem is given.
+		// Coefficients are pre-convolved with the cosine lobe and divided by pi: evaluating them gives irradiance / pi,
+		// which is what the diffuse term multiplies by base color
+		IrradianceSH ProjectIrradianceSH(const DirectX::XMFLOAT4* texels, std::size_t width, std::size_t height, JobSystem* jobSystem = nullptr);
+
+		// Irradiance / pi around normalized direction
+		DirectX::XMVECTOR XM_CALLCONV EvaluateIrradianceSH(const IrradianceSH& sh, DirectX::FXMVECTOR direction);
+	}
+}
@@ -0,0 +1,316 @@
+#include <Precompiled.h>
+
+#include <random>
+
+#include <Core/JobSystem.h>
+#include <Render/ViewData.h>
+#include <Utils/Bvh.h>
+
+#include <Testing/Benchmark.h>
+#include <Testing/Check.h>
+
+// utils::Bvh queries against testing every box, at 10k / 100k / 1M boxes. Brute force uses the same
+// per-box tests as the tree leaves, so both must return the same primitives
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::testing;
+
+	constexpr float k_worldExtent = 1000.0f;
+
+	struct MinMax
+	{
+		XMVECTOR Min;
+		XMVECTOR Max;
+	};
+
+	std::vector<BoundingBox> MakeBoxes(std::size_t count)
+	{
+		std::mt19937 random(9);
+		std::uniform_real_distribution<float> position(-k_worldExtent, k_worldExtent);
+		std::uniform_real_distribution<float> extent(0.25f, 4.0f);
+
+		std::vector<BoundingBox> boxes(count);
+		for (auto& box : boxes)
+		{
+			box.Center = XMFLOAT3(position(random), position(random), position(random));
+			box.Extents = XMFLOAT3(extent(random), extent(random), extent(random));
+		}
+
+		return boxes;
+	}
+
+	std::vector<MinMax> ToMinMax(const std::vector<BoundingBox>& boxes)
+	{
+		std::vector<MinMax> result(boxes.size());
+		for (std::size_t i = 0; i < boxes.size(); ++i)
+		{
+			XMVECTOR center = XMLoadFloat3(&boxes[i].Center);
+			XMVECTOR extents = XMLoadFloat3(&boxes[i].Extents);
+			result[i] = { XMVectorSubtract(center, extents), XMVectorAdd(center, extents) };
+		}
+
+		return result;
+	}
+
+	void BruteFrustum(const std::vector<MinMax>& boxes, const std::array<XMVECTOR, 6>& planes, std::vector<std::uint32_t>& out)
+	{
+		for (std::size_t i = 0; i < boxes.size(); ++i)
+		{
+			XMVECTOR center = XMVectorScale(XMVectorAdd(boxes[i].Min, boxes[i].Max), 0.5f);
+			XMVECTOR extents = XMVectorScale(XMVectorSubtract(boxes[i].Max, boxes[i].Min), 0.5f);
+
+			bool isInside = true;
+			for (const auto& plane : planes)
+			{
+				float distance = XMVectorGetX(XMPlaneDotCoord(plane, center));
+				float radius = XMVectorGetX(XMVector3Dot(extents, XMVectorAbs(plane)));
+				if (distance < -radius)
+				{
+					isInside = false;
+					break;
+				}
+			}
+
+			if (isInside)
+			{
+				out.push_back(static_cast<std::uint32_t>(i));
+			}
+		}
+	}
+
+	void BruteSphere(const std::vector<MinMax>& boxes, FXMVECTOR center, float radius, std::vector<std::uint32_t>& out)
+	{
+		for (std::size_t i = 0; i < boxes.size(); ++i)
+		{
+			XMVECTOR toClosest = XMVectorSubtract(XMVectorClamp(center, boxes[i].Min, boxes[i].Max), center);
+			if (XMVectorGetX(XMVector3LengthSq(toClosest)) <= radius * radius)
+			{
+				out.push_back(static_cast<std::uint32_t>(i));
+			}
+		}
+	}
+
+	void BruteBox(const std::vector<MinMax>& boxes, FXMVECTOR queryMin, FXMVECTOR queryMax, std::vector<std::uint32_t>& out)
+	{
+		for (std::size_t i = 0; i < boxes.size(); ++i)
+		{
+			if (XMVector3LessOrEqual(boxes[i].Min, queryMax) && XMVector3LessOrEqual(queryMin, boxes[i].Max))
+			{
+				out.push_back(static_cast<std::uint32_t>(i));
+			}
+		}
+	}
+
+	bool BruteRaycast(const std::vector<MinMax>& boxes, FXMVECTOR origin, FXMVECTOR direction, float maxDistance, float& outDistance)
+	{
+		const XMVECTOR invDirection = XMVectorReciprocal(direction);
+
+		bool isHit = false;
+		outDistance = maxDistance;
+		for (const auto& box : boxes)
+		{
+			XMVECTOR t1 = XMVectorMultiply(XMVectorSubtract(box.Min, origin), invDirection);
+			XMVECTOR t2 = XMVectorMultiply(XMVectorSubtract(box.Max, origin), invDirection);
+
+			XMFLOAT3 tNear;
+			XMFLOAT3 tFar;
+			XMStoreFloat3(&tNear, XMVectorMin(t1, t2));
+			XMStoreFloat3(&tFar, XMVectorMax(t1, t2));
+
+			float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+			float exit = std::min(std::min(tFar.x, tFar.y), tFar.z);
+
+			if (enter <= exit && enter <= outDistance)
+			{
+				outDistance = enter;
+				isHit = true;
+			}
+		}
+
+		return isHit;
+	}
+
+	bool SameSet(std::vector<std::uint32_t> a, std::vector<std::uint32_t> b)
+	{
+		std::sort(a.begin(), a.end());
+		std::sort(b.begin(), b.end());
+		return a == b;
+	}
+
+	struct Queries
+	{
+		std::array<XMVECTOR, 6> Planes;
+		std::vector<XMFLOAT4> Spheres;
+		std::vector<std::pair<XMFLOAT3, XMFLOAT3>> Boxes;
+		std::vector<std::pair<XMFLOAT3, XMFLOAT3>> Rays;
+	};
+
+	Queries MakeQueries(int queryCount)
+	{
+		Queries queries;
+
+		XMMATRIX view = XMMatrixLookToLH(XMVectorZero(), XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		XMMATRIX proj = XMMatrixPerspectiveFovLH(XMConvertToRadians(60.0f), 16.0f / 9.0f, 0.1f, 600.0f);
+		ViewData viewData;
+		BuildViewData(XMVectorZero(), view, XMMatrixInverse(nullptr, view), proj, XMMatrixInverse(nullptr, proj), viewData);
+		std::copy(viewData.FrustumPlanes.begin(), viewData.FrustumPlanes.end(), queries.Planes.begin());
+
+		std::mt19937 random(13);
+		std::uniform_real_distribution<float> position(-k_worldExtent, k_worldExtent);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+		for (int i = 0; i < queryCount; ++i)
+		{
+			queries.Spheres.push_back(XMFLOAT4(position(random), position(random), position(random), 25.0f));
+
+			XMFLOAT3 center(position(random), position(random), position(random));
+			queries.Boxes.push_back({ XMFLOAT3(center.x - 20.0f, center.y - 20.0f, center.z - 20.0f), XMFLOAT3(center.x + 20.0f, center.y + 20.0f, center.z + 20.0f) });
+
+			XMFLOAT3 direction;
+			XMStoreFloat3(&direction, XMVector3Normalize(XMVectorSet(unit(random), unit(random), unit(random), 0.0f)));
+			queries.Rays.push_back({ XMFLOAT3(position(random), position(random), position(random)), direction });
+		}
+
+		return queries;
+	}
+
+	void Run(std::size_t count, int repeatCount, int queryCount, JobSystem& jobSystem)
+	{
+		auto boxes = MakeBoxes(count);
+		auto minMax = ToMinMax(boxes);
+		auto queries = MakeQueries(queryCount);
+
+		utils::Bvh bvh;
+		double serialBuildMs = MeasureBestMilliseconds(repeatCount, [&]() { bvh.Build(boxes.data(), count); });
+		double parallelBuildMs = MeasureBestMilliseconds(repeatCount, [&]() { bvh.Build(boxes.data(), count, &jobSystem); });
+		double refitMs = MeasureBestMilliseconds(repeatCount, [&]() { bvh.Refit(boxes.data()); });
+
+		std::vector<std::uint32_t> bruteResult;
+		std::vector<std::uint32_t> bvhResult;
+
+		// Frustum
+		double bruteMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			bruteResult.clear();
+			BruteFrustum(minMax, queries.Planes, bruteResult);
+		});
+		double bvhMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			bvhResult.clear();
+			bvh.QueryFrustum(queries.Planes, bvhResult);
+		});
+		CHECK(SameSet(bruteResult, bvhResult));
+		PrintRow("frustum (60 deg, far 600)", count, bruteMs, bvhMs);
+
+		// Spheres and boxes, per query
+		bool isSame = true;
+		bruteMs = MeasureMilliseconds([&]()
+		{
+			for (const auto& sphere : queries.Spheres)
+			{
+				bruteResult.clear();
+				BruteSphere(minMax, XMLoadFloat4(&sphere), sphere.w, bruteResult);
+			}
+		}) / queryCount;
+		bvhMs = MeasureMilliseconds([&]()
+		{
+			for (const auto& sphere : queries.Spheres)
+			{
+				bvhResult.clear();
+				bvh.QuerySphere(XMLoadFloat4(&sphere), sphere.w, bvhResult);
+			}
+		}) / queryCount;
+		for (const auto& sphere : queries.Spheres)
+		{
+			bruteResult.clear();
+			bvhResult.clear();
+			BruteSphere(minMax, XMLoadFloat4(&sphere), sphere.w, bruteResult);
+			bvh.QuerySphere(XMLoadFloat4(&sphere), sphere.w, bvhResult);
+			isSame = isSame && SameSet(bruteResult, bvhResult);
+		}
+		CHECK(isSame);
+		PrintRow("sphere (r 25), per query", count, bruteMs, bvhMs);
+
+		isSame = true;
+		bruteMs = MeasureMilliseconds([&]()
+		{
+			for (const auto& [min, max] : queries.Boxes)
+			{
+				bruteResult.clear();
+				BruteBox(minMax, XMLoadFloat3(&min), XMLoadFloat3(&max), bruteResult);
+			}
+		}) / queryCount;
+		bvhMs = MeasureMilliseconds([&]()
+		{
+			for (const auto& [min, max] : queries.Boxes)
+			{
+				BoundingBox box;
+				BoundingBox::CreateFromPoints(box, XMLoadFloat3(&min), XMLoadFloat3(&max));
+				bvhResult.clear();
+				bvh.QueryBox(box, bvhResult);
+			}
+		}) / queryCount;
+		for (const auto& [min, max] : queries.Boxes)
+		{
+			BoundingBox box;
+			BoundingBox::CreateFromPoints(box, XMLoadFloat3(&min), XMLoadFloat3(&max));
+			bruteResult.clear();
+			bvhResult.clear();
+			BruteBox(minMax, XMLoadFloat3(&min), XMLoadFloat3(&max), bruteResult);
+			bvh.QueryBox(box, bvhResult);
+			isSame = isSame && SameSet(bruteResult, bvhResult);
+		}
+		CHECK(isSame);
+		PrintRow("box (40^3), per query", count, bruteMs, bvhMs);
+
+		// Rays, closest hit
+		std::vector<float> bruteDistances(queryCount, -1.0f);
+		std::vector<float> bvhDistances(queryCount, -1.0f);
+		bruteMs = MeasureMilliseconds([&]()
+		{
+			for (int i = 0; i < queryCount; ++i)
+			{
+				float distance = 0.0f;
+				const auto& [origin, direction] = queries.Rays[i];
+				bruteDistances[i] = BruteRaycast(minMax, XMLoadFloat3(&origin), XMLoadFloat3(&direction), 2.0f * k_worldExtent, distance) ? distance : -1.0f;
+			}
+		}) / queryCount;
+		bvhMs = MeasureMilliseconds([&]()
+		{
+			for (int i = 0; i < queryCount; ++i)
+			{
+				float distance = 0.0f;
+				std::uint32_t primitive = 0;
+				const auto& [origin, direction] = queries.Rays[i];
+				bvhDistances[i] = bvh.Raycast(XMLoadFloat3(&origin), XMLoadFloat3(&direction), 2.0f * k_worldExtent, primitive, distance) ? distance : -1.0f;
+			}
+		}) / queryCount;
+		for (int i = 0; i < queryCount; ++i)
+		{
+			CHECK_NEAR(bruteDistances[i], bvhDistances[i], 1e-3);
+		}
+		PrintRow("raycast (closest hit), per ray", count, bruteMs, bvhMs);
+
+		std::printf("%-32s %10zu   build %.3f ms serial, %.3f ms on %u workers, refit %.3f ms\n", "", count,
+			serialBuildMs, parallelBuildMs, jobSystem.GetWorkerCount(), refitMs);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool isQuick = IsQuickRun(argc, argv);
+	std::vector<std::size_t> counts = isQuick ? std::vector<std::size_t>{ 10000 } : std::vector<std::size_t>{ 10000, 100000, 1000000 };
+	int repeatCount = isQuick ? 1 : 5;
+	int queryCount = isQuick ? 20 : 200;
+
+	JobSystem jobSystem;
+
+	PrintHeader("Scene BVH queries", "brute force", "Bvh");
+	for (auto count : counts)
+	{
+		Run(count, repeatCount, queryCount, jobSystem);
+	}
+
+	return Report("BvhBenchmark");
+}
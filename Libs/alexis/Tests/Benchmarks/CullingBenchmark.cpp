@@ -0,0 +1,151 @@
+#include <Precompiled.h>
+
+#include <random>
+
+#include <Core/JobSystem.h>
+#include <Render/Culling.h>
+#include <Render/RenderScene.h>
+#include <Utils/FrustumCulling.h>
+
+#include <Testing/Benchmark.h>
+#include <Testing/Check.h>
+
+// Sphere frustum culling at 10k / 100k / 1M models: per-model DirectXMath plane tests over AoS spheres
+// against utils::CullSpheres over the SoA proxy streams, then CullModels for all views on the JobSystem
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::testing;
+
+	constexpr float k_worldExtent = 1000.0f;
+
+	void FillModels(RenderScene::ModelProxies& models, std::vector<XMFLOAT4>& spheres, std::size_t count)
+	{
+		std::mt19937 random(3);
+		std::uniform_real_distribution<float> position(-k_worldExtent, k_worldExtent);
+		std::uniform_real_distribution<float> radius(0.5f, 8.0f);
+
+		models.Resize(count);
+		spheres.resize(count);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			spheres[i] = XMFLOAT4(position(random), position(random), position(random), radius(random));
+			models.SphereCenterX[i] = spheres[i].x;
+			models.SphereCenterY[i] = spheres[i].y;
+			models.SphereCenterZ[i] = spheres[i].z;
+			models.SphereRadius[i] = spheres[i].w;
+		}
+	}
+
+	// Main view looks along +Z from the origin, the others turn around Y like extra cameras or shadow views
+	void FillViews(RenderScene& renderScene)
+	{
+		for (std::size_t view = 0; view < RenderScene::k_viewCount; ++view)
+		{
+			float yaw = XM_2PI * static_cast<float>(view) / static_cast<float>(RenderScene::k_viewCount);
+			XMVECTOR position = XMVectorZero();
+			XMVECTOR direction = XMVectorSet(std::sin(yaw), 0.0f, std::cos(yaw), 0.0f);
+
+			XMMATRIX viewMatrix = XMMatrixLookToLH(position, direction, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+			XMMATRIX projMatrix = XMMatrixPerspectiveFovLH(XMConvertToRadians(60.0f), 16.0f / 9.0f, 0.1f, 600.0f);
+
+			BuildViewData(position, viewMatrix, XMMatrixInverse(nullptr, viewMatrix), projMatrix, XMMatrixInverse(nullptr, projMatrix), renderScene.Views[view]);
+		}
+	}
+
+	// What culling looks like without the SoA streams: one sphere at a time, one plane at a time
+	std::size_t CullSpheresScalar(const std::vector<XMFLOAT4>& spheres, const std::array<XMVECTOR, ViewData::PlaneCount>& planes, std::uint32_t* outVisible)
+	{
+		std::size_t visibleCount = 0;
+		for (std::size_t i = 0; i < spheres.size(); ++i)
+		{
+			XMVECTOR center = XMLoadFloat3(reinterpret_cast<const XMFLOAT3*>(&spheres[i]));
+			float negRadius = -spheres[i].w;
+
+			bool isVisible = true;
+			for (const auto& plane : planes)
+			{
+				if (XMVectorGetX(XMPlaneDotCoord(plane, center)) < negRadius)
+				{
+					isVisible = false;
+					break;
+				}
+			}
+
+			if (isVisible)
+			{
+				outVisible[visibleCount++] = static_cast<std::uint32_t>(i);
+			}
+		}
+
+		return visibleCount;
+	}
+
+	void Run(std::size_t count, int repeatCount, JobSystem& jobSystem)
+	{
+		auto renderScene = std::make_unique<RenderScene>();
+		std::vector<XMFLOAT4> spheres;
+		FillModels(renderScene->Models, spheres, count);
+		FillViews(*renderScene);
+
+		const auto& models = renderScene->Models;
+		const auto& planes = renderScene->Views[RenderScene::k_mainView].FrustumPlanes;
+
+		utils::SphereStreams streams;
+		streams.CenterX = models.SphereCenterX.data();
+		streams.CenterY = models.SphereCenterY.data();
+		streams.CenterZ = models.SphereCenterZ.data();
+		streams.Radius = models.SphereRadius.data();
+
+		std::vector<std::uint32_t> scalarVisible(count);
+		std::vector<std::uint32_t> simdVisible(count);
+		std::size_t scalarCount = 0;
+		std::size_t simdCount = 0;
+
+		double scalarMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			scalarCount = CullSpheresScalar(spheres, planes, scalarVisible.data());
+		});
+
+		double simdMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			simdCount = utils::CullSpheres(streams, 0, count, planes, simdVisible.data());
+		});
+
+		CHECK(scalarCount == simdCount);
+		CHECK(std::equal(scalarVisible.begin(), scalarVisible.begin() + std::min(scalarCount, simdCount), simdVisible.begin()));
+
+		// No BVH: CullModels takes the linear path over all views
+		double allViewsMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			CullModels(*renderScene, jobSystem);
+		});
+
+		CHECK(renderScene->VisibleModels[RenderScene::k_mainView].size() == simdCount);
+
+		PrintRow("one view, single thread", count, scalarMs, simdMs);
+		std::printf("%-32s %10zu %14s %11.3f ms   %zu views on %u workers, %.1f%% visible in main view\n", "CullModels", count, "",
+			allViewsMs, RenderScene::k_viewCount, jobSystem.GetWorkerCount(), 100.0 * static_cast<double>(simdCount) / static_cast<double>(count));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool isQuick = IsQuickRun(argc, argv);
+	std::vector<std::size_t> counts = isQuick ? std::vector<std::size_t>{ 10000 } : std::vector<std::size_t>{ 10000, 100000, 1000000 };
+	int repeatCount = isQuick ? 2 : 10;
+
+	JobSystem jobSystem;
+
+#if defined(__AVX2__)
+	PrintHeader("Sphere frustum culling (AVX2)", "DirectXMath", "CullSpheres");
+#else
+	PrintHeader("Sphere frustum culling (SSE)", "DirectXMath", "CullSpheres");
+#endif
+	for (auto count : counts)
+	{
+		Run(count, repeatCount, jobSystem);
+	}
+
+	return Report("CullingBenchmark");
+}
@@ -0,0 +1,254 @@
+#include <Precompiled.h>
+
+#include <cstdint>
+#include <random>
+
+#include <ECS/ECS.h>
+
+#include <Testing/Benchmark.h>
+#include <Testing/Check.h>
+
+#include "LegacyEcs.h"
+
+// Archetype chunk storage against the ComponentManager it replaced, at 10k / 100k / 1M entities
+namespace
+{
+	namespace legacy = alexis::testing::legacy;
+
+	struct Position
+	{
+		float X, Y, Z;
+	};
+
+	struct Velocity
+	{
+		float X, Y, Z;
+	};
+
+	struct Health
+	{
+		int Value;
+	};
+
+	struct LegacyMoveSystem : legacy::System
+	{
+	};
+
+	struct MoveSystem : alexis::ecs::System
+	{
+	};
+
+	struct Timings
+	{
+		double Create{ 0.0 };
+		double Iterate{ 0.0 };
+		double RandomGet{ 0.0 };
+		double AddRemove{ 0.0 };
+		double Destroy{ 0.0 };
+		double Checksum{ 0.0 };
+	};
+
+	constexpr int k_iterateRepeats = 5;
+
+	// Random subset of entity indices, same for both implementations
+	std::vector<std::uint32_t> MakeLookups(std::size_t entityCount)
+	{
+		std::mt19937 random(42);
+		std::uniform_int_distribution<std::uint32_t> distribution(0, static_cast<std::uint32_t>(entityCount - 1));
+
+		std::vector<std::uint32_t> lookups(std::min<std::size_t>(entityCount, 100000));
+		for (auto& lookup : lookups)
+		{
+			lookup = distribution(random);
+		}
+
+		return lookups;
+	}
+
+	Timings RunLegacy(std::size_t entityCount, const std::vector<std::uint32_t>& lookups)
+	{
+		using namespace legacy;
+
+		Timings timings;
+		auto world = std::make_unique<World>();
+
+		world->RegisterComponent<Position>();
+		world->RegisterComponent<Velocity>();
+		world->RegisterComponent<Health>();
+
+		auto moveSystem = world->RegisterSystem<LegacyMoveSystem>();
+		{
+			ComponentMask mask;
+			mask.set(world->GetComponentType<Position>());
+			mask.set(world->GetComponentType<Velocity>());
+			world->SetSystemComponentMask<LegacyMoveSystem>(mask);
+		}
+
+		std::vector<Entity> entities(entityCount);
+		timings.Create = alexis::testing::MeasureMilliseconds([&]()
+		{
+			for (std::size_t i = 0; i < entityCount; ++i)
+			{
+				entities[i] = world->CreateEntity();
+				world->AddComponent(entities[i], Position{ static_cast<float>(i), 0.0f, 0.0f });
+				world->AddComponent(entities[i], Velocity{ 1.0f, 2.0f, 3.0f });
+			}
+		});
+
+		// System update the way the old systems were written: walk the entity set, fetch each component
+		timings.Iterate = alexis::testing::MeasureBestMilliseconds(k_iterateRepeats, [&]()
+		{
+			for (Entity entity : moveSystem->Entities)
+			{
+				auto& position = world->GetComponent<Position>(entity);
+				const auto& velocity = world->GetComponent<Velocity>(entity);
+				position.X += velocity.X;
+				position.Y += velocity.Y;
+				position.Z += velocity.Z;
+			}
+		});
+
+		double sum = 0.0;
+		timings.RandomGet = alexis::testing::MeasureMilliseconds([&]()
+		{
+			for (std::uint32_t lookup : lookups)
+			{
+				sum += world->GetComponent<Position>(entities[lookup]).Y;
+			}
+		});
+		timings.Checksum = sum;
+
+		timings.AddRemove = alexis::testing::MeasureMilliseconds([&]()
+		{
+			for (Entity entity : entities)
+			{
+				world->AddComponent(entity, Health{ 100 });
+			}
+
+			for (Entity entity : entities)
+			{
+				world->RemoveComponent<Health>(entity);
+			}
+		});
+
+		timings.Destroy = alexis::testing::MeasureMilliseconds([&]()
+		{
+			for (Entity entity : entities)
+			{
+				world->DestroyEntity(entity);
+			}
+		});
+
+		return timings;
+	}
+
+	Timings RunArchetypes(std::size_t entityCount, const std::vector<std::uint32_t>& lookups)
+	{
+		using namespace alexis::ecs;
+
+		Timings timings;
+		auto world = std::make_unique<World>();
+		world->Init();
+
+		world->RegisterComponent<Position>();
+		world->RegisterComponent<Velocity>();
+		world->RegisterComponent<Health>();
+
+		world->RegisterSystem<MoveSystem>();
+		{
+			ComponentMask mask;
+			mask.set(world->GetComponentType<Position>());
+			mask.set(world->GetComponentType<Velocity>());
+			world->SetSystemComponentMask<MoveSystem>(mask);
+		}
+
+		std::vector<Entity> entities(entityCount);
+		timings.Create = alexis::testing::MeasureMilliseconds([&]()
+		{
+			for (std::size_t i = 0; i < entityCount; ++i)
+			{
+				entities[i] = world->CreateEntity();
+				world->AddComponent(entities[i], Position{ static_cast<float>(i), 0.0f, 0.0f });
+				world->AddComponent(entities[i], Velocity{ 1.0f, 2.0f, 3.0f });
+			}
+		});
+
+		timings.Iterate = alexis::testing::MeasureBestMilliseconds(k_iterateRepeats, [&]()
+		{
+			world->ForEachChunk<Position, const Velocity>([](std::size_t count, const Entity*, Position* positions, const Velocity* velocities)
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					positions[i].X += velocities[i].X;
+					positions[i].Y += velocities[i].Y;
+					positions[i].Z += velocities[i].Z;
+				}
+			});
+		});
+
+		double sum = 0.0;
+		timings.RandomGet = alexis::testing::MeasureMilliseconds([&]()
+		{
+			for (std::uint32_t lookup : lookups)
+			{
+				sum += world->GetComponent<const Position>(entities[lookup]).Y;
+			}
+		});
+		timings.Checksum = sum;
+
+		timings.AddRemove = alexis::testing::MeasureMilliseconds([&]()
+		{
+			for (Entity entity : entities)
+			{
+				world->AddComponent(entity, Health{ 100 });
+			}
+
+			for (Entity entity : entities)
+			{
+				world->RemoveComponent<Health>(entity);
+			}
+		});
+
+		timings.Destroy = alexis::testing::MeasureMilliseconds([&]()
+		{
+			for (Entity entity : entities)
+			{
+				world->DestroyEntity(entity);
+			}
+		});
+
+		return timings;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using namespace alexis::testing;
+
+	std::vector<std::size_t> sizes = { 10000, 100000, 1000000 };
+	if (IsQuickRun(argc, argv))
+	{
+		sizes.resize(1);
+	}
+
+	PrintHeader("ECS storage: per-type arrays + hash maps vs archetype chunks", "hash maps", "archetypes");
+
+	for (std::size_t size : sizes)
+	{
+		auto lookups = MakeLookups(size);
+
+		Timings legacyTimings = RunLegacy(size, lookups);
+		Timings timings = RunArchetypes(size, lookups);
+
+		// Both did the same work
+		CHECK(legacyTimings.Checksum == timings.Checksum);
+
+		PrintRow("create + add 2 components", size, legacyTimings.Create, timings.Create);
+		PrintRow("iterate Position += Velocity", size, legacyTimings.Iterate, timings.Iterate);
+		PrintRow("random GetComponent (100k max)", size, legacyTimings.RandomGet, timings.RandomGet);
+		PrintRow("add + remove component", size, legacyTimings.AddRemove, timings.AddRemove);
+		PrintRow("destroy", size, legacyTimings.Destroy, timings.Destroy);
+	}
+
+	return Report("EcsStorageBenchmark");
+}
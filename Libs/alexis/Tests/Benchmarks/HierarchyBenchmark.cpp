@@ -0,0 +1,252 @@
+#include <Precompiled.h>
+
+#include <Core/Core.h>
+
+#include <ECS/Components/HierarchyComponent.h>
+#include <ECS/Components/ModelComponent.h>
+#include <ECS/Components/TransformComponent.h>
+#include <ECS/Systems/TransformSystem.h>
+
+#include <Testing/Benchmark.h>
+#include <Testing/Check.h>
+
+// TransformSystem on deep (long chains) and wide (many children per root) hierarchies,
+// against a per-entity walk up the parent chain with memoized world matrices
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::ecs;
+	using namespace alexis::testing;
+
+	// Straightforward hierarchy update: every entity asks its parent for the world matrix, recursing up the chain.
+	// Recomputes everything, it has no change tracking
+	class ParentWalk
+	{
+	public:
+		void Update(World& world, const std::vector<Entity>& entities)
+		{
+			m_done.assign(m_done.size(), 0);
+			for (auto entity : entities)
+			{
+				if (entity.Index >= m_done.size())
+				{
+					m_done.resize(entity.Index + 1, 0);
+					m_worldMatrices.resize(entity.Index + 1);
+				}
+			}
+
+			for (auto entity : entities)
+			{
+				world.GetComponent<ModelComponent>(entity).ModelMatrix = Resolve(world, entity);
+			}
+		}
+
+		XMMATRIX GetWorldMatrix(Entity entity) const
+		{
+			return m_worldMatrices[entity.Index];
+		}
+
+	private:
+		XMMATRIX Resolve(World& world, Entity entity)
+		{
+			if (m_done[entity.Index])
+			{
+				return m_worldMatrices[entity.Index];
+			}
+
+			const auto& transform = world.GetComponent<const TransformComponent>(entity);
+			XMMATRIX scaling = XMMatrixScaling(transform.UniformScale, transform.UniformScale, transform.UniformScale);
+			XMMATRIX local = XMMatrixMultiply(XMMatrixMultiply(scaling, XMMatrixRotationQuaternion(transform.Rotation)), XMMatrixTranslationFromVector(transform.Position));
+
+			if (world.HasComponent<HierarchyComponent>(entity))
+			{
+				local = XMMatrixMultiply(local, Resolve(world, world.GetComponent<const HierarchyComponent>(entity).Parent));
+			}
+
+			m_done[entity.Index] = 1;
+			m_worldMatrices[entity.Index] = local;
+			return local;
+		}
+
+		std::vector<std::uint8_t> m_done;
+		std::vector<XMMATRIX> m_worldMatrices;
+	};
+
+	TransformSystem* Setup(World& world)
+	{
+		world.RegisterComponent<TransformComponent>();
+		world.RegisterComponent<HierarchyComponent>();
+		world.RegisterComponent<ModelComponent>();
+
+		auto* system = world.RegisterSystem<TransformSystem>().get();
+
+		ComponentMask mask;
+		mask.set(world.GetComponentType<TransformComponent>());
+		world.SetSystemComponentMask<TransformSystem>(mask);
+
+		return system;
+	}
+
+	void RunUpdate(World& world, TransformSystem& system)
+	{
+		std::uint32_t version = world.AdvanceChangeVersion();
+		system.Update(0.0f);
+		system.LastSystemVersion = version;
+	}
+
+	struct Shape
+	{
+		const char* Name;
+		// Nodes per root, including the root
+		std::size_t TreeSize;
+		// Node j of a tree hangs under node (j - 1) / Fanout: 1 gives a chain
+		std::size_t Fanout;
+	};
+
+	// Returns the roots, entities are in creation order
+	std::vector<Entity> CreateHierarchy(World& world, TransformSystem& system, std::size_t count, const Shape& shape, std::vector<Entity>& entities)
+	{
+		entities = world.CreateEntities(count);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			float t = static_cast<float>(i % shape.TreeSize);
+			world.AddComponent(entities[i], TransformComponent{ XMVectorSet(0.01f, 0.1f * t, 0.0f, 1.0f), XMQuaternionRotationRollPitchYaw(0.0f, 0.001f * t, 0.0f), 1.0f });
+			world.AddComponent(entities[i], ModelComponent{});
+		}
+
+		// Deepest nodes first: the parent is still unlinked, so the cycle check in SetParent stays one step
+		std::vector<Entity> roots;
+		for (std::size_t i = count; i-- > 0;)
+		{
+			std::size_t j = i % shape.TreeSize;
+			if (j == 0)
+			{
+				roots.push_back(entities[i]);
+			}
+			else
+			{
+				system.SetParent(entities[i], entities[i - j + (j - 1) / shape.Fanout]);
+			}
+		}
+
+		return roots;
+	}
+
+	void MoveRoots(World& world, const std::vector<Entity>& roots, std::size_t rootCount, float offset)
+	{
+		for (std::size_t i = 0; i < rootCount; ++i)
+		{
+			world.GetComponent<TransformComponent>(roots[i]).Position = XMVectorSet(offset, 0.0f, 0.0f, 1.0f);
+		}
+	}
+
+	struct Result
+	{
+		double WalkAllMs;
+		double SystemAllMs;
+		double WalkOneMs;
+		double SystemOneMs;
+		double BuildMs;
+		double IdleMs;
+	};
+
+	Result Run(const Shape& shape, std::size_t count, int repeatCount)
+	{
+		Result result;
+
+		Core::Create();
+		{
+			auto& world = Core::Get().GetECSWorld();
+			auto* system = Setup(world);
+
+			std::vector<Entity> entities;
+			std::vector<Entity> roots;
+			result.BuildMs = MeasureMilliseconds([&]()
+			{
+				roots = CreateHierarchy(world, *system, count, shape, entities);
+				RunUpdate(world, *system);
+			});
+
+			ParentWalk parentWalk;
+			float offset = 0.0f;
+
+			// Every root moved, or a single one
+			for (std::size_t rootCount : { roots.size(), std::size_t{ 1 } })
+			{
+				double walkMs = MeasureBestMilliseconds(repeatCount, [&]()
+				{
+					MoveRoots(world, roots, rootCount, offset += 1.0f);
+					parentWalk.Update(world, entities);
+				});
+
+				double systemMs = MeasureBestMilliseconds(repeatCount, [&]()
+				{
+					MoveRoots(world, roots, rootCount, offset += 1.0f);
+					RunUpdate(world, *system);
+				});
+
+				(rootCount == 1 ? result.WalkOneMs : result.WalkAllMs) = walkMs;
+				(rootCount == 1 ? result.SystemOneMs : result.SystemAllMs) = systemMs;
+			}
+
+			result.IdleMs = MeasureBestMilliseconds(repeatCount, [&]()
+			{
+				RunUpdate(world, *system);
+			});
+
+			// Both saw the same root positions
+			parentWalk.Update(world, entities);
+			for (auto entity : { entities[1], entities[count / 2], entities.back() })
+			{
+				XMVECTOR expected = parentWalk.GetWorldMatrix(entity).r[3];
+				XMVECTOR delta = XMVectorSubtract(system->GetWorldMatrix(entity).r[3], expected);
+				CHECK(XMVectorGetX(XMVector3Length(delta)) <= 1e-4f * (1.0f + XMVectorGetX(XMVector3Length(expected))));
+			}
+		}
+		Core::Destroy();
+
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool isQuick = IsQuickRun(argc, argv);
+	std::vector<std::size_t> counts = isQuick ? std::vector<std::size_t>{ 10000 } : std::vector<std::size_t>{ 10000, 100000, 1000000 };
+	int repeatCount = isQuick ? 2 : 5;
+
+	const Shape shapes[] = {
+		{ "deep (chains of 1000)", 1000, 1 },
+		{ "binary (trees of 65536)", 65536, 2 },
+		{ "wide (1000 children per root)", 1001, 1000 },
+	};
+
+	std::vector<std::pair<std::size_t, Result>> results;
+	for (auto count : counts)
+	{
+		for (const auto& shape : shapes)
+		{
+			results.push_back({ count, Run(shape, count, repeatCount) });
+		}
+	}
+
+	PrintHeader("Every root moved (whole hierarchy dirty)", "parent walk", "TransformSystem");
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+		PrintRow(shapes[i % std::size(shapes)].Name, results[i].first, results[i].second.WalkAllMs, results[i].second.SystemAllMs);
+	}
+
+	PrintHeader("One root moved", "parent walk", "TransformSystem");
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+		PrintRow(shapes[i % std::size(shapes)].Name, results[i].first, results[i].second.WalkOneMs, results[i].second.SystemOneMs);
+	}
+
+	std::printf("\n%-32s %10s %14s %14s\n", "TransformSystem", "count", "build+update", "nothing moved");
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+		std::printf("%-32s %10zu %11.3f ms %11.3f ms\n", shapes[i % std::size(shapes)].Name, results[i].first, results[i].second.BuildMs, results[i].second.IdleMs);
+	}
+
+	return Report("HierarchyBenchmark");
+}
@@ -0,0 +1,200 @@
+#include <Precompiled.h>
+
+#include <ctime>
+#include <thread>
+
+#include <Core/JobSystem.h>
+
+#include <Testing/Benchmark.h>
+#include <Testing/Check.h>
+
+// JobSystem scheduling overhead with empty jobs (Run + Wait, ParallelFor batches, nested Run in fib, RunAfter chains),
+// CPU burned by idle workers while a job waits for its dependency, and ParallelFor speedup over a serial loop as workers are added
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::testing;
+
+	constexpr int k_fibCutoff = 12;
+
+	int Fib(int n)
+	{
+		return n < 2 ? n : Fib(n - 1) + Fib(n - 2);
+	}
+
+	// One job per call down to the cutoff
+	int FibJobs(JobSystem& jobSystem, int n)
+	{
+		if (n < k_fibCutoff)
+		{
+			return Fib(n);
+		}
+
+		int left = 0;
+		JobCounter counter{ 0 };
+		jobSystem.Run([&jobSystem, &left, n]() { left = FibJobs(jobSystem, n - 1); }, &counter);
+		int right = FibJobs(jobSystem, n - 2);
+		jobSystem.Wait(counter);
+
+		return left + right;
+	}
+
+	void RunOverhead(std::uint32_t workerCount, std::size_t jobCount, int repeatCount)
+	{
+		JobSystem jobSystem(workerCount);
+
+		std::atomic<std::size_t> runCount{ 0 };
+		double runMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			JobCounter counter{ 0 };
+			for (std::size_t i = 0; i < jobCount; ++i)
+			{
+				jobSystem.Run([&runCount]() { runCount.fetch_add(1, std::memory_order_relaxed); }, &counter);
+			}
+			jobSystem.Wait(counter);
+		});
+		CHECK(runCount.load() == jobCount * repeatCount);
+
+		std::atomic<std::size_t> batchCount{ 0 };
+		double parallelForMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			jobSystem.ParallelFor(jobCount, 1, [&batchCount](std::size_t, std::size_t) { batchCount.fetch_add(1, std::memory_order_relaxed); });
+		});
+		CHECK(batchCount.load() == jobCount * repeatCount);
+
+		int fib = 0;
+		double fibMs = MeasureBestMilliseconds(repeatCount, [&]() { fib = FibJobs(jobSystem, 27); });
+		CHECK(fib == Fib(27));
+
+		// Every link waits for the previous one
+		const std::size_t chainLength = jobCount / 10;
+		std::vector<JobCounter> links(chainLength);
+		std::size_t lastLink = 0;
+		double chainMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			for (auto& link : links)
+			{
+				link.store(0);
+			}
+
+			jobSystem.Run([&lastLink]() { lastLink = 0; }, &links[0]);
+			for (std::size_t i = 1; i < chainLength; ++i)
+			{
+				jobSystem.RunAfter(links[i - 1], [&lastLink, i]() { lastLink = i; }, &links[i]);
+			}
+			jobSystem.Wait(links.back());
+		});
+		CHECK(lastLink == chainLength - 1);
+
+		std::printf("%8u %12.0f ns %12.0f ns %12.3f ms %12.0f ns\n", workerCount, 1e6 * runMs / jobCount, 1e6 * parallelForMs / jobCount, fibMs, 1e6 * chainMs / chainLength);
+	}
+
+	// Process CPU time of all threads. MSVC's clock() is wall time, the row is skipped there
+	void RunParkedIdle(std::uint32_t workerCount)
+	{
+#if !defined(_MSC_VER)
+		constexpr auto k_jobTime = std::chrono::milliseconds(60);
+		constexpr auto k_window = std::chrono::milliseconds(40);
+
+		JobSystem jobSystem(workerCount);
+
+		// Let the workers fall asleep
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+		JobCounter dependency{ 0 };
+		JobCounter done{ 0 };
+		std::clock_t start = std::clock();
+		jobSystem.Run([k_jobTime]() { std::this_thread::sleep_for(k_jobTime); }, &dependency);
+		jobSystem.RunAfter(dependency, []() {}, &done);
+		std::this_thread::sleep_for(k_window);
+		double cpuMs = 1000.0 * static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+		jobSystem.Wait(done);
+
+		std::printf("%8u %12.1f ms CPU in %lld ms\n", workerCount, cpuMs, static_cast<long long>(k_window.count()));
+#endif
+	}
+
+	// Pure arithmetic over a buffer, no shared writes
+	float Work(std::size_t i)
+	{
+		float x = static_cast<float>(i) * 1e-3f;
+		for (int k = 0; k < 64; ++k)
+		{
+			x = std::sqrt(x * x + 1.0f) * 0.999f;
+		}
+		return x;
+	}
+
+	void RunScaling(const std::vector<std::uint32_t>& workerCounts, std::size_t count, int repeatCount)
+	{
+		std::vector<float> results(count);
+		constexpr std::size_t k_batchSize = 1024;
+
+		double serialMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				results[i] = Work(i);
+			}
+			DoNotOptimize(results);
+		});
+		const std::vector<float> expected = results;
+
+		std::printf("\nParallelFor scaling, %zu items in batches of %zu, %u hardware threads\n", count, k_batchSize, std::thread::hardware_concurrency());
+		std::printf("%8s %14s %9s\n", "threads", "time", "speedup");
+		std::printf("%8s %11.3f ms %8.2fx\n", "serial", serialMs, 1.0);
+
+		for (auto workerCount : workerCounts)
+		{
+			JobSystem jobSystem(workerCount);
+			std::fill(results.begin(), results.end(), 0.0f);
+
+			double parallelMs = MeasureBestMilliseconds(repeatCount, [&]()
+			{
+				jobSystem.ParallelFor(count, k_batchSize, [&results](std::size_t begin, std::size_t end)
+				{
+					for (std::size_t i = begin; i < end; ++i)
+					{
+						results[i] = Work(i);
+					}
+				});
+				DoNotOptimize(results);
+			});
+			CHECK(results == expected);
+
+			// Workers plus the calling thread
+			std::printf("%8u %11.3f ms %8.2fx\n", workerCount + 1, parallelMs, serialMs / parallelMs);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool isQuick = IsQuickRun(argc, argv);
+	std::vector<std::uint32_t> workerCounts = isQuick ? std::vector<std::uint32_t>{ 3 } : std::vector<std::uint32_t>{ 1, 3, 7 };
+	std::size_t jobCount = isQuick ? 10000 : 100000;
+	int repeatCount = isQuick ? 1 : 10;
+
+	std::printf("\nJob system overhead per job, empty jobs\n");
+	std::printf("%8s %15s %15s %15s %15s\n", "workers", "Run + Wait", "ParallelFor", "fib(27) jobs", "RunAfter chain");
+	for (auto workerCount : workerCounts)
+	{
+		RunOverhead(workerCount, jobCount, repeatCount);
+	}
+
+	std::printf("\nIdle workers while a job waits for its dependency\n");
+	for (auto workerCount : workerCounts)
+	{
+		RunParkedIdle(workerCount);
+	}
+
+	std::uint32_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+	std::vector<std::uint32_t> scalingWorkers;
+	for (std::uint32_t threadCount = 2; threadCount <= std::max(hardwareThreads, 8u); threadCount *= 2)
+	{
+		scalingWorkers.push_back(threadCount - 1);
+	}
+	RunScaling(isQuick ? std::vector<std::uint32_t>{ 3 } : scalingWorkers, isQuick ? 1u << 14 : 1u << 20, repeatCount);
+
+	return Report("JobSystemBenchmark");
+}
@@ -0,0 +1,309 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <memory>
+#include <queue>
+#include <set>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace alexis
+{
+	namespace testing
+	{
+		// ECS of the baseline commit, trimmed to what the benchmarks use. The only changes are
+		// growable arrays instead of std::array<T, 5000> so that it reaches 1M entities,
+		// and RemoveComponent taking the entity only (the original did not compile when instantiated)
+		namespace legacy
+		{
+			using Entity = std::uint64_t;
+			using ComponentType = std::uint8_t;
+			using ComponentMask = std::bitset<32>;
+
+			class EntityManager
+			{
+			public:
+				Entity CreateEntity()
+				{
+					if (!m_availableEntities.empty())
+					{
+						Entity id = m_availableEntities.front();
+						m_availableEntities.pop();
+						return id;
+					}
+
+					m_componentMasks.emplace_back();
+					return m_componentMasks.size() - 1;
+				}
+
+				void DestroyEntity(Entity entity)
+				{
+					m_componentMasks[entity].reset();
+					m_availableEntities.push(entity);
+				}
+
+				void SetComponentMask(Entity entity, ComponentMask componentMask)
+				{
+					m_componentMasks[entity] = componentMask;
+				}
+
+				ComponentMask GetComponentMask(Entity entity)
+				{
+					return m_componentMasks[entity];
+				}
+
+			private:
+				std::queue<Entity> m_availableEntities;
+				std::vector<ComponentMask> m_componentMasks;
+			};
+
+			class IComponentArray
+			{
+			public:
+				virtual ~IComponentArray() = default;
+				virtual void EntityDestroyed(Entity entity) = 0;
+			};
+
+			template<class T>
+			class ComponentArray : public IComponentArray
+			{
+			public:
+				void InsertData(Entity entity, T& component)
+				{
+					std::size_t newIndex = m_size;
+					if (newIndex == m_componentArray.size())
+					{
+						m_componentArray.resize(std::max<std::size_t>(64, m_componentArray.size() * 2));
+					}
+
+					m_entityToIndexMap[entity] = newIndex;
+					m_indexToEntityMap[newIndex] = entity;
+					m_componentArray[newIndex] = std::move(component);
+					++m_size;
+				}
+
+				void RemoveData(Entity entity)
+				{
+					std::size_t indexOfRemovedEntity = m_entityToIndexMap[entity];
+					std::size_t indexOfLastElement = m_size - 1;
+
+					std::swap(m_componentArray[indexOfRemovedEntity], m_componentArray[indexOfLastElement]);
+
+					Entity entityOfLastElement = m_indexToEntityMap[indexOfLastElement];
+					m_entityToIndexMap[entityOfLastElement] = indexOfRemovedEntity;
+					m_indexToEntityMap[indexOfRemovedEntity] = entityOfLastElement;
+
+					m_entityToIndexMap.erase(entity);
+					m_indexToEntityMap.erase(indexOfLastElement);
+					--m_size;
+				}
+
+				T& GetData(Entity entity)
+				{
+					return m_componentArray[m_entityToIndexMap[entity]];
+				}
+
+				void EntityDestroyed(Entity entity) override
+				{
+					if (m_entityToIndexMap.find(entity) != m_entityToIndexMap.end())
+					{
+						RemoveData(entity);
+					}
+				}
+
+			private:
+				std::vector<T> m_componentArray;
+				std::unordered_map<Entity, std::size_t> m_entityToIndexMap;
+				std::unordered_map<Entity, std::size_t> m_indexToEntityMap;
+				std::size_t m_size{ 0 };
+			};
+
+			class ComponentManager
+			{
+			public:
+				template<class T>
+				void RegisterComponent()
+				{
+					const char* typeName = typeid(T).name();
+
+					m_componentTypes.insert({ typeName, m_nextComponentType });
+					m_componentArrays.insert({ typeName, std::make_shared<ComponentArray<T>>() });
+
+					++m_nextComponentType;
+				}
+
+				template<class T>
+				ComponentType GetComponentType()
+				{
+					return m_componentTypes[typeid(T).name()];
+				}
+
+				template<class T>
+				void AddComponent(Entity entity, T& component)
+				{
+					GetComponentArray<T>()->InsertData(entity, component);
+				}
+
+				template<class T>
+				void RemoveComponent(Entity entity)
+				{
+					GetComponentArray<T>()->RemoveData(entity);
+				}
+
+				template<class T>
+				T& GetComponent(Entity entity)
+				{
+					return GetComponentArray<T>()->GetData(entity);
+				}
+
+				void EntityDestroyed(Entity entity)
+				{
+					for (const auto& pair : m_componentArrays)
+					{
+						pair.second->EntityDestroyed(entity);
+					}
+				}
+
+			private:
+				std::unordered_map<const char*, ComponentType> m_componentTypes;
+				std::unordered_map<const char*, std::shared_ptr<IComponentArray>> m_componentArrays;
+				ComponentType m_nextComponentType{ 0 };
+
+				template<class T>
+				std::shared_ptr<ComponentArray<T>> GetComponentArray()
+				{
+					return std::static_pointer_cast<ComponentArray<T>>(m_componentArrays[typeid(T).name()]);
+				}
+			};
+
+			struct System
+			{
+				std::set<Entity> Entities;
+			};
+
+			class SystemManager
+			{
+			public:
+				template<class T>
+				std::shared_ptr<T> RegisterSystem()
+				{
+					auto system = std::make_shared<T>();
+					m_systems.insert({ typeid(T).name(), system });
+					return system;
+				}
+
+				template<class T>
+				void SetComponentMask(ComponentMask componentMask)
+				{
+					m_componentMasks.insert({ typeid(T).name(), componentMask });
+				}
+
+				void EntityDestroyed(Entity entity)
+				{
+					for (const auto& pair : m_systems)
+					{
+						pair.second->Entities.erase(entity);
+					}
+				}
+
+				void EntityComponentMaskChanged(Entity entity, ComponentMask componentMask)
+				{
+					for (const auto& pair : m_systems)
+					{
+						const auto& systemComponentMask = m_componentMasks[pair.first];
+
+						if ((componentMask & systemComponentMask) == systemComponentMask)
+						{
+							pair.second->Entities.insert(entity);
+						}
+						else
+						{
+							pair.second->Entities.erase(entity);
+						}
+					}
+				}
+
+			private:
+				std::unordered_map<const char*, ComponentMask> m_componentMasks;
+				std::unordered_map<const char*, std::shared_ptr<System>> m_systems;
+			};
+
+			class World
+			{
+			public:
+				Entity CreateEntity()
+				{
+					return m_entityManager.CreateEntity();
+				}
+
+				void DestroyEntity(Entity entity)
+				{
+					m_entityManager.DestroyEntity(entity);
+					m_componentManager.EntityDestroyed(entity);
+					m_systemManager.EntityDestroyed(entity);
+				}
+
+				template<class T>
+				void RegisterComponent()
+				{
+					m_componentManager.RegisterComponent<T>();
+				}
+
+				template<class T>
+				void AddComponent(Entity entity, T component)
+				{
+					m_componentManager.AddComponent<T>(entity, component);
+
+					auto componentMask = m_entityManager.GetComponentMask(entity);
+					componentMask.set(m_componentManager.GetComponentType<T>(), true);
+					m_entityManager.SetComponentMask(entity, componentMask);
+
+					m_systemManager.EntityComponentMaskChanged(entity, componentMask);
+				}
+
+				template<class T>
+				void RemoveComponent(Entity entity)
+				{
+					m_componentManager.RemoveComponent<T>(entity);
+
+					auto componentMask = m_entityManager.GetComponentMask(entity);
+					componentMask.set(m_componentManager.GetComponentType<T>(), false);
+					m_entityManager.SetComponentMask(entity, componentMask);
+
+					m_systemManager.EntityComponentMaskChanged(entity, componentMask);
+				}
+
+				template<class T>
+				T& GetComponent(Entity entity)
+				{
+					return m_componentManager.GetComponent<T>(entity);
+				}
+
+				template<class T>
+				ComponentType GetComponentType()
+				{
+					return m_componentManager.GetComponentType<T>();
+				}
+
+				template<class T>
+				std::shared_ptr<T> RegisterSystem()
+				{
+					return m_systemManager.RegisterSystem<T>();
+				}
+
+				template<class T>
+				void SetSystemComponentMask(ComponentMask componentMask)
+				{
+					m_systemManager.SetComponentMask<T>(componentMask);
+				}
+
+			private:
+				ComponentManager m_componentManager;
+				EntityManager m_entityManager;
+				SystemManager m_systemManager;
+			};
+		}
+	}
+}
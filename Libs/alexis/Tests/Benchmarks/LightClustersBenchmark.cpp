@@ -0,0 +1,221 @@
+#include <Precompiled.h>
+
+#include <random>
+
+#include <Core/JobSystem.h>
+#include <Utils/LightClusters.h>
+
+#include <Testing/Benchmark.h>
+#include <Testing/Check.h>
+
+// Clustered light binning at 1k / 10k lights (80% point, 20% spot) on the LightingSystem grid:
+// every light tested against every cluster bounding sphere, against LightClusters::Bin serial and on the JobSystem
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::testing;
+	using namespace alexis::utils;
+
+	constexpr std::uint32_t k_tilesX = 16;
+	constexpr std::uint32_t k_tilesY = 9;
+	constexpr std::uint32_t k_slices = 24;
+	constexpr float k_nearZ = 0.5f;
+	constexpr float k_farZ = 200.0f;
+
+	struct Lights
+	{
+		std::vector<float> CenterX;
+		std::vector<float> CenterY;
+		std::vector<float> CenterZ;
+		std::vector<float> Radius;
+		std::vector<LightCone> Cones;
+
+		SphereStreams GetSpheres() const
+		{
+			SphereStreams spheres;
+			spheres.CenterX = CenterX.data();
+			spheres.CenterY = CenterY.data();
+			spheres.CenterZ = CenterZ.data();
+			spheres.Radius = Radius.data();
+			return spheres;
+		}
+	};
+
+	// A town-sized area in front of the camera
+	Lights MakeLights(std::size_t count)
+	{
+		std::mt19937 random(11);
+		std::uniform_real_distribution<float> horizontal(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> height(0.0f, 20.0f);
+		std::uniform_real_distribution<float> depth(0.0f, 200.0f);
+		std::uniform_real_distribution<float> radius(1.0f, 8.0f);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> cosAngle(0.5f, 0.95f);
+
+		Lights lights;
+		std::size_t coneCount = count / 5;
+		for (std::size_t i = 0; i < count - coneCount; ++i)
+		{
+			lights.CenterX.push_back(horizontal(random));
+			lights.CenterY.push_back(height(random));
+			lights.CenterZ.push_back(depth(random));
+			lights.Radius.push_back(radius(random));
+		}
+
+		for (std::size_t i = 0; i < coneCount; ++i)
+		{
+			LightCone cone;
+			cone.Apex = XMFLOAT3(horizontal(random), height(random), depth(random));
+			cone.Range = 2.0f * radius(random);
+			XMStoreFloat3(&cone.Direction, XMVector3Normalize(XMVectorSet(unit(random), -1.0f, unit(random), 0.0f)));
+			cone.CosAngle = cosAngle(random);
+			lights.Cones.push_back(cone);
+		}
+
+		return lights;
+	}
+
+	// Straightforward clustering: view space bounding sphere of every light against every cluster bounding sphere
+	class BruteForceClusters
+	{
+	public:
+		BruteForceClusters(float projScaleX, float projScaleY)
+		{
+			float sliceScale = (k_slices - 1) / std::log(k_farZ / k_nearZ);
+			float sliceBias = 1.0f - std::log(k_nearZ) * sliceScale;
+
+			for (std::uint32_t slice = 0; slice < k_slices; ++slice)
+			{
+				float depths[2] = { slice == 0 ? 0.0f : std::exp((slice - sliceBias) / sliceScale), slice + 1 == k_slices ? k_farZ : std::exp((slice + 1 - sliceBias) / sliceScale) };
+
+				for (std::uint32_t y = 0; y < k_tilesY; ++y)
+				{
+					float v[2] = { 1.0f - 2.0f * (y + 1) / k_tilesY, 1.0f - 2.0f * y / k_tilesY };
+					for (std::uint32_t x = 0; x < k_tilesX; ++x)
+					{
+						float u[2] = { -1.0f + 2.0f * x / k_tilesX, -1.0f + 2.0f * (x + 1) / k_tilesX };
+
+						XMVECTOR boxMin = g_XMFltMax;
+						XMVECTOR boxMax = XMVectorNegate(g_XMFltMax);
+						for (int corner = 0; corner < 8; ++corner)
+						{
+							float z = depths[corner >> 2];
+							XMVECTOR point = XMVectorSet(u[corner & 1] * z / projScaleX, v[(corner >> 1) & 1] * z / projScaleY, z, 0.0f);
+							boxMin = XMVectorMin(boxMin, point);
+							boxMax = XMVectorMax(boxMax, point);
+						}
+
+						XMFLOAT4 sphere;
+						XMStoreFloat4(&sphere, XMVectorScale(XMVectorAdd(boxMin, boxMax), 0.5f));
+						sphere.w = 0.5f * XMVectorGetX(XMVector3Length(XMVectorSubtract(boxMax, boxMin)));
+						m_clusterSpheres.push_back(sphere);
+					}
+				}
+			}
+
+			m_lists.resize(m_clusterSpheres.size());
+		}
+
+		std::size_t Bin(FXMMATRIX view, const Lights& lights)
+		{
+			for (auto& list : m_lists)
+			{
+				list.clear();
+			}
+
+			auto binSphere = [this](std::uint32_t light, FXMVECTOR center, float radius)
+			{
+				for (std::size_t cluster = 0; cluster < m_clusterSpheres.size(); ++cluster)
+				{
+					XMVECTOR clusterSphere = XMLoadFloat4(&m_clusterSpheres[cluster]);
+					float distance = XMVectorGetX(XMVector3Length(XMVectorSubtract(clusterSphere, center)));
+					if (distance <= radius + m_clusterSpheres[cluster].w)
+					{
+						m_lists[cluster].push_back(light);
+					}
+				}
+			};
+
+			std::uint32_t light = 0;
+			for (std::size_t i = 0; i < lights.Radius.size(); ++i)
+			{
+				XMVECTOR center = XMVector3Transform(XMVectorSet(lights.CenterX[i], lights.CenterY[i], lights.CenterZ[i], 1.0f), view);
+				binSphere(light++, center, lights.Radius[i]);
+			}
+
+			// Cones by the sphere around apex and range
+			for (const auto& cone : lights.Cones)
+			{
+				binSphere(light++, XMVector3Transform(XMLoadFloat3(&cone.Apex), view), cone.Range);
+			}
+
+			std::size_t entryCount = 0;
+			for (const auto& list : m_lists)
+			{
+				entryCount += list.size();
+			}
+
+			return entryCount;
+		}
+
+	private:
+		std::vector<XMFLOAT4> m_clusterSpheres;
+		std::vector<std::vector<std::uint32_t>> m_lists;
+	};
+
+	void Run(std::size_t count, int repeatCount, JobSystem& jobSystem)
+	{
+		Lights lights = MakeLights(count);
+
+		XMMATRIX view = XMMatrixLookToLH(XMVectorSet(0.0f, 10.0f, -10.0f, 1.0f), XMVector3Normalize(XMVectorSet(0.0f, -0.2f, 1.0f, 0.0f)), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		float projScaleY = 1.0f / std::tan(0.5f * XM_PIDIV4);
+		float projScaleX = projScaleY / (16.0f / 9.0f);
+
+		BruteForceClusters bruteForce(projScaleX, projScaleY);
+		std::size_t bruteEntryCount = 0;
+		double bruteMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			bruteEntryCount = bruteForce.Bin(view, lights);
+		});
+
+		LightClusters clusters;
+		clusters.SetGrid(k_tilesX, k_tilesY, k_slices, k_nearZ, k_farZ, projScaleX, projScaleY);
+
+		double serialMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			clusters.Bin(view, lights.GetSpheres(), lights.Radius.size(), lights.Cones.data(), lights.Cones.size());
+		});
+		std::vector<std::uint32_t> serialIndices = clusters.GetLightIndices();
+
+		double parallelMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			clusters.Bin(view, lights.GetSpheres(), lights.Radius.size(), lights.Cones.data(), lights.Cones.size(), &jobSystem);
+		});
+
+		CHECK(!serialIndices.empty());
+		CHECK(clusters.GetLightIndices() == serialIndices);
+
+		PrintRow("Bin, single thread", count, bruteMs, serialMs);
+		std::printf("%-32s %10zu %14s %11.3f ms   %u workers; %.1f vs %.1f lights per cluster\n", "Bin on JobSystem", count, "", parallelMs, jobSystem.GetWorkerCount(),
+			static_cast<double>(bruteEntryCount) / clusters.GetClusterCount(), static_cast<double>(serialIndices.size()) / clusters.GetClusterCount());
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool isQuick = IsQuickRun(argc, argv);
+	std::vector<std::size_t> counts = isQuick ? std::vector<std::size_t>{ 1000 } : std::vector<std::size_t>{ 1000, 10000 };
+	int repeatCount = isQuick ? 1 : 10;
+
+	JobSystem jobSystem;
+
+	char title[128];
+	std::snprintf(title, sizeof(title), "Light binning, %ux%ux%u clusters", k_tilesX, k_tilesY, k_slices);
+	PrintHeader(title, "brute force", "LightClusters");
+	for (auto count : counts)
+	{
+		Run(count, repeatCount, jobSystem);
+	}
+
+	return Report("LightClustersBenchmark");
+}
@@ -0,0 +1,104 @@
+#include <Precompiled.h>
+
+#include <random>
+
+#include <ECS/Components/TransformComponent.h>
+#include <Utils/MatrixBatch.h>
+
+#include <Testing/Benchmark.h>
+#include <Testing/Check.h>
+
+// World matrix throughput: per-transform DirectXMath composition, as ModelSystem did before TransformSystem,
+// against gathering into TransformBatch and running BatchWorldMatrices
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::testing;
+
+	std::vector<ecs::TransformComponent> MakeTransforms(std::size_t count)
+	{
+		std::mt19937 random(11);
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+		std::uniform_real_distribution<float> scale(0.1f, 10.0f);
+
+		std::vector<ecs::TransformComponent> transforms(count);
+		for (auto& transform : transforms)
+		{
+			transform.Position = XMVectorSet(position(random), position(random), position(random), 1.0f);
+			transform.Rotation = XMQuaternionRotationRollPitchYaw(angle(random), angle(random), angle(random));
+			transform.UniformScale = scale(random);
+		}
+
+		return transforms;
+	}
+
+	void Run(std::size_t count, int repeatCount)
+	{
+		auto transforms = MakeTransforms(count);
+		std::vector<XMMATRIX> scalarWorlds(count);
+		std::vector<XMMATRIX> batchWorlds(count);
+
+		double scalarMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const auto& transform = transforms[i];
+				XMMATRIX scaling = XMMatrixScaling(transform.UniformScale, transform.UniformScale, transform.UniformScale);
+				scalarWorlds[i] = XMMatrixMultiply(XMMatrixMultiply(scaling, XMMatrixRotationQuaternion(transform.Rotation)), XMMatrixTranslationFromVector(transform.Position));
+			}
+			DoNotOptimize(scalarWorlds);
+		});
+
+		utils::TransformBatch batch;
+		batch.Reserve(count);
+
+		// Gather included: TransformSystem pays for it every update
+		double batchMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			batch.Clear();
+			for (const auto& transform : transforms)
+			{
+				batch.Add(transform.Position, transform.Rotation, transform.UniformScale);
+			}
+			utils::BatchWorldMatrices(batch.GetStreams(), count, batchWorlds.data(), sizeof(XMMATRIX));
+			DoNotOptimize(batchWorlds);
+		});
+
+		double kernelMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			utils::BatchWorldMatrices(batch.GetStreams(), count, batchWorlds.data(), sizeof(XMMATRIX));
+			DoNotOptimize(batchWorlds);
+		});
+
+		for (std::size_t i = 0; i < count; i += count / 16 + 1)
+		{
+			CHECK(XMVector4NearEqual(scalarWorlds[i].r[0], batchWorlds[i].r[0], XMVectorReplicate(1e-3f)));
+			CHECK(XMVector4NearEqual(scalarWorlds[i].r[3], batchWorlds[i].r[3], XMVectorReplicate(1e-3f)));
+		}
+
+		PrintRow("gather + BatchWorldMatrices", count, scalarMs, batchMs);
+		PrintRow("BatchWorldMatrices only", count, scalarMs, kernelMs);
+		std::printf("%-32s %10s %25.1f M matrices/s\n", "", "", static_cast<double>(count) / kernelMs * 1e-3);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool isQuick = IsQuickRun(argc, argv);
+	std::vector<std::size_t> counts = isQuick ? std::vector<std::size_t>{ 10000 } : std::vector<std::size_t>{ 10000, 100000, 1000000 };
+	int repeatCount = isQuick ? 2 : 10;
+
+#if defined(__AVX2__)
+	const char* title = "World matrices (AVX2 kernel)";
+#else
+	const char* title = "World matrices (SSE kernel)";
+#endif
+	PrintHeader(title, "DirectXMath", "batch");
+	for (auto count : counts)
+	{
+		Run(count, repeatCount);
+	}
+
+	return Report("MatrixBatchBenchmark");
+}
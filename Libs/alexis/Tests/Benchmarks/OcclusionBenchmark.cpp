@@ -0,0 +1,188 @@
+#include <Precompiled.h>
+
+#include <random>
+
+#include <Core/JobSystem.h>
+#include <Render/Culling.h>
+#include <Render/Mesh.h>
+#include <Render/OcclusionCulling.h>
+#include <Render/RenderScene.h>
+
+#include <Testing/Benchmark.h>
+#include <Testing/Check.h>
+
+#include "SceneLoader.h"
+
+// Cull rates of OcclusionCuller on the shipped scenes. The main view turns around the scene camera position,
+// every direction is frustum culled by CullModels then occlusion culled. The occluder work stays within the
+// OcclusionCuller budget in every direction, and full runs check the worst direction against k_budgetMs
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::testing;
+
+	constexpr int k_directionCount = 12;
+
+	// Time OcclusionCuller::Cull may take per frame, on one core
+	constexpr double k_budgetMs = 0.5;
+
+	struct SceneCase
+	{
+		const char* Name;
+		const char* Path;
+		// Small cubes scattered in the scene bounds, a crowded variant of the scene
+		std::size_t ExtraCubeCount;
+	};
+
+	// Same as ModelSystem::Extract
+	void FillModels(RenderScene::ModelProxies& models, const std::vector<SceneModel>& sceneModels)
+	{
+		models.Resize(sceneModels.size());
+		for (std::size_t proxy = 0; proxy < sceneModels.size(); ++proxy)
+		{
+			const auto& model = sceneModels[proxy];
+			models.WorldMatrices[proxy] = model.WorldMatrix;
+			models.Meshes[proxy] = model.Mesh;
+
+			BoundingSphere worldSphere;
+			model.Mesh->GetBoundingSphere().Transform(worldSphere, model.WorldMatrix);
+			models.SphereCenterX[proxy] = worldSphere.Center.x;
+			models.SphereCenterY[proxy] = worldSphere.Center.y;
+			models.SphereCenterZ[proxy] = worldSphere.Center.z;
+			models.SphereRadius[proxy] = worldSphere.Radius;
+
+			model.Mesh->GetBoundingBox().Transform(models.Boxes[proxy], model.WorldMatrix);
+		}
+	}
+
+	void AddCubes(SceneLoader& loader, std::vector<SceneModel>& sceneModels, std::size_t count)
+	{
+		BoundingBox bounds = sceneModels.front().Mesh->GetBoundingBox();
+		bounds.Transform(bounds, sceneModels.front().WorldMatrix);
+
+		std::mt19937 random(21);
+		std::uniform_real_distribution<float> unit(-0.9f, 0.9f);
+		std::uniform_real_distribution<float> scale(0.1f, 0.4f);
+		std::uniform_real_distribution<float> angle(0.0f, XM_2PI);
+
+		auto* cube = loader.GetMesh("Resources/Models/Cube.DAE");
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			float s = scale(random);
+			XMMATRIX world = XMMatrixMultiply(XMMatrixMultiply(XMMatrixScaling(s, s, s), XMMatrixRotationRollPitchYaw(angle(random), angle(random), 0.0f)),
+				XMMatrixTranslation(bounds.Center.x + unit(random) * bounds.Extents.x, bounds.Center.y + unit(random) * bounds.Extents.y, bounds.Center.z + unit(random) * bounds.Extents.z));
+			sceneModels.push_back({ cube, world });
+		}
+	}
+
+	// Only the main view matters here, the other views get the same frustum
+	void FillViews(RenderScene& renderScene, const SceneCamera& camera, float yaw)
+	{
+		XMVECTOR position = XMLoadFloat3(&camera.Position);
+		XMVECTOR direction = XMVectorSet(std::sin(yaw), 0.0f, std::cos(yaw), 0.0f);
+
+		XMMATRIX view = XMMatrixLookToLH(position, direction, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		XMMATRIX proj = XMMatrixPerspectiveFovLH(XMConvertToRadians(camera.Fov), camera.AspectRatio, camera.NearZ, camera.FarZ);
+
+		for (auto& viewData : renderScene.Views)
+		{
+			BuildViewData(position, view, XMMatrixInverse(nullptr, view), proj, XMMatrixInverse(nullptr, proj), viewData);
+		}
+	}
+
+	struct Result
+	{
+		std::size_t ModelCount{ 0 };
+		std::size_t FrustumVisibleCount{ 0 };
+		std::size_t OccludedCount{ 0 };
+		std::size_t OccluderCount{ 0 };
+		std::size_t TriangleCount{ 0 };
+		double TotalMs{ 0.0 };
+		double MaxMs{ 0.0 };
+	};
+
+	bool Run(const SceneCase& sceneCase, int repeatCount, JobSystem& jobSystem, Result& result)
+	{
+		SceneLoader loader(ALEXIS_RESOURCES_ROOT);
+
+		std::vector<SceneModel> sceneModels;
+		SceneCamera camera;
+		if (!loader.LoadScene(sceneCase.Path, sceneModels, camera) || sceneModels.empty())
+		{
+			return false;
+		}
+		AddCubes(loader, sceneModels, sceneCase.ExtraCubeCount);
+
+		auto renderScene = std::make_unique<RenderScene>();
+		FillModels(renderScene->Models, sceneModels);
+
+		OcclusionCuller culler;
+		auto& visible = renderScene->VisibleModels[RenderScene::k_mainView];
+
+		result.ModelCount = sceneModels.size();
+		for (int direction = 0; direction < k_directionCount; ++direction)
+		{
+			FillViews(*renderScene, camera, XM_2PI * static_cast<float>(direction) / k_directionCount);
+			CullModels(*renderScene, jobSystem);
+
+			const std::vector<std::uint32_t> frustumVisible = visible;
+
+			double bestMs = std::numeric_limits<double>::max();
+			for (int repeat = 0; repeat < repeatCount; ++repeat)
+			{
+				visible = frustumVisible;
+				bestMs = std::min(bestMs, MeasureMilliseconds([&]() { culler.Cull(*renderScene, jobSystem); }));
+			}
+
+			// Occlusion only removes models, in order
+			const auto& stats = culler.GetStats();
+			CHECK(std::includes(frustumVisible.begin(), frustumVisible.end(), visible.begin(), visible.end()));
+			CHECK(stats.OccludedCount == frustumVisible.size() - visible.size());
+			CHECK(stats.TriangleCount <= OcclusionCuller::k_maxTriangles);
+			CHECK(stats.Coverage <= OcclusionCuller::k_maxCoverage);
+
+			result.FrustumVisibleCount += frustumVisible.size();
+			result.OccludedCount += stats.OccludedCount;
+			result.OccluderCount += stats.OccluderCount;
+			result.TriangleCount += stats.TriangleCount;
+			result.TotalMs += bestMs;
+			result.MaxMs = std::max(result.MaxMs, bestMs);
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool isQuick = IsQuickRun(argc, argv);
+	int repeatCount = isQuick ? 2 : 20;
+
+	const SceneCase sceneCases[] = {
+		{ "sgc", "Resources/Scenes/sgc.scene", 0 },
+		{ "PBR_test", "Resources/Scenes/PBR_test.scene", 0 },
+		{ "sgc + 5000 cubes", "Resources/Scenes/sgc.scene", 5000 },
+	};
+
+	JobSystem jobSystem;
+
+	std::printf("\nOcclusion culling, %d view directions per scene, %u workers\n", k_directionCount, jobSystem.GetWorkerCount());
+	std::printf("%-20s %8s %10s %10s %8s %10s %10s %12s %12s\n", "scene", "models", "in frustum", "occluded", "rate", "occluders", "triangles", "mean", "max");
+	for (const auto& sceneCase : sceneCases)
+	{
+		Result result;
+		CHECK(Run(sceneCase, repeatCount, jobSystem, result));
+		if (!isQuick)
+		{
+			CHECK(result.MaxMs <= k_budgetMs);
+		}
+
+		double rate = result.FrustumVisibleCount ? 100.0 * static_cast<double>(result.OccludedCount) / static_cast<double>(result.FrustumVisibleCount) : 0.0;
+		std::printf("%-20s %8zu %10.1f %10.1f %7.1f%% %10.1f %10.1f %9.1f us %9.1f us\n", sceneCase.Name, result.ModelCount,
+			static_cast<double>(result.FrustumVisibleCount) / k_directionCount, static_cast<double>(result.OccludedCount) / k_directionCount, rate,
+			static_cast<double>(result.OccluderCount) / k_directionCount, static_cast<double>(result.TriangleCount) / k_directionCount,
+			1000.0 * result.TotalMs / k_directionCount, 1000.0 * result.MaxMs);
+	}
+
+	return Report("OcclusionBenchmark");
+}
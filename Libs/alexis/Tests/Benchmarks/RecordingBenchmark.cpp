@@ -0,0 +1,158 @@
+#include <Precompiled.h>
+
+#include <cstring>
+#include <thread>
+
+#include <Core/JobSystem.h>
+#include <Utils/DrawRanges.h>
+
+#include <Testing/Benchmark.h>
+#include <Testing/Check.h>
+
+// Draw list recording split in ranges the way FrameRenderGraph::Render does it, at 1, 3 and 7 workers.
+// A recorded draw is a stand-in for ModelSystem::Render: camera and model constants copied into the upload block of
+// the context, then a few command words. Serial records the whole list into one context on the calling thread
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::testing;
+
+	// Same as FrameRenderGraph
+	constexpr std::size_t k_minDrawsPerContext = 128;
+
+	// D3D12 constant buffer placement
+	constexpr std::size_t k_constantAlignment = 256;
+
+	struct alignas(16) CameraConstants
+	{
+		XMMATRIX View;
+		XMMATRIX Proj;
+	};
+
+	struct Context
+	{
+		std::vector<std::byte> Upload;
+		std::size_t UploadOffset{ 0 };
+		std::vector<std::uint32_t> Commands;
+
+		void Reset()
+		{
+			UploadOffset = 0;
+			Commands.clear();
+		}
+
+		std::uint32_t SetConstants(const void* data, std::size_t size)
+		{
+			std::size_t offset = UploadOffset;
+			UploadOffset += (size + k_constantAlignment - 1) & ~(k_constantAlignment - 1);
+			if (UploadOffset > Upload.size())
+			{
+				Upload.resize(2 * UploadOffset);
+			}
+
+			std::memcpy(Upload.data() + offset, data, size);
+			return static_cast<std::uint32_t>(offset);
+		}
+	};
+
+	struct Scene
+	{
+		CameraConstants Camera;
+		std::vector<XMMATRIX> WorldMatrices;
+		std::vector<std::uint32_t> MaterialIds;
+		std::vector<std::uint32_t> MeshIds;
+	};
+
+	void Record(const Scene& scene, Context& context, std::size_t first, std::size_t last)
+	{
+		for (std::size_t draw = first; draw < last; ++draw)
+		{
+			context.Commands.push_back(scene.MaterialIds[draw]);
+			context.Commands.push_back(context.SetConstants(&scene.Camera, sizeof(scene.Camera)));
+			context.Commands.push_back(context.SetConstants(&scene.WorldMatrices[draw], sizeof(XMMATRIX)));
+			context.Commands.push_back(scene.MeshIds[draw]);
+		}
+	}
+
+	Scene MakeScene(std::size_t drawCount)
+	{
+		Scene scene;
+		scene.Camera.View = XMMatrixLookToLH(XMVectorZero(), XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		scene.Camera.Proj = XMMatrixPerspectiveFovLH(XMConvertToRadians(60.0f), 16.0f / 9.0f, 0.1f, 600.0f);
+		for (std::size_t draw = 0; draw < drawCount; ++draw)
+		{
+			scene.WorldMatrices.push_back(XMMatrixTranslation(static_cast<float>(draw), 0.0f, 0.0f));
+			scene.MaterialIds.push_back(static_cast<std::uint32_t>(draw % 16));
+			scene.MeshIds.push_back(static_cast<std::uint32_t>(draw % 64));
+		}
+
+		return scene;
+	}
+
+	void Run(std::size_t drawCount, std::uint32_t workerCount, int repeatCount)
+	{
+		JobSystem jobSystem(workerCount);
+		const Scene scene = MakeScene(drawCount);
+
+		const std::size_t rangeCount = utils::GetDrawRangeCount(drawCount, k_minDrawsPerContext, jobSystem.GetWorkerCount() + 1);
+		std::vector<Context> contexts(rangeCount);
+
+		Context serialContext;
+		double serialMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			serialContext.Reset();
+			Record(scene, serialContext, 0, drawCount);
+		});
+
+		double rangesMs = MeasureBestMilliseconds(repeatCount, [&]()
+		{
+			JobCounter recordCounter{ 0 };
+			for (std::size_t range = 0; range < rangeCount; ++range)
+			{
+				std::size_t first = utils::GetDrawRangeStart(drawCount, rangeCount, range);
+				std::size_t last = utils::GetDrawRangeStart(drawCount, rangeCount, range + 1);
+				auto* context = &contexts[range];
+				jobSystem.Run([&scene, context, first, last]()
+				{
+					context->Reset();
+					Record(scene, *context, first, last);
+				}, &recordCounter);
+			}
+			jobSystem.Wait(recordCounter);
+		});
+
+		// Ranges cover the list once, in order
+		std::size_t commandCount = 0;
+		for (const auto& context : contexts)
+		{
+			commandCount += context.Commands.size();
+		}
+		CHECK(commandCount == serialContext.Commands.size());
+		CHECK(contexts.front().Commands.front() == serialContext.Commands.front());
+		CHECK(contexts.back().Commands.back() == serialContext.Commands.back());
+
+		char name[64];
+		std::snprintf(name, sizeof(name), "%u workers, %zu ranges", jobSystem.GetWorkerCount(), rangeCount);
+		PrintRow(name, drawCount, serialMs, rangesMs);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool isQuick = IsQuickRun(argc, argv);
+	std::vector<std::size_t> drawCounts = isQuick ? std::vector<std::size_t>{ 1000 } : std::vector<std::size_t>{ 1000, 4000, 16000 };
+	int repeatCount = isQuick ? 2 : 50;
+
+	char title[64];
+	std::snprintf(title, sizeof(title), "Draw recording split in ranges, %u hardware threads", std::thread::hardware_concurrency());
+	PrintHeader(title, "serial", "ranges");
+	for (auto drawCount : drawCounts)
+	{
+		for (std::uint32_t workerCount : { 1u, 3u, 7u })
+		{
+			Run(drawCount, workerCount, repeatCount);
+		}
+	}
+
+	return Report("RecordingBenchmark");
+}
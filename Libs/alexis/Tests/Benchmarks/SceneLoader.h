@@ -0,0 +1,283 @@
+#pragma once
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <json.hpp>
+
+#include <Render/Mesh.h>
+
+// Loads the shipped scenes without Assimp or the editor: model entities and the camera of a .scene file,
+// meshes are read from their COLLADA files and transformed the way ResourceManager imports them
+// (node matrices applied, converted to left handed). Only positions and triangles are read, enough for culling
+namespace alexis
+{
+	namespace testing
+	{
+		struct SceneModel
+		{
+			alexis::Mesh* Mesh;
+			DirectX::XMMATRIX WorldMatrix;
+		};
+
+		struct SceneCamera
+		{
+			DirectX::XMFLOAT3 Position{ 0.0f, 0.0f, 0.0f };
+			float Fov{ 45.0f };
+			float AspectRatio{ 16.0f / 9.0f };
+			float NearZ{ 0.01f };
+			float FarZ{ 100.0f };
+		};
+
+		class SceneLoader
+		{
+		public:
+			// root is the directory scene and mesh paths are relative to (Build)
+			explicit SceneLoader(fs::path root) :
+				m_root(std::move(root))
+			{
+			}
+
+			bool LoadScene(const std::string& scenePath, std::vector<SceneModel>& outModels, SceneCamera& outCamera)
+			{
+				std::ifstream file(Resolve(scenePath));
+				if (!file)
+				{
+					return false;
+				}
+
+				auto scene = nlohmann::json::parse(file);
+				for (auto& entity : scene["entities"])
+				{
+					auto& components = entity["components"];
+					if (!components.contains("TransformComponent"))
+					{
+						continue;
+					}
+
+					const auto& transform = components["TransformComponent"];
+					const auto& position = transform["position"];
+					const auto& rotation = transform["rotation"];
+					float scale = transform["scale"];
+
+					if (components.contains("CameraComponent"))
+					{
+						const auto& camera = components["CameraComponent"];
+						outCamera.Position = XMFLOAT3(position["x"], position["y"], position["z"]);
+						outCamera.Fov = camera["fov"];
+						outCamera.AspectRatio = camera["aspectRatio"];
+						outCamera.NearZ = camera["nearZ"];
+						outCamera.FarZ = camera["farZ"];
+					}
+
+					if (components.contains("ModelComponent"))
+					{
+						auto* mesh = GetMesh(components["ModelComponent"]["mesh"]);
+						if (!mesh)
+						{
+							return false;
+						}
+
+						// Same as TransformSystem: scale, rotation, translation
+						XMVECTOR quaternion = XMQuaternionRotationRollPitchYaw(XMConvertToRadians(rotation["x"]), XMConvertToRadians(rotation["y"]), XMConvertToRadians(rotation["z"]));
+						XMMATRIX world = XMMatrixMultiply(XMMatrixMultiply(XMMatrixScaling(scale, scale, scale), XMMatrixRotationQuaternion(quaternion)),
+							XMMatrixTranslation(position["x"], position["y"], position["z"]));
+
+						outModels.push_back({ mesh, world });
+					}
+				}
+
+				return true;
+			}
+
+			// Meshes are loaded once and live as long as the loader
+			alexis::Mesh* GetMesh(const std::string& meshPath)
+			{
+				auto it = m_meshes.find(meshPath);
+				if (it == m_meshes.end())
+				{
+					it = m_meshes.emplace(meshPath, LoadCollada(Resolve(meshPath))).first;
+				}
+
+				return it->second.get();
+			}
+
+		private:
+			// Scenes were written on Windows, file names do not always match the case on disk
+			fs::path Resolve(const std::string& path) const
+			{
+				fs::path result = m_root;
+				for (const auto& part : fs::path(path))
+				{
+					fs::path exact = result / part;
+					if (fs::exists(exact) || !fs::is_directory(result))
+					{
+						result = exact;
+						continue;
+					}
+
+					for (const auto& entry : fs::directory_iterator(result))
+					{
+						if (ToLower(entry.path().filename().string()) == ToLower(part.string()))
+						{
+							exact = entry.path();
+							break;
+						}
+					}
+					result = exact;
+				}
+
+				return result;
+			}
+
+			static std::string ToLower(std::string text)
+			{
+				std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+				return text;
+			}
+
+			// Value of attribute name in the tag starting at tagBegin
+			static std::string GetAttribute(const std::string& text, std::size_t tagBegin, const char* name)
+			{
+				std::size_t tagEnd = text.find('>', tagBegin);
+				std::size_t at = text.find(std::string(" ") + name + "=\"", tagBegin);
+				if (at == std::string::npos || at > tagEnd)
+				{
+					return {};
+				}
+
+				at += std::strlen(name) + 3;
+				return text.substr(at, text.find('"', at) - at);
+			}
+
+			// Whitespace separated numbers between the end of the tag at tagBegin and the next '<'
+			template<class T>
+			static std::vector<T> ReadValues(const std::string& text, std::size_t tagBegin)
+			{
+				std::size_t begin = text.find('>', tagBegin) + 1;
+				std::istringstream stream(text.substr(begin, text.find('<', begin) - begin));
+
+				std::vector<T> values;
+				T value;
+				while (stream >> value)
+				{
+					values.push_back(value);
+				}
+
+				return values;
+			}
+
+			static std::unique_ptr<alexis::Mesh> LoadCollada(const fs::path& path)
+			{
+				std::ifstream file(path);
+				if (!file)
+				{
+					return nullptr;
+				}
+
+				std::stringstream buffer;
+				buffer << file.rdbuf();
+				const std::string text = buffer.str();
+
+				// Geometry id -> positions and the position index of every triangle corner
+				struct Geometry
+				{
+					std::vector<float> Positions;
+					std::vector<std::uint32_t> Corners;
+				};
+				std::unordered_map<std::string, Geometry> geometries;
+
+				for (std::size_t at = text.find("<geometry "); at != std::string::npos; at = text.find("<geometry ", at + 1))
+				{
+					std::size_t end = text.find("</geometry>", at);
+					auto& geometry = geometries[GetAttribute(text, at, "id")];
+
+					std::size_t positions = text.find("-POSITION-array\"", at);
+					if (positions == std::string::npos || positions > end)
+					{
+						continue;
+					}
+					geometry.Positions = ReadValues<float>(text, positions);
+
+					for (std::size_t triangles = text.find("<triangles", at); triangles < end; triangles = text.find("<triangles", triangles + 1))
+					{
+						std::size_t trianglesEnd = text.find("</triangles>", triangles);
+
+						// Corners interleave one index per input, VERTEX is the position
+						std::size_t inputCount = 0;
+						std::size_t vertexOffset = 0;
+						for (std::size_t input = text.find("<input ", triangles); input < trianglesEnd; input = text.find("<input ", input + 1))
+						{
+							std::size_t offset = std::stoul(GetAttribute(text, input, "offset"));
+							inputCount = std::max(inputCount, offset + 1);
+							if (GetAttribute(text, input, "semantic") == "VERTEX")
+							{
+								vertexOffset = offset;
+							}
+						}
+
+						auto indices = ReadValues<std::uint32_t>(text, text.find("<p>", triangles));
+						for (std::size_t i = vertexOffset; i < indices.size(); i += inputCount)
+						{
+							geometry.Corners.push_back(indices[i]);
+						}
+					}
+				}
+
+				// Every node instancing a geometry, pre-transformed into one mesh
+				std::vector<XMFLOAT3> positions;
+				IndexCollection indices;
+
+				for (std::size_t node = text.find("<node ", text.find("<library_visual_scenes")); node != std::string::npos; node = text.find("<node ", node + 1))
+				{
+					std::size_t nodeEnd = text.find("</node>", node);
+					std::size_t matrixAt = text.find("<matrix", node);
+					std::size_t instanceAt = text.find("<instance_geometry ", node);
+					if (matrixAt > nodeEnd || instanceAt > nodeEnd)
+					{
+						continue;
+					}
+
+					// Row-major, column vectors
+					auto m = ReadValues<float>(text, matrixAt);
+					const auto& geometry = geometries[GetAttribute(text, instanceAt, "url").substr(1)];
+
+					std::size_t base = positions.size();
+					for (std::size_t i = 0; i + 2 < geometry.Positions.size(); i += 3)
+					{
+						float x = geometry.Positions[i];
+						float y = geometry.Positions[i + 1];
+						float z = geometry.Positions[i + 2];
+
+						// Left handed: z is mirrored
+						positions.emplace_back(
+							m[0] * x + m[1] * y + m[2] * z + m[3],
+							m[4] * x + m[5] * y + m[6] * z + m[7],
+							-(m[8] * x + m[9] * y + m[10] * z + m[11]));
+					}
+
+					// Mirroring flips the winding
+					for (std::size_t i = 0; i + 2 < geometry.Corners.size(); i += 3)
+					{
+						indices.push_back(static_cast<std::uint16_t>(base + geometry.Corners[i]));
+						indices.push_back(static_cast<std::uint16_t>(base + geometry.Corners[i + 2]));
+						indices.push_back(static_cast<std::uint16_t>(base + geometry.Corners[i + 1]));
+					}
+				}
+
+				return std::make_unique<alexis::Mesh>(path.wstring(), std::move(positions), std::move(indices));
+			}
+
+			fs::path m_root;
+			std::unordered_map<std::string, std::unique_ptr<alexis::Mesh>> m_meshes;
+		};
+	}
+}
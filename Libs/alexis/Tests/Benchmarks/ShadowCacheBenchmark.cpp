@@ -0,0 +1,247 @@
+#include <Precompiled.h>
+
+#include <random>
+
+#include <Core/JobSystem.h>
+#include <Render/Culling.h>
+#include <Render/Mesh.h>
+#include <Render/RenderScene.h>
+#include <Utils/ShadowCascades.h>
+#include <Utils/ShadowCasterCache.h>
+
+#include <Testing/Benchmark.h>
+#include <Testing/Check.h>
+
+#include "SceneLoader.h"
+
+// Shadow caster draws per frame with the shadow cache, over a camera path on the crowded sgc scene: the camera stands
+// still, walks, then turns, while a few cubes keep moving. Cascades are fitted and culled like ShadowSystem does, each
+// cascade either draws every caster (not cached) or its dynamic casters plus its static ones when its tile is stale.
+// ShadowSystem caches every cascade, caching only the far ones is the comparison
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::testing;
+
+	constexpr std::size_t k_extraCubeCount = 5000;
+	constexpr std::size_t k_movingCubeCount = 50;
+
+	constexpr int k_stillFrames = 60;
+	constexpr int k_walkFrames = 120;
+	constexpr int k_turnFrames = 120;
+
+	// 60 fps, walking speed and a slow look around
+	constexpr float k_walkStep = 1.4f / 60.0f;
+	constexpr float k_turnStep = XMConvertToRadians(30.0f) / 60.0f;
+
+	// Same as ShadowSystem and the Shadow Map target
+	constexpr float k_shadowDistance = 60.0f;
+	constexpr float k_cascadeSplitLambda = 0.7f;
+	constexpr std::uint32_t k_cascadeResolution = 1024;
+	constexpr std::uint32_t k_cachedSnapTexels = 32;
+
+	struct Policy
+	{
+		const char* Name;
+		// Snap of each cascade, 0 is not cached
+		std::uint32_t SnapTexels[RenderScene::k_shadowCascadeCount];
+	};
+
+	struct PhaseResult
+	{
+		std::size_t Draws{ 0 };
+		std::size_t StaleTiles{ 0 };
+		int Frames{ 0 };
+	};
+
+	// Same as OcclusionBenchmark
+	void FillModels(RenderScene::ModelProxies& models, const std::vector<SceneModel>& sceneModels)
+	{
+		models.Resize(sceneModels.size());
+		for (std::size_t proxy = 0; proxy < sceneModels.size(); ++proxy)
+		{
+			const auto& model = sceneModels[proxy];
+			models.WorldMatrices[proxy] = model.WorldMatrix;
+			models.Meshes[proxy] = model.Mesh;
+
+			BoundingSphere worldSphere;
+			model.Mesh->GetBoundingSphere().Transform(worldSphere, model.WorldMatrix);
+			models.SphereCenterX[proxy] = worldSphere.Center.x;
+			models.SphereCenterY[proxy] = worldSphere.Center.y;
+			models.SphereCenterZ[proxy] = worldSphere.Center.z;
+			models.SphereRadius[proxy] = worldSphere.Radius;
+
+			model.Mesh->GetBoundingBox().Transform(models.Boxes[proxy], model.WorldMatrix);
+		}
+	}
+
+	void AddCubes(SceneLoader& loader, std::vector<SceneModel>& sceneModels, std::size_t count)
+	{
+		BoundingBox bounds = sceneModels.front().Mesh->GetBoundingBox();
+		bounds.Transform(bounds, sceneModels.front().WorldMatrix);
+
+		std::mt19937 random(21);
+		std::uniform_real_distribution<float> unit(-0.9f, 0.9f);
+		std::uniform_real_distribution<float> scale(0.1f, 0.4f);
+
+		auto* cube = loader.GetMesh("Resources/Models/Cube.DAE");
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			float s = scale(random);
+			XMMATRIX world = XMMatrixMultiply(XMMatrixScaling(s, s, s),
+				XMMatrixTranslation(bounds.Center.x + unit(random) * bounds.Extents.x, bounds.Center.y + unit(random) * bounds.Extents.y, bounds.Center.z + unit(random) * bounds.Extents.z));
+			sceneModels.push_back({ cube, world });
+		}
+	}
+
+	// Moving cubes bob up and down, their sphere follows
+	void MoveCubes(RenderScene& renderScene, std::size_t firstCube, int frame)
+	{
+		auto& models = renderScene.Models;
+		renderScene.MovedModels.clear();
+		for (std::size_t i = 0; i < k_movingCubeCount; ++i)
+		{
+			std::uint32_t proxy = static_cast<std::uint32_t>(firstCube + i);
+			float offset = 0.01f * std::sin(0.1f * static_cast<float>(frame + proxy));
+			models.SphereCenterY[proxy] += offset;
+			models.WorldMatrices[proxy] = XMMatrixMultiply(models.WorldMatrices[proxy], XMMatrixTranslation(0.0f, offset, 0.0f));
+			renderScene.MovedModels.push_back(proxy);
+		}
+	}
+
+	// Same as ShadowSystem::Extract, without the atlas matrices
+	void FitCascades(RenderScene& renderScene, const Policy& policy, const SceneCamera& camera, XMVECTOR position, float yaw, FXMVECTOR sunDirection,
+		const BoundingBox& casterBounds)
+	{
+		XMVECTOR direction = XMVectorSet(std::sin(yaw), 0.0f, std::cos(yaw), 0.0f);
+		XMMATRIX view = XMMatrixLookToLH(position, direction, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		XMMATRIX proj = XMMatrixPerspectiveFovLH(XMConvertToRadians(camera.Fov), camera.AspectRatio, camera.NearZ, camera.FarZ);
+		XMMATRIX invView = XMMatrixInverse(nullptr, view);
+
+		auto& mainView = renderScene.Views[RenderScene::k_mainView];
+		BuildViewData(position, view, invView, proj, XMMatrixInverse(nullptr, proj), mainView);
+
+		XMFLOAT4X4 proj4x4;
+		XMStoreFloat4x4(&proj4x4, proj);
+
+		float splits[RenderScene::k_shadowCascadeCount + 1];
+		utils::ComputeCascadeSplits(camera.NearZ, std::min(camera.FarZ, k_shadowDistance), k_cascadeSplitLambda, RenderScene::k_shadowCascadeCount, splits);
+
+		for (std::size_t i = 0; i < RenderScene::k_shadowCascadeCount; ++i)
+		{
+			auto projection = utils::FitCascade(sunDirection, invView, proj4x4._11, proj4x4._22, splits[i], splits[i + 1], k_cascadeResolution, casterBounds,
+				std::max(policy.SnapTexels[i], 1u));
+
+			auto& cascadeView = renderScene.Views[RenderScene::k_shadowView + i];
+			BuildViewData(projection.Position, projection.View, XMMatrixInverse(nullptr, projection.View), projection.Proj, XMMatrixInverse(nullptr, projection.Proj),
+				cascadeView);
+			cascadeView.MinModelRadius = 0.5f * projection.TexelSize;
+		}
+	}
+
+	bool Run(const Policy& policy, JobSystem& jobSystem, PhaseResult (&phases)[3])
+	{
+		SceneLoader loader(ALEXIS_RESOURCES_ROOT);
+
+		std::vector<SceneModel> sceneModels;
+		SceneCamera camera;
+		if (!loader.LoadScene("Resources/Scenes/sgc.scene", sceneModels, camera) || sceneModels.empty())
+		{
+			return false;
+		}
+		const std::size_t firstCube = sceneModels.size();
+		AddCubes(loader, sceneModels, k_extraCubeCount);
+
+		auto renderScene = std::make_unique<RenderScene>();
+		FillModels(renderScene->Models, sceneModels);
+
+		BoundingBox casterBounds = renderScene->Models.Boxes.front();
+		for (const auto& box : renderScene->Models.Boxes)
+		{
+			BoundingBox::CreateMerged(casterBounds, casterBounds, box);
+		}
+
+		XMVECTOR sunDirection = XMVector3Normalize(XMVectorSet(-0.3f, -1.0f, 0.4f, 0.0f));
+
+		utils::ShadowCasterCache casterCache;
+		casterCache.SetViewCount(RenderScene::k_shadowCascadeCount);
+
+		std::vector<std::uint32_t> staticCasters;
+		std::vector<std::uint32_t> dynamicCasters;
+
+		XMVECTOR position = XMLoadFloat3(&camera.Position);
+		float yaw = 0.0f;
+
+		const int phaseEnds[] = { k_stillFrames, k_stillFrames + k_walkFrames, k_stillFrames + k_walkFrames + k_turnFrames };
+		for (int frame = 0, phase = 0; frame < phaseEnds[2]; ++frame)
+		{
+			phase += frame == phaseEnds[phase] ? 1 : 0;
+			if (phase == 1)
+			{
+				position = XMVectorAdd(position, XMVectorSet(std::sin(yaw) * k_walkStep, 0.0f, std::cos(yaw) * k_walkStep, 0.0f));
+			}
+			else if (phase == 2)
+			{
+				yaw += k_turnStep;
+			}
+
+			MoveCubes(*renderScene, firstCube, frame);
+			FitCascades(*renderScene, policy, camera, position, yaw, sunDirection, casterBounds);
+			CullModels(*renderScene, jobSystem);
+
+			const auto& moved = renderScene->MovedModels;
+			casterCache.UpdateCasters(renderScene->Models.Size(), 1, moved.data(), moved.size());
+
+			// The first frame fills every tile whatever the policy
+			auto& result = phases[phase];
+			++result.Frames;
+			for (std::size_t i = 0; i < RenderScene::k_shadowCascadeCount; ++i)
+			{
+				const auto& casters = renderScene->VisibleModels[RenderScene::k_shadowView + i];
+				if (policy.SnapTexels[i] == 0)
+				{
+					result.Draws += casters.size();
+					continue;
+				}
+
+				bool isStale = casterCache.UpdateView(i, renderScene->Views[RenderScene::k_shadowView + i].ViewProj, 1, casters, staticCasters, dynamicCasters);
+				CHECK(staticCasters.size() + dynamicCasters.size() == casters.size());
+
+				result.Draws += dynamicCasters.size() + (isStale ? staticCasters.size() : 0);
+				result.StaleTiles += isStale ? 1 : 0;
+			}
+		}
+
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	IsQuickRun(argc, argv);
+
+	const Policy policies[] = {
+		{ "cascades 2-3 cached", { 0, 0, k_cachedSnapTexels, k_cachedSnapTexels } },
+		{ "every cascade cached", { k_cachedSnapTexels, k_cachedSnapTexels, k_cachedSnapTexels, k_cachedSnapTexels } },
+	};
+	const char* phaseNames[] = { "still", "walk", "turn" };
+
+	JobSystem jobSystem;
+
+	std::printf("\nShadow caster draws per frame, sgc + %zu cubes, %zu moving\n", k_extraCubeCount, k_movingCubeCount);
+	std::printf("%-24s %-8s %8s %14s %12s\n", "policy", "camera", "frames", "draws/frame", "stale tiles");
+	for (const auto& policy : policies)
+	{
+		PhaseResult phases[3];
+		CHECK(Run(policy, jobSystem, phases));
+
+		for (int phase = 0; phase < 3; ++phase)
+		{
+			const auto& result = phases[phase];
+			std::printf("%-24s %-8s %8d %14.1f %12zu\n", policy.Name, phaseNames[phase], result.Frames,
+				static_cast<double>(result.Draws) / result.Frames, result.StaleTiles);
+		}
+	}
+
+	return Report("ShadowCacheBenchmark");
+}
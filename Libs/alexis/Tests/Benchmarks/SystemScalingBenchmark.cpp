@@ -0,0 +1,319 @@
+#include <Precompiled.h>
+
+#include <cstdint>
+#include <random>
+
+#include <ECS/ECS.h>
+
+#include <Testing/Benchmark.h>
+#include <Testing/Check.h>
+
+#include "LegacyEcs.h"
+
+// System membership bookkeeping as the number of systems grows: every component add/remove/destroy
+// updates the Entities of matching systems. Baseline SystemManager tests every system per change,
+// the current one caches matching systems per mask and per mask transition
+namespace
+{
+	namespace legacy = alexis::testing::legacy;
+
+	using namespace alexis;
+	using namespace alexis::testing;
+
+	constexpr int k_componentTypeCount = 12;
+	constexpr int k_maxSystemCount = 100;
+
+	// Systems without a component mask, they see every entity
+	constexpr int k_masklessSystemCount = 8;
+
+	template<int N>
+	struct Component
+	{
+		float Value;
+	};
+
+	template<int N>
+	struct LegacySystem : legacy::System
+	{
+	};
+
+	template<int N>
+	struct System : ecs::System
+	{
+	};
+
+	template<int N>
+	struct MasklessSystem : ecs::System
+	{
+	};
+
+	// 1-3 component types per system, deterministic so that both worlds agree
+	template<class Mask>
+	Mask MakeSystemMask(int system, int (&types)[k_componentTypeCount])
+	{
+		Mask mask;
+		mask.set(types[system % k_componentTypeCount]);
+		mask.set(types[(system * 5 + 3) % k_componentTypeCount]);
+		if (system % 3 == 0)
+		{
+			mask.set(types[(system * 7 + 1) % k_componentTypeCount]);
+		}
+
+		return mask;
+	}
+
+	template<int Count, class Func>
+	void ForEachIndex(Func&& func)
+	{
+		[&]<int... N>(std::integer_sequence<int, N...>)
+		{
+			(func(std::integral_constant<int, N>{}), ...);
+		}(std::make_integer_sequence<int, Count>{});
+	}
+
+	// Component type index -> typed Add/Remove, for both worlds
+	template<class WorldT, class EntityT>
+	struct ComponentOps
+	{
+		using Func = void (*)(WorldT&, EntityT);
+
+		std::array<Func, k_componentTypeCount> Add;
+		std::array<Func, k_componentTypeCount> Remove;
+
+		ComponentOps()
+		{
+			ForEachIndex<k_componentTypeCount>([this](auto n)
+			{
+				constexpr int N = decltype(n)::value;
+				Add[N] = [](WorldT& world, EntityT entity) { world.AddComponent(entity, Component<N>{ static_cast<float>(N) }); };
+				Remove[N] = [](WorldT& world, EntityT entity) { world.template RemoveComponent<Component<N>>(entity); };
+			});
+		}
+	};
+
+	// Per entity: how many components and which ones, same for both worlds
+	struct EntityRecipe
+	{
+		std::uint8_t Count;
+		std::array<std::uint8_t, k_componentTypeCount> Types;
+	};
+
+	std::vector<EntityRecipe> MakeRecipes(std::size_t entityCount)
+	{
+		std::mt19937 random(5);
+		std::vector<EntityRecipe> recipes(entityCount);
+		for (auto& recipe : recipes)
+		{
+			for (int i = 0; i < k_componentTypeCount; ++i)
+			{
+				recipe.Types[i] = static_cast<std::uint8_t>(i);
+			}
+			std::shuffle(recipe.Types.begin(), recipe.Types.end(), random);
+			recipe.Count = static_cast<std::uint8_t>(2 + random() % 4);
+		}
+
+		return recipes;
+	}
+
+	struct Timings
+	{
+		double CreateMs;
+		double ChurnMs;
+		double DestroyMs;
+		double BareCreateMs;
+	};
+
+	Timings RunLegacy(int systemCount, const std::vector<EntityRecipe>& recipes, std::vector<std::size_t>& outMembership)
+	{
+		using Ops = ComponentOps<legacy::World, legacy::Entity>;
+		static const Ops ops;
+
+		legacy::World world;
+		int types[k_componentTypeCount];
+		ForEachIndex<k_componentTypeCount>([&](auto n)
+		{
+			world.RegisterComponent<Component<n>>();
+			types[n] = world.GetComponentType<Component<n>>();
+		});
+
+		std::vector<legacy::System*> systems;
+		ForEachIndex<k_maxSystemCount>([&](auto n)
+		{
+			if (n < systemCount)
+			{
+				systems.push_back(world.RegisterSystem<LegacySystem<n>>().get());
+				world.SetSystemComponentMask<LegacySystem<n>>(MakeSystemMask<legacy::ComponentMask>(n, types));
+			}
+		});
+
+		Timings timings;
+		std::vector<legacy::Entity> entities(recipes.size());
+
+		timings.CreateMs = MeasureMilliseconds([&]()
+		{
+			for (std::size_t i = 0; i < recipes.size(); ++i)
+			{
+				entities[i] = world.CreateEntity();
+				for (int c = 0; c < recipes[i].Count; ++c)
+				{
+					ops.Add[recipes[i].Types[c]](world, entities[i]);
+				}
+			}
+		});
+
+		timings.ChurnMs = MeasureMilliseconds([&]()
+		{
+			for (std::size_t i = 0; i < recipes.size(); ++i)
+			{
+				ops.Remove[recipes[i].Types[0]](world, entities[i]);
+				ops.Add[recipes[i].Types[0]](world, entities[i]);
+			}
+		});
+
+		outMembership.clear();
+		for (auto* system : systems)
+		{
+			outMembership.push_back(system->Entities.size());
+		}
+
+		timings.DestroyMs = MeasureMilliseconds([&]()
+		{
+			for (auto entity : entities)
+			{
+				world.DestroyEntity(entity);
+			}
+		});
+
+		timings.BareCreateMs = MeasureMilliseconds([&]()
+		{
+			for (std::size_t i = 0; i < recipes.size(); ++i)
+			{
+				entities[i] = world.CreateEntity();
+			}
+		});
+
+		return timings;
+	}
+
+	Timings RunCurrent(int systemCount, const std::vector<EntityRecipe>& recipes, std::vector<std::size_t>& outMembership)
+	{
+		using Ops = ComponentOps<ecs::World, ecs::Entity>;
+		static const Ops ops;
+
+		ecs::World world;
+		world.Init();
+
+		int types[k_componentTypeCount];
+		ForEachIndex<k_componentTypeCount>([&](auto n)
+		{
+			world.RegisterComponent<Component<n>>();
+			types[n] = world.GetComponentType<Component<n>>();
+		});
+
+		std::vector<ecs::System*> systems;
+		ForEachIndex<k_maxSystemCount>([&](auto n)
+		{
+			if (n < systemCount)
+			{
+				systems.push_back(world.RegisterSystem<System<n>>().get());
+				world.SetSystemComponentMask<System<n>>(MakeSystemMask<ecs::ComponentMask>(n, types));
+			}
+		});
+
+		std::vector<ecs::System*> masklessSystems;
+		ForEachIndex<k_masklessSystemCount>([&](auto n)
+		{
+			masklessSystems.push_back(world.RegisterSystem<MasklessSystem<n>>().get());
+		});
+
+		Timings timings;
+		std::vector<ecs::Entity> entities(recipes.size());
+
+		timings.CreateMs = MeasureMilliseconds([&]()
+		{
+			for (std::size_t i = 0; i < recipes.size(); ++i)
+			{
+				entities[i] = world.CreateEntity();
+				for (int c = 0; c < recipes[i].Count; ++c)
+				{
+					ops.Add[recipes[i].Types[c]](world, entities[i]);
+				}
+			}
+		});
+
+		timings.ChurnMs = MeasureMilliseconds([&]()
+		{
+			for (std::size_t i = 0; i < recipes.size(); ++i)
+			{
+				ops.Remove[recipes[i].Types[0]](world, entities[i]);
+				ops.Add[recipes[i].Types[0]](world, entities[i]);
+			}
+		});
+
+		outMembership.clear();
+		for (auto* system : systems)
+		{
+			outMembership.push_back(system->Entities.size());
+		}
+
+		timings.DestroyMs = MeasureMilliseconds([&]()
+		{
+			for (auto entity : entities)
+			{
+				world.DestroyEntity(entity);
+			}
+		});
+
+		timings.BareCreateMs = MeasureMilliseconds([&]()
+		{
+			entities = world.CreateEntities(recipes.size());
+		});
+
+		for (auto* system : masklessSystems)
+		{
+			CHECK(system->Entities.size() == recipes.size());
+		}
+
+		return timings;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool isQuick = IsQuickRun(argc, argv);
+	std::size_t entityCount = isQuick ? 10000 : 100000;
+	std::vector<int> systemCounts = isQuick ? std::vector<int>{ 50 } : std::vector<int>{ 10, 50, 100 };
+
+	auto recipes = MakeRecipes(entityCount);
+
+	std::vector<std::pair<Timings, Timings>> results;
+	for (int systemCount : systemCounts)
+	{
+		std::vector<std::size_t> legacyMembership;
+		std::vector<std::size_t> membership;
+
+		Timings legacyTimings = RunLegacy(systemCount, recipes, legacyMembership);
+		Timings timings = RunCurrent(systemCount, recipes, membership);
+
+		// Same entities end up in the same systems
+		CHECK(legacyMembership == membership);
+
+		results.push_back({ legacyTimings, timings });
+	}
+
+	const char* caseNames[] = { "create + add 2-5 components", "remove + add one component", "destroy", "create without components" };
+	for (std::size_t i = 0; i < systemCounts.size(); ++i)
+	{
+		char title[128];
+		std::snprintf(title, sizeof(title), "%zu entities, %d systems (+%d without mask)", entityCount, systemCounts[i], k_masklessSystemCount);
+		PrintHeader(title, "baseline", "current");
+
+		const auto& [legacyTimings, timings] = results[i];
+		PrintRow(caseNames[0], entityCount, legacyTimings.CreateMs, timings.CreateMs);
+		PrintRow(caseNames[1], entityCount, legacyTimings.ChurnMs, timings.ChurnMs);
+		PrintRow(caseNames[2], entityCount, legacyTimings.DestroyMs, timings.DestroyMs);
+		PrintRow(caseNames[3], entityCount, legacyTimings.BareCreateMs, timings.BareCreateMs);
+	}
+
+	return Report("SystemScalingBenchmark");
+}
@@ -0,0 +1,179 @@
+#include <Precompiled.h>
+
+#include <cstdint>
+#include <typeinfo>
+
+#include <ECS/ECS.h>
+
+#include <Testing/Benchmark.h>
+#include <Testing/Check.h>
+
+// Per-call cost of component and system type lookups: typeid-name hash maps of the baseline vs static ids
+namespace
+{
+	// Lookups of the baseline ComponentManager / SystemManager, asserts dropped as in a release build
+	namespace legacy
+	{
+		using ComponentType = std::uint8_t;
+
+		struct System
+		{
+		};
+
+		class Registry
+		{
+		public:
+			template<class T>
+			void RegisterComponent()
+			{
+				m_componentTypes.insert({ typeid(T).name(), m_nextComponentType++ });
+			}
+
+			template<class T>
+			ComponentType GetComponentType()
+			{
+				return m_componentTypes[typeid(T).name()];
+			}
+
+			template<class T>
+			void RegisterSystem()
+			{
+				m_systems.insert({ typeid(T).name(), std::make_shared<T>() });
+			}
+
+			template<class T>
+			std::shared_ptr<T> GetSystem()
+			{
+				auto it = m_systems.find(typeid(T).name());
+				return std::static_pointer_cast<T>(it->second);
+			}
+
+		private:
+			std::unordered_map<const char*, ComponentType> m_componentTypes;
+			std::unordered_map<const char*, std::shared_ptr<System>> m_systems;
+			ComponentType m_nextComponentType{ 0 };
+		};
+	}
+
+	template<int N>
+	struct Component
+	{
+		float Value;
+	};
+
+	template<int N>
+	struct LegacySystem : legacy::System
+	{
+		int Value{ N };
+	};
+
+	template<int N>
+	struct System : alexis::ecs::System
+	{
+		int Value{ N };
+	};
+
+	constexpr int k_typeCount = 8;
+
+	template<class Func, int... N>
+	void ForEachType(Func&& func, std::integer_sequence<int, N...>)
+	{
+		(func(std::integral_constant<int, N>{}), ...);
+	}
+
+	template<class Func>
+	void ForEachType(Func&& func)
+	{
+		ForEachType(std::forward<Func>(func), std::make_integer_sequence<int, k_typeCount>{});
+	}
+
+	void PrintNanoseconds(const char* name, std::size_t callCount, double baselineMs, double currentMs)
+	{
+		double baselineNs = baselineMs * 1e6 / static_cast<double>(callCount);
+		double currentNs = currentMs * 1e6 / static_cast<double>(callCount);
+		std::printf("%-32s %10zu %11.2f ns %11.2f ns %8.1fx\n", name, callCount, baselineNs, currentNs, currentNs > 0.0 ? baselineNs / currentNs : 0.0);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	using namespace alexis::testing;
+
+	const std::size_t iterationCount = IsQuickRun(argc, argv) ? 100000 : 10000000;
+	const std::size_t callCount = iterationCount * k_typeCount;
+	constexpr int k_repeats = 3;
+
+	legacy::Registry registry;
+	alexis::ecs::World world;
+	world.Init();
+
+	ForEachType([&](auto n)
+	{
+		registry.RegisterComponent<Component<n>>();
+		registry.RegisterSystem<LegacySystem<n>>();
+
+		world.RegisterComponent<Component<n>>();
+		world.RegisterSystem<System<n>>();
+	});
+
+	// Both hand out ids in registration order
+	ForEachType([&](auto n)
+	{
+		CHECK(registry.GetComponentType<Component<n>>() == static_cast<legacy::ComponentType>(n));
+		CHECK(world.GetComponentType<Component<n>>() - world.GetComponentType<Component<0>>() == n);
+		CHECK(registry.GetSystem<LegacySystem<n>>()->Value == world.GetSystem<System<n>>()->Value);
+	});
+
+	PrintHeader("Type lookups per call: typeid-name hash maps vs static ids", "hash maps", "static ids");
+
+	{
+		std::uint32_t sum = 0;
+		double baselineMs = MeasureBestMilliseconds(k_repeats, [&]()
+		{
+			for (std::size_t i = 0; i < iterationCount; ++i)
+			{
+				ForEachType([&](auto n) { sum += registry.GetComponentType<Component<n>>(); });
+				DoNotOptimize(sum);
+			}
+		});
+
+		std::uint32_t currentSum = 0;
+		double currentMs = MeasureBestMilliseconds(k_repeats, [&]()
+		{
+			for (std::size_t i = 0; i < iterationCount; ++i)
+			{
+				ForEachType([&](auto n) { currentSum += world.GetComponentType<Component<n>>(); });
+				DoNotOptimize(currentSum);
+			}
+		});
+
+		PrintNanoseconds("GetComponentType<T>", callCount, baselineMs, currentMs);
+	}
+
+	{
+		int sum = 0;
+		double baselineMs = MeasureBestMilliseconds(k_repeats, [&]()
+		{
+			for (std::size_t i = 0; i < iterationCount; ++i)
+			{
+				ForEachType([&](auto n) { sum += registry.GetSystem<LegacySystem<n>>()->Value; });
+				DoNotOptimize(sum);
+			}
+		});
+
+		int currentSum = 0;
+		double currentMs = MeasureBestMilliseconds(k_repeats, [&]()
+		{
+			for (std::size_t i = 0; i < iterationCount; ++i)
+			{
+				ForEachType([&](auto n) { currentSum += world.GetSystem<System<n>>()->Value; });
+				DoNotOptimize(currentSum);
+			}
+		});
+
+		CHECK(sum == currentSum);
+		PrintNanoseconds("GetSystem<T>", callCount, baselineMs, currentMs);
+	}
+
+	return Report("TypeIdBenchmark");
+}
@@ -0,0 +1,314 @@
+#include <Precompiled.h>
+
+#include <cstring>
+#include <thread>
+
+#include <Core/Core.h>
+#include <Core/FrameUpdateGraph.h>
+
+#include <Testing/Check.h>
+
+// Systems scheduled by FrameUpdateGraph on several workers end up with exactly the state of a serial run in registration order
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::ecs;
+
+	struct A
+	{
+		double Value;
+	};
+
+	struct B
+	{
+		double Value;
+	};
+
+	struct C
+	{
+		double Value;
+	};
+
+	struct D
+	{
+		double Value;
+	};
+
+	struct ChangedCount
+	{
+		std::uint64_t Value;
+	};
+
+	struct TestSystem : System
+	{
+		World* TargetWorld{ nullptr };
+	};
+
+	// Reads A, writes B
+	struct BlendSystem : TestSystem
+	{
+		void Update(float dt)
+		{
+			TargetWorld->ForEachChunk<const A, B>([dt](std::size_t count, const Entity*, const A* a, B* b)
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					b[i].Value = b[i].Value * 0.5 + a[i].Value * 1.25 + dt;
+				}
+			});
+		}
+	};
+
+	// Writes C, independent of BlendSystem
+	struct GrowSystem : TestSystem
+	{
+		void Update(float dt)
+		{
+			TargetWorld->ForEachChunk<C>([dt](std::size_t count, const Entity*, C* c)
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					c[i].Value = c[i].Value * 1.01 + dt;
+				}
+			});
+		}
+	};
+
+	// Reads B, writes A: after BlendSystem
+	struct FeedbackSystem : TestSystem
+	{
+		void Update(float)
+		{
+			TargetWorld->ForEachChunk<A, const B>([](std::size_t count, const Entity*, A* a, const B* b)
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					a[i].Value = a[i].Value - b[i].Value * 0.3;
+				}
+			});
+		}
+	};
+
+	// Reads B and C, writes D
+	struct MixSystem : TestSystem
+	{
+		void Update(float)
+		{
+			TargetWorld->ForEachChunk<const B, const C, D>([](std::size_t count, const Entity*, const B* b, const C* c, D* d)
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					d[i].Value = std::sin(d[i].Value) + c[i].Value * b[i].Value * 1e-3;
+				}
+			});
+		}
+	};
+
+	// Main thread only, reads D
+	struct MainThreadSystem : TestSystem
+	{
+		std::thread::id MainThread;
+		bool RanOnMainThread{ true };
+		double Sum{ 0.0 };
+
+		void Update(float)
+		{
+			RanOnMainThread = RanOnMainThread && std::this_thread::get_id() == MainThread;
+
+			TargetWorld->ForEachChunk<const D>([this](std::size_t count, const Entity*, const D* d)
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					Sum += d[i].Value;
+				}
+			});
+		}
+	};
+
+	// Reads D, writes A
+	struct CorrectSystem : TestSystem
+	{
+		void Update(float)
+		{
+			TargetWorld->ForEachChunk<A, const D>([](std::size_t count, const Entity*, A* a, const D* d)
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					a[i].Value += d[i].Value * 1e-3;
+				}
+			});
+		}
+	};
+
+	// Counts entities in chunks whose B changed since its previous Update, writes ChangedCount
+	struct WatchSystem : TestSystem
+	{
+		void Update(float)
+		{
+			std::uint64_t changed = TargetWorld->View<const B>(Changed<B>{ LastSystemVersion }).Count();
+
+			TargetWorld->ForEachChunk<ChangedCount>([changed](std::size_t count, const Entity*, ChangedCount* counts)
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					counts[i].Value += changed;
+				}
+			});
+		}
+	};
+
+	template<class T>
+	T* RegisterTestSystem(World& world, std::initializer_list<ComponentType> reads, std::initializer_list<ComponentType> writes, bool mainThreadOnly = false)
+	{
+		T* system = world.RegisterSystem<T>().get();
+		system->TargetWorld = &world;
+
+		SystemAccess access;
+		for (auto type : reads)
+		{
+			access.Reads.set(type);
+		}
+		for (auto type : writes)
+		{
+			access.Writes.set(type);
+		}
+		access.MainThreadOnly = mainThreadOnly;
+		world.SetSystemAccess<T>(access);
+
+		return system;
+	}
+
+	// Same order in both worlds, FrameUpdateGraph::AddSystem and the serial loop below rely on it
+	void Setup(World& world)
+	{
+		world.Init();
+
+		world.RegisterComponent<A>();
+		world.RegisterComponent<B>();
+		world.RegisterComponent<C>();
+		world.RegisterComponent<D>();
+		world.RegisterComponent<ChangedCount>();
+
+		auto a = world.GetComponentType<A>();
+		auto b = world.GetComponentType<B>();
+		auto c = world.GetComponentType<C>();
+		auto d = world.GetComponentType<D>();
+		auto changedCount = world.GetComponentType<ChangedCount>();
+
+		RegisterTestSystem<BlendSystem>(world, { a }, { b });
+		RegisterTestSystem<GrowSystem>(world, {}, { c });
+		RegisterTestSystem<FeedbackSystem>(world, { b }, { a });
+		RegisterTestSystem<MixSystem>(world, { b, c }, { d });
+		RegisterTestSystem<MainThreadSystem>(world, { d }, {}, true)->MainThread = std::this_thread::get_id();
+		RegisterTestSystem<CorrectSystem>(world, { d }, { a });
+		RegisterTestSystem<WatchSystem>(world, { b }, { changedCount });
+
+		// Two archetypes, several chunks each
+		for (int i = 0; i < 3000; ++i)
+		{
+			Entity entity = world.CreateEntity();
+			world.AddComponent(entity, A{ i * 0.01 });
+			world.AddComponent(entity, B{ 1.0 });
+			world.AddComponent(entity, C{ (i % 7) * 0.5 });
+			world.AddComponent(entity, D{ 0.0 });
+			if (i % 3 == 0)
+			{
+				world.AddComponent(entity, ChangedCount{ 0 });
+			}
+		}
+	}
+
+	template<class T>
+	void UpdateSerial(World& world, float dt)
+	{
+		auto* system = world.GetSystem<T>();
+		std::uint32_t version = world.AdvanceChangeVersion();
+		system->Update(dt);
+		system->LastSystemVersion = version;
+	}
+
+	template<class T>
+	bool HasSameValues(World& expected, World& actual)
+	{
+		std::vector<T> expectedValues;
+		expected.ForEachChunk<const T>([&expectedValues](std::size_t count, const Entity*, const T* values)
+		{
+			expectedValues.insert(expectedValues.end(), values, values + count);
+		});
+
+		std::vector<T> actualValues;
+		actual.ForEachChunk<const T>([&actualValues](std::size_t count, const Entity*, const T* values)
+		{
+			actualValues.insert(actualValues.end(), values, values + count);
+		});
+
+		// Bitwise, any reordering of the floating point math would show up
+		return expectedValues.size() == actualValues.size() && std::memcmp(expectedValues.data(), actualValues.data(), expectedValues.size() * sizeof(T)) == 0;
+	}
+
+	void TestMatchesSerialExecution(std::uint32_t workerCount)
+	{
+		Core::Create(workerCount);
+
+		World serialWorld;
+		Setup(serialWorld);
+
+		World world;
+		Setup(world);
+
+		FrameUpdateGraph graph;
+		graph.AddSystem<BlendSystem>(world);
+		graph.AddSystem<GrowSystem>(world);
+		graph.AddSystem<FeedbackSystem>(world);
+		graph.AddSystem<MixSystem>(world);
+		graph.AddSystem<MainThreadSystem>(world);
+		graph.AddSystem<CorrectSystem>(world);
+		graph.AddSystem<WatchSystem>(world);
+		graph.Build();
+
+		for (int frame = 0; frame < 50; ++frame)
+		{
+			float dt = 0.016f + 0.001f * static_cast<float>(frame % 5);
+
+			UpdateSerial<BlendSystem>(serialWorld, dt);
+			UpdateSerial<GrowSystem>(serialWorld, dt);
+			UpdateSerial<FeedbackSystem>(serialWorld, dt);
+			UpdateSerial<MixSystem>(serialWorld, dt);
+			UpdateSerial<MainThreadSystem>(serialWorld, dt);
+			UpdateSerial<CorrectSystem>(serialWorld, dt);
+			UpdateSerial<WatchSystem>(serialWorld, dt);
+
+			graph.Update(dt);
+		}
+
+		CHECK(HasSameValues<A>(serialWorld, world));
+		CHECK(HasSameValues<B>(serialWorld, world));
+		CHECK(HasSameValues<C>(serialWorld, world));
+		CHECK(HasSameValues<D>(serialWorld, world));
+		CHECK(HasSameValues<ChangedCount>(serialWorld, world));
+
+		auto* mainThreadSystem = world.GetSystem<MainThreadSystem>();
+		CHECK(mainThreadSystem->RanOnMainThread);
+		CHECK(mainThreadSystem->Sum == serialWorld.GetSystem<MainThreadSystem>()->Sum);
+
+		// B is rewritten every frame, the watcher saw all of it each time
+		std::uint64_t expectedChanged = 0;
+		world.ForEachChunk<const ChangedCount>([&expectedChanged](std::size_t count, const Entity*, const ChangedCount* counts)
+		{
+			expectedChanged = count ? counts[0].Value : expectedChanged;
+		});
+		CHECK(expectedChanged == 50u * 3000u);
+
+		Core::Destroy();
+	}
+}
+
+int main()
+{
+	for (std::uint32_t workerCount : { 1u, 2u, 4u, 7u })
+	{
+		TestMatchesSerialExecution(workerCount);
+	}
+
+	return alexis::testing::Report("FrameUpdateGraphTests");
+}
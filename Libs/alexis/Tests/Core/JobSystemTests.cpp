@@ -0,0 +1,191 @@
+#include <Precompiled.h>
+
+#include <atomic>
+#include <thread>
+
+#include <Core/JobSystem.h>
+
+#include <Testing/Check.h>
+
+// JobSystem runs every job once, from owner and foreign threads, nested or not. Jobs after a dependency start once all
+// of its jobs are done, including on workers that went to sleep meanwhile. Captures are destroyed before the counter drains
+namespace
+{
+	using namespace alexis;
+
+	void TestParallelFor()
+	{
+		JobSystem jobSystem(3);
+
+		std::vector<std::atomic<int>> hits(10007);
+		jobSystem.ParallelFor(hits.size(), 16, [&hits](std::size_t begin, std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				hits[i].fetch_add(1, std::memory_order_relaxed);
+			}
+		});
+
+		bool isEachOnce = std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& hit) { return hit.load() == 1; });
+		CHECK(isEachOnce);
+	}
+
+	int Fib(JobSystem& jobSystem, int n)
+	{
+		if (n < 2)
+		{
+			return n;
+		}
+
+		int left = 0;
+		JobCounter counter{ 0 };
+		jobSystem.Run([&jobSystem, &left, n]() { left = Fib(jobSystem, n - 1); }, &counter);
+		int right = Fib(jobSystem, n - 2);
+		jobSystem.Wait(counter);
+
+		return left + right;
+	}
+
+	void TestNested()
+	{
+		JobSystem jobSystem(3);
+		CHECK(Fib(jobSystem, 20) == 6765);
+	}
+
+	// Threads without a deque go through the shared queue and free list
+	void TestForeignThreads()
+	{
+		JobSystem jobSystem(2);
+
+		std::atomic<int> sum{ 0 };
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 3; ++t)
+		{
+			threads.emplace_back([&jobSystem, &sum]()
+			{
+				JobCounter counter{ 0 };
+				for (int i = 0; i < 1000; ++i)
+				{
+					jobSystem.Run([&sum]() { sum.fetch_add(1, std::memory_order_relaxed); }, &counter);
+				}
+				jobSystem.Wait(counter);
+			});
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		CHECK(sum.load() == 3000);
+	}
+
+	void TestRunAfter()
+	{
+		JobSystem jobSystem(3);
+
+		// Several dependents of several jobs
+		std::atomic<int> finished{ 0 };
+		std::atomic<int> early{ 0 };
+		JobCounter dependency{ 0 };
+		JobCounter done{ 0 };
+		for (int i = 0; i < 8; ++i)
+		{
+			jobSystem.Run([&finished]()
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				finished.fetch_add(1);
+			}, &dependency);
+		}
+		for (int i = 0; i < 4; ++i)
+		{
+			jobSystem.RunAfter(dependency, [&finished, &early]()
+			{
+				if (finished.load() != 8)
+				{
+					early.fetch_add(1);
+				}
+			}, &done);
+		}
+		jobSystem.Wait(done);
+		CHECK(early.load() == 0);
+
+		// Dependency already drained
+		bool hasRun = false;
+		jobSystem.RunAfter(dependency, [&hasRun]() { hasRun = true; }, &done);
+		jobSystem.Wait(done);
+		CHECK(hasRun);
+
+		// Chain, every link waits for the previous one
+		std::vector<JobCounter> links(200);
+		std::vector<int> order;
+		jobSystem.Run([&order]() { order.push_back(0); }, &links[0]);
+		for (int i = 1; i < static_cast<int>(links.size()); ++i)
+		{
+			jobSystem.RunAfter(links[i - 1], [&order, i]() { order.push_back(i); }, &links[i]);
+		}
+		jobSystem.Wait(links.back());
+
+		bool isInOrder = order.size() == links.size();
+		for (std::size_t i = 0; isInOrder && i < order.size(); ++i)
+		{
+			isInOrder = order[i] == static_cast<int>(i);
+		}
+		CHECK(isInOrder);
+	}
+
+	// Nobody waits: sleeping workers have to be woken when the dependency drains
+	void TestRunAfterWakesWorkers()
+	{
+		JobSystem jobSystem(2);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+		std::atomic<bool> hasRun{ false };
+		JobCounter dependency{ 0 };
+		JobCounter done{ 0 };
+		jobSystem.Run([]() { std::this_thread::sleep_for(std::chrono::milliseconds(5)); }, &dependency);
+		jobSystem.RunAfter(dependency, [&hasRun]() { hasRun.store(true); }, &done);
+
+		for (int i = 0; i < 2000 && !hasRun.load(); ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		CHECK(hasRun.load());
+		jobSystem.Wait(done);
+	}
+
+	// Captures larger than a job are allocated on the side
+	void TestCaptures()
+	{
+		JobSystem jobSystem(2);
+
+		auto owner = std::make_shared<int>(7);
+		std::array<int, 64> big{};
+		big.back() = 5;
+
+		std::atomic<int> sum{ 0 };
+		JobCounter counter{ 0 };
+		for (int i = 0; i < 100; ++i)
+		{
+			jobSystem.Run([owner, big, &sum]() { sum.fetch_add(*owner + big.back()); }, &counter);
+			jobSystem.Run([owner, &sum]() { sum.fetch_add(*owner); }, &counter);
+		}
+		jobSystem.Wait(counter);
+
+		static_assert(sizeof(big) > JobSystem::k_jobStorageSize);
+		CHECK(sum.load() == 100 * (12 + 7));
+		CHECK(owner.use_count() == 1);
+	}
+}
+
+int main()
+{
+	TestParallelFor();
+	TestNested();
+	TestForeignThreads();
+	TestRunAfter();
+	TestRunAfterWakesWorkers();
+	TestCaptures();
+
+	return alexis::testing::Report("JobSystemTests");
+}
@@ -0,0 +1,184 @@
+#include <Precompiled.h>
+
+#include <string>
+
+#include <ECS/ECS.h>
+
+#include <Testing/Check.h>
+
+// Components survive archetype moves: adding and removing a component keeps the values of the others,
+// destroying or moving an entity out of a chunk fills the hole without disturbing the remaining entities,
+// and non-trivial components are moved and destroyed exactly once
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::ecs;
+
+	struct Position
+	{
+		float X{ 0.0f };
+		float Y{ 0.0f };
+	};
+
+	struct Health
+	{
+		int Value{ 0 };
+	};
+
+	// Counts live instances, so leaks and double destruction show up
+	struct Label
+	{
+		static inline int s_liveCount = 0;
+
+		std::string Text;
+
+		explicit Label(std::string text = {}) :
+			Text(std::move(text))
+		{
+			++s_liveCount;
+		}
+
+		Label(const Label& other) :
+			Text(other.Text)
+		{
+			++s_liveCount;
+		}
+
+		Label(Label&& other) noexcept :
+			Text(std::move(other.Text))
+		{
+			++s_liveCount;
+		}
+
+		Label& operator=(const Label&) = default;
+		Label& operator=(Label&&) = default;
+
+		~Label()
+		{
+			--s_liveCount;
+		}
+	};
+
+	void Setup(World& world)
+	{
+		world.Init();
+		world.RegisterComponent<Position>();
+		world.RegisterComponent<Health>();
+		world.RegisterComponent<Label>();
+	}
+
+	void TestAddRemoveKeepsValues()
+	{
+		World world;
+		Setup(world);
+
+		Entity entity = world.CreateEntity();
+		world.AddComponent(entity, Position{ 1.0f, 2.0f });
+		world.AddComponent(entity, Label{ "crate" });
+		world.AddComponent(entity, Health{ 7 });
+
+		CHECK(world.GetComponent<const Position>(entity).X == 1.0f);
+		CHECK(world.GetComponent<const Position>(entity).Y == 2.0f);
+		CHECK(world.GetComponent<const Label>(entity).Text == "crate");
+		CHECK(world.GetComponent<const Health>(entity).Value == 7);
+
+		world.RemoveComponent<Position>(entity);
+		CHECK(!world.HasComponent<Position>(entity));
+		CHECK(world.GetComponent<const Label>(entity).Text == "crate");
+		CHECK(world.GetComponent<const Health>(entity).Value == 7);
+
+		// Back into an archetype it was in before
+		world.AddComponent(entity, Position{ 3.0f, 4.0f });
+		CHECK(world.GetComponent<const Position>(entity).X == 3.0f);
+		CHECK(world.GetComponent<const Label>(entity).Text == "crate");
+
+		world.RemoveComponent<Label>(entity);
+		world.RemoveComponent<Health>(entity);
+		world.RemoveComponent<Position>(entity);
+		CHECK(world.GetComponentMask(entity).none());
+		CHECK(Label::s_liveCount == 0);
+	}
+
+	// Enough entities for several chunks, every other one leaves the archetype
+	void TestHolesAreFilled()
+	{
+		World world;
+		Setup(world);
+
+		constexpr int k_count = 2000;
+
+		std::vector<Entity> entities;
+		for (int i = 0; i < k_count; ++i)
+		{
+			Entity entity = world.CreateEntity();
+			world.AddComponent(entity, Health{ i });
+			world.AddComponent(entity, Label{ std::to_string(i) });
+			entities.push_back(entity);
+		}
+
+		for (int i = 0; i < k_count; i += 2)
+		{
+			if (i % 4 == 0)
+			{
+				world.DestroyEntity(entities[i]);
+			}
+			else
+			{
+				world.RemoveComponent<Label>(entities[i]);
+			}
+		}
+
+		for (int i = 0; i < k_count; ++i)
+		{
+			if (i % 4 == 0)
+			{
+				CHECK(!world.IsAlive(entities[i]));
+				continue;
+			}
+
+			CHECK(world.GetComponent<const Health>(entities[i]).Value == i);
+			CHECK(world.HasComponent<Label>(entities[i]) == (i % 2 == 1));
+			if (i % 2 == 1)
+			{
+				CHECK(world.GetComponent<const Label>(entities[i]).Text == std::to_string(i));
+			}
+		}
+
+		// Views see each remaining entity once
+		std::size_t labelCount = 0;
+		for (auto [entity, label] : world.View<const Label>())
+		{
+			CHECK(label.Text == std::to_string(world.GetComponent<const Health>(entity).Value));
+			++labelCount;
+		}
+		CHECK(labelCount == k_count / 2);
+		CHECK(Label::s_liveCount == k_count / 2);
+	}
+
+	// Destroying the world destroys the components still stored
+	void TestWorldTeardown()
+	{
+		{
+			World world;
+			Setup(world);
+
+			for (int i = 0; i < 100; ++i)
+			{
+				Entity entity = world.CreateEntity();
+				world.AddComponent(entity, Label{ "temporary" });
+			}
+			CHECK(Label::s_liveCount == 100);
+		}
+
+		CHECK(Label::s_liveCount == 0);
+	}
+}
+
+int main()
+{
+	TestAddRemoveKeepsValues();
+	TestHolesAreFilled();
+	TestWorldTeardown();
+
+	return alexis::testing::Report("ArchetypeTests");
+}
@@ -0,0 +1,155 @@
+#include <Precompiled.h>
+
+#include <ECS/ECS.h>
+
+#include <Testing/Check.h>
+
+// Changed<T> filters by per-chunk write versions: non-const access (GetComponent<T>, View<T>) stamps the chunk with the
+// current version, const access leaves it alone, and a filtered view skips chunks not written since the given version
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::ecs;
+
+	struct Position
+	{
+		float X{ 0.0f };
+	};
+
+	struct Velocity
+	{
+		float X{ 0.0f };
+	};
+
+	constexpr std::size_t k_entityCount = 3000;
+
+	struct Fixture
+	{
+		World EcsWorld;
+		std::vector<Entity> Entities;
+
+		// Entities of the first chunk, the front entity lives there
+		std::size_t FirstChunkSize{ 0 };
+		std::size_t ChunkCount{ 0 };
+
+		Fixture()
+		{
+			EcsWorld.Init();
+			EcsWorld.RegisterComponent<Position>();
+			EcsWorld.RegisterComponent<Velocity>();
+
+			for (std::size_t i = 0; i < k_entityCount; ++i)
+			{
+				Entity entity = EcsWorld.CreateEntity();
+				EcsWorld.AddComponent(entity, Position{});
+				EcsWorld.AddComponent(entity, Velocity{});
+				Entities.push_back(entity);
+			}
+
+			EcsWorld.ForEachChunk<const Position>([this](std::size_t count, const Entity*, const Position*)
+			{
+				FirstChunkSize = ChunkCount++ == 0 ? count : FirstChunkSize;
+			});
+		}
+
+		std::size_t CountChanged(std::uint32_t sinceVersion)
+		{
+			return EcsWorld.View<const Position, const Velocity>(Changed<Position>{ sinceVersion }).Count();
+		}
+	};
+
+	void TestEverythingNewAtFirst()
+	{
+		Fixture fixture;
+		CHECK(fixture.ChunkCount > 1);
+		CHECK(fixture.CountChanged(0) == fixture.Entities.size());
+	}
+
+	void TestGetComponent()
+	{
+		Fixture fixture;
+		auto& world = fixture.EcsWorld;
+
+		std::uint32_t since = world.AdvanceChangeVersion();
+		CHECK(fixture.CountChanged(since) == 0);
+
+		// Reading does not count as a change
+		CHECK(world.GetComponent<const Position>(fixture.Entities.front()).X == 0.0f);
+		CHECK(fixture.CountChanged(since) == 0);
+
+		// Writing one entity brings in its whole chunk, not the others
+		std::uint32_t before = world.GetComponentChangeVersion<Position>(fixture.Entities.front());
+		world.GetComponent<Position>(fixture.Entities.front()).X = 1.0f;
+		CHECK(world.GetComponentChangeVersion<Position>(fixture.Entities.front()) > before);
+		CHECK(fixture.CountChanged(since) == fixture.FirstChunkSize);
+
+		// Filter is per component: Velocity of that chunk did not change
+		CHECK((world.View<const Position, const Velocity>(Changed<Velocity>{ since }).Count() == 0));
+
+		// Next version: seen as old
+		std::uint32_t next = world.AdvanceChangeVersion();
+		CHECK(fixture.CountChanged(next) == 0);
+	}
+
+	void TestViewAccess()
+	{
+		Fixture fixture;
+		auto& world = fixture.EcsWorld;
+
+		std::uint32_t since = world.AdvanceChangeVersion();
+
+		for (auto [entity, position] : world.View<const Position>())
+		{
+			CHECK(position.X == 0.0f);
+		}
+		CHECK(fixture.CountChanged(since) == 0);
+
+		// Non-const view marks every chunk it visits
+		for (auto [entity, position] : world.View<Position>())
+		{
+			position.X += 1.0f;
+		}
+		CHECK(fixture.CountChanged(since) == fixture.Entities.size());
+
+		// A system only sees what was written after its previous run
+		std::uint32_t lastSystemVersion = world.AdvanceChangeVersion();
+		world.GetComponent<Position>(fixture.Entities.front()).X = 2.0f;
+
+		std::size_t visited = 0;
+		world.ForEachChunk<const Position>([&](std::size_t count, const Entity*, const Position*) { visited += count; }, Changed<Position>{ lastSystemVersion });
+		CHECK(visited == fixture.FirstChunkSize);
+	}
+
+	// Structural changes count as writes to the chunk receiving the entity
+	void TestStructuralChange()
+	{
+		Fixture fixture;
+		auto& world = fixture.EcsWorld;
+
+		std::uint32_t since = world.AdvanceChangeVersion();
+
+		Entity entity = world.CreateEntity();
+		world.AddComponent(entity, Position{});
+		world.AddComponent(entity, Velocity{});
+
+		// Only the last chunk, where the entity landed
+		bool isSeen = false;
+		for (auto [changedEntity, position, velocity] : world.View<const Position, const Velocity>(Changed<Position>{ since }))
+		{
+			isSeen |= changedEntity == entity;
+			CHECK(changedEntity != fixture.Entities.front());
+		}
+		CHECK(isSeen);
+		CHECK(fixture.CountChanged(since) < fixture.FirstChunkSize);
+	}
+}
+
+int main()
+{
+	TestEverythingNewAtFirst();
+	TestGetComponent();
+	TestViewAccess();
+	TestStructuralChange();
+
+	return alexis::testing::Report("ChangeVersionTests");
+}
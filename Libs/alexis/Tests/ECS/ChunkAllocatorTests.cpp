@@ -0,0 +1,249 @@
+#include <Precompiled.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <set>
+
+#include <ECS/ECS.h>
+#include <ECS/ChunkAllocator.h>
+
+#include <Testing/Check.h>
+
+// Counts every heap allocation of the process, structural changes must not add to it once the pool is warm
+namespace
+{
+	std::atomic<std::size_t> g_allocationCount{ 0 };
+
+	void* Allocate(std::size_t size, std::size_t alignment)
+	{
+		g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+		size = size ? size : 1;
+#if defined(_MSC_VER)
+		void* memory = _aligned_malloc(size, alignment);
+#else
+		void* memory = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+		if (!memory)
+		{
+			throw std::bad_alloc();
+		}
+
+		return memory;
+	}
+
+	void Deallocate(void* memory)
+	{
+#if defined(_MSC_VER)
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+}
+
+void* operator new(std::size_t size) { return Allocate(size, alignof(std::max_align_t)); }
+void* operator new[](std::size_t size) { return Allocate(size, alignof(std::max_align_t)); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return Allocate(size, static_cast<std::size_t>(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return Allocate(size, static_cast<std::size_t>(alignment)); }
+void operator delete(void* memory) noexcept { Deallocate(memory); }
+void operator delete[](void* memory) noexcept { Deallocate(memory); }
+void operator delete(void* memory, std::size_t) noexcept { Deallocate(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { Deallocate(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { Deallocate(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { Deallocate(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { Deallocate(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { Deallocate(memory); }
+
+namespace
+{
+	using namespace alexis::ecs;
+
+	struct Position
+	{
+		float X, Y, Z;
+	};
+
+	struct Velocity
+	{
+		float X, Y, Z;
+	};
+
+	// Over-aligned like CameraComponent::CameraData
+	struct alignas(16) Transform
+	{
+		float M[16];
+	};
+
+	struct Health
+	{
+		int Value;
+	};
+
+	struct Tag
+	{
+	};
+
+	struct MovingSystem : System
+	{
+	};
+
+	void TestChunkAllocator()
+	{
+		ChunkAllocator allocator;
+
+		std::vector<std::byte*> chunks;
+		for (std::size_t i = 0; i < ChunkAllocator::k_chunksPerSlab; ++i)
+		{
+			chunks.push_back(allocator.Allocate());
+		}
+
+		CHECK(allocator.GetSlabCount() == 1);
+		CHECK(allocator.GetFreeChunkCount() == 0);
+
+		std::set<std::byte*> distinct(chunks.begin(), chunks.end());
+		CHECK(distinct.size() == chunks.size());
+
+		for (std::size_t i = 0; i < chunks.size(); ++i)
+		{
+			CHECK(reinterpret_cast<std::uintptr_t>(chunks[i]) % k_chunkAlignment == 0);
+
+			// Fresh slab is handed out in address order
+			if (i > 0)
+			{
+				CHECK(chunks[i] == chunks[i - 1] + k_chunkSize);
+			}
+
+			// Whole chunk is writable
+			std::fill(chunks[i], chunks[i] + k_chunkSize, std::byte{ 0xCD });
+		}
+
+		// Next chunk needs a second slab
+		std::byte* extra = allocator.Allocate();
+		CHECK(allocator.GetSlabCount() == 2);
+		CHECK(allocator.GetFreeChunkCount() == ChunkAllocator::k_chunksPerSlab - 1);
+
+		// Freed chunks are recycled before anything new is carved
+		allocator.Free(chunks[3]);
+		CHECK(allocator.Allocate() == chunks[3]);
+
+		std::size_t allocationsBefore = g_allocationCount.load();
+		for (int i = 0; i < 1000; ++i)
+		{
+			std::byte* chunk = allocator.Allocate();
+			allocator.Free(chunk);
+		}
+		CHECK(g_allocationCount.load() == allocationsBefore);
+		CHECK(allocator.GetSlabCount() == 2);
+
+		allocator.Free(extra);
+		for (auto* chunk : chunks)
+		{
+			allocator.Free(chunk);
+		}
+		CHECK(allocator.GetFreeChunkCount() == 2 * ChunkAllocator::k_chunksPerSlab);
+	}
+
+	// Moves every entity through several archetypes and back
+	void Churn(World& world, const std::vector<Entity>& entities)
+	{
+		for (Entity entity : entities)
+		{
+			world.AddComponent(entity, Velocity{ 1.0f, 0.0f, 0.0f });
+		}
+
+		for (std::size_t i = 0; i < entities.size(); i += 2)
+		{
+			world.AddComponent(entities[i], Transform{});
+			world.AddComponent(entities[i], Tag{});
+		}
+
+		for (std::size_t i = 0; i < entities.size(); i += 3)
+		{
+			world.AddComponent(entities[i], Health{ 100 });
+		}
+
+		for (std::size_t i = 0; i < entities.size(); i += 3)
+		{
+			world.RemoveComponent<Health>(entities[i]);
+		}
+
+		for (std::size_t i = 0; i < entities.size(); i += 2)
+		{
+			world.RemoveComponent<Tag>(entities[i]);
+			world.RemoveComponent<Transform>(entities[i]);
+		}
+
+		for (Entity entity : entities)
+		{
+			world.RemoveComponent<Velocity>(entity);
+		}
+	}
+
+	void TestStructuralChangesDoNotAllocate()
+	{
+		World world;
+		world.Init();
+
+		world.RegisterComponent<Position>();
+		world.RegisterComponent<Velocity>();
+		world.RegisterComponent<Transform>();
+		world.RegisterComponent<Health>();
+		world.RegisterComponent<Tag>();
+
+		world.RegisterSystem<MovingSystem>();
+		{
+			ComponentMask mask;
+			mask.set(world.GetComponentType<Position>());
+			mask.set(world.GetComponentType<Velocity>());
+			world.SetSystemComponentMask<MovingSystem>(mask);
+		}
+
+		// Enough entities for several chunks per archetype
+		constexpr std::size_t k_entityCount = 4096;
+
+		std::vector<Entity> entities = world.CreateEntities(k_entityCount);
+		for (std::size_t i = 0; i < k_entityCount; ++i)
+		{
+			world.AddComponent(entities[i], Position{ static_cast<float>(i), 0.0f, 0.0f });
+		}
+
+		// Warm up: chunk pool, archetype graph, cached system matches and container capacities
+		Churn(world, entities);
+
+		std::size_t allocationsBefore = g_allocationCount.load();
+		for (int i = 0; i < 3; ++i)
+		{
+			Churn(world, entities);
+		}
+		std::size_t allocations = g_allocationCount.load() - allocationsBefore;
+
+		if (allocations)
+		{
+			std::fprintf(stderr, "  %zu allocation(s) during warm churn\n", allocations);
+		}
+		CHECK(allocations == 0);
+
+		// Data survived all the moves
+		std::size_t count = 0;
+		world.View<const Position>().ForEachChunk([&count](std::size_t size, const Entity*, const Position* positions)
+		{
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				count += positions[i].Y == 0.0f ? 1 : 0;
+			}
+		});
+		CHECK(count == k_entityCount);
+		CHECK(world.GetSystem<MovingSystem>()->Entities.empty());
+	}
+}
+
+int main()
+{
+	TestChunkAllocator();
+	TestStructuralChangesDoNotAllocate();
+
+	return alexis::testing::Report("ChunkAllocatorTests");
+}
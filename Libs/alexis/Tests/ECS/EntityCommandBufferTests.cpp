@@ -0,0 +1,254 @@
+#include <Precompiled.h>
+
+#include <string>
+#include <thread>
+
+#include <ECS/ECS.h>
+#include <ECS/EntityCommandBuffer.h>
+
+#include <Testing/Check.h>
+
+// EntityCommandBuffer playback: commands of one entity apply in recording order and end in a single archetype move
+// and system update, placeholders become real entities in creation order, destroy drops everything recorded for the
+// entity, and recording from several threads loses nothing. Payloads are destroyed exactly once
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::ecs;
+
+	struct Position
+	{
+		float X{ 0.0f };
+	};
+
+	struct Velocity
+	{
+		float X{ 0.0f };
+	};
+
+	// Counts live instances, payloads left behind or destroyed twice show up
+	struct Label
+	{
+		static inline int s_liveCount = 0;
+
+		std::string Text;
+
+		explicit Label(std::string text = {}) :
+			Text(std::move(text))
+		{
+			++s_liveCount;
+		}
+
+		Label(const Label& other) :
+			Text(other.Text)
+		{
+			++s_liveCount;
+		}
+
+		Label(Label&& other) noexcept :
+			Text(std::move(other.Text))
+		{
+			++s_liveCount;
+		}
+
+		Label& operator=(const Label&) = default;
+		Label& operator=(Label&&) = default;
+
+		~Label()
+		{
+			--s_liveCount;
+		}
+	};
+
+	struct MovingSystem : System
+	{
+	};
+
+	MovingSystem* Setup(World& world)
+	{
+		world.Init();
+		world.RegisterComponent<Position>();
+		world.RegisterComponent<Velocity>();
+		world.RegisterComponent<Label>();
+
+		auto* system = world.RegisterSystem<MovingSystem>().get();
+		ComponentMask mask;
+		mask.set(world.GetComponentType<Position>());
+		mask.set(world.GetComponentType<Velocity>());
+		world.SetSystemComponentMask<MovingSystem>(mask);
+
+		return system;
+	}
+
+	void TestRecordingOrder()
+	{
+		World world;
+		Setup(world);
+
+		Entity replaced = world.CreateEntity();
+		Entity removed = world.CreateEntity();
+		Entity readded = world.CreateEntity();
+		world.AddComponent(readded, Position{ 1.0f });
+
+		EntityCommandBuffer commands(world);
+		commands.AddComponent(replaced, Position{ 1.0f });
+		commands.AddComponent(removed, Position{ 1.0f });
+		commands.AddComponent(replaced, Position{ 2.0f });
+		commands.RemoveComponent<Position>(removed);
+		commands.RemoveComponent<Position>(readded);
+		commands.AddComponent(readded, Position{ 3.0f });
+
+		// Nothing happens before playback
+		CHECK(!world.HasComponent<Position>(replaced));
+		CHECK(world.GetComponent<const Position>(readded).X == 1.0f);
+
+		commands.Playback();
+		CHECK(commands.IsEmpty());
+
+		CHECK(world.GetComponent<const Position>(replaced).X == 2.0f);
+		CHECK(!world.HasComponent<Position>(removed));
+		CHECK(world.GetComponent<const Position>(readded).X == 3.0f);
+	}
+
+	void TestCoalescedMembership()
+	{
+		World world;
+		auto* system = Setup(world);
+
+		Entity entity = world.CreateEntity();
+		std::uint32_t version = system->Entities.GetVersion();
+
+		EntityCommandBuffer commands(world);
+		commands.AddComponent(entity, Position{});
+		commands.AddComponent(entity, Velocity{});
+		commands.AddComponent(entity, Label{ "moving" });
+		commands.Playback();
+
+		// One insert for three adds
+		CHECK(system->Entities.contains(entity));
+		CHECK(system->Entities.GetVersion() == version + 1);
+		CHECK(world.GetComponent<const Label>(entity).Text == "moving");
+	}
+
+	void TestPlaceholders()
+	{
+		World world;
+		auto* system = Setup(world);
+
+		EntityCommandBuffer commands(world);
+		Entity first = commands.CreateEntity();
+		Entity second = commands.CreateEntity();
+		CHECK(EntityCommandBuffer::IsDeferred(first));
+		CHECK(!world.IsAlive(first));
+
+		commands.AddComponent(second, Position{ 2.0f });
+		commands.AddComponent(second, Velocity{});
+		commands.AddComponent(first, Position{ 1.0f });
+		commands.Playback();
+
+		// Created in recording order: the first placeholder gets the lower index
+		std::array<std::uint32_t, 2> indices{};
+		for (auto [entity, position] : world.View<const Position>())
+		{
+			CHECK(world.IsAlive(entity));
+			indices[position.X == 1.0f ? 0 : 1] = entity.Index;
+		}
+		CHECK(world.View<const Position>().Count() == 2);
+		CHECK(indices[0] < indices[1]);
+
+		CHECK(system->Entities.size() == 1);
+		for (auto [entity, position, velocity] : world.View<const Position, const Velocity>())
+		{
+			CHECK(position.X == 2.0f);
+			CHECK(system->Entities.contains(entity));
+		}
+	}
+
+	void TestDestroy()
+	{
+		World world;
+		auto* system = Setup(world);
+
+		Entity entity = world.CreateEntity();
+		world.AddComponent(entity, Position{});
+		world.AddComponent(entity, Velocity{});
+
+		EntityCommandBuffer commands(world);
+		commands.AddComponent(entity, Label{ "dropped" });
+		commands.DestroyEntity(entity);
+
+		// Created and destroyed within the same playback
+		Entity temporary = commands.CreateEntity();
+		commands.AddComponent(temporary, Label{ "temporary" });
+		commands.DestroyEntity(temporary);
+		commands.Playback();
+
+		CHECK(!world.IsAlive(entity));
+		CHECK(system->Entities.empty());
+		CHECK(world.View<const Label>().Count() == 0);
+		CHECK(Label::s_liveCount == 0);
+
+		// Never played back: the buffer still owns the payload
+		{
+			EntityCommandBuffer pending(world);
+			pending.AddComponent(pending.CreateEntity(), Label{ "pending" });
+			CHECK(Label::s_liveCount == 1);
+		}
+		CHECK(Label::s_liveCount == 0);
+	}
+
+	void TestThreads()
+	{
+		World world;
+		Setup(world);
+
+		constexpr int k_threadCount = 4;
+		constexpr int k_perThread = 1000;
+
+		EntityCommandBuffer commands(world);
+
+		std::vector<std::thread> threads;
+		for (int thread = 0; thread < k_threadCount; ++thread)
+		{
+			threads.emplace_back([&commands, thread]()
+			{
+				for (int i = 0; i < k_perThread; ++i)
+				{
+					Entity entity = commands.CreateEntity();
+					commands.AddComponent(entity, Position{ static_cast<float>(thread) });
+					commands.AddComponent(entity, Label{ std::to_string(i) });
+				}
+			});
+		}
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+
+		commands.Playback();
+
+		std::vector<int> perThread(k_threadCount, 0);
+		for (auto [entity, position, label] : world.View<const Position, const Label>())
+		{
+			++perThread[static_cast<int>(position.X)];
+		}
+
+		for (int count : perThread)
+		{
+			CHECK(count == k_perThread);
+		}
+		CHECK(Label::s_liveCount == k_threadCount * k_perThread);
+	}
+}
+
+int main()
+{
+	TestRecordingOrder();
+	TestCoalescedMembership();
+	TestPlaceholders();
+	TestDestroy();
+	TestThreads();
+
+	return alexis::testing::Report("EntityCommandBufferTests");
+}
@@ -0,0 +1,106 @@
+#include <Precompiled.h>
+
+#include <ECS/ECS.h>
+
+#include <Testing/Check.h>
+
+// Generational handles: a destroyed entity's index is reused with a new generation, so stale handles are not alive
+// and never reach the new entity's components. Capacity grows past the old fixed limit of 5000 entities
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::ecs;
+
+	struct Health
+	{
+		int Value{ 0 };
+	};
+
+	void TestStaleHandle()
+	{
+		World world;
+		world.Init();
+		world.RegisterComponent<Health>();
+
+		Entity first = world.CreateEntity();
+		world.AddComponent(first, Health{ 1 });
+		CHECK(first.IsValid());
+		CHECK(world.IsAlive(first));
+
+		world.DestroyEntity(first);
+		CHECK(!world.IsAlive(first));
+
+		// Same slot, next generation
+		Entity second = world.CreateEntity();
+		CHECK(second.Index == first.Index);
+		CHECK(second.Generation != first.Generation);
+		CHECK(second != first);
+		CHECK(world.IsAlive(second));
+		CHECK(!world.IsAlive(first));
+
+		// The new entity starts without the old one's components, the stale handle sees nothing
+		CHECK(!world.HasComponent<Health>(second));
+		CHECK(!world.HasComponent<Health>(first));
+
+		world.AddComponent(second, Health{ 2 });
+		CHECK(world.GetComponent<const Health>(second).Value == 2);
+		CHECK(!world.HasComponent<Health>(first));
+	}
+
+	void TestInvalidHandle()
+	{
+		World world;
+		world.Init();
+
+		CHECK(!k_invalidEntity.IsValid());
+		CHECK(!world.IsAlive(k_invalidEntity));
+		CHECK(!world.IsAlive(Entity{ 12345, 0 }));
+	}
+
+	void TestGrowth()
+	{
+		World world;
+		world.Init();
+		world.RegisterComponent<Health>();
+
+		constexpr int k_count = 20000;
+
+		std::vector<Entity> entities;
+		for (int i = 0; i < k_count; ++i)
+		{
+			entities.push_back(world.CreateEntity());
+		}
+		world.AddComponent(entities.back(), Health{ k_count });
+
+		CHECK(world.IsAlive(entities.front()));
+		CHECK(world.GetComponent<const Health>(entities.back()).Value == k_count);
+
+		// Freed indices come back before the tables grow
+		for (int i = 0; i < 100; ++i)
+		{
+			world.DestroyEntity(entities[i]);
+		}
+
+		std::uint32_t maxIndex = 0;
+		for (int i = 0; i < 100; ++i)
+		{
+			Entity entity = world.CreateEntity();
+			CHECK(entity.Generation == 1);
+			maxIndex = std::max(maxIndex, entity.Index);
+		}
+		CHECK(maxIndex < 100);
+
+		// Indices are unique among living entities
+		auto more = world.CreateEntities(10);
+		CHECK(more.front().Index == k_count);
+	}
+}
+
+int main()
+{
+	TestStaleHandle();
+	TestInvalidHandle();
+	TestGrowth();
+
+	return alexis::testing::Report("EntityTests");
+}
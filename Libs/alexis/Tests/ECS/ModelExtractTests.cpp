@@ -0,0 +1,139 @@
+#include <Precompiled.h>
+
+#include <Core/Core.h>
+#include <Render/Mesh.h>
+#include <Render/RenderScene.h>
+
+#include <ECS/Components/ModelComponent.h>
+#include <ECS/Components/TransformComponent.h>
+#include <ECS/Systems/ModelSystem.h>
+
+#include <Testing/Check.h>
+
+// ModelSystem::Extract rebuilds the proxies when models come or go and otherwise rewrites only chunks changed since
+// the previous extract: MovedModels lists exactly the proxies whose mesh or matrix differs, untouched frames cost nothing
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::ecs;
+
+	constexpr std::size_t k_modelCount = 1000;
+
+	ModelSystem* Setup(World& world)
+	{
+		world.RegisterComponent<TransformComponent>();
+		world.RegisterComponent<ModelComponent>();
+
+		auto* system = world.RegisterSystem<ModelSystem>().get();
+
+		// Same mask as SystemsHolder
+		ComponentMask mask;
+		mask.set(world.GetComponentType<ModelComponent>());
+		mask.set(world.GetComponentType<TransformComponent>());
+		world.SetSystemComponentMask<ModelSystem>(mask);
+
+		return system;
+	}
+
+	Entity CreateModel(World& world, Mesh& mesh, float x)
+	{
+		Entity entity = world.CreateEntity();
+		world.AddComponent(entity, TransformComponent{ XMVectorSet(x, 0.0f, 0.0f, 1.0f), XMQuaternionIdentity(), 1.0f });
+		world.AddComponent(entity, ModelComponent{ &mesh, nullptr, XMMatrixTranslation(x, 0.0f, 0.0f) });
+		return entity;
+	}
+
+	// Proxy of the entity, found by its unique translation
+	std::uint32_t FindProxy(const RenderScene& scene, float x)
+	{
+		for (std::uint32_t proxy = 0; proxy < scene.Models.Size(); ++proxy)
+		{
+			if (XMVectorGetX(scene.Models.WorldMatrices[proxy].r[3]) == x)
+			{
+				return proxy;
+			}
+		}
+		return std::numeric_limits<std::uint32_t>::max();
+	}
+
+	void TestExtract(World& world, ModelSystem& system)
+	{
+		Mesh cube(L"cube", { { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } }, {});
+		Mesh other(L"other", { { -2.0f, -2.0f, -2.0f }, { 2.0f, 2.0f, 2.0f } }, {});
+
+		std::vector<Entity> entities;
+		for (std::size_t i = 0; i < k_modelCount; ++i)
+		{
+			entities.push_back(CreateModel(world, cube, static_cast<float>(i) * 10.0f));
+		}
+
+		// Models without transform are not rendered
+		Entity unplaced = world.CreateEntity();
+		world.AddComponent(unplaced, ModelComponent{ &cube, nullptr, XMMatrixIdentity() });
+
+		RenderScene scene;
+		system.Extract(scene);
+		CHECK(scene.Models.Size() == k_modelCount);
+		CHECK(scene.ModelsVersion == 1);
+		CHECK(scene.MovedModels.empty());
+
+		std::uint32_t proxy = FindProxy(scene, 50.0f);
+		CHECK(proxy < scene.Models.Size());
+		CHECK(scene.Models.Meshes[proxy] == &cube);
+		CHECK(scene.Models.Boxes[proxy].Center.x == 50.0f);
+		CHECK(scene.Models.SphereCenterX[proxy] == 50.0f);
+
+		// Nothing written: same proxies, nothing moved
+		system.Extract(scene);
+		CHECK(scene.ModelsVersion == 1);
+		CHECK(scene.MovedModels.empty());
+
+		// One model moved: its whole chunk is rewritten but only it is reported
+		world.GetComponent<ModelComponent>(entities[5]).ModelMatrix = XMMatrixTranslation(55.0f, 0.0f, 0.0f);
+		system.Extract(scene);
+		CHECK(scene.ModelsVersion == 1);
+		CHECK(scene.MovedModels.size() == 1);
+		CHECK(!scene.MovedModels.empty() && scene.MovedModels[0] == proxy);
+		CHECK(scene.Models.Boxes[proxy].Center.x == 55.0f);
+
+		// Moved list is per extract
+		system.Extract(scene);
+		CHECK(scene.MovedModels.empty());
+
+		// Written without a change, or with only the material changed: not moved
+		world.GetComponent<ModelComponent>(entities[6]);
+		world.GetComponent<ModelComponent>(entities[7]).Material = reinterpret_cast<Material*>(&other);
+		system.Extract(scene);
+		CHECK(scene.MovedModels.empty());
+		CHECK(scene.Models.Materials[FindProxy(scene, 70.0f)] == reinterpret_cast<Material*>(&other));
+
+		// Mesh swap is a move
+		world.GetComponent<ModelComponent>(entities[8]).Mesh = &other;
+		system.Extract(scene);
+		CHECK(scene.MovedModels.size() == 1);
+		CHECK(scene.Models.Boxes[FindProxy(scene, 80.0f)].Extents.x == 2.0f);
+
+		// Membership changes rebuild
+		world.DestroyEntity(entities[0]);
+		world.AddComponent(unplaced, TransformComponent{ XMVectorZero(), XMQuaternionIdentity(), 1.0f });
+		system.Extract(scene);
+		CHECK(scene.ModelsVersion == 2);
+		CHECK(scene.Models.Size() == k_modelCount);
+		CHECK(scene.MovedModels.empty());
+		CHECK(scene.Models.Meshes[FindProxy(scene, 0.0f)] == &cube);
+	}
+}
+
+int main()
+{
+	Core::Create(1);
+	{
+		auto& world = Core::Get().GetECSWorld();
+		auto* system = Setup(world);
+
+		TestExtract(world, *system);
+	}
+	Core::Destroy();
+
+	return alexis::testing::Report("ModelExtractTests");
+}
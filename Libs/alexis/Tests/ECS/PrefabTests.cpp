@@ -0,0 +1,159 @@
+#include <Precompiled.h>
+
+#include <string>
+
+#include <ECS/ECS.h>
+#include <ECS/Prefab.h>
+
+#include <Testing/Check.h>
+
+// Prefab instantiation: every instance gets its own copy of each prefab component, instances are independent of each
+// other and of later prefab changes, tags come from the mask, and the prefab owns its values until it is destroyed
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::ecs;
+
+	struct Position
+	{
+		float X{ 0.0f };
+	};
+
+	struct Selected
+	{
+	};
+
+	// Counts live instances, leaked or doubly destroyed copies show up
+	struct Label
+	{
+		static inline int s_liveCount = 0;
+
+		std::string Text;
+
+		explicit Label(std::string text = {}) :
+			Text(std::move(text))
+		{
+			++s_liveCount;
+		}
+
+		Label(const Label& other) :
+			Text(other.Text)
+		{
+			++s_liveCount;
+		}
+
+		Label(Label&& other) noexcept :
+			Text(std::move(other.Text))
+		{
+			++s_liveCount;
+		}
+
+		Label& operator=(const Label&) = default;
+		Label& operator=(Label&&) = default;
+
+		~Label()
+		{
+			--s_liveCount;
+		}
+	};
+
+	void Setup(World& world)
+	{
+		world.Init();
+		world.RegisterComponent<Position>();
+		world.RegisterComponent<Selected>();
+		world.RegisterComponent<Label>();
+	}
+
+	void TestInstances()
+	{
+		World world;
+		Setup(world);
+
+		Prefab prefab(world);
+		prefab.Set(Position{ 1.0f }).Set(Label{ "crate" }).Set(Selected{});
+		CHECK(prefab.Has<Position>());
+		CHECK(prefab.Has<Selected>());
+		CHECK(Label::s_liveCount == 1);
+
+		// Set again replaces the value
+		prefab.Set(Position{ 2.0f });
+		CHECK(prefab.Get<Position>().X == 2.0f);
+
+		constexpr std::size_t k_count = 3000;
+		auto instances = world.CreateEntities(k_count, prefab);
+		CHECK(instances.size() == k_count);
+		CHECK(Label::s_liveCount == static_cast<int>(k_count) + 1);
+
+		for (auto entity : instances)
+		{
+			CHECK(world.IsAlive(entity));
+			CHECK(world.GetComponentMask(entity) == prefab.GetComponentMask());
+			CHECK(world.HasComponent<Selected>(entity));
+			CHECK(world.GetComponent<const Position>(entity).X == 2.0f);
+			CHECK(world.GetComponent<const Label>(entity).Text == "crate");
+		}
+
+		// Instances are copies: neither the prefab nor their siblings see a write
+		world.GetComponent<Label>(instances[5]).Text = "opened";
+		prefab.Get<Label>().Text = "barrel";
+		CHECK(world.GetComponent<const Label>(instances[4]).Text == "crate");
+		CHECK(world.GetComponent<const Label>(instances[6]).Text == "crate");
+
+		// Later instances take the new value
+		auto barrels = world.CreateEntities(2, prefab);
+		CHECK(world.GetComponent<const Label>(barrels[1]).Text == "barrel");
+
+		CHECK((world.View<const Position, const Label>().Count() == k_count + 2));
+	}
+
+	// Instances are regular entities afterwards
+	void TestInstanceChanges()
+	{
+		World world;
+		Setup(world);
+
+		Prefab prefab(world);
+		prefab.Set(Position{ 1.0f }).Set(Label{ "crate" });
+		auto instances = world.CreateEntities(10, prefab);
+
+		world.RemoveComponent<Label>(instances[0]);
+		world.AddComponent(instances[1], Selected{});
+		world.DestroyEntity(instances[2]);
+
+		CHECK(!world.HasComponent<Label>(instances[0]));
+		CHECK(world.GetComponent<const Position>(instances[0]).X == 1.0f);
+		CHECK(world.HasComponent<Selected>(instances[1]));
+		CHECK(!world.IsAlive(instances[2]));
+		CHECK(world.GetComponent<const Label>(instances[9]).Text == "crate");
+		CHECK(world.View<const Label>().Count() == 8);
+	}
+
+	void TestEmpty()
+	{
+		World world;
+		Setup(world);
+
+		Prefab prefab(world);
+		CHECK(world.CreateEntities(0, prefab).empty());
+
+		auto bare = world.CreateEntities(4, prefab);
+		for (auto entity : bare)
+		{
+			CHECK(world.IsAlive(entity));
+			CHECK(world.GetComponentMask(entity).none());
+		}
+	}
+}
+
+int main()
+{
+	TestInstances();
+	TestInstanceChanges();
+	TestEmpty();
+
+	// Worlds and prefabs are gone, so are their copies
+	CHECK(Label::s_liveCount == 0);
+
+	return alexis::testing::Report("PrefabTests");
+}
@@ -0,0 +1,141 @@
+#include <Precompiled.h>
+
+#include <ECS/ECS.h>
+#include <ECS/Prefab.h>
+
+#include <Testing/Check.h>
+
+// Systems hold exactly the entities satisfying their mask, through create, add, remove, destroy and prefab
+// instantiation. A system without a mask (like the editor outliner) holds every living entity
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::ecs;
+
+	struct Position
+	{
+		float X{ 0.0f };
+	};
+
+	struct Velocity
+	{
+		float X{ 0.0f };
+	};
+
+	struct MovingSystem : System
+	{
+	};
+
+	struct AllEntitiesSystem : System
+	{
+	};
+
+	struct Fixture
+	{
+		World EcsWorld;
+		MovingSystem* Moving{ nullptr };
+		AllEntitiesSystem* All{ nullptr };
+
+		Fixture()
+		{
+			EcsWorld.Init();
+			EcsWorld.RegisterComponent<Position>();
+			EcsWorld.RegisterComponent<Velocity>();
+
+			Moving = EcsWorld.RegisterSystem<MovingSystem>().get();
+			ComponentMask mask;
+			mask.set(EcsWorld.GetComponentType<Position>());
+			mask.set(EcsWorld.GetComponentType<Velocity>());
+			EcsWorld.SetSystemComponentMask<MovingSystem>(mask);
+
+			All = EcsWorld.RegisterSystem<AllEntitiesSystem>().get();
+			EcsWorld.SetSystemComponentMask<AllEntitiesSystem>(ComponentMask{});
+		}
+	};
+
+	void TestMaskless()
+	{
+		Fixture fixture;
+		auto& world = fixture.EcsWorld;
+
+		Entity entity = world.CreateEntity();
+		CHECK(fixture.All->Entities.contains(entity));
+		CHECK(!fixture.Moving->Entities.contains(entity));
+
+		auto entities = world.CreateEntities(10);
+		CHECK(fixture.All->Entities.size() == 11);
+
+		Prefab prefab(world);
+		prefab.Set(Position{ 1.0f });
+		auto instances = world.CreateEntities(5, prefab);
+		CHECK(fixture.All->Entities.size() == 16);
+
+		// Components come and go, the entity stays
+		world.AddComponent(entity, Position{});
+		world.RemoveComponent<Position>(entity);
+		CHECK(fixture.All->Entities.contains(entity));
+
+		world.DestroyEntity(entity);
+		world.DestroyEntity(instances[0]);
+		CHECK(!fixture.All->Entities.contains(entity));
+		CHECK(fixture.All->Entities.size() == 14);
+	}
+
+	void TestMasked()
+	{
+		Fixture fixture;
+		auto& world = fixture.EcsWorld;
+
+		Entity entity = world.CreateEntity();
+		world.AddComponent(entity, Position{});
+		CHECK(!fixture.Moving->Entities.contains(entity));
+
+		world.AddComponent(entity, Velocity{});
+		CHECK(fixture.Moving->Entities.contains(entity));
+
+		world.RemoveComponent<Position>(entity);
+		CHECK(!fixture.Moving->Entities.contains(entity));
+
+		world.AddComponent(entity, Position{});
+		CHECK(fixture.Moving->Entities.contains(entity));
+
+		// Same transition again goes through the cached one
+		Entity other = world.CreateEntity();
+		world.AddComponent(other, Position{});
+		world.AddComponent(other, Velocity{});
+		CHECK(fixture.Moving->Entities.size() == 2);
+
+		world.DestroyEntity(entity);
+		CHECK(!fixture.Moving->Entities.contains(entity));
+		CHECK(fixture.Moving->Entities.contains(other));
+
+		Prefab prefab(world);
+		prefab.Set(Position{}).Set(Velocity{});
+		world.CreateEntities(3, prefab);
+		CHECK(fixture.Moving->Entities.size() == 4);
+	}
+
+	// Mask set after entities exist: later changes use the new mask
+	void TestMaskChange()
+	{
+		Fixture fixture;
+		auto& world = fixture.EcsWorld;
+
+		ComponentMask positionOnly;
+		positionOnly.set(world.GetComponentType<Position>());
+		world.SetSystemComponentMask<MovingSystem>(positionOnly);
+
+		Entity entity = world.CreateEntity();
+		world.AddComponent(entity, Position{});
+		CHECK(fixture.Moving->Entities.contains(entity));
+	}
+}
+
+int main()
+{
+	TestMaskless();
+	TestMasked();
+	TestMaskChange();
+
+	return alexis::testing::Report("SystemMembershipTests");
+}
@@ -0,0 +1,150 @@
+#include <Precompiled.h>
+
+#include <ECS/ECS.h>
+#include <ECS/EntityCommandBuffer.h>
+
+#include <Testing/Check.h>
+
+// Empty components are tags living in the entity mask only: adding or removing one does not move the entity's
+// components or stamp their chunks, systems still filter by tags, and command buffers record them without payload
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::ecs;
+
+	struct Position
+	{
+		float X{ 0.0f };
+	};
+
+	struct Selected
+	{
+	};
+
+	struct Static
+	{
+	};
+
+	struct SelectedSystem : System
+	{
+	};
+
+	static_assert(k_isTagComponent<Selected>);
+	static_assert(k_isTagComponent<const Static>);
+	static_assert(!k_isTagComponent<Position>);
+
+	SelectedSystem* Setup(World& world)
+	{
+		world.Init();
+		world.RegisterComponent<Position>();
+		world.RegisterComponent<Selected>();
+		world.RegisterComponent<Static>();
+
+		auto* system = world.RegisterSystem<SelectedSystem>().get();
+		ComponentMask mask;
+		mask.set(world.GetComponentType<Position>());
+		mask.set(world.GetComponentType<Selected>());
+		world.SetSystemComponentMask<SelectedSystem>(mask);
+
+		return system;
+	}
+
+	std::size_t CountChunks(World& world)
+	{
+		std::size_t chunkCount = 0;
+		world.ForEachChunk<const Position>([&](std::size_t, const Entity*, const Position*) { ++chunkCount; });
+		return chunkCount;
+	}
+
+	void TestMaskOnly()
+	{
+		World world;
+		auto* system = Setup(world);
+
+		std::vector<Entity> entities;
+		for (int i = 0; i < 100; ++i)
+		{
+			Entity entity = world.CreateEntity();
+			world.AddComponent(entity, Position{ static_cast<float>(i) });
+			entities.push_back(entity);
+		}
+		CHECK(CountChunks(world) == 1);
+
+		std::uint32_t since = world.AdvanceChangeVersion();
+
+		// Every other entity tagged: still one archetype, one chunk, nothing written
+		for (int i = 0; i < 100; i += 2)
+		{
+			world.AddComponent(entities[i], Selected{});
+		}
+		CHECK(CountChunks(world) == 1);
+		CHECK(world.View<const Position>(Changed<Position>{ since }).Count() == 0);
+
+		for (int i = 0; i < 100; ++i)
+		{
+			CHECK(world.HasComponent<Selected>(entities[i]) == (i % 2 == 0));
+			CHECK(world.GetComponentMask(entities[i]).test(world.GetComponentType<Selected>()) == (i % 2 == 0));
+			CHECK(world.GetComponent<const Position>(entities[i]).X == static_cast<float>(i));
+		}
+
+		// Systems filter by the tag bit
+		CHECK(system->Entities.size() == 50);
+
+		world.RemoveComponent<Selected>(entities[0]);
+		CHECK(!world.HasComponent<Selected>(entities[0]));
+		CHECK(!system->Entities.contains(entities[0]));
+		CHECK(system->Entities.size() == 49);
+		CHECK(CountChunks(world) == 1);
+	}
+
+	// An entity with tags only has no storage at all
+	void TestTagOnlyEntity()
+	{
+		World world;
+		Setup(world);
+
+		Entity entity = world.CreateEntity();
+		world.AddComponent(entity, Static{});
+		world.AddComponent(entity, Selected{});
+		CHECK(world.HasComponent<Static>(entity));
+		CHECK(!world.HasComponent<Position>(entity));
+		CHECK(world.GetComponentMask(entity).count() == 2);
+		CHECK(CountChunks(world) == 0);
+
+		// Storage appears with the first real component
+		world.AddComponent(entity, Position{ 3.0f });
+		CHECK(world.HasComponent<Static>(entity));
+		CHECK(world.GetComponent<const Position>(entity).X == 3.0f);
+
+		world.DestroyEntity(entity);
+		CHECK(!world.HasComponent<Static>(entity));
+	}
+
+	void TestCommandBuffer()
+	{
+		World world;
+		auto* system = Setup(world);
+
+		Entity entity = world.CreateEntity();
+		world.AddComponent(entity, Position{});
+
+		EntityCommandBuffer commands(world);
+		commands.AddComponent(entity, Selected{});
+		commands.AddComponent(entity, Static{});
+		commands.RemoveComponent<Static>(entity);
+		commands.Playback();
+
+		CHECK(world.HasComponent<Selected>(entity));
+		CHECK(!world.HasComponent<Static>(entity));
+		CHECK(system->Entities.contains(entity));
+	}
+}
+
+int main()
+{
+	TestMaskOnly();
+	TestTagOnlyEntity();
+	TestCommandBuffer();
+
+	return alexis::testing::Report("TagComponentTests");
+}
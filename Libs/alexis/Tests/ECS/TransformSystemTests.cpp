@@ -0,0 +1,186 @@
+#include <Precompiled.h>
+
+#include <Core/Core.h>
+
+#include <ECS/Components/HierarchyComponent.h>
+#include <ECS/Components/ModelComponent.h>
+#include <ECS/Components/TransformComponent.h>
+#include <ECS/Systems/TransformSystem.h>
+
+#include <Testing/Check.h>
+
+// World matrices follow the hierarchy, SetParent refuses links that would close a cycle
+// and cycles written directly into HierarchyComponent do not stop their nodes from updating
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::ecs;
+
+	TransformSystem* Setup(World& world)
+	{
+		world.RegisterComponent<TransformComponent>();
+		world.RegisterComponent<HierarchyComponent>();
+		world.RegisterComponent<ModelComponent>();
+
+		auto* system = world.RegisterSystem<TransformSystem>().get();
+
+		ComponentMask mask;
+		mask.set(world.GetComponentType<TransformComponent>());
+		world.SetSystemComponentMask<TransformSystem>(mask);
+
+		return system;
+	}
+
+	// Same bookkeeping as a FrameUpdateGraph node
+	void RunUpdate(World& world, TransformSystem& system)
+	{
+		std::uint32_t version = world.AdvanceChangeVersion();
+		system.Update(0.0f);
+		system.LastSystemVersion = version;
+	}
+
+	TransformComponent MakeTransform(float x, float angle, float scale)
+	{
+		return TransformComponent{ XMVectorSet(x, 1.0f, -2.0f, 1.0f), XMQuaternionRotationRollPitchYaw(0.1f, angle, 0.0f), scale };
+	}
+
+	XMMATRIX LocalMatrix(const TransformComponent& transform)
+	{
+		XMMATRIX scaling = XMMatrixScaling(transform.UniformScale, transform.UniformScale, transform.UniformScale);
+		return XMMatrixMultiply(XMMatrixMultiply(scaling, XMMatrixRotationQuaternion(transform.Rotation)), XMMatrixTranslationFromVector(transform.Position));
+	}
+
+	void CheckMatrix(FXMMATRIX a, CXMMATRIX b)
+	{
+		XMFLOAT4X4 fa;
+		XMFLOAT4X4 fb;
+		XMStoreFloat4x4(&fa, a);
+		XMStoreFloat4x4(&fb, b);
+
+		for (int row = 0; row < 4; ++row)
+		{
+			for (int column = 0; column < 4; ++column)
+			{
+				CHECK_NEAR(fa.m[row][column], fb.m[row][column], 1e-4);
+			}
+		}
+	}
+
+	Entity CreateNode(World& world, const TransformComponent& transform)
+	{
+		Entity entity = world.CreateEntity();
+		world.AddComponent(entity, TransformComponent{ transform });
+		world.AddComponent(entity, ModelComponent{});
+		return entity;
+	}
+
+	void TestPropagation(World& world, TransformSystem& system)
+	{
+		auto rootTransform = MakeTransform(1.0f, 0.3f, 2.0f);
+		auto childTransform = MakeTransform(-3.0f, 1.1f, 0.5f);
+		auto grandchildTransform = MakeTransform(0.5f, -0.7f, 1.5f);
+
+		Entity root = CreateNode(world, rootTransform);
+		Entity child = CreateNode(world, childTransform);
+		Entity grandchild = CreateNode(world, grandchildTransform);
+
+		CHECK(system.SetParent(child, root));
+		CHECK(system.SetParent(grandchild, child));
+		RunUpdate(world, system);
+
+		XMMATRIX rootWorld = LocalMatrix(rootTransform);
+		XMMATRIX childWorld = XMMatrixMultiply(LocalMatrix(childTransform), rootWorld);
+		XMMATRIX grandchildWorld = XMMatrixMultiply(LocalMatrix(grandchildTransform), childWorld);
+
+		CheckMatrix(system.GetWorldMatrix(root), rootWorld);
+		CheckMatrix(system.GetWorldMatrix(child), childWorld);
+		CheckMatrix(system.GetWorldMatrix(grandchild), grandchildWorld);
+		CheckMatrix(world.GetComponent<const ModelComponent>(grandchild).ModelMatrix, grandchildWorld);
+
+		// Moving the root alone reaches the whole subtree
+		rootTransform = MakeTransform(4.0f, -0.2f, 1.0f);
+		world.GetComponent<TransformComponent>(root) = rootTransform;
+		RunUpdate(world, system);
+
+		grandchildWorld = XMMatrixMultiply(LocalMatrix(grandchildTransform), XMMatrixMultiply(LocalMatrix(childTransform), LocalMatrix(rootTransform)));
+		CheckMatrix(system.GetWorldMatrix(grandchild), grandchildWorld);
+
+		world.DestroyEntity(root);
+		world.DestroyEntity(child);
+		world.DestroyEntity(grandchild);
+	}
+
+	void TestSetParentRejectsCycles(World& world, TransformSystem& system)
+	{
+		Entity a = CreateNode(world, MakeTransform(1.0f, 0.0f, 1.0f));
+		Entity b = CreateNode(world, MakeTransform(2.0f, 0.0f, 1.0f));
+		Entity c = CreateNode(world, MakeTransform(3.0f, 0.0f, 1.0f));
+		RunUpdate(world, system);
+
+		CHECK(system.SetParent(b, a));
+		CHECK(system.SetParent(c, b));
+		RunUpdate(world, system);
+
+		CHECK(!system.SetParent(a, a));
+		CHECK(!system.SetParent(a, b));
+		CHECK(!system.SetParent(a, c));
+		CHECK(!world.HasComponent<HierarchyComponent>(a));
+
+		// Reparenting within the tree and detaching are fine
+		CHECK(system.SetParent(c, a));
+		CHECK(system.SetParent(b, c));
+		CHECK(system.SetParent(b, k_invalidEntity));
+		CHECK(system.SetParent(a, b));
+		RunUpdate(world, system);
+
+		CheckMatrix(system.GetWorldMatrix(c), XMMatrixMultiply(XMMatrixMultiply(LocalMatrix(MakeTransform(3.0f, 0.0f, 1.0f)), LocalMatrix(MakeTransform(1.0f, 0.0f, 1.0f))), LocalMatrix(MakeTransform(2.0f, 0.0f, 1.0f))));
+
+		world.DestroyEntity(a);
+		world.DestroyEntity(b);
+		world.DestroyEntity(c);
+	}
+
+	void TestDirectCycleKeepsUpdating(World& world, TransformSystem& system)
+	{
+		Entity a = CreateNode(world, MakeTransform(1.0f, 0.0f, 1.0f));
+		Entity b = CreateNode(world, MakeTransform(2.0f, 0.5f, 1.0f));
+		CHECK(system.SetParent(b, a));
+		RunUpdate(world, system);
+
+		// Bypasses SetParent
+		world.AddComponent(a, HierarchyComponent{ b });
+		RunUpdate(world, system);
+
+		auto moved = MakeTransform(-5.0f, 0.25f, 3.0f);
+		world.GetComponent<TransformComponent>(a) = moved;
+		world.GetComponent<TransformComponent>(b) = moved;
+		RunUpdate(world, system);
+
+		// One of the two becomes the root, the other its child
+		XMMATRIX local = LocalMatrix(moved);
+		XMMATRIX worldA = system.GetWorldMatrix(a);
+		XMMATRIX worldB = system.GetWorldMatrix(b);
+		bool aIsRoot = XMVector4NearEqual(worldA.r[3], local.r[3], XMVectorReplicate(1e-4f));
+		CheckMatrix(aIsRoot ? worldA : worldB, local);
+		CheckMatrix(aIsRoot ? worldB : worldA, XMMatrixMultiply(local, local));
+
+		world.DestroyEntity(a);
+		world.DestroyEntity(b);
+	}
+}
+
+int main()
+{
+	Core::Create(2);
+	{
+		auto& world = Core::Get().GetECSWorld();
+		auto* system = Setup(world);
+
+		TestPropagation(world, *system);
+		TestSetParentRejectsCycles(world, *system);
+		TestDirectCycleKeepsUpdating(world, *system);
+	}
+	Core::Destroy();
+
+	return alexis::testing::Report("TransformSystemTests");
+}
@@ -0,0 +1,165 @@
+#include <Precompiled.h>
+
+#include <ECS/ECS.h>
+
+#include <Testing/Check.h>
+
+// View<Ts...> visits exactly the entities having all of Ts, once each, with references into their storage.
+// The cached query picks up archetypes created after it, and ForEachChunk sees the same entities as iteration
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::ecs;
+
+	struct Position
+	{
+		float X{ 0.0f };
+	};
+
+	struct Velocity
+	{
+		float X{ 0.0f };
+	};
+
+	struct Health
+	{
+		int Value{ 0 };
+	};
+
+	void Setup(World& world)
+	{
+		world.Init();
+		world.RegisterComponent<Position>();
+		world.RegisterComponent<Velocity>();
+		world.RegisterComponent<Health>();
+	}
+
+	void TestMatching()
+	{
+		World world;
+		Setup(world);
+
+		// i % 3: 0 has Position, 1 Position + Velocity, 2 Position + Velocity + Health
+		std::vector<Entity> entities;
+		for (int i = 0; i < 300; ++i)
+		{
+			Entity entity = world.CreateEntity();
+			world.AddComponent(entity, Position{ static_cast<float>(i) });
+			if (i % 3 >= 1)
+			{
+				world.AddComponent(entity, Velocity{ 1.0f });
+			}
+			if (i % 3 == 2)
+			{
+				world.AddComponent(entity, Health{ i });
+			}
+			entities.push_back(entity);
+		}
+
+		std::vector<int> visits(entities.size(), 0);
+		for (auto [entity, position, velocity] : world.View<Position, const Velocity>())
+		{
+			CHECK(world.HasComponent<Velocity>(entity));
+			CHECK(position.X == static_cast<float>(entity.Index));
+			++visits[entity.Index];
+
+			position.X += velocity.X;
+		}
+
+		for (std::size_t i = 0; i < entities.size(); ++i)
+		{
+			CHECK(visits[i] == (i % 3 >= 1 ? 1 : 0));
+
+			// Writes went into the storage
+			float expected = static_cast<float>(i) + (i % 3 >= 1 ? 1.0f : 0.0f);
+			CHECK(world.GetComponent<const Position>(entities[i]).X == expected);
+		}
+
+		CHECK(world.View<const Position>().Count() == 300);
+		CHECK((world.View<const Position, const Velocity>().Count() == 200));
+		CHECK(world.View<const Health>().Count() == 100);
+	}
+
+	void TestCachedQueryGrows()
+	{
+		World world;
+		Setup(world);
+
+		Entity moving = world.CreateEntity();
+		world.AddComponent(moving, Position{});
+		world.AddComponent(moving, Velocity{});
+		CHECK(world.View<const Velocity>().Count() == 1);
+
+		// New archetype with Velocity after the query was cached
+		Entity tough = world.CreateEntity();
+		world.AddComponent(tough, Velocity{});
+		world.AddComponent(tough, Health{ 5 });
+		CHECK(world.View<const Velocity>().Count() == 2);
+
+		world.DestroyEntity(moving);
+		CHECK(world.View<const Velocity>().Count() == 1);
+	}
+
+	void TestForEachChunk()
+	{
+		World world;
+		Setup(world);
+
+		for (int i = 0; i < 5000; ++i)
+		{
+			Entity entity = world.CreateEntity();
+			world.AddComponent(entity, Health{ 1 });
+			if (i % 2 == 0)
+			{
+				world.AddComponent(entity, Position{});
+			}
+		}
+
+		std::size_t entityCount = 0;
+		int healthSum = 0;
+		world.ForEachChunk<const Health>([&](std::size_t count, const Entity* entities, const Health* health)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				CHECK(world.IsAlive(entities[i]));
+				healthSum += health[i].Value;
+			}
+			entityCount += count;
+		});
+
+		CHECK(entityCount == 5000);
+		CHECK(healthSum == 5000);
+	}
+
+	// System entity sets are packed: erase swaps the last entity in
+	void TestEntitySet()
+	{
+		EntitySet set;
+		for (std::uint32_t i = 0; i < 10; ++i)
+		{
+			set.insert(Entity{ i, 0 });
+		}
+		std::uint32_t version = set.GetVersion();
+
+		set.erase(Entity{ 3, 0 });
+		CHECK(set.size() == 9);
+		CHECK(!set.contains(Entity{ 3, 0 }));
+		CHECK(set.GetDense()[3] == (Entity{ 9, 0 }));
+		CHECK(set.GetVersion() != version);
+
+		// Stale generation is another entity
+		CHECK(!set.contains(Entity{ 4, 1 }));
+		set.erase(Entity{ 4, 1 });
+		CHECK(set.size() == 9);
+	}
+}
+
+int main()
+{
+	TestMatching();
+	TestCachedQueryGrows();
+	TestForEachChunk();
+	TestEntitySet();
+
+	return alexis::testing::Report("ViewTests");
+}
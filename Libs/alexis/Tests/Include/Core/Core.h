@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+#include <ECS/ECS.h>
+#include <Core/JobSystem.h>
+
+namespace alexis
+{
+	// Headless replacement for Sources/Core/Core.h: only the job system and ECS world that systems reach through Core::Get()
+	class Core
+	{
+	public:
+		static void Create(std::uint32_t workerCount = 0)
+		{
+			assert(!s_core && "Core is already created!");
+
+			s_core = new Core();
+			s_core->m_jobSystem = std::make_unique<JobSystem>(workerCount);
+			s_core->m_ecs = std::make_unique<ecs::World>();
+			s_core->m_ecs->Init();
+		}
+
+		static void Destroy()
+		{
+			delete s_core;
+			s_core = nullptr;
+		}
+
+		static Core& Get()
+		{
+			assert(s_core && "Core is not created!");
+
+			return *s_core;
+		}
+
+		static std::uint64_t GetFrameCount()
+		{
+			return 0;
+		}
+
+		ecs::World& GetECSWorld() const
+		{
+			return *m_ecs;
+		}
+
+		JobSystem& GetJobSystem() const
+		{
+			return *m_jobSystem;
+		}
+
+	private:
+		// Declared first to outlive everything that may schedule jobs
+		std::unique_ptr<JobSystem> m_jobSystem;
+		std::unique_ptr<ecs::World> m_ecs;
+
+		static inline Core* s_core = nullptr;
+	};
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// Headless replacement for Sources/Precompiled.h: STL and DirectXMath only, no Windows or D3D12
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+#include <array>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <filesystem>
+#include <string>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+namespace fs = std::filesystem;
+using namespace DirectX;
+
+using namespace std::string_literals;
+
+// Same as CoreHelpers.h
+template<class T>
+std::enable_if_t<std::is_floating_point<T>::value, bool>
+IsEqual(const T a, const T b)
+{
+	return (std::abs(a - b) < std::numeric_limits<T>::epsilon());
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+namespace alexis
+{
+	using IndexCollection = std::vector<uint16_t>;
+
+	// Headless replacement for Sources/Render/Mesh.h: bounds and the CPU copy of the geometry, no GPU buffers
+	class Mesh
+	{
+	public:
+		Mesh(std::wstring_view path, std::vector<DirectX::XMFLOAT3> positions, IndexCollection indices) :
+			m_positions(std::move(positions)),
+			m_indices(std::move(indices)),
+			m_path(path)
+		{
+			assert(m_positions.size() < UINT16_MAX && "Too many vertices for 16-bit indices!");
+
+			if (!m_positions.empty())
+			{
+				DirectX::BoundingBox::CreateFromPoints(m_boundingBox, m_positions.size(), m_positions.data(), sizeof(DirectX::XMFLOAT3));
+				DirectX::BoundingSphere::CreateFromPoints(m_boundingSphere, m_positions.size(), m_positions.data(), sizeof(DirectX::XMFLOAT3));
+			}
+		}
+
+		Mesh(const Mesh& copy) = delete;
+
+		const std::wstring& GetPath() const
+		{
+			return m_path;
+		}
+
+		const DirectX::BoundingBox& GetBoundingBox() const
+		{
+			return m_boundingBox;
+		}
+
+		const DirectX::BoundingSphere& GetBoundingSphere() const
+		{
+			return m_boundingSphere;
+		}
+
+		const std::vector<DirectX::XMFLOAT3>& GetPositions() const
+		{
+			return m_positions;
+		}
+
+		const IndexCollection& GetIndices() const
+		{
+			return m_indices;
+		}
+
+	private:
+		DirectX::BoundingBox m_boundingBox;
+		DirectX::BoundingSphere m_boundingSphere;
+
+		std::vector<DirectX::XMFLOAT3> m_positions;
+		IndexCollection m_indices;
+
+		std::wstring m_path;
+	};
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+// Helpers shared by the benchmark executables. They run the full sizes by default,
+// --quick (used by ctest) only smoke-tests the smallest one
+
+namespace alexis
+{
+	namespace testing
+	{
+		inline bool IsQuickRun(int argc, char** argv)
+		{
+			for (int i = 1; i < argc; ++i)
+			{
+				if (std::strcmp(argv[i], "--quick") == 0)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		// Wall time of a single call
+		template<class Func>
+		double MeasureMilliseconds(Func&& func)
+		{
+			auto start = std::chrono::steady_clock::now();
+			func();
+			return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		// Best of repeatCount calls, for steady-state work that can be repeated
+		template<class Func>
+		double MeasureBestMilliseconds(int repeatCount, Func&& func)
+		{
+			double best = std::numeric_limits<double>::max();
+			for (int i = 0; i < repeatCount; ++i)
+			{
+				best = std::min(best, MeasureMilliseconds(func));
+			}
+
+			return best;
+		}
+
+		// Keeps results alive so that the measured work is not optimized away
+		template<class T>
+		inline void DoNotOptimize(const T& value)
+		{
+#if defined(_MSC_VER)
+			static volatile const void* s_sink;
+			s_sink = &value;
+#else
+			asm volatile("" : : "g"(&value) : "memory");
+#endif
+		}
+
+		inline void PrintHeader(const char* title, const char* baselineName, const char* currentName)
+		{
+			std::printf("\n%s\n%-32s %10s %14s %14s %9s\n", title, "case", "count", baselineName, currentName, "speedup");
+		}
+
+		inline void PrintRow(const char* name, std::size_t count, double baselineMs, double currentMs)
+		{
+			std::printf("%-32s %10zu %11.3f ms %11.3f ms %8.1fx\n", name, count, baselineMs, currentMs, currentMs > 0.0 ? baselineMs / currentMs : 0.0);
+		}
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+// Minimal checks for the headless tests: failures are reported and counted, the test keeps going
+
+namespace alexis
+{
+	namespace testing
+	{
+		inline int g_failureCount = 0;
+
+		inline void Fail(const char* file, int line, const char* expression)
+		{
+			std::fprintf(stderr, "%s(%d): check failed: %s\n", file, line, expression);
+			++g_failureCount;
+		}
+
+		// Return value for main
+		inline int Report(const char* testName)
+		{
+			if (g_failureCount)
+			{
+				std::fprintf(stderr, "%s: %d check(s) failed\n", testName, g_failureCount);
+				return 1;
+			}
+
+			std::printf("%s: passed\n", testName);
+			return 0;
+		}
+	}
+}
+
+#define CHECK(expression) \
+	do { if (!(expression)) { ::alexis::testing::Fail(__FILE__, __LINE__, #expression); } } while (false)
+
+#define CHECK_NEAR(a, b, tolerance) \
+	do { if (!(std::abs(static_cast<double>(a) - static_cast<double>(b)) <= static_cast<double>(tolerance))) { \
+		std::fprintf(stderr, "  %g vs %g\n", static_cast<double>(a), static_cast<double>(b)); \
+		::alexis::testing::Fail(__FILE__, __LINE__, #a " ~= " #b); } } while (false)
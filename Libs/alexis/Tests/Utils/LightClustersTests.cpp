@@ -0,0 +1,317 @@
+#include <Precompiled.h>
+
+#include <random>
+
+#include <Core/JobSystem.h>
+#include <Utils/LightClusters.h>
+
+#include <Testing/Check.h>
+
+// LightClusters binning is conservative: every point inside a light volume lands in a cluster that lists the light.
+// Lists are sorted and packed, the parallel path gives the same result, lights out of the frustum are dropped
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::utils;
+
+	// Same grid as LightingSystem
+	constexpr std::uint32_t k_tilesX = 16;
+	constexpr std::uint32_t k_tilesY = 9;
+	constexpr std::uint32_t k_slices = 24;
+	constexpr float k_nearZ = 0.5f;
+	constexpr float k_farZ = 200.0f;
+
+	constexpr float k_fovY = XM_PIDIV4;
+	constexpr float k_aspectRatio = 16.0f / 9.0f;
+
+	struct Camera
+	{
+		XMMATRIX View;
+		float ProjScaleX;
+		float ProjScaleY;
+	};
+
+	Camera MakeCamera()
+	{
+		Camera camera;
+		camera.View = XMMatrixLookToLH(XMVectorSet(3.0f, 2.0f, -5.0f, 1.0f), XMVector3Normalize(XMVectorSet(0.3f, -0.1f, 1.0f, 0.0f)), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		camera.ProjScaleY = 1.0f / std::tan(0.5f * k_fovY);
+		camera.ProjScaleX = camera.ProjScaleY / k_aspectRatio;
+		return camera;
+	}
+
+	struct Lights
+	{
+		std::vector<float> CenterX;
+		std::vector<float> CenterY;
+		std::vector<float> CenterZ;
+		std::vector<float> Radius;
+		std::vector<LightCone> Cones;
+
+		SphereStreams GetSpheres() const
+		{
+			SphereStreams spheres;
+			spheres.CenterX = CenterX.data();
+			spheres.CenterY = CenterY.data();
+			spheres.CenterZ = CenterZ.data();
+			spheres.Radius = Radius.data();
+			return spheres;
+		}
+
+		void AddSphere(float x, float y, float z, float radius)
+		{
+			CenterX.push_back(x);
+			CenterY.push_back(y);
+			CenterZ.push_back(z);
+			Radius.push_back(radius);
+		}
+	};
+
+	// Scattered in front of the camera, some reaching behind it or past the far plane
+	Lights MakeLights(std::size_t sphereCount, std::size_t coneCount, std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+		std::uniform_real_distribution<float> depth(-20.0f, 220.0f);
+		std::uniform_real_distribution<float> radius(0.2f, 12.0f);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> cosAngle(0.3f, 0.98f);
+
+		Lights lights;
+		for (std::size_t i = 0; i < sphereCount; ++i)
+		{
+			lights.AddSphere(position(random), 0.3f * position(random), depth(random), radius(random));
+		}
+
+		for (std::size_t i = 0; i < coneCount; ++i)
+		{
+			LightCone cone;
+			cone.Apex = XMFLOAT3(position(random), 0.3f * position(random), depth(random));
+			cone.Range = radius(random) * 2.0f;
+			XMStoreFloat3(&cone.Direction, XMVector3Normalize(XMVectorSet(unit(random), unit(random), unit(random), 0.0f)));
+			cone.CosAngle = cosAngle(random);
+			lights.Cones.push_back(cone);
+		}
+
+		return lights;
+	}
+
+	bool ListsLight(const LightClusters& clusters, std::uint32_t cluster, std::uint32_t light)
+	{
+		const auto& entry = clusters.GetClusters()[cluster];
+		const auto* begin = clusters.GetLightIndices().data() + entry.Offset;
+		return std::binary_search(begin, begin + entry.Count, light);
+	}
+
+	// Cluster of a world space point, false if it is outside of the view frustum
+	bool XM_CALLCONV FindCluster(const LightClusters& clusters, const Camera& camera, FXMVECTOR point, std::uint32_t& outCluster)
+	{
+		XMFLOAT3 view;
+		XMStoreFloat3(&view, XMVector3Transform(point, camera.View));
+		if (view.z <= 0.0f || view.z >= k_farZ)
+		{
+			return false;
+		}
+
+		float u = view.x * camera.ProjScaleX / view.z;
+		float v = view.y * camera.ProjScaleY / view.z;
+		if (std::abs(u) >= 1.0f || std::abs(v) >= 1.0f)
+		{
+			return false;
+		}
+
+		auto x = static_cast<std::uint32_t>((u + 1.0f) * 0.5f * k_tilesX);
+		auto y = static_cast<std::uint32_t>((1.0f - v) * 0.5f * k_tilesY);
+		outCluster = clusters.GetClusterIndex(std::min(x, k_tilesX - 1), std::min(y, k_tilesY - 1), clusters.GetSlice(view.z));
+		return true;
+	}
+
+	void TestSlices()
+	{
+		Camera camera = MakeCamera();
+		LightClusters clusters;
+		clusters.SetGrid(k_tilesX, k_tilesY, k_slices, k_nearZ, k_farZ, camera.ProjScaleX, camera.ProjScaleY);
+
+		CHECK(clusters.GetClusterCount() == k_tilesX * k_tilesY * k_slices);
+		CHECK(clusters.GetSlice(0.01f) == 0);
+		CHECK(clusters.GetSlice(k_nearZ * 0.99f) == 0);
+		CHECK(clusters.GetSlice(k_nearZ * 1.01f) == 1);
+		CHECK(clusters.GetSlice(k_farZ * 0.99f) == k_slices - 1);
+		CHECK(clusters.GetSlice(k_farZ * 10.0f) == k_slices - 1);
+
+		// Slices grow exponentially and the shader formula agrees with GetSlice
+		std::uint32_t previous = 0;
+		for (float z = k_nearZ * 1.001f; z < k_farZ; z *= 1.05f)
+		{
+			std::uint32_t slice = clusters.GetSlice(z);
+			CHECK(slice >= previous);
+			CHECK(slice == static_cast<std::uint32_t>(std::log(z) * clusters.GetSliceScale() + clusters.GetSliceBias()));
+			previous = slice;
+		}
+	}
+
+	void TestPackedLists(const LightClusters& clusters, std::size_t lightCount)
+	{
+		std::uint32_t offset = 0;
+		for (const auto& cluster : clusters.GetClusters())
+		{
+			CHECK(cluster.Offset == offset);
+			offset += cluster.Count;
+
+			const auto* lights = clusters.GetLightIndices().data() + cluster.Offset;
+			for (std::uint32_t i = 0; i < cluster.Count; ++i)
+			{
+				CHECK(lights[i] < lightCount);
+				CHECK(i == 0 || lights[i - 1] < lights[i]);
+			}
+		}
+		CHECK(offset == clusters.GetLightIndices().size());
+	}
+
+	void TestConservative()
+	{
+		std::mt19937 random(17);
+		Camera camera = MakeCamera();
+
+		// 401 spheres: the SIMD bounds loop and its scalar tail both run
+		Lights lights = MakeLights(401, 150, random);
+
+		LightClusters clusters;
+		clusters.SetGrid(k_tilesX, k_tilesY, k_slices, k_nearZ, k_farZ, camera.ProjScaleX, camera.ProjScaleY);
+		clusters.Bin(camera.View, lights.GetSpheres(), lights.Radius.size(), lights.Cones.data(), lights.Cones.size());
+
+		TestPackedLists(clusters, lights.Radius.size() + lights.Cones.size());
+
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		std::uniform_real_distribution<float> fraction(0.0f, 0.999f);
+
+		// Points inside each sphere
+		std::size_t missingCount = 0;
+		std::size_t sampleCount = 0;
+		for (std::uint32_t light = 0; light < lights.Radius.size(); ++light)
+		{
+			XMVECTOR center = XMVectorSet(lights.CenterX[light], lights.CenterY[light], lights.CenterZ[light], 1.0f);
+			for (int sample = 0; sample < 200; ++sample)
+			{
+				XMVECTOR offset = XMVectorScale(XMVector3Normalize(XMVectorSet(unit(random), unit(random), unit(random), 0.0f)), lights.Radius[light] * fraction(random));
+
+				std::uint32_t cluster;
+				if (FindCluster(clusters, camera, XMVectorAdd(center, offset), cluster))
+				{
+					++sampleCount;
+					missingCount += ListsLight(clusters, cluster, light) ? 0 : 1;
+				}
+			}
+		}
+		CHECK(sampleCount > 10000);
+		CHECK(missingCount == 0);
+
+		// Points inside each cone
+		missingCount = 0;
+		sampleCount = 0;
+		for (std::uint32_t cone = 0; cone < lights.Cones.size(); ++cone)
+		{
+			const auto& lightCone = lights.Cones[cone];
+			XMVECTOR apex = XMLoadFloat3(&lightCone.Apex);
+			XMVECTOR direction = XMLoadFloat3(&lightCone.Direction);
+
+			for (int sample = 0; sample < 200; ++sample)
+			{
+				XMVECTOR offset = XMVectorScale(XMVector3Normalize(XMVectorSet(unit(random), unit(random), unit(random), 0.0f)), lightCone.Range * fraction(random));
+				float cosToAxis = XMVectorGetX(XMVector3Dot(XMVector3Normalize(offset), direction));
+				if (cosToAxis < lightCone.CosAngle)
+				{
+					continue;
+				}
+
+				std::uint32_t cluster;
+				if (FindCluster(clusters, camera, XMVectorAdd(apex, offset), cluster))
+				{
+					++sampleCount;
+					missingCount += ListsLight(clusters, cluster, static_cast<std::uint32_t>(lights.Radius.size()) + cone) ? 0 : 1;
+				}
+			}
+		}
+		CHECK(sampleCount > 1000);
+		CHECK(missingCount == 0);
+
+		// Same lists when slices are binned on the job system
+		std::vector<LightClusters::Cluster> serialClusters = clusters.GetClusters();
+		std::vector<std::uint32_t> serialIndices = clusters.GetLightIndices();
+
+		JobSystem jobSystem(3);
+		clusters.Bin(camera.View, lights.GetSpheres(), lights.Radius.size(), lights.Cones.data(), lights.Cones.size(), &jobSystem);
+
+		CHECK(clusters.GetLightIndices() == serialIndices);
+		CHECK(std::equal(serialClusters.begin(), serialClusters.end(), clusters.GetClusters().begin(), [](const auto& a, const auto& b)
+		{
+			return a.Offset == b.Offset && a.Count == b.Count;
+		}));
+	}
+
+	void TestTightness()
+	{
+		Camera camera = MakeCamera();
+		XMMATRIX invView = XMMatrixInverse(nullptr, camera.View);
+
+		LightClusters clusters;
+		clusters.SetGrid(k_tilesX, k_tilesY, k_slices, k_nearZ, k_farZ, camera.ProjScaleX, camera.ProjScaleY);
+
+		// A small light on the view axis touches a handful of clusters, lights behind the eye, past the far plane
+		// or off screen touch none, a cone pointing away from the screen center stays out of the other half
+		Lights lights;
+		auto addViewSphere = [&](float x, float y, float z, float radius)
+		{
+			XMFLOAT3 world;
+			XMStoreFloat3(&world, XMVector3Transform(XMVectorSet(x, y, z, 1.0f), invView));
+			lights.AddSphere(world.x, world.y, world.z, radius);
+		};
+		addViewSphere(0.0f, 0.0f, 20.0f, 0.1f);
+		addViewSphere(0.0f, 0.0f, -5.0f, 1.0f);
+		addViewSphere(0.0f, 0.0f, k_farZ + 5.0f, 1.0f);
+		addViewSphere(100.0f, 0.0f, 10.0f, 1.0f);
+
+		LightCone cone;
+		XMStoreFloat3(&cone.Apex, XMVector3Transform(XMVectorSet(0.0f, 0.0f, 20.0f, 1.0f), invView));
+		XMStoreFloat3(&cone.Direction, XMVector3TransformNormal(XMVectorSet(1.0f, 0.0f, 0.0f, 0.0f), invView));
+		cone.Range = 8.0f;
+		cone.CosAngle = std::cos(XMConvertToRadians(20.0f));
+		lights.Cones.push_back(cone);
+
+		clusters.Bin(camera.View, lights.GetSpheres(), lights.Radius.size(), lights.Cones.data(), lights.Cones.size());
+
+		std::array<std::uint32_t, 5> clusterCounts{};
+		std::uint32_t leftHalfConeCount = 0;
+		for (std::uint32_t slice = 0; slice < k_slices; ++slice)
+		{
+			for (std::uint32_t y = 0; y < k_tilesY; ++y)
+			{
+				for (std::uint32_t x = 0; x < k_tilesX; ++x)
+				{
+					std::uint32_t cluster = clusters.GetClusterIndex(x, y, slice);
+					for (std::uint32_t light = 0; light < clusterCounts.size(); ++light)
+					{
+						clusterCounts[light] += ListsLight(clusters, cluster, light) ? 1 : 0;
+					}
+
+					leftHalfConeCount += x < k_tilesX / 2 - 1 && ListsLight(clusters, cluster, 4) ? 1 : 0;
+				}
+			}
+		}
+
+		CHECK(clusterCounts[0] >= 1 && clusterCounts[0] <= 8);
+		CHECK(clusterCounts[1] == 0);
+		CHECK(clusterCounts[2] == 0);
+		CHECK(clusterCounts[3] == 0);
+		CHECK(clusterCounts[4] > 0);
+		CHECK(leftHalfConeCount == 0);
+	}
+}
+
+int main()
+{
+	TestSlices();
+	TestConservative();
+	TestTightness();
+
+	return alexis::testing::Report("LightClustersTests");
+}
@@ -0,0 +1,128 @@
+#include <Precompiled.h>
+
+#include <cstring>
+#include <random>
+
+#include <Utils/MatrixBatch.h>
+
+#include <Testing/Check.h>
+
+// BatchWorldMatrices against the DirectXMath composition, for every tail length of the SIMD loops and a strided output
+namespace
+{
+	using namespace alexis;
+
+	struct Transform
+	{
+		XMVECTOR Position;
+		XMVECTOR Rotation;
+		float Scale;
+	};
+
+	// Output lives inside a bigger struct like ModelComponent::ModelMatrix, Guard must stay untouched
+	struct alignas(16) Output
+	{
+		void* Before;
+		XMMATRIX World;
+		float Guard;
+	};
+
+	XMMATRIX ReferenceWorld(const Transform& transform)
+	{
+		XMMATRIX scaling = XMMatrixScaling(transform.Scale, transform.Scale, transform.Scale);
+		return XMMatrixMultiply(XMMatrixMultiply(scaling, XMMatrixRotationQuaternion(transform.Rotation)), XMMatrixTranslationFromVector(transform.Position));
+	}
+
+	std::vector<Transform> MakeTransforms(std::size_t count, std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+		std::uniform_real_distribution<float> scale(0.1f, 10.0f);
+
+		std::vector<Transform> transforms(count);
+		for (auto& transform : transforms)
+		{
+			transform.Position = XMVectorSet(position(random), position(random), position(random), 1.0f);
+			transform.Rotation = XMQuaternionRotationRollPitchYaw(angle(random), angle(random), angle(random));
+			transform.Scale = scale(random);
+		}
+
+		return transforms;
+	}
+
+	void TestMatchesDirectXMath()
+	{
+		std::mt19937 random(7);
+		utils::TransformBatch batch;
+
+		for (std::size_t count = 0; count <= 37; ++count)
+		{
+			auto transforms = MakeTransforms(count, random);
+
+			batch.Clear();
+			for (const auto& transform : transforms)
+			{
+				batch.Add(transform.Position, transform.Rotation, transform.Scale);
+			}
+			CHECK(batch.Size() == count);
+
+			std::vector<Output> outputs(count + 1);
+			for (auto& output : outputs)
+			{
+				output.Guard = -1.0f;
+			}
+
+			utils::BatchWorldMatrices(batch.GetStreams(), count, &outputs[0].World, sizeof(Output));
+
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				XMFLOAT4X4 expected;
+				XMFLOAT4X4 actual;
+				XMStoreFloat4x4(&expected, ReferenceWorld(transforms[i]));
+				XMStoreFloat4x4(&actual, outputs[i].World);
+
+				for (int row = 0; row < 4; ++row)
+				{
+					for (int column = 0; column < 4; ++column)
+					{
+						CHECK_NEAR(actual.m[row][column], expected.m[row][column], 1e-5 * (1.0 + std::abs(expected.m[row][column])));
+					}
+				}
+			}
+
+			for (const auto& output : outputs)
+			{
+				CHECK(output.Guard == -1.0f);
+			}
+		}
+	}
+
+	void TestIdentity()
+	{
+		utils::TransformBatch batch;
+		for (int i = 0; i < 9; ++i)
+		{
+			batch.Add(XMVectorZero(), XMQuaternionIdentity(), 1.0f);
+		}
+
+		XMMATRIX worlds[9];
+		utils::BatchWorldMatrices(batch.GetStreams(), 9, worlds, sizeof(XMMATRIX));
+
+		XMFLOAT4X4 identity;
+		XMStoreFloat4x4(&identity, XMMatrixIdentity());
+		for (const auto& world : worlds)
+		{
+			XMFLOAT4X4 actual;
+			XMStoreFloat4x4(&actual, world);
+			CHECK(std::memcmp(&actual, &identity, sizeof(identity)) == 0);
+		}
+	}
+}
+
+int main()
+{
+	TestMatchesDirectXMath();
+	TestIdentity();
+
+	return alexis::testing::Report("MatrixBatchTests");
+}
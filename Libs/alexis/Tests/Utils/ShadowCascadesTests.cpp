@@ -0,0 +1,275 @@
+#include <Precompiled.h>
+
+#include <Utils/ShadowCascades.h>
+
+#include <Testing/Check.h>
+
+// Cascade splits blend uniform and logarithmic distributions. A fitted cascade covers its slice of the view frustum,
+// its light space offset is a whole number of texels and sub-texel camera motion leaves the projection scale bit exact
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::utils;
+
+	// Same setup as ShadowSystem
+	constexpr std::size_t k_cascadeCount = 4;
+	constexpr float k_nearZ = 0.01f;
+	constexpr float k_shadowDistance = 60.0f;
+	constexpr float k_lambda = 0.7f;
+	constexpr std::uint32_t k_resolution = 1024;
+
+	constexpr float k_fovY = XM_PIDIV4;
+	constexpr float k_aspectRatio = 16.0f / 9.0f;
+
+	const float k_projScaleY = 1.0f / std::tan(0.5f * k_fovY);
+	const float k_projScaleX = k_projScaleY / k_aspectRatio;
+
+	XMVECTOR GetSunDirection()
+	{
+		return XMVector3Normalize(XMVectorSet(-0.3f, -1.0f, 0.4f, 0.0f));
+	}
+
+	BoundingBox GetCasterBounds()
+	{
+		return BoundingBox(XMFLOAT3(0.0f, 10.0f, 0.0f), XMFLOAT3(100.0f, 10.0f, 100.0f));
+	}
+
+	XMMATRIX MakeInvView(FXMVECTOR position, float yaw)
+	{
+		XMVECTOR direction = XMVectorSet(std::sin(yaw), -0.2f, std::cos(yaw), 0.0f);
+		return XMMatrixInverse(nullptr, XMMatrixLookToLH(position, XMVector3Normalize(direction), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)));
+	}
+
+	// Same as ShadowSystem for cached cascades
+	constexpr std::uint32_t k_cachedSnapTexels = 32;
+
+	CascadeProjection Fit(FXMMATRIX invView, float splitNear, float splitFar, std::uint32_t snapTexels = 1)
+	{
+		return FitCascade(GetSunDirection(), invView, k_projScaleX, k_projScaleY, splitNear, splitFar, k_resolution, GetCasterBounds(), snapTexels);
+	}
+
+	bool IsEqual(FXMMATRIX a, CXMMATRIX b)
+	{
+		for (int row = 0; row < 4; ++row)
+		{
+			if (!XMVector4Equal(a.r[row], b.r[row]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void TestSplits()
+	{
+		float uniform[k_cascadeCount + 1];
+		float logarithmic[k_cascadeCount + 1];
+		float blended[k_cascadeCount + 1];
+		ComputeCascadeSplits(k_nearZ, k_shadowDistance, 0.0f, k_cascadeCount, uniform);
+		ComputeCascadeSplits(k_nearZ, k_shadowDistance, 1.0f, k_cascadeCount, logarithmic);
+		ComputeCascadeSplits(k_nearZ, k_shadowDistance, k_lambda, k_cascadeCount, blended);
+
+		// Ends are exact whatever the blend
+		for (const float* splits : { uniform, logarithmic, blended })
+		{
+			CHECK(splits[0] == k_nearZ);
+			CHECK(splits[k_cascadeCount] == k_shadowDistance);
+
+			for (std::size_t i = 0; i < k_cascadeCount; ++i)
+			{
+				CHECK(splits[i] < splits[i + 1]);
+			}
+		}
+
+		for (std::size_t i = 1; i < k_cascadeCount; ++i)
+		{
+			float fraction = static_cast<float>(i) / k_cascadeCount;
+			CHECK_NEAR(uniform[i], k_nearZ + (k_shadowDistance - k_nearZ) * fraction, 1e-4f);
+			CHECK_NEAR(logarithmic[i] / (k_nearZ * std::pow(k_shadowDistance / k_nearZ, fraction)), 1.0f, 1e-5f);
+			CHECK_NEAR(blended[i], k_lambda * logarithmic[i] + (1.0f - k_lambda) * uniform[i], 1e-4f);
+
+			// Logarithmic splits give near cascades more resolution
+			CHECK(logarithmic[i] < blended[i] && blended[i] < uniform[i]);
+		}
+	}
+
+	// Every corner of the slice lands inside the tile with a texel of margin, depths within [0, 1]
+	void TestCoverage(std::uint32_t snapTexels)
+	{
+		float splits[k_cascadeCount + 1];
+		ComputeCascadeSplits(k_nearZ, k_shadowDistance, k_lambda, k_cascadeCount, splits);
+
+		XMMATRIX invView = MakeInvView(XMVectorSet(5.0f, 2.0f, -3.0f, 1.0f), 0.7f);
+
+		for (std::size_t cascade = 0; cascade < k_cascadeCount; ++cascade)
+		{
+			auto projection = Fit(invView, splits[cascade], splits[cascade + 1], snapTexels);
+			XMMATRIX viewProj = XMMatrixMultiply(projection.View, projection.Proj);
+
+			float margin = 1.0f - 2.0f / k_resolution;
+			for (int corner = 0; corner < 8; ++corner)
+			{
+				float z = corner & 4 ? splits[cascade + 1] : splits[cascade];
+				float x = (corner & 1 ? 1.0f : -1.0f) * z / k_projScaleX;
+				float y = (corner & 2 ? 1.0f : -1.0f) * z / k_projScaleY;
+
+				XMFLOAT3 clip;
+				XMStoreFloat3(&clip, XMVector3TransformCoord(XMVector3Transform(XMVectorSet(x, y, z, 1.0f), invView), viewProj));
+				CHECK(std::abs(clip.x) <= margin && std::abs(clip.y) <= margin);
+				CHECK(clip.z >= 0.0f && clip.z <= 1.0f);
+			}
+
+			// Casters between the light and the slice are not clipped by the near plane
+			XMFLOAT3 casterCorners[BoundingBox::CORNER_COUNT];
+			GetCasterBounds().GetCorners(casterCorners);
+			for (const auto& casterCorner : casterCorners)
+			{
+				CHECK(XMVectorGetZ(XMVector3TransformCoord(XMLoadFloat3(&casterCorner), viewProj)) >= -1e-5f);
+			}
+
+			// Texel size is the tile extent over the resolution
+			XMFLOAT4X4 proj;
+			XMStoreFloat4x4(&proj, projection.Proj);
+			CHECK_NEAR(2.0f / proj._11 / k_resolution, projection.TexelSize, 1e-5f);
+			CHECK(proj._11 == proj._22);
+		}
+	}
+
+	// Light space offset of the projection is a whole number of texels, so texels stay on the same world grid
+	void TestTexelSnapping()
+	{
+		float splits[k_cascadeCount + 1];
+		ComputeCascadeSplits(k_nearZ, k_shadowDistance, k_lambda, k_cascadeCount, splits);
+
+		for (int step = 0; step < 16; ++step)
+		{
+			XMMATRIX invView = MakeInvView(XMVectorSet(0.37f * step, 1.0f, -0.61f * step, 1.0f), 0.3f * step);
+
+			for (std::size_t cascade = 0; cascade < k_cascadeCount; ++cascade)
+			{
+				auto projection = Fit(invView, splits[cascade], splits[cascade + 1]);
+
+				// World origin in light space is minus the snapped center
+				XMFLOAT3 origin;
+				XMStoreFloat3(&origin, XMVector3Transform(XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), projection.View));
+
+				float texelsX = origin.x / projection.TexelSize;
+				float texelsY = origin.y / projection.TexelSize;
+				CHECK_NEAR(texelsX, std::round(texelsX), 1e-2f);
+				CHECK_NEAR(texelsY, std::round(texelsY), 1e-2f);
+			}
+		}
+	}
+
+	// Camera moving by less than a texel: projection scale is bit exact, the view moves by whole texels or not at all.
+	// Turning the camera does not resize texels either
+	void TestStability()
+	{
+		float splits[k_cascadeCount + 1];
+		ComputeCascadeSplits(k_nearZ, k_shadowDistance, k_lambda, k_cascadeCount, splits);
+
+		const XMVECTOR start = XMVectorSet(2.0f, 1.5f, -4.0f, 1.0f);
+		const float yaw = 0.4f;
+
+		for (std::size_t cascade = 0; cascade < k_cascadeCount; ++cascade)
+		{
+			auto reference = Fit(MakeInvView(start, yaw), splits[cascade], splits[cascade + 1]);
+
+			XMFLOAT3 referenceOrigin;
+			XMStoreFloat3(&referenceOrigin, XMVector3Transform(XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), reference.View));
+
+			std::size_t unchangedCount = 0;
+			for (int step = 1; step <= 32; ++step)
+			{
+				// A tenth of a texel per step in a few directions
+				XMVECTOR offset = XMVectorScale(XMVector3Normalize(XMVectorSet(std::sin(0.9f * step), 0.3f, std::cos(0.9f * step), 0.0f)), 0.1f * reference.TexelSize);
+				auto projection = Fit(MakeInvView(XMVectorAdd(start, offset), yaw), splits[cascade], splits[cascade + 1]);
+
+				// Depth range follows the camera, the scale is what must not shimmer
+				XMFLOAT4X4 proj;
+				XMFLOAT4X4 referenceProj;
+				XMStoreFloat4x4(&proj, projection.Proj);
+				XMStoreFloat4x4(&referenceProj, reference.Proj);
+				CHECK(projection.TexelSize == reference.TexelSize);
+				CHECK(proj._11 == referenceProj._11 && proj._22 == referenceProj._22);
+				CHECK(proj._41 == referenceProj._41 && proj._42 == referenceProj._42);
+
+				XMFLOAT3 origin;
+				XMStoreFloat3(&origin, XMVector3Transform(XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), projection.View));
+
+				float shiftX = (origin.x - referenceOrigin.x) / reference.TexelSize;
+				float shiftY = (origin.y - referenceOrigin.y) / reference.TexelSize;
+				CHECK(std::abs(shiftX) < 1.01f && std::abs(shiftY) < 1.01f);
+				CHECK_NEAR(shiftX, std::round(shiftX), 1e-2f);
+				CHECK_NEAR(shiftY, std::round(shiftY), 1e-2f);
+
+				if (IsEqual(projection.View, reference.View))
+				{
+					++unchangedCount;
+				}
+			}
+
+			// Most sub-texel moves do not cross a texel boundary
+			CHECK(unchangedCount > 0);
+
+			// Same slice from another direction, texel size does not depend on orientation
+			for (float turn : { 0.5f, 1.7f, 3.1f })
+			{
+				CHECK(Fit(MakeInvView(start, yaw + turn), splits[cascade], splits[cascade + 1]).TexelSize == reference.TexelSize);
+			}
+		}
+	}
+
+	// Coarse snapping keeps the whole view-projection bit exact over most frames of a walking camera, it is what makes
+	// a cascade worth caching. Texel snapping alone refits nearly every frame
+	void TestCachedFit()
+	{
+		float splits[k_cascadeCount + 1];
+		ComputeCascadeSplits(k_nearZ, k_shadowDistance, k_lambda, k_cascadeCount, splits);
+
+		const std::size_t cascade = k_cascadeCount - 1;
+		constexpr int k_frameCount = 200;
+
+		for (std::uint32_t snapTexels : { 1u, k_cachedSnapTexels })
+		{
+			auto first = Fit(MakeInvView(XMVectorSet(0.0f, 1.5f, 0.0f, 1.0f), 0.4f), splits[cascade], splits[cascade + 1], snapTexels);
+			XMMATRIX lastViewProj = XMMatrixMultiply(first.View, first.Proj);
+
+			// A texel of camera motion per frame along a diagonal
+			int refitCount = 0;
+			for (int frame = 1; frame <= k_frameCount; ++frame)
+			{
+				XMVECTOR position = XMVectorSet(0.7f * frame * first.TexelSize, 1.5f, 0.7f * frame * first.TexelSize, 1.0f);
+				auto projection = Fit(MakeInvView(position, 0.4f), splits[cascade], splits[cascade + 1], snapTexels);
+
+				XMMATRIX viewProj = XMMatrixMultiply(projection.View, projection.Proj);
+				if (!IsEqual(viewProj, lastViewProj))
+				{
+					++refitCount;
+				}
+				lastViewProj = viewProj;
+			}
+
+			if (snapTexels == 1)
+			{
+				CHECK(refitCount > k_frameCount / 2);
+			}
+			else
+			{
+				CHECK(refitCount <= 3 * k_frameCount / static_cast<int>(snapTexels) + 1);
+			}
+		}
+	}
+}
+
+int main()
+{
+	TestSplits();
+	TestCoverage(1);
+	TestCoverage(k_cachedSnapTexels);
+	TestTexelSnapping();
+	TestStability();
+	TestCachedFit();
+
+	return alexis::testing::Report("ShadowCascadesTests");
+}
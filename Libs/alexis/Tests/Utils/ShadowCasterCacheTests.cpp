@@ -0,0 +1,166 @@
+#include <Precompiled.h>
+
+#include <numeric>
+
+#include <Utils/ShadowCasterCache.h>
+
+#include <Testing/Check.h>
+
+// ShadowCasterCache invalidation without a GPU: a view goes stale when it is new, the light changes, its matrix changes,
+// caster indices are rebuilt or its set of static casters changes. Moving casters stay dynamic until they settle
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::utils;
+
+	constexpr std::size_t k_casterCount = 100;
+
+	struct Frame
+	{
+		std::vector<std::uint32_t> Static;
+		std::vector<std::uint32_t> Dynamic;
+		bool IsStale{ false };
+	};
+
+	class CacheFixture
+	{
+	public:
+		CacheFixture() :
+			m_casters(k_casterCount)
+		{
+			std::iota(m_casters.begin(), m_casters.end(), 0u);
+			m_cache.SetViewCount(2);
+		}
+
+		Frame Update(std::vector<std::uint32_t> moved = {}, std::size_t view = 0)
+		{
+			m_cache.UpdateCasters(k_casterCount, CasterVersion, moved.data(), moved.size());
+
+			Frame frame;
+			frame.IsStale = m_cache.UpdateView(view, ViewProj, LightVersion, m_casters, frame.Static, frame.Dynamic);
+			return frame;
+		}
+
+		// Another view over the casters of the last Update
+		bool UpdateOtherView(const std::vector<std::uint32_t>& casters)
+		{
+			std::vector<std::uint32_t> staticCasters;
+			std::vector<std::uint32_t> dynamicCasters;
+			return m_cache.UpdateView(1, ViewProj, LightVersion, casters, staticCasters, dynamicCasters);
+		}
+
+		XMMATRIX ViewProj{ XMMatrixIdentity() };
+		std::uint32_t LightVersion{ 1 };
+		std::uint32_t CasterVersion{ 1 };
+
+	private:
+		ShadowCasterCache m_cache;
+		std::vector<std::uint32_t> m_casters;
+	};
+
+	void TestSteadyScene()
+	{
+		CacheFixture fixture;
+
+		// First frame fills the cache, every caster present from the start is static
+		auto first = fixture.Update();
+		CHECK(first.IsStale);
+		CHECK(first.Static.size() == k_casterCount);
+		CHECK(first.Dynamic.empty());
+
+		for (int frame = 0; frame < 20; ++frame)
+		{
+			CHECK(!fixture.Update().IsStale);
+		}
+	}
+
+	void TestMovingCaster()
+	{
+		CacheFixture fixture;
+		fixture.Update();
+
+		// Caster starts moving: it leaves the static set once, then keeps moving without staling the view
+		auto moved = fixture.Update({ 7 });
+		CHECK(moved.IsStale);
+		CHECK(moved.Dynamic == std::vector<std::uint32_t>{ 7 });
+		CHECK(moved.Static.size() == k_casterCount - 1);
+
+		for (int frame = 0; frame < 30; ++frame)
+		{
+			auto moving = fixture.Update({ 7 });
+			CHECK(!moving.IsStale);
+			CHECK(moving.Dynamic == std::vector<std::uint32_t>{ 7 });
+		}
+
+		// Stopped: dynamic for k_settleFrames more frames, then static again and the view is redrawn once
+		for (std::uint32_t frame = 1; frame < ShadowCasterCache::k_settleFrames; ++frame)
+		{
+			auto settling = fixture.Update();
+			CHECK(!settling.IsStale);
+			CHECK(settling.Dynamic.size() == 1);
+		}
+
+		auto settled = fixture.Update();
+		CHECK(settled.IsStale);
+		CHECK(settled.Dynamic.empty());
+		CHECK(settled.Static.size() == k_casterCount);
+
+		CHECK(!fixture.Update().IsStale);
+	}
+
+	// Casters out of a view do not stale it
+	void TestOtherView()
+	{
+		CacheFixture fixture;
+		fixture.Update();
+		CHECK(fixture.UpdateOtherView({ 1, 2, 3 }));
+		CHECK(!fixture.UpdateOtherView({ 1, 2, 3 }));
+
+		fixture.Update({ 50 });
+		CHECK(!fixture.UpdateOtherView({ 1, 2, 3 }));
+
+		fixture.Update({ 2 });
+		CHECK(fixture.UpdateOtherView({ 1, 2, 3 }));
+	}
+
+	void TestLightAndView()
+	{
+		CacheFixture fixture;
+		fixture.Update();
+
+		// Light changed, same matrix
+		++fixture.LightVersion;
+		CHECK(fixture.Update().IsStale);
+		CHECK(!fixture.Update().IsStale);
+
+		// Cascade refitted
+		fixture.ViewProj = XMMatrixTranslation(0.5f, 0.0f, 0.0f);
+		CHECK(fixture.Update().IsStale);
+		CHECK(!fixture.Update().IsStale);
+	}
+
+	// Rebuilt proxies: indices mean other casters now, everything is static and redrawn
+	void TestRebuild()
+	{
+		CacheFixture fixture;
+		fixture.Update();
+		fixture.Update({ 3, 4 });
+
+		++fixture.CasterVersion;
+		auto rebuilt = fixture.Update();
+		CHECK(rebuilt.IsStale);
+		CHECK(rebuilt.Dynamic.empty());
+		CHECK(!fixture.Update().IsStale);
+	}
+}
+
+int main()
+{
+	TestSteadyScene();
+	TestMovingCaster();
+	TestOtherView();
+	TestLightAndView();
+	TestRebuild();
+
+	return alexis::testing::Report("ShadowCasterCacheTests");
+}
@@ -0,0 +1,242 @@
+#include <Precompiled.h>
+
+#include <cstring>
+
+#include <Core/JobSystem.h>
+#include <Utils/SpecularIBL.h>
+
+#include <Testing/Check.h>
+
+// Baked split sum terms against brute force quadrature of the same integrals: the prefiltered map against the GGX lobe
+// with V = N summed over every environment texel, the BRDF LUT against the specular integral over a fine half vector grid.
+// Baked with the sample count EnvironmentSystem uses, the JobSystem gives the same bits
+namespace
+{
+	using namespace alexis;
+	using namespace alexis::utils;
+
+	// Same as EnvironmentSystem
+	constexpr std::uint32_t k_sampleCount = 1024;
+	constexpr std::size_t k_mipCount = 6;
+
+	constexpr std::size_t k_envWidth = 256;
+	constexpr std::size_t k_envHeight = 128;
+	constexpr std::size_t k_cubemapSize = 32;
+	constexpr std::size_t k_lutSize = 32;
+
+	float D_GGX(float NdotH, float roughness)
+	{
+		float a2 = roughness * roughness * roughness * roughness;
+		float denom = NdotH * NdotH * (a2 - 1.0f) + 1.0f;
+		return a2 / (XM_PI * denom * denom);
+	}
+
+	float G_SchlickGGX(float NdotX, float roughness)
+	{
+		float k = roughness * roughness / 2.0f;
+		return NdotX / (NdotX * (1.0f - k) + k);
+	}
+
+	// Same texel to direction mapping as ProjectIrradianceSH
+	XMVECTOR GetTexelDirection(std::size_t x, std::size_t y)
+	{
+		float phi = ((x + 0.5f) / k_envWidth - 0.5f) * XM_2PI;
+		float beta = (0.5f - (y + 0.5f) / k_envHeight) * XM_PI;
+		return XMVectorSet(std::cos(beta) * std::cos(phi), std::sin(beta), std::cos(beta) * std::sin(phi), 0.0f);
+	}
+
+	// Sky gradient, dark ground and a sun a few degrees wide
+	std::vector<XMFLOAT4> MakeEnvironment()
+	{
+		const XMVECTOR sunDirection = XMVector3Normalize(XMVectorSet(0.4f, 0.7f, -0.3f, 0.0f));
+
+		std::vector<XMFLOAT4> texels(k_envWidth * k_envHeight);
+		for (std::size_t y = 0; y < k_envHeight; ++y)
+		{
+			for (std::size_t x = 0; x < k_envWidth; ++x)
+			{
+				XMVECTOR direction = GetTexelDirection(x, y);
+				float up = XMVectorGetY(direction);
+				XMVECTOR sky = up > 0.0f ? XMVectorLerp(XMVectorSet(0.8f, 0.9f, 1.0f, 0.0f), XMVectorSet(0.2f, 0.4f, 0.9f, 0.0f), up) : XMVectorSet(0.1f, 0.08f, 0.05f, 0.0f);
+				float sun = std::pow(std::max(XMVectorGetX(XMVector3Dot(direction, sunDirection)), 0.0f), 64.0f);
+				XMStoreFloat4(&texels[y * k_envWidth + x], XMVectorSetW(XMVectorAdd(sky, XMVectorScale(XMVectorSet(1.0f, 0.95f, 0.8f, 0.0f), 20.0f * sun)), 1.0f));
+			}
+		}
+		return texels;
+	}
+
+	// Radiance weighted by D(H) * NdotL over every texel, normalized by the weights: what the importance samples estimate
+	XMVECTOR BruteForcePrefilter(const std::vector<XMFLOAT4>& texels, FXMVECTOR N, float roughness)
+	{
+		XMVECTOR sum = XMVectorZero();
+		float totalWeight = 0.0f;
+		for (std::size_t y = 0; y < k_envHeight; ++y)
+		{
+			float beta = (0.5f - (y + 0.5f) / k_envHeight) * XM_PI;
+			float solidAngle = std::cos(beta);
+
+			for (std::size_t x = 0; x < k_envWidth; ++x)
+			{
+				XMVECTOR L = GetTexelDirection(x, y);
+				float NdotL = XMVectorGetX(XMVector3Dot(N, L));
+				if (NdotL <= 0.0f)
+				{
+					continue;
+				}
+
+				float NdotH = XMVectorGetX(XMVector3Dot(N, XMVector3Normalize(XMVectorAdd(N, L))));
+				float weight = D_GGX(NdotH, roughness) * NdotL * solidAngle;
+				sum = XMVectorMultiplyAdd(XMLoadFloat4(&texels[y * k_envWidth + x]), XMVectorReplicate(weight), sum);
+				totalWeight += weight;
+			}
+		}
+		return XMVectorScale(sum, 1.0f / totalWeight);
+	}
+
+	// Scale and bias to F0: integral of G * VdotH / (NdotH * NdotV) against the GGX distribution of half vectors around N = +Z,
+	// (1 - Fc) and Fc weighted, zero where the reflection is below the horizon. Midpoint rule on a fine grid in the CDF of
+	// theta and in phi, so the sharpest lobes are as well resolved as the widest
+	XMFLOAT2 BruteForceBRDF(float NdotV, float roughness)
+	{
+		constexpr int k_xiSteps = 4096;
+		constexpr int k_phiSteps = 512;
+
+		const float a2 = roughness * roughness * roughness * roughness;
+		const XMFLOAT3 V{ std::sqrt(1.0f - NdotV * NdotV), 0.0f, NdotV };
+		const float G_V = G_SchlickGGX(NdotV, roughness);
+
+		double A = 0.0;
+		double B = 0.0;
+		for (int i = 0; i < k_xiSteps; ++i)
+		{
+			float xi = (i + 0.5f) / k_xiSteps;
+			float cosTheta = std::sqrt((1.0f - xi) / (1.0f + (a2 - 1.0f) * xi));
+			float sinTheta = std::sqrt(1.0f - cosTheta * cosTheta);
+
+			for (int j = 0; j < k_phiSteps; ++j)
+			{
+				float phi = (j + 0.5f) / k_phiSteps * XM_2PI;
+				XMFLOAT3 H{ sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta };
+
+				float VdotH = V.x * H.x + V.z * H.z;
+				float NdotL = 2.0f * VdotH * H.z - V.z;
+				if (NdotL <= 0.0f || VdotH <= 0.0f)
+				{
+					continue;
+				}
+
+				float G_Vis = G_V * G_SchlickGGX(NdotL, roughness) * VdotH / (cosTheta * NdotV);
+				float Fc = std::pow(1.0f - VdotH, 5.0f);
+
+				A += (1.0f - Fc) * G_Vis;
+				B += Fc * G_Vis;
+			}
+		}
+
+		const double count = static_cast<double>(k_xiSteps) * k_phiSteps;
+		return { static_cast<float>(A / count), static_cast<float>(B / count) };
+	}
+
+	// Face centers look down the axes, in D3D face order
+	void TestCubemapDirections()
+	{
+		const XMVECTORF32 axes[6] = { g_XMIdentityR0, g_XMNegIdentityR0, g_XMIdentityR1, g_XMNegIdentityR1, g_XMIdentityR2, g_XMNegIdentityR2 };
+		for (std::size_t face = 0; face < 6; ++face)
+		{
+			CHECK(XMVector3NearEqual(GetCubemapDirection(face, 0.5f, 0.5f), axes[face], XMVectorReplicate(1e-6f)));
+		}
+
+		// Top left corner of +Z is up and to the left (-X), like a view looking down +Z with +Y up
+		CHECK(XMVector3NearEqual(GetCubemapDirection(4, 0.0f, 0.0f), XMVector3Normalize(XMVectorSet(-1.0f, 1.0f, 1.0f, 0.0f)), XMVectorReplicate(1e-6f)));
+	}
+
+	void TestPrefilteredMap()
+	{
+		auto texels = MakeEnvironment();
+		PrefilteredCubemap cubemap = PrefilterEnvironmentGGX(texels.data(), k_envWidth, k_envHeight, k_cubemapSize, k_mipCount, k_sampleCount);
+
+		CHECK(cubemap.Images.size() == 6 * k_mipCount);
+
+		// Rough mips, a few texels per face, error relative to the reference. Measured 1.2% to 2.4% per mip, the filtered
+		// samples blur the sun a little more than the lobe does
+		for (std::size_t mip = 1; mip < k_mipCount; ++mip)
+		{
+			const std::size_t mipSize = k_cubemapSize >> mip;
+			const float roughness = static_cast<float>(mip) / (k_mipCount - 1);
+
+			float maxError = 0.0f;
+			for (std::size_t face = 0; face < 6; ++face)
+			{
+				const auto& image = cubemap.Images[face * k_mipCount + mip];
+				CHECK(image.size() == mipSize * mipSize);
+
+				for (std::size_t y = 0; y < mipSize; y += std::max<std::size_t>(mipSize / 4, 1))
+				{
+					for (std::size_t x = 0; x < mipSize; x += std::max<std::size_t>(mipSize / 4, 1))
+					{
+						XMVECTOR N = GetCubemapDirection(face, (x + 0.5f) / mipSize, (y + 0.5f) / mipSize);
+						XMVECTOR reference = BruteForcePrefilter(texels, N, roughness);
+						XMVECTOR baked = XMLoadFloat4(&image[y * mipSize + x]);
+
+						float error = XMVectorGetX(XMVector3Length(XMVectorSubtract(baked, reference))) / XMVectorGetX(XMVector3Length(reference));
+						maxError = std::max(maxError, error);
+					}
+				}
+			}
+			CHECK(maxError < 0.05f);
+		}
+	}
+
+	void TestBRDFLut()
+	{
+		auto lut = IntegrateEnvironmentBRDF(k_lutSize, k_sampleCount);
+		CHECK(lut.size() == k_lutSize * k_lutSize);
+
+		// Measured 0.0025 at worst, on the grazing column
+		float maxError = 0.0f;
+		for (std::size_t y = 1; y < k_lutSize; y += 5)
+		{
+			for (std::size_t x = 0; x < k_lutSize; x += 5)
+			{
+				const float NdotV = (x + 0.5f) / k_lutSize;
+				const float roughness = (y + 0.5f) / k_lutSize;
+
+				XMFLOAT2 reference = BruteForceBRDF(NdotV, roughness);
+				const auto& baked = lut[y * k_lutSize + x];
+				maxError = std::max(maxError, std::max(std::abs(baked.x - reference.x), std::abs(baked.y - reference.y)));
+
+				// Energy of a white F0 = 1 surface
+				CHECK(baked.x + baked.y <= 1.0f + 1e-3f);
+			}
+		}
+		CHECK(maxError < 0.005f);
+	}
+
+	// Rows are split between jobs but every texel is computed the same way
+	void TestJobSystem()
+	{
+		auto texels = MakeEnvironment();
+
+		JobSystem jobSystem;
+		PrefilteredCubemap serial = PrefilterEnvironmentGGX(texels.data(), k_envWidth, k_envHeight, 8, 3, 64);
+		PrefilteredCubemap parallel = PrefilterEnvironmentGGX(texels.data(), k_envWidth, k_envHeight, 8, 3, 64, &jobSystem);
+		for (std::size_t i = 0; i < serial.Images.size(); ++i)
+		{
+			CHECK(std::memcmp(serial.Images[i].data(), parallel.Images[i].data(), serial.Images[i].size() * sizeof(XMFLOAT4)) == 0);
+		}
+
+		auto serialLut = IntegrateEnvironmentBRDF(16, 64);
+		auto parallelLut = IntegrateEnvironmentBRDF(16, 64, &jobSystem);
+		CHECK(std::memcmp(serialLut.data(), parallelLut.data(), serialLut.size() * sizeof(XMFLOAT2)) == 0);
+	}
+}
+
+int main()
+{
+	TestCubemapDirections();
+	TestPrefilteredMap();
+	TestBRDFLut();
+	TestJobSystem();
+
+	return alexis::testing::Report("SpecularIBLTests");
+}
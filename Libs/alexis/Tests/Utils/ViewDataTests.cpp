@@ -0,0 +1,121 @@
+#include <Precompiled.h>
+
+#include <Render/ViewData.h>
+
+#include <Testing/Check.h>
+
+// BuildViewData combines the camera matrices once per view: products and inverses agree with the inputs and the
+// frustum planes are normalized, point inside and separate points in the view from points outside of it on each side
+namespace
+{
+	using namespace alexis;
+
+	constexpr float k_fovY = XM_PIDIV4;
+	constexpr float k_aspectRatio = 16.0f / 9.0f;
+	constexpr float k_nearZ = 0.1f;
+	constexpr float k_farZ = 100.0f;
+
+	static_assert(alignof(ViewData) == 16);
+
+	bool IsNear(FXMMATRIX a, CXMMATRIX b)
+	{
+		const XMVECTOR epsilon = XMVectorReplicate(1e-4f);
+		for (int row = 0; row < 4; ++row)
+		{
+			if (!XMVector4NearEqual(a.r[row], b.r[row], epsilon))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	ViewData MakeView(FXMVECTOR position, FXMVECTOR direction)
+	{
+		XMMATRIX view = XMMatrixLookToLH(position, direction, XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+		XMMATRIX proj = XMMatrixPerspectiveFovLH(k_fovY, k_aspectRatio, k_nearZ, k_farZ);
+
+		ViewData viewData;
+		BuildViewData(position, view, XMMatrixInverse(nullptr, view), proj, XMMatrixInverse(nullptr, proj), viewData);
+		return viewData;
+	}
+
+	// Point at distance along the view direction, offset sideways and up in view space units
+	XMVECTOR GetPoint(const ViewData& viewData, float distance, float right, float up)
+	{
+		return XMVector3TransformCoord(XMVectorSet(right, up, distance, 1.0f), viewData.InvView);
+	}
+
+	bool IsInside(const ViewData& viewData, FXMVECTOR point)
+	{
+		for (const auto& plane : viewData.FrustumPlanes)
+		{
+			if (XMVectorGetX(XMPlaneDotCoord(plane, point)) < 0.0f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Only the given plane rejects the point
+	bool IsOutsideOf(const ViewData& viewData, FXMVECTOR point, ViewData::FrustumPlane outside)
+	{
+		for (int plane = 0; plane < ViewData::PlaneCount; ++plane)
+		{
+			bool isInFront = XMVectorGetX(XMPlaneDotCoord(viewData.FrustumPlanes[plane], point)) >= 0.0f;
+			if (isInFront == (plane == outside))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void TestMatrices()
+	{
+		ViewData viewData = MakeView(XMVectorSet(1.0f, 2.0f, 3.0f, 1.0f), XMVector3Normalize(XMVectorSet(0.3f, -0.2f, 1.0f, 0.0f)));
+
+		CHECK(IsNear(viewData.ViewProj, XMMatrixMultiply(viewData.View, viewData.Proj)));
+		CHECK(IsNear(XMMatrixMultiply(viewData.ViewProj, viewData.InvViewProj), XMMatrixIdentity()));
+		CHECK(IsNear(XMMatrixMultiply(viewData.View, viewData.InvView), XMMatrixIdentity()));
+		CHECK(XMVector3Equal(viewData.Position, XMVectorSet(1.0f, 2.0f, 3.0f, 1.0f)));
+	}
+
+	void TestFrustumPlanes()
+	{
+		ViewData viewData = MakeView(XMVectorSet(1.0f, 2.0f, 3.0f, 1.0f), XMVector3Normalize(XMVectorSet(0.3f, -0.2f, 1.0f, 0.0f)));
+
+		for (const auto& plane : viewData.FrustumPlanes)
+		{
+			CHECK(std::abs(XMVectorGetX(XMVector3Length(plane)) - 1.0f) < 1e-5f);
+		}
+
+		// Half extents of the view at distance 10
+		const float halfHeight = 10.0f * std::tan(0.5f * k_fovY);
+		const float halfWidth = halfHeight * k_aspectRatio;
+
+		CHECK(IsInside(viewData, GetPoint(viewData, 10.0f, 0.0f, 0.0f)));
+		CHECK(IsInside(viewData, GetPoint(viewData, 10.0f, 0.9f * halfWidth, 0.9f * halfHeight)));
+		CHECK(IsInside(viewData, GetPoint(viewData, 0.5f * (k_nearZ + 0.2f), 0.0f, 0.0f)));
+		CHECK(IsInside(viewData, GetPoint(viewData, 0.99f * k_farZ, 0.0f, 0.0f)));
+
+		CHECK(IsOutsideOf(viewData, GetPoint(viewData, 10.0f, -1.1f * halfWidth, 0.0f), ViewData::Left));
+		CHECK(IsOutsideOf(viewData, GetPoint(viewData, 10.0f, 1.1f * halfWidth, 0.0f), ViewData::Right));
+		CHECK(IsOutsideOf(viewData, GetPoint(viewData, 10.0f, 0.0f, -1.1f * halfHeight), ViewData::Bottom));
+		CHECK(IsOutsideOf(viewData, GetPoint(viewData, 10.0f, 0.0f, 1.1f * halfHeight), ViewData::Top));
+		CHECK(IsOutsideOf(viewData, GetPoint(viewData, 0.5f * k_nearZ, 0.0f, 0.0f), ViewData::Near));
+		CHECK(IsOutsideOf(viewData, GetPoint(viewData, 1.01f * k_farZ, 0.0f, 0.0f), ViewData::Far));
+
+		// Behind the camera
+		CHECK(!IsInside(viewData, GetPoint(viewData, -10.0f, 0.0f, 0.0f)));
+	}
+}
+
+int main()
+{
+	TestMatrices();
+	TestFrustumPlanes();
+
+	return alexis::testing::Report("ViewDataTests");
+}
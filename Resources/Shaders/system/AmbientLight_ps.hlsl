@@ -13,15 +13,20 @@ struct CameraParams
 	matrix InvProjMatrix;
 };
 
+struct IrradianceParams
+{
+	float4 SH[9]; // Irradiance / pi, see utils::IrradianceSH
+};
+
 ConstantBuffer<CameraParams> CamCB : register(b0);
+ConstantBuffer<IrradianceParams> IrradianceCB : register(b1);
 
 Texture2D gb0 : register(t0); // (x,y,z) - baseColor RGB
 Texture2D gb1 : register(t1); // (x,y,z) - normal XYZ
 Texture2D gb2 : register(t2); // x - metall, y - roughness
 Texture2D depthTexture : register(t3); // Depth 24-bit + Stencil 8-bit
-TextureCube irradianceMap : register(t4); // Irradiance Map
-TextureCube prefilteredMap : register(t5); // Prefiltered Split-Sum Map
-Texture2D brdfLUT : register(t6); // Convoluted BRDF LUTt
+TextureCube prefilteredMap : register(t4); // Prefiltered Split-Sum Map
+Texture2D brdfLUT : register(t5); // Convoluted BRDF LUTt
 
 SamplerState AnisoSampler : register(s0);
 SamplerState LinearSampler : register(s1);
@@ -53,7 +58,7 @@ float4 main(PSInput input) : SV_TARGET
 	envBrdfInput.V = V;
 	envBrdfInput.Metallic = metallic;
 	envBrdfInput.Roughness = roughness;
-	envBrdfInput.IrradianceMap = irradianceMap;
+	envBrdfInput.Irradiance = EvaluateIrradianceSH(IrradianceCB.SH, N);
 	envBrdfInput.PrefilteredMap = prefilteredMap;
 	envBrdfInput.BrdfLUT = brdfLUT;
 	envBrdfInput.LinearSampler = LinearSampler;
@@ -1,6 +1,7 @@
 #define RootSig "RootFlags(ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT)," \
 "CBV(b0, flags = DATA_STATIC)," \
-"DescriptorTable(SRV(t0, numDescriptors = 7),visibility=SHADER_VISIBILITY_PIXEL)," \
+"DescriptorTable(SRV(t0, numDescriptors = 6),visibility=SHADER_VISIBILITY_PIXEL)," \
+"CBV(b1, flags = DATA_STATIC, visibility = SHADER_VISIBILITY_PIXEL)," \
 "StaticSampler(s0, filter = FILTER_ANISOTROPIC, addressU = TEXTURE_ADDRESS_CLAMP, addressV = TEXTURE_ADDRESS_CLAMP, addressW = TEXTURE_ADDRESS_CLAMP)," \
 "StaticSampler(s1, filter = FILTER_MIN_MAG_MIP_LINEAR, addressU = TEXTURE_ADDRESS_CLAMP, addressV = TEXTURE_ADDRESS_CLAMP, addressW = TEXTURE_ADDRESS_CLAMP)"
 
@@ -0,0 +1,107 @@
+#include "../utils/Common.hlsli"
+#include "../utils/PBSHelpers.hlsli"
+
+struct PSInput
+{
+	float2 uv0 : TEXCOORD;
+};
+
+struct CameraParams
+{
+	float4 CameraPos;
+	matrix InvViewMatrix;
+	matrix InvProjMatrix;
+};
+
+struct ClusterParams
+{
+	uint4 Grid; // x, y - tile count, z - slice count
+	float4 Slicing; // slice = log(viewZ) * x + y
+	matrix ViewMatrix;
+};
+
+struct ClusteredLight
+{
+	float3 Position;
+	float Range;
+	float3 Color;
+	float CosAngle; // Spot only
+	float3 Direction; // Spot only
+	uint Type; // 0 - point, 1 - spot
+};
+
+ConstantBuffer<CameraParams> CamCB : register(b0);
+ConstantBuffer<ClusterParams> ClusterCB : register(b1);
+
+Texture2D gb0 : register(t0); // (x,y,z) - baseColor RGB
+Texture2D gb1 : register(t1); // (x,y,z) - normal XYZ
+Texture2D gb2 : register(t2); // x - metall, y - roughness
+Texture2D depthTexture : register(t3); // Depth 24-bit + Stencil 8-bit
+
+StructuredBuffer<ClusteredLight> Lights : register(t4);
+StructuredBuffer<uint2> Clusters : register(t5); // x - first entry in LightIndices, y - light count
+StructuredBuffer<uint> LightIndices : register(t6);
+
+SamplerState AnisoSampler : register(s0);
+
+float4 main(PSInput input) : SV_TARGET
+{
+	float2 uv = input.uv0;
+	float3 baseColor = gb0.Sample(AnisoSampler, uv).rgb;
+	float3 normal = gb1.Sample(AnisoSampler, uv).xyz;
+	float3 metalRoughness = gb2.Sample(AnisoSampler, uv).rgb;
+	float metallic = metalRoughness.r;
+	float roughness = metalRoughness.g;
+
+	float depth = depthTexture.Sample(AnisoSampler, uv).r;
+	[flatten] if (depth >= 1.0f)
+	{
+		discard;
+	}
+
+	float3 worldPos = GetWorldPosFromDepth(depth, uv, CamCB.InvViewMatrix, CamCB.InvProjMatrix);
+
+	// Cluster of the pixel, tiles go from the top left corner
+	float viewZ = mul(ClusterCB.ViewMatrix, float4(worldPos, 1.0)).z;
+	uint2 tile = min(uint2(uv * ClusterCB.Grid.xy), ClusterCB.Grid.xy - 1);
+	uint slice = uint(clamp(floor(log(viewZ) * ClusterCB.Slicing.x + ClusterCB.Slicing.y), 0, ClusterCB.Grid.z - 1));
+	uint2 cluster = Clusters[(slice * ClusterCB.Grid.y + tile.y) * ClusterCB.Grid.x + tile.x];
+
+	float3 N = normalize(normal * 2.0 - 1.0);
+	float3 V = normalize(CamCB.CameraPos.xyz - worldPos);
+
+	BRDFInput brdfInput;
+	brdfInput.BaseColor = baseColor;
+	brdfInput.N = N;
+	brdfInput.V = V;
+	brdfInput.Metallic = metallic;
+	brdfInput.Roughness = roughness;
+
+	float3 color = 0.0;
+	for (uint i = 0; i < cluster.y; ++i)
+	{
+		ClusteredLight light = Lights[LightIndices[cluster.x + i]];
+
+		float3 toLight = light.Position - worldPos;
+		float distance = length(toLight);
+		float3 L = toLight / distance;
+
+		// Fades out at the light volume, clusters only hold lights whose volume reaches them
+		float fade = saturate(1.0 - pow(distance / light.Range, 4));
+		float attenuation = fade * fade / (distance * distance);
+
+		[branch] if (light.Type == 1)
+		{
+			float spot = saturate((dot(-L, light.Direction) - light.CosAngle) / max(1.0 - light.CosAngle, 1e-4));
+			attenuation *= spot * spot;
+		}
+
+		brdfInput.L = L;
+		BRDFOutput brdf = BRDF(brdfInput);
+
+		float3 radiance = light.Color * attenuation;
+		color += (brdf.Diffuse + brdf.Specular) * (radiance * max(dot(N, L), 0.0));
+	}
+
+	return float4(color, 1.0f);
+}
@@ -1,25 +1,21 @@
 #define RootSig "RootFlags(ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT)," \
 "CBV(b0, flags = DATA_STATIC)," \
 "CBV(b1, flags = DATA_STATIC)," \
-"CBV(b2, flags = DATA_STATIC)," \
-"CBV(b3, flags = DATA_STATIC)," \
+"SRV(t4, flags = DATA_STATIC, visibility = SHADER_VISIBILITY_PIXEL)," \
+"SRV(t5, flags = DATA_STATIC, visibility = SHADER_VISIBILITY_PIXEL)," \
+"SRV(t6, flags = DATA_STATIC, visibility = SHADER_VISIBILITY_PIXEL)," \
 "DescriptorTable(SRV(t0, numDescriptors = 4),visibility=SHADER_VISIBILITY_PIXEL)," \
 "StaticSampler(s0, filter = FILTER_ANISOTROPIC, addressU = TEXTURE_ADDRESS_CLAMP, addressV = TEXTURE_ADDRESS_CLAMP, addressW = TEXTURE_ADDRESS_CLAMP)"
 
-struct LightParams
-{
-	matrix WVPMatrix;
-};
-
-ConstantBuffer<LightParams> LightCB : register(b0);
-
 struct VSInput
 {
 	float3 position : POSITION;
+	float2 uv0 : TEXCOORD;
 };
 
 struct VSOutput
 {
+	float2 uv0 : TEXCOORD;
 	float4 position : SV_Position;
 };
 
@@ -27,6 +23,8 @@ struct VSOutput
 VSOutput main(VSInput input)
 {
 	VSOutput output;
-	output.position = mul(LightCB.WVPMatrix, float4(input.position, 1.0));
+	output.position = float4(input.position, 1.0);
+	output.uv0 = input.uv0;
+
 	return output;
-}
\ No newline at end of file
+}
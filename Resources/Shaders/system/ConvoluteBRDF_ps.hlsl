@@ -1,69 +0,0 @@
-#include "../utils/PBShelpers.hlsli"
-
-float VanDerCorpusSequence(uint bits)
-{
-	bits = (bits << 16u) | (bits >> 16u);
-	bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
-	bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
-	bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
-	bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
-
-	return float(bits) * 2.3283064365386963e-10; // 0x100000000
-}
-
-float2 Hammersley(uint i, uint N)
-{
-	return float2(float(i) / float(N), VanDerCorpusSequence(i));
-}
-
-float2 IntegrateBRDF(float NdotV, float roughness)
-{
-	float3 V;
-	V.x = sqrt(1.0 - NdotV * NdotV);
-	V.y = 0.0;
-	V.z = NdotV;
-
-	float A = 0.0;
-	float B = 0.0;
-
-	float3 N = float3(0.0, 0.0, 1.0);
-
-	const uint SAMPLE_COUNT = 1024u;
-
-	for (uint i = 0u; i < SAMPLE_COUNT; ++i)
-	{
-		float2 Xi = Hammersley(i, SAMPLE_COUNT);
-		float3 H = ImportanceSampleGGX(Xi, N, roughness);
-		float3 L = normalize(2.0 * dot(V, H) * H - V);
-
-		float NdotL = max(L.z, 0.0);
-		float NdotH = max(H.z, 0.0);
-		float VdotH = max(dot(V, H), 0.0);
-
-		if (NdotL > 0.0)
-		{
-			float G = G_Smith_IBL(N, V, L, roughness);
-			float G_Vis = (G * VdotH) / (NdotH * NdotV);
-			float Fc = pow(1.0 - VdotH, 5.0);
-
-			A += (1.0 - Fc) * G_Vis;
-			B += Fc * G_Vis;
-		}
-	}
-
-	A /= float(SAMPLE_COUNT);
-	B /= float(SAMPLE_COUNT);
-
-	return float2(A, B);
-}
-
-struct PSInput
-{
-	float2 uv0 : TEXCOORD;
-};
-
-float4 main(PSInput input) : SV_TARGET
-{
-	float2 integratedBRDF = IntegrateBRDF(input.uv0.x, input.uv0.y);
-	return float4(integratedBRDF, 0.0, 1.0);
-}
\ No newline at end of file
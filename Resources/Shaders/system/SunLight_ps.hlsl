@@ -0,0 +1,98 @@
+#include "../utils/Common.hlsli"
+#include "../utils/PBSHelpers.hlsli"
+
+struct PSInput
+{
+	float2 uv0 : TEXCOORD;
+};
+
+struct CameraParams
+{
+	float4 CameraPos;
+	matrix InvViewMatrix;
+	matrix InvProjMatrix;
+};
+
+struct SunParams
+{
+	float4 Direction; // Direction the light travels
+	float4 Color;
+	matrix ViewMatrix;
+	float4 CascadeSplits; // Far depth of each cascade
+	float4 CascadeTexelSizes;
+	matrix ShadowMatrices[4]; // World -> shadow atlas UV and depth
+};
+
+ConstantBuffer<CameraParams> CamCB : register(b0);
+ConstantBuffer<SunParams> SunCB : register(b1);
+
+Texture2D gb0 : register(t0); // (x,y,z) - baseColor RGB
+Texture2D gb1 : register(t1); // (x,y,z) - normal XYZ
+Texture2D gb2 : register(t2); // x - metall, y - roughness
+Texture2D depthTexture : register(t3); // Depth 24-bit + Stencil 8-bit
+Texture2D shadowMap : register(t4); // 2x2 atlas of cascades
+
+SamplerState AnisoSampler : register(s0);
+SamplerComparisonState ShadowSampler : register(s1);
+
+float SampleShadow(float3 worldPos, float3 N)
+{
+	// Cascade of the pixel by view depth, past the last one nothing is shadowed
+	float viewZ = mul(SunCB.ViewMatrix, float4(worldPos, 1.0)).z;
+	uint cascade = uint(dot(float4(viewZ >= SunCB.CascadeSplits), 1.0));
+
+	[branch] if (cascade >= 4)
+	{
+		return 1.0;
+	}
+
+	// Normal offset by a texel and a half keeps surfaces from shadowing themselves
+	float3 offsetPos = worldPos + N * (1.5 * SunCB.CascadeTexelSizes[cascade]);
+	float4 shadowPos = mul(SunCB.ShadowMatrices[cascade], float4(offsetPos, 1.0));
+
+	// 2x2 PCF, the cascade fit keeps a texel of margin inside its tile
+	return shadowMap.SampleCmpLevelZero(ShadowSampler, shadowPos.xy, shadowPos.z);
+}
+
+float4 main(PSInput input) : SV_TARGET
+{
+	float2 uv = input.uv0;
+	float3 baseColor = gb0.Sample(AnisoSampler, uv).rgb;
+	float3 normal = gb1.Sample(AnisoSampler, uv).xyz;
+	float3 metalRoughness = gb2.Sample(AnisoSampler, uv).rgb;
+	float metallic = metalRoughness.r;
+	float roughness = metalRoughness.g;
+
+	float depth = depthTexture.Sample(AnisoSampler, uv).r;
+	[flatten] if (depth >= 1.0f)
+	{
+		discard;
+	}
+
+	float3 worldPos = GetWorldPosFromDepth(depth, uv, CamCB.InvViewMatrix, CamCB.InvProjMatrix);
+
+	float3 N = normalize(normal * 2.0 - 1.0);
+	float3 V = normalize(CamCB.CameraPos.xyz - worldPos);
+	float3 L = -SunCB.Direction.xyz;
+
+	float NdotL = max(dot(N, L), 0.0);
+	[branch] if (NdotL <= 0.0)
+	{
+		discard;
+	}
+
+	BRDFInput brdfInput;
+	brdfInput.BaseColor = baseColor;
+	brdfInput.N = N;
+	brdfInput.V = V;
+	brdfInput.L = L;
+	brdfInput.Metallic = metallic;
+	brdfInput.Roughness = roughness;
+
+	BRDFOutput brdf = BRDF(brdfInput);
+
+	float3 radiance = SunCB.Color.rgb * SampleShadow(worldPos, N);
+	float3 color = (brdf.Diffuse + brdf.Specular) * (radiance * NdotL);
+
+	return float4(color, 1.0f);
+}
\ No newline at end of file
@@ -141,6 +141,22 @@ BRDFOutput BRDF(BRDFInput input)
 	return output;
 }
 
+// Order 2 SH in the basis of utils::ProjectIrradianceSH, n is normalized
+float3 EvaluateIrradianceSH(float4 sh[9], float3 n)
+{
+	float3 irradiance = sh[0].rgb * 0.282095f
+		+ sh[1].rgb * (0.488603f * n.y)
+		+ sh[2].rgb * (0.488603f * n.z)
+		+ sh[3].rgb * (0.488603f * n.x)
+		+ sh[4].rgb * (1.092548f * n.x * n.y)
+		+ sh[5].rgb * (1.092548f * n.y * n.z)
+		+ sh[6].rgb * (0.315392f * (3.0f * n.z * n.z - 1.0f))
+		+ sh[7].rgb * (1.092548f * n.x * n.z)
+		+ sh[8].rgb * (0.546274f * (n.x * n.x - n.y * n.y));
+
+	return max(irradiance, 0.0f);
+}
+
 struct EnvBRDFInput
 {
 	float3 BaseColor;
@@ -148,7 +164,7 @@ struct EnvBRDFInput
 	float3 V;
 	float Metallic;
 	float Roughness;
-	TextureCube IrradianceMap;
+	float3 Irradiance; // Irradiance / pi around N
 	TextureCube PrefilteredMap;
 	Texture2D BrdfLUT;
 	SamplerState LinearSampler;
@@ -174,8 +190,7 @@ EnvBRDFOutput EnvBRDF(EnvBRDFInput input)
 	float3 kD = 1.0 - kS;
 	kD *= (1.0 - input.Metallic);
 
-	float3 irradiance = input.IrradianceMap.Sample(input.LinearSampler, input.N).rgb;
-	float3 diffuse = kD * irradiance * input.BaseColor;
+	float3 diffuse = kD * input.Irradiance * input.BaseColor;
 
 	const float k_maxReflectionLod = 5.0f;
 	float3 prefilteredColor = input.PrefilteredMap.SampleLevel(input.LinearSampler, R, input.Roughness * k_maxReflectionLod).rgb;
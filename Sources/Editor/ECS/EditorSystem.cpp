@@ -52,10 +52,10 @@ namespace editor
 		return m_editorCamera;
 	}
 
-	std::set<alexis::ecs::Entity> EditorSystem::GetEntityList() const
+	std::vector<alexis::ecs::Entity> EditorSystem::GetEntityList() const
 	{
 		// Explicit copy entities
-		return Entities;
+		return Entities.GetDense();
 	}
 
 	bool EditorSystem::IsCameraFixed() const
@@ -92,8 +92,7 @@ namespace editor
 			std::string name = "";
 			if (ecsWorld.HasComponent<ecs::NameComponent>(entity))
 			{
-				auto& nameComponent = ecsWorld.GetComponent<ecs::NameComponent>(entity);
-				name = nameComponent.Name;
+				name = ecsWorld.GetComponent<const ecs::NameComponent>(entity).Name;
 			}
 
 			auto entityName = (name.empty() ? "Entity " + std::to_string(i++) : name);
@@ -102,7 +101,8 @@ namespace editor
 			{
 				if (ecsWorld.HasComponent<ecs::NameComponent>(entity))
 				{
-					auto& nameComponent = ecsWorld.GetComponent<ecs::NameComponent>(entity);
+					// Read-only access unless edited, like the other components below
+					const auto& nameComponent = ecsWorld.GetComponent<const ecs::NameComponent>(entity);
 
 					if (ImGui::TreeNode("NameComponent"))
 					{
@@ -110,7 +110,7 @@ namespace editor
 						strcpy_s(buf, nameComponent.Name.c_str());
 						if (ImGui::InputText("Name", buf, 128, ImGuiInputTextFlags_EnterReturnsTrue))
 						{
-							nameComponent.Name = buf;
+							ecsWorld.GetComponent<ecs::NameComponent>(entity).Name = buf;
 						}
 
 						ImGui::TreePop();
@@ -121,7 +121,8 @@ namespace editor
 
 				if (ecsWorld.HasComponent<ecs::TransformComponent>(entity))
 				{
-					auto& transformComponent = ecsWorld.GetComponent<ecs::TransformComponent>(entity);
+					// Read-only access unless edited: writes mark the transform as changed
+					const auto& transformComponent = ecsWorld.GetComponent<const ecs::TransformComponent>(entity);
 
 					if (ImGui::TreeNode("TransformComponent"))
 					{
@@ -132,9 +133,7 @@ namespace editor
 						if (ImGui::InputFloat3("Position", positionGUI, 3))
 						{
 							XMFLOAT4 positionDX(positionGUI);
-							transformComponent.Position = XMLoadFloat4(&positionDX);
-
-							transformComponent.IsTransformDirty = true;
+							ecsWorld.GetComponent<ecs::TransformComponent>(entity).Position = XMLoadFloat4(&positionDX);
 						}
 
 						XMFLOAT3 pyr = utils::GetPitchYawRollFromQuaternion(transformComponent.Rotation);
@@ -142,16 +141,13 @@ namespace editor
 						if (ImGui::InputFloat3("Rotation", rotationGUI, 3))
 						{
 							XMVECTOR pyrVec{ XMConvertToRadians(rotationGUI[0]), XMConvertToRadians(rotationGUI[1]), XMConvertToRadians(rotationGUI[2]) };
-							transformComponent.Rotation = XMQuaternionRotationRollPitchYawFromVector(pyrVec);
-
-							transformComponent.IsTransformDirty = true;
+							ecsWorld.GetComponent<ecs::TransformComponent>(entity).Rotation = XMQuaternionRotationRollPitchYawFromVector(pyrVec);
 						}
 
 						float scaleGUI = transformComponent.UniformScale;
 						if (ImGui::InputFloat("Scale", &scaleGUI))
 						{
-							transformComponent.UniformScale = scaleGUI;
-							transformComponent.IsTransformDirty = true;
+							ecsWorld.GetComponent<ecs::TransformComponent>(entity).UniformScale = scaleGUI;
 						}
 
 						ImGui::TreePop();
@@ -161,7 +157,7 @@ namespace editor
 				if (ecsWorld.HasComponent<ecs::CameraComponent>(entity) &&
 					ImGui::TreeNode("CameraComponent"))
 				{
-					auto& cameraComponent = ecsWorld.GetComponent<ecs::CameraComponent>(entity);
+					const auto& cameraComponent = ecsWorld.GetComponent<const ecs::CameraComponent>(entity);
 
 
 					ImGui::TreePop();
@@ -170,9 +166,30 @@ namespace editor
 				if (ecsWorld.HasComponent<ecs::LightComponent>(entity) &&
 					ImGui::TreeNode("LightComponent"))
 				{
-					auto& lightComponent = ecsWorld.GetComponent<ecs::LightComponent>(entity);
+					const auto& lightComponent = ecsWorld.GetComponent<const ecs::LightComponent>(entity);
+
+					bool isSpot = lightComponent.Type == ecs::LightComponent::LightType::Spot;
+					switch (lightComponent.Type)
+					{
+					case ecs::LightComponent::LightType::Point:
+						ImGui::Text("Type: Point");
+						break;
+					case ecs::LightComponent::LightType::Spot:
+						ImGui::Text("Type: Spot");
+						break;
+					case ecs::LightComponent::LightType::Directional:
+						ImGui::Text("Type: Directional");
+						break;
+					}
 
-					ImGui::Text("Type: Point");
+					if (isSpot)
+					{
+						float angle = XMConvertToDegrees(lightComponent.SpotAngle);
+						if (ImGui::SliderFloat("Angle", &angle, 1.0f, 89.0f))
+						{
+							ecsWorld.GetComponent<ecs::LightComponent>(entity).SpotAngle = XMConvertToRadians(angle);
+						}
+					}
 
 					XMFLOAT4 lightColor{};
 					XMStoreFloat4(&lightColor, lightComponent.Color);
@@ -180,7 +197,7 @@ namespace editor
 					float lightColorGUI[3]{ lightColor.x, lightColor.y, lightColor.z };
 					if (ImGui::InputFloat3("Color", lightColorGUI, 3))
 					{
-						lightComponent.Color = { lightColorGUI[0], lightColorGUI[1], lightColorGUI[2] };
+						ecsWorld.GetComponent<ecs::LightComponent>(entity).Color = { lightColorGUI[0], lightColorGUI[1], lightColorGUI[2] };
 					}
 
 					ImGui::TreePop();
@@ -189,7 +206,7 @@ namespace editor
 				if (ecsWorld.HasComponent<ecs::ModelComponent>(entity) &&
 					ImGui::TreeNode("ModelComponent"))
 				{
-					auto& modelComponent = ecsWorld.GetComponent<ecs::ModelComponent>(entity);
+					const auto& modelComponent = ecsWorld.GetComponent<const ecs::ModelComponent>(entity);
 					const auto& meshPath = modelComponent.Mesh->GetPath();
 					std::string meshPathStr{ meshPath.cbegin(), meshPath.cend() };
 					ImGui::Text("Mesh: %s", meshPathStr.c_str());
@@ -211,7 +228,7 @@ namespace editor
 		auto& ecsWorld = Core::Get().GetECSWorld();
 
 		XMVECTOR posOffset = XMVectorSet(m_movement[3] - m_movement[2], /*up-down*/ 0.0f, m_movement[0] - m_movement[1], 1.0f) * k_cameraSpeed * static_cast<float>(dt);
-		auto& cameraTransformComponent = ecsWorld.GetComponent<ecs::TransformComponent>(m_editorCamera);
+		const auto& cameraTransformComponent = ecsWorld.GetComponent<const ecs::TransformComponent>(m_editorCamera);
 		XMVECTOR newPos = cameraTransformComponent.Position + XMVector3Rotate(posOffset, cameraTransformComponent.Rotation);
 		newPos = XMVectorSetW(newPos, 1.0f);
 
@@ -15,7 +15,7 @@ namespace editor
 		void SetMovement(const std::array<float, 4>& movement);
 
 		alexis::ecs::Entity GetActiveCamera() const;
-		std::set<alexis::ecs::Entity> GetEntityList() const;
+		std::vector<alexis::ecs::Entity> GetEntityList() const;
 
 		bool IsCameraFixed() const;
 		void ToggleFixedCamera();
@@ -29,7 +29,7 @@ namespace editor
 		void UpdateEditorCamera(float dt);
 		void UpdateECSGUI();
 
-		alexis::ecs::Entity m_editorCamera{ 0 };
+		alexis::ecs::Entity m_editorCamera;
 
 		std::array<float, 4> m_movement{ 0.f, 0.f, 0.f, 0.f };
 
@@ -11,6 +11,7 @@
 #include <filesystem>
 
 #include <ECS/ECS.h>
+#include <ECS/EntityCommandBuffer.h>
 #include <ECS/Components/ModelComponent.h>
 #include <ECS/Components/CameraComponent.h>
 #include <ECS/Components/TransformComponent.h>
@@ -45,9 +46,12 @@ namespace editor
 
 		auto entities = j["entities"];
 
+		// Structural changes are applied in one pass after parsing
+		ecs::EntityCommandBuffer commandBuffer(ecsWorld);
+
 		for (auto& entityJson : entities)
 		{
-			auto entity = ecsWorld.CreateEntity();
+			auto entity = commandBuffer.CreateEntity();
 
 			for (auto& [componentName, componentValue] : entityJson["components"].items())
 			{
@@ -58,7 +62,8 @@ namespace editor
 					float nearZ = componentValue["nearZ"];
 					float farZ = componentValue["farZ"];
 					bool isOrtho = componentValue["isOrtho"] == 1;
-					ecsWorld.AddComponent(entity, ecs::CameraComponent{ fov, aspectRatio, nearZ, farZ, isOrtho });
+					float orthoHeight = componentValue.value("orthoHeight", ecs::CameraComponent::k_defaultOrthoHeight);
+					commandBuffer.AddComponent(entity, ecs::CameraComponent{ fov, aspectRatio, nearZ, farZ, isOrtho, orthoHeight });
 				}
 				else if (componentName == "TransformComponent")
 				{
@@ -70,7 +75,7 @@ namespace editor
 					XMVECTOR rotation = XMQuaternionRotationRollPitchYaw(XMConvertToRadians(rotJson["x"]), XMConvertToRadians(rotJson["y"]), XMConvertToRadians(rotJson["z"]));
 					float scale = scaleJson;
 
-					ecsWorld.AddComponent(entity, ecs::TransformComponent{ position, rotation, scale });
+					commandBuffer.AddComponent(entity, ecs::TransformComponent{ position, rotation, scale });
 				}
 				else if (componentName == "ModelComponent")
 				{
@@ -83,27 +88,49 @@ namespace editor
 					auto* material = resourceManager->GetMaterial(ToWStr(materialPath));
 
 					// TODO: Move semantics for adding components
-					ecsWorld.AddComponent(entity, ecs::ModelComponent{ mesh, material });
+					commandBuffer.AddComponent(entity, ecs::ModelComponent{ mesh, material });
 				}
 				else if (componentName == "LightComponent")
 				{
 					std::string lightTypeStr = componentValue["type"];
 
+					const auto& colorJson = componentValue["color"];
+					XMVECTOR color = XMVectorSet(colorJson["r"], colorJson["g"], colorJson["b"], 1.f);
+
 					if (lightTypeStr == "Point")
 					{
-						const auto& colorJson = componentValue["color"];
-						XMVECTOR color = XMVectorSet(colorJson["r"], colorJson["g"], colorJson["b"], 1.f);
-
-						ecsWorld.AddComponent(entity, ecs::LightComponent{ ecs::LightComponent::LightType::Point, color });
+						commandBuffer.AddComponent(entity, ecs::LightComponent{ ecs::LightComponent::LightType::Point, color });
+					}
+					else if (lightTypeStr == "Spot")
+					{
+						float angle = componentValue.value("angle", 45.0f);
+						commandBuffer.AddComponent(entity, ecs::LightComponent{ ecs::LightComponent::LightType::Spot, color, XMConvertToRadians(angle) });
+					}
+					else if (lightTypeStr == "Directional")
+					{
+						commandBuffer.AddComponent(entity, ecs::LightComponent{ ecs::LightComponent::LightType::Directional, color });
+
+						// Hand-written scenes point "direction" at the light instead of giving a transform, the light shines along +Z of its rotation
+						if (componentValue.contains("direction") && !entityJson["components"].contains("TransformComponent"))
+						{
+							const auto& directionJson = componentValue["direction"];
+							XMFLOAT3 direction;
+							XMStoreFloat3(&direction, XMVector3Normalize(XMVectorSet(-directionJson["x"].get<float>(), -directionJson["y"].get<float>(), -directionJson["z"].get<float>(), 0.f)));
+
+							XMVECTOR rotation = XMQuaternionRotationRollPitchYaw(std::asin(-direction.y), std::atan2(direction.x, direction.z), 0.f);
+							commandBuffer.AddComponent(entity, ecs::TransformComponent{ XMVectorSet(0.f, 0.f, 0.f, 1.f), rotation, 1.f });
+						}
 					}
 				}
 				else if (componentName == "NameComponent")
 				{
 					std::string nameStr = componentValue["name"];
-					ecsWorld.AddComponent(entity, ecs::NameComponent{ nameStr });
+					commandBuffer.AddComponent(entity, ecs::NameComponent{ nameStr });
 				}
 			}
 		}
+
+		commandBuffer.Playback();
 	}
 
 	void EditorSystemSerializer::Save(const std::wstring& filename)
@@ -135,7 +162,7 @@ namespace editor
 			//TransformComponent
 			if (ecsWorld.HasComponent<ecs::TransformComponent>(entity))
 			{
-				const auto& transformComponent = ecsWorld.GetComponent<ecs::TransformComponent>(entity);
+				const auto& transformComponent = ecsWorld.GetComponent<const ecs::TransformComponent>(entity);
 				json transCmp;
 
 				// Position
@@ -166,7 +193,7 @@ namespace editor
 			//NameComponent
 			if (ecsWorld.HasComponent<ecs::NameComponent>(entity))
 			{
-				const auto& nameComponent = ecsWorld.GetComponent<ecs::NameComponent>(entity);
+				const auto& nameComponent = ecsWorld.GetComponent<const ecs::NameComponent>(entity);
 				json nameCmp;
 
 				nameCmp["name"] = nameComponent.Name;
@@ -177,7 +204,7 @@ namespace editor
 			//ModelComponent
 			if (ecsWorld.HasComponent<ecs::ModelComponent>(entity))
 			{
-				const auto& modelComponent = ecsWorld.GetComponent<ecs::ModelComponent>(entity);
+				const auto& modelComponent = ecsWorld.GetComponent<const ecs::ModelComponent>(entity);
 				json modelCmp;
 
 				const auto& meshPath = modelComponent.Mesh->GetPath();
@@ -192,10 +219,23 @@ namespace editor
 			//LightComponent
 			if (ecsWorld.HasComponent<ecs::LightComponent>(entity))
 			{
-				const auto& lightComponent = ecsWorld.GetComponent<ecs::LightComponent>(entity);
+				const auto& lightComponent = ecsWorld.GetComponent<const ecs::LightComponent>(entity);
 				json lightCmp;
 
-				lightCmp["type"] = "Point"; // TODO: remove hardcode when other types will be impl
+				if (lightComponent.Type == ecs::LightComponent::LightType::Spot)
+				{
+					lightCmp["type"] = "Spot";
+					lightCmp["angle"] = XMConvertToDegrees(lightComponent.SpotAngle);
+				}
+				else if (lightComponent.Type == ecs::LightComponent::LightType::Directional)
+				{
+					lightCmp["type"] = "Directional";
+				}
+				else
+				{
+					lightCmp["type"] = "Point";
+				}
+
 				XMFLOAT4 color{};
 				XMStoreFloat4(&color, lightComponent.Color);
 				lightCmp["color"]["r"] = color.x;
@@ -208,14 +248,15 @@ namespace editor
 			//CameraComponent
 			if (ecsWorld.HasComponent<ecs::CameraComponent>(entity))
 			{
-				const auto& cameraComponent = ecsWorld.GetComponent<ecs::CameraComponent>(entity);
+				const auto& cameraComponent = ecsWorld.GetComponent<const ecs::CameraComponent>(entity);
 				json cameraCmp;
 
-				cameraCmp["fov"] = cameraComponent.Fov;
-				cameraCmp["aspectRatio"] = cameraComponent.AspectRatio;
-				cameraCmp["nearZ"] = cameraComponent.NearZ;
-				cameraCmp["farZ"] = cameraComponent.FarZ;
-				cameraCmp["isOrtho"] = cameraComponent.IsOrtho;
+				cameraCmp["fov"] = cameraComponent.GetFov();
+				cameraCmp["aspectRatio"] = cameraComponent.GetAspectRatio();
+				cameraCmp["nearZ"] = cameraComponent.GetNearZ();
+				cameraCmp["farZ"] = cameraComponent.GetFarZ();
+				cameraCmp["isOrtho"] = cameraComponent.IsOrtho();
+				cameraCmp["orthoHeight"] = cameraComponent.GetOrthoHeight();
 
 				entityJSON["components"]["CameraComponent"] = cameraCmp;
 			}
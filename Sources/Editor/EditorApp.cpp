@@ -12,6 +12,7 @@
 #include <ECS/Components/DoNotSerializeComponent.h>
 #include <ECS/Components/TransformComponent.h>
 #include <ECS/Components/CameraComponent.h>
+#include <Core/JobSystem.h>
 #include <Core/KeyCodes.h>
 #include <Render/Render.h>
 #include <utils/RenderUtils.h>
@@ -111,7 +112,11 @@ void EditorApp::OnUpdate(float dt)
 		// FPS topbar
 		char buffer[256];
 		{
-			sprintf_s(buffer, _countof(buffer), "FPS: %.2f (%.2f ms) | UPS: %.2f (%.2f ms)", m_fps, 1.0 / m_fps * 1000.f, m_ups, 1.0 / m_ups * 1000.f);
+			// Render CPU stages, to compare frame times across worker counts (-workers N)
+			const auto& cpuTimings = alexis::Render::GetInstance()->GetFrameRenderGraph()->GetCpuTimings();
+			sprintf_s(buffer, _countof(buffer), "CPU: extract %.2f record %.2f submit %.2f ms, %u threads | FPS: %.2f (%.2f ms) | UPS: %.2f (%.2f ms)",
+				cpuTimings.ExtractMs, cpuTimings.RecordMs, cpuTimings.SubmitMs, alexis::Core::Get().GetJobSystem().GetWorkerCount() + 1,
+				m_fps, 1.0 / m_fps * 1000.f, m_ups, 1.0 / m_ups * 1000.f);
 			auto fpsTextSize = ImGui::CalcTextSize(buffer);
 			ImGui::SameLine(ImGui::GetWindowWidth() - fpsTextSize.x - 20.f);
 			ImGui::Text(buffer);
@@ -328,7 +333,7 @@ void EditorApp::SaveEditorConfig()
 
 	auto& ecsWorld = alexis::Core::Get().GetECSWorld();
 	//TransformComponent
-	const auto& transformComponent = ecsWorld.GetComponent<alexis::ecs::TransformComponent>(m_editorSystem->GetActiveCamera());
+	const auto& transformComponent = ecsWorld.GetComponent<const alexis::ecs::TransformComponent>(m_editorSystem->GetActiveCamera());
 	json j;
 
 	// Position
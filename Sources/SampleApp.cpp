@@ -3,6 +3,7 @@
 #include "SampleApp.h"
 
 #include <Core/Core.h>
+#include <Core/JobSystem.h>
 #include <Render/Render.h>
 
 #include <Render/Mesh.h>
@@ -15,8 +16,6 @@
 using namespace alexis;
 using namespace DirectX;
 
-//#define MULTITHREAD_CONTEXTS
-
 static const float k_cameraSpeed = 10.0f;
 static const float k_cameraTurnSpeed = 0.1f;
 
@@ -62,7 +61,7 @@ void SampleApp::OnUpdate(float dt)
 		auto& ecsWorld = Core::Get().GetECSWorld();
 
 		XMVECTOR posOffset = XMVectorSet(m_rightMovement - m_leftMovement, m_upMovement - m_downMovement, m_fwdMovement - m_aftMovement, 1.0f) * k_cameraSpeed * static_cast<float>(dt);
-		auto cameraTransformComponent = ecsWorld.GetComponent<ecs::TransformComponent>(m_sceneCamera);
+		auto cameraTransformComponent = ecsWorld.GetComponent<const ecs::TransformComponent>(m_sceneCamera);
 		XMVECTOR newPos = cameraTransformComponent.Position + XMVector3Rotate(posOffset, cameraTransformComponent.Rotation);
 		newPos = XMVectorSetW(newPos, 1.0f);
 
@@ -275,7 +274,11 @@ void SampleApp::UpdateGUI()
 
 
 		{
-			sprintf_s(buffer, _countof(buffer), "FPS: %.2f (%.2f ms) Frame: %I64i  ", m_fps, 1.0 / m_fps * 1000.0, alexis::Core::GetFrameCount());
+			// Render CPU stages, to compare frame times across worker counts (-workers N)
+			const auto& cpuTimings = Render::GetInstance()->GetFrameRenderGraph()->GetCpuTimings();
+			sprintf_s(buffer, _countof(buffer), "CPU: extract %.2f record %.2f submit %.2f ms, %u threads | FPS: %.2f (%.2f ms) Frame: %I64i  ",
+				cpuTimings.ExtractMs, cpuTimings.RecordMs, cpuTimings.SubmitMs, Core::Get().GetJobSystem().GetWorkerCount() + 1,
+				m_fps, 1.0 / m_fps * 1000.0, alexis::Core::GetFrameCount());
 			auto fpsTextSize = ImGui::CalcTextSize(buffer);
 			ImGui::SameLine(ImGui::GetWindowWidth() - fpsTextSize.x);
 			ImGui::Text(buffer);